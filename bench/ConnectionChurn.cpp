@@ -0,0 +1,451 @@
+// Connection churn benchmark.
+//
+// Opens and closes connections against an in-process Server at a series of controlled rates, using a pool of
+// in-process Clients, and reports for every rate step:
+//   - sustained accepts/sec and disconnects/sec as seen by the server,
+//   - handshake latency percentiles, measured from the *scheduled* connect time to Client::OnConnected so that a
+//     stalled loop shows up as latency instead of silently lowering the offered rate,
+//   - server tick time percentiles (Server::Poll() + Server::ReceiveMessages()),
+// and the first step at which the accept path no longer keeps up.
+//
+// Everything runs on one thread. GNS dispatches the status callbacks of every connection in the process from
+// whichever RunCallbacks() call comes first, so only the server is polled and the (cheap) client-side handlers run
+// inside the measured server tick. Resident clients (--resident) stay connected for the whole run so the cost of
+// the server's client list under churn can be observed.
+//
+// Each client owns a UDP socket; raise the open file limit (ulimit -n) for large --pool or --resident values.
+
+#include "quicknet/quicknet.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <sstream>
+#include <streambuf>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace
+{
+    using Clock = std::chrono::steady_clock;
+
+    /// @brief Benchmark settings, from the command line.
+    struct Options
+    {
+        uint16_t nPort = 27090;
+        std::vector<double> vecRates = {50, 100, 200, 400, 800, 1600};
+        double flStepSeconds = 5.0;
+        int nHoldMs = 200;
+        int nPoolSize = 1000;
+        int nResident = 0;
+        int nTickMs = 10;
+        int nHandshakeTimeoutMs = 5000;
+        bool bVerbose = false;
+    };
+
+    /// @brief One pooled client and where it is in its connect / hold / disconnect cycle.
+    struct ClientSlot
+    {
+        enum class State
+        {
+            Idle,
+            Connecting,
+            Connected
+        };
+
+        std::unique_ptr<QNET::Client> pClient;
+        State eState = State::Idle;
+        Clock::time_point tScheduled;
+        Clock::time_point tRelease;
+    };
+
+    /// @brief Results of one rate step.
+    struct StepResult
+    {
+        double flTargetRate = 0;
+        double flAcceptsPerSec = 0;
+        double flDisconnectsPerSec = 0;
+        uint64_t nFailed = 0;
+        uint64_t nPoolExhausted = 0;
+        std::vector<double> vecHandshakeMs;
+        std::vector<double> vecTickMs;
+    };
+
+    /// @brief Discards everything written to it; used to silence the library's per-connection logging.
+    class NullBuffer : public std::streambuf
+    {
+    protected:
+        int overflow(int c) override { return c; }
+    };
+
+    double Percentile(std::vector<double> &vecSamples, double flPercentile)
+    {
+        if (vecSamples.empty())
+            return 0.0;
+
+        std::sort(vecSamples.begin(), vecSamples.end());
+        const size_t nIndex = static_cast<size_t>(flPercentile / 100.0 * (vecSamples.size() - 1) + 0.5);
+        return vecSamples[std::min(nIndex, vecSamples.size() - 1)];
+    }
+
+    double MillisecondsBetween(Clock::time_point tStart, Clock::time_point tEnd)
+    {
+        return std::chrono::duration<double, std::milli>(tEnd - tStart).count();
+    }
+
+    void PrintUsage()
+    {
+        std::cerr << "Usage: qnet_bench_churn [options]\n"
+                     "  --port N              Server port (default 27090)\n"
+                     "  --rates R1,R2,...     Connect rates to step through, per second (default 50,...,1600)\n"
+                     "  --step-seconds S      Duration of each rate step (default 5)\n"
+                     "  --hold-ms N           How long each churn client stays connected (default 200)\n"
+                     "  --pool N              Number of pooled churn clients (default 1000)\n"
+                     "  --resident N          Clients that stay connected for the whole run (default 0)\n"
+                     "  --tick-ms N           Server tick interval, as in Server::Run() (default 10)\n"
+                     "  --handshake-timeout-ms N  Connect attempts slower than this count as failed (default 5000)\n"
+                     "  --verbose             Keep the library's connection logging on stdout\n";
+    }
+
+    bool ParseOptions(int argc, char **argv, Options &options)
+    {
+        for (int i = 1; i < argc; ++i)
+        {
+            const std::string strArg = argv[i];
+            const bool bHasValue = i + 1 < argc;
+            if (strArg == "--verbose")
+            {
+                options.bVerbose = true;
+            }
+            else if (strArg == "--rates" && bHasValue)
+            {
+                options.vecRates.clear();
+                std::stringstream ss(argv[++i]);
+                std::string strRate;
+                while (std::getline(ss, strRate, ','))
+                {
+                    options.vecRates.push_back(std::atof(strRate.c_str()));
+                }
+            }
+            else if (strArg == "--port" && bHasValue)
+                options.nPort = static_cast<uint16_t>(std::atoi(argv[++i]));
+            else if (strArg == "--step-seconds" && bHasValue)
+                options.flStepSeconds = std::atof(argv[++i]);
+            else if (strArg == "--hold-ms" && bHasValue)
+                options.nHoldMs = std::atoi(argv[++i]);
+            else if (strArg == "--pool" && bHasValue)
+                options.nPoolSize = std::atoi(argv[++i]);
+            else if (strArg == "--resident" && bHasValue)
+                options.nResident = std::atoi(argv[++i]);
+            else if (strArg == "--tick-ms" && bHasValue)
+                options.nTickMs = std::atoi(argv[++i]);
+            else if (strArg == "--handshake-timeout-ms" && bHasValue)
+                options.nHandshakeTimeoutMs = std::atoi(argv[++i]);
+            else
+                return false;
+        }
+        return !options.vecRates.empty() && options.flStepSeconds > 0 && options.nPoolSize > 0 &&
+               options.nTickMs > 0;
+    }
+
+    /// @brief Drives the server and the client pool.
+    class ChurnBenchmark
+    {
+    public:
+        explicit ChurnBenchmark(const Options &options) : m_options(options)
+        {
+            m_strAddress = "127.0.0.1:" + std::to_string(options.nPort);
+
+            m_server.OnClientConnected = [this](HSteamNetConnection) { ++m_nAccepted; };
+            m_server.OnClientDisconnected = [this](HSteamNetConnection) { ++m_nDisconnected; };
+
+            m_vecSlots.resize(options.nPoolSize);
+            for (int i = 0; i < options.nPoolSize; ++i)
+            {
+                ClientSlot &slot = m_vecSlots[i];
+                slot.pClient = std::make_unique<QNET::Client>();
+                slot.pClient->OnConnected = [this, i]() { OnSlotConnected(i); };
+                slot.pClient->OnDisconnected = [this, i]() { OnSlotLost(i); };
+                m_vecIdle.push_back(i);
+            }
+        }
+
+        bool Start() { return m_server.Initialize(m_options.nPort) && ConnectResidents(); }
+
+        void Stop()
+        {
+            for (ClientSlot &slot : m_vecSlots)
+            {
+                slot.pClient->Disconnect();
+            }
+            for (auto &pClient : m_vecResidents)
+            {
+                pClient->Disconnect();
+            }
+            m_server.Stop();
+        }
+
+        /// @brief Runs one rate step and returns its measurements.
+        StepResult RunStep(double flRate)
+        {
+            StepResult result;
+            result.flTargetRate = flRate;
+            m_pResult = &result;
+            m_nAccepted = 0;
+            m_nDisconnected = 0;
+
+            const Clock::duration interval = std::chrono::duration_cast<Clock::duration>(
+                std::chrono::duration<double>(flRate > 0 ? 1.0 / flRate : 0.0));
+            const Clock::time_point tStart = Clock::now();
+            const Clock::time_point tEnd = tStart + std::chrono::duration_cast<Clock::duration>(
+                                                        std::chrono::duration<double>(m_options.flStepSeconds));
+
+            Clock::time_point tNextConnect = tStart;
+            Clock::time_point tNextTick = tStart;
+            while (Clock::now() < tEnd)
+            {
+                // Open-loop schedule: every connect that is due is issued, however late the loop is running.
+                Clock::time_point tNow = Clock::now();
+                while (flRate > 0 && tNextConnect <= tNow)
+                {
+                    IssueConnect(tNextConnect);
+                    tNextConnect += interval;
+                }
+
+                ReleaseExpiredSlots(tNow);
+
+                const Clock::time_point tTickStart = Clock::now();
+                m_server.Poll();
+                m_server.ReceiveMessages();
+                result.vecTickMs.push_back(MillisecondsBetween(tTickStart, Clock::now()));
+
+                tNextTick += std::chrono::milliseconds(m_options.nTickMs);
+                std::this_thread::sleep_until(tNextTick);
+            }
+
+            const double flElapsed = std::chrono::duration<double>(Clock::now() - tStart).count();
+            result.flAcceptsPerSec = m_nAccepted / flElapsed;
+            result.flDisconnectsPerSec = m_nDisconnected / flElapsed;
+            m_pResult = nullptr;
+
+            Drain();
+            return result;
+        }
+
+    private:
+        /// @brief Connects the resident clients and waits until the server has accepted all of them.
+        bool ConnectResidents()
+        {
+            for (int i = 0; i < m_options.nResident; ++i)
+            {
+                m_vecResidents.push_back(std::make_unique<QNET::Client>());
+                if (!m_vecResidents.back()->Connect(m_strAddress))
+                    return false;
+            }
+
+            const Clock::time_point tDeadline = Clock::now() + std::chrono::seconds(30);
+            while (m_nAccepted < uint64_t(m_options.nResident) && Clock::now() < tDeadline)
+            {
+                m_server.Poll();
+                m_server.ReceiveMessages();
+                std::this_thread::sleep_for(std::chrono::milliseconds(m_options.nTickMs));
+            }
+            return m_nAccepted >= uint64_t(m_options.nResident);
+        }
+
+        void IssueConnect(Clock::time_point tScheduled)
+        {
+            if (m_vecIdle.empty())
+            {
+                ++m_pResult->nPoolExhausted;
+                return;
+            }
+
+            const int nSlot = m_vecIdle.back();
+            m_vecIdle.pop_back();
+
+            ClientSlot &slot = m_vecSlots[nSlot];
+            slot.tScheduled = tScheduled;
+            if (!slot.pClient->Connect(m_strAddress))
+            {
+                ++m_pResult->nFailed;
+                m_vecIdle.push_back(nSlot);
+                return;
+            }
+            slot.eState = ClientSlot::State::Connecting;
+        }
+
+        /// @brief Disconnects clients whose hold time is over, and gives up on handshakes that took too long.
+        void ReleaseExpiredSlots(Clock::time_point tNow)
+        {
+            const Clock::duration handshakeTimeout = std::chrono::milliseconds(m_options.nHandshakeTimeoutMs);
+            for (size_t i = 0; i < m_vecSlots.size(); ++i)
+            {
+                ClientSlot &slot = m_vecSlots[i];
+                const bool bHoldOver = slot.eState == ClientSlot::State::Connected && tNow >= slot.tRelease;
+                const bool bTimedOut =
+                    slot.eState == ClientSlot::State::Connecting && tNow - slot.tScheduled >= handshakeTimeout;
+                if (!bHoldOver && !bTimedOut)
+                    continue;
+
+                if (bTimedOut && m_pResult)
+                {
+                    ++m_pResult->nFailed;
+                }
+                slot.pClient->Disconnect();
+                slot.eState = ClientSlot::State::Idle;
+                m_vecIdle.push_back(static_cast<int>(i));
+            }
+        }
+
+        void OnSlotConnected(int nSlot)
+        {
+            ClientSlot &slot = m_vecSlots[nSlot];
+            if (slot.eState != ClientSlot::State::Connecting)
+                return;
+
+            const Clock::time_point tNow = Clock::now();
+            if (m_pResult)
+            {
+                m_pResult->vecHandshakeMs.push_back(MillisecondsBetween(slot.tScheduled, tNow));
+            }
+            slot.eState = ClientSlot::State::Connected;
+            slot.tRelease = tNow + std::chrono::milliseconds(m_options.nHoldMs);
+        }
+
+        void OnSlotLost(int nSlot)
+        {
+            ClientSlot &slot = m_vecSlots[nSlot];
+            if (slot.eState == ClientSlot::State::Idle)
+                return;
+
+            if (m_pResult)
+            {
+                ++m_pResult->nFailed;
+            }
+            slot.eState = ClientSlot::State::Idle;
+            m_vecIdle.push_back(nSlot);
+        }
+
+        /// @brief Disconnects every churn client and lets the server settle before the next step.
+        void Drain()
+        {
+            for (size_t i = 0; i < m_vecSlots.size(); ++i)
+            {
+                ClientSlot &slot = m_vecSlots[i];
+                if (slot.eState == ClientSlot::State::Idle)
+                    continue;
+
+                slot.pClient->Disconnect();
+                slot.eState = ClientSlot::State::Idle;
+                m_vecIdle.push_back(static_cast<int>(i));
+            }
+
+            const Clock::time_point tEnd = Clock::now() + std::chrono::milliseconds(500);
+            while (Clock::now() < tEnd)
+            {
+                m_server.Poll();
+                m_server.ReceiveMessages();
+                std::this_thread::sleep_for(std::chrono::milliseconds(m_options.nTickMs));
+            }
+        }
+
+    private:
+        const Options &m_options;
+        std::string m_strAddress;
+
+        QNET::Server m_server;
+        std::vector<std::unique_ptr<QNET::Client>> m_vecResidents;
+        std::vector<ClientSlot> m_vecSlots;
+        std::vector<int> m_vecIdle;
+
+        uint64_t m_nAccepted = 0;
+        uint64_t m_nDisconnected = 0;
+        StepResult *m_pResult = nullptr;
+    };
+} // namespace
+
+int main(int argc, char **argv)
+{
+    Options options;
+    if (!ParseOptions(argc, argv, options))
+    {
+        PrintUsage();
+        return 1;
+    }
+
+    // Results go to the real stdout; the library's per-connection logging is discarded unless --verbose. The
+    // logging statements are still formatted, so their CPU cost remains part of the measurement.
+    std::ostream out(std::cout.rdbuf());
+    NullBuffer nullBuffer;
+    if (!options.bVerbose)
+    {
+        std::cout.rdbuf(&nullBuffer);
+    }
+
+    int nExitCode = 0;
+    {
+        ChurnBenchmark benchmark(options);
+        if (!benchmark.Start())
+        {
+            std::cerr << "Failed to start the server or connect the resident clients." << std::endl;
+            nExitCode = 1;
+        }
+        else
+        {
+            out << "Connection churn: pool " << options.nPoolSize << ", resident " << options.nResident << ", hold "
+                << options.nHoldMs << " ms, tick " << options.nTickMs << " ms, " << options.flStepSeconds
+                << " s per step\n\n";
+            out << std::setw(9) << "target/s" << std::setw(11) << "accepts/s" << std::setw(10) << "discon/s"
+                << std::setw(8) << "failed" << std::setw(10) << "pool-out" << std::setw(11) << "hs p50 ms"
+                << std::setw(11) << "hs p99 ms" << std::setw(11) << "hs max ms" << std::setw(13) << "tick p50 ms"
+                << std::setw(13) << "tick p99 ms" << std::setw(13) << "tick max ms" << "\n";
+
+            double flSaturationRate = 0;
+            double flBestAcceptRate = 0;
+            for (double flRate : options.vecRates)
+            {
+                StepResult result = benchmark.RunStep(flRate);
+                out << std::fixed << std::setprecision(1) << std::setw(9) << result.flTargetRate << std::setw(11)
+                    << result.flAcceptsPerSec << std::setw(10) << result.flDisconnectsPerSec << std::setw(8)
+                    << result.nFailed << std::setw(10) << result.nPoolExhausted << std::setprecision(2)
+                    << std::setw(11) << Percentile(result.vecHandshakeMs, 50) << std::setw(11)
+                    << Percentile(result.vecHandshakeMs, 99) << std::setw(11) << Percentile(result.vecHandshakeMs, 100)
+                    << std::setw(13) << Percentile(result.vecTickMs, 50) << std::setw(13)
+                    << Percentile(result.vecTickMs, 99) << std::setw(13) << Percentile(result.vecTickMs, 100) << "\n"
+                    << std::flush;
+
+                flBestAcceptRate = std::max(flBestAcceptRate, result.flAcceptsPerSec);
+
+                // The accept path is saturated once it falls clearly behind the offered rate, or once connects
+                // start failing or piling up in the pool.
+                const bool bSaturated = result.flAcceptsPerSec < 0.9 * flRate || result.nFailed > 0 ||
+                                        result.nPoolExhausted > 0;
+                if (bSaturated && flSaturationRate == 0)
+                {
+                    flSaturationRate = flRate;
+                }
+            }
+
+            out << "\n";
+            if (flSaturationRate > 0)
+            {
+                out << "Accept path saturated at a target of " << std::setprecision(1) << flSaturationRate
+                    << " connects/s; best sustained rate " << flBestAcceptRate << " accepts/s.\n";
+            }
+            else
+            {
+                out << "No saturation up to " << std::setprecision(1) << options.vecRates.back()
+                    << " connects/s; best sustained rate " << flBestAcceptRate << " accepts/s.\n";
+            }
+        }
+        benchmark.Stop();
+    }
+
+    std::cout.rdbuf(out.rdbuf());
+    return nExitCode;
+}
\ No newline at end of file
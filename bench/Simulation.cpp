@@ -0,0 +1,315 @@
+// Deterministic tick simulation.
+//
+// Runs a Server and a set of Clients over a SimTransport: an in-memory network on a virtual clock with seeded
+// latency, jitter, loss and bandwidth. Every client sends a small unreliable input each client tick and the server
+// broadcasts a reliable state update each server tick, which is the traffic shape of a typical game session. The
+// run reports, in virtual time:
+//   - state update latency percentiles, from the server's broadcast to the client's OnMessageReceived,
+//   - inputs received by the server and state updates received by the clients,
+//   - the server's worst send queue time and pending reliable bytes (backpressure),
+//   - transport counters (sent, delivered, dropped, retransmitted),
+// plus the wall-clock time the run took, and a digest of every delivery (connection, payload and virtual time).
+//
+// The same options and seed always produce the same digest, so a scaling or pacing experiment can be replayed
+// exactly; --verify runs the scenario twice and fails if the digests differ.
+
+#include "quicknet/quicknet.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <streambuf>
+#include <string>
+#include <vector>
+
+namespace
+{
+    /// @brief Benchmark settings, from the command line.
+    struct Options
+    {
+        uint64_t nSeed = 1;
+        int nClients = 32;
+        double flSeconds = 600.0;
+        int nServerTickMs = 50;
+        int nClientTickMs = 16;
+        int nStateBytes = 256;
+        int nInputBytes = 32;
+        QNET::SimLinkConfig link;
+        bool bVerify = false;
+        bool bVerbose = false;
+    };
+
+    /// @brief Measurements of one run.
+    struct RunResult
+    {
+        uint64_t nDigest = 14695981039346656037ull;
+        uint64_t nInputsReceived = 0;
+        uint64_t nStatesReceived = 0;
+        uint64_t nConnected = 0;
+        std::vector<double> vecStateLatencyMs;
+        SteamNetworkingMicroseconds usecMaxQueueTime = 0;
+        int cbMaxPendingReliable = 0;
+        QNET::SimStats stats;
+        double flWallSeconds = 0;
+    };
+
+    /// @brief Discards everything written to it; used to silence the library's per-connection logging.
+    class NullBuffer : public std::streambuf
+    {
+    protected:
+        int overflow(int c) override { return c; }
+    };
+
+    double Percentile(std::vector<double> &vecSamples, double flPercentile)
+    {
+        if (vecSamples.empty())
+            return 0.0;
+
+        std::sort(vecSamples.begin(), vecSamples.end());
+        const size_t nIndex = static_cast<size_t>(flPercentile / 100.0 * (vecSamples.size() - 1) + 0.5);
+        return vecSamples[std::min(nIndex, vecSamples.size() - 1)];
+    }
+
+    /// @brief Folds a value into an FNV-1a digest.
+    void Mix(uint64_t &nDigest, uint64_t nValue)
+    {
+        for (int i = 0; i < 8; ++i)
+        {
+            nDigest = (nDigest ^ ((nValue >> (i * 8)) & 0xff)) * 1099511628211ull;
+        }
+    }
+
+    void PrintUsage()
+    {
+        std::cerr << "Usage: qnet_bench_sim [options]\n"
+                     "  --seed N              Seed for latency, jitter and loss (default 1)\n"
+                     "  --clients N           Number of clients (default 32)\n"
+                     "  --seconds S           Simulated duration (default 600)\n"
+                     "  --server-tick-ms N    Interval of the server's state broadcast (default 50)\n"
+                     "  --client-tick-ms N    Interval of each client's input message (default 16)\n"
+                     "  --state-bytes N       Size of a state update (default 256)\n"
+                     "  --input-bytes N       Size of an input message (default 32)\n"
+                     "  --latency-ms N        One-way latency (default 20)\n"
+                     "  --jitter-ms N         Additional random one-way delay (default 0)\n"
+                     "  --loss P              Loss percentage (default 0)\n"
+                     "  --bandwidth N         Bytes per second per connection and direction, 0 = unlimited\n"
+                     "  --verify              Run twice and fail unless both runs are identical\n"
+                     "  --verbose             Keep the library's connection logging on stdout\n";
+    }
+
+    bool ParseOptions(int argc, char **argv, Options &options)
+    {
+        for (int i = 1; i < argc; ++i)
+        {
+            const std::string strArg = argv[i];
+            const bool bHasValue = i + 1 < argc;
+            if (strArg == "--verify")
+                options.bVerify = true;
+            else if (strArg == "--verbose")
+                options.bVerbose = true;
+            else if (strArg == "--seed" && bHasValue)
+                options.nSeed = std::strtoull(argv[++i], nullptr, 10);
+            else if (strArg == "--clients" && bHasValue)
+                options.nClients = std::atoi(argv[++i]);
+            else if (strArg == "--seconds" && bHasValue)
+                options.flSeconds = std::atof(argv[++i]);
+            else if (strArg == "--server-tick-ms" && bHasValue)
+                options.nServerTickMs = std::atoi(argv[++i]);
+            else if (strArg == "--client-tick-ms" && bHasValue)
+                options.nClientTickMs = std::atoi(argv[++i]);
+            else if (strArg == "--state-bytes" && bHasValue)
+                options.nStateBytes = std::atoi(argv[++i]);
+            else if (strArg == "--input-bytes" && bHasValue)
+                options.nInputBytes = std::atoi(argv[++i]);
+            else if (strArg == "--latency-ms" && bHasValue)
+                options.link.nLatencyMs = static_cast<uint32_t>(std::atoi(argv[++i]));
+            else if (strArg == "--jitter-ms" && bHasValue)
+                options.link.nJitterMs = static_cast<uint32_t>(std::atoi(argv[++i]));
+            else if (strArg == "--loss" && bHasValue)
+                options.link.flLossPercent = static_cast<float>(std::atof(argv[++i]));
+            else if (strArg == "--bandwidth" && bHasValue)
+                options.link.nBandwidthBytesPerSec = static_cast<uint32_t>(std::atoi(argv[++i]));
+            else
+                return false;
+        }
+        return options.nClients > 0 && options.flSeconds > 0 && options.nServerTickMs > 0 &&
+               options.nClientTickMs > 0 && options.nStateBytes >= 8 && options.nInputBytes > 0;
+    }
+
+    /// @brief Runs the scenario once. Everything happens on this thread, one millisecond of virtual time per step.
+    RunResult RunScenario(const Options &options)
+    {
+        RunResult result;
+        const auto tWallStart = std::chrono::steady_clock::now();
+
+        QNET::SimTransport transport(options.nSeed, options.link);
+        QNET::Server server(transport);
+        std::vector<HSteamNetConnection> vecConnections;
+
+        server.OnClientConnected = [&](HSteamNetConnection hConn)
+        {
+            vecConnections.push_back(hConn);
+            ++result.nConnected;
+        };
+        server.OnClientDisconnected = [&](HSteamNetConnection hConn)
+        {
+            vecConnections.erase(std::remove(vecConnections.begin(), vecConnections.end(), hConn),
+                                 vecConnections.end());
+        };
+        server.OnMessageReceived = [&](HSteamNetConnection hConn, const std::vector<uint8_t> &byteMessage)
+        {
+            ++result.nInputsReceived;
+            Mix(result.nDigest, hConn);
+            Mix(result.nDigest, byteMessage.size());
+            Mix(result.nDigest, uint64_t(transport.GetLocalTimestamp()));
+        };
+
+        const uint16_t nPort = 27100;
+        if (!server.Initialize(nPort))
+            return result;
+
+        std::vector<std::unique_ptr<QNET::Client>> vecClients;
+        for (int i = 0; i < options.nClients; ++i)
+        {
+            vecClients.push_back(std::make_unique<QNET::Client>(transport));
+            vecClients.back()->OnMessageReceived = [&result, &transport, i](const std::vector<uint8_t> &byteMessage)
+            {
+                // Every state update starts with the virtual time it was broadcast at.
+                SteamNetworkingMicroseconds usecSent = 0;
+                std::memcpy(&usecSent, byteMessage.data(), sizeof(usecSent));
+                const SteamNetworkingMicroseconds usecNow = transport.GetLocalTimestamp();
+                result.vecStateLatencyMs.push_back((usecNow - usecSent) / 1000.0);
+                ++result.nStatesReceived;
+                Mix(result.nDigest, uint64_t(i));
+                Mix(result.nDigest, uint64_t(usecSent));
+                Mix(result.nDigest, uint64_t(usecNow));
+            };
+            vecClients.back()->Connect("127.0.0.1:" + std::to_string(nPort));
+        }
+
+        std::vector<uint8_t> byteState(options.nStateBytes, 0);
+        const std::vector<uint8_t> byteInput(options.nInputBytes, 0);
+        int64_t nStep = 0;
+        auto tick = [&]()
+        {
+            server.Poll();
+            server.ReceiveMessages();
+
+            if (nStep % options.nServerTickMs == 0)
+            {
+                const SteamNetworkingMicroseconds usecNow = transport.GetLocalTimestamp();
+                std::memcpy(byteState.data(), &usecNow, sizeof(usecNow));
+                server.BroadcastReliableMessage(byteState);
+
+                for (HSteamNetConnection hConn : vecConnections)
+                {
+                    SteamNetConnectionRealTimeStatus_t status;
+                    if (server.GetRealTimeStatus(hConn, status))
+                    {
+                        result.usecMaxQueueTime = std::max(result.usecMaxQueueTime,
+                                                           status.m_usecQueueTime);
+                        result.cbMaxPendingReliable = std::max(result.cbMaxPendingReliable,
+                                                               status.m_cbPendingReliable);
+                    }
+                }
+            }
+
+            for (auto &pClient : vecClients)
+            {
+                pClient->Poll();
+                pClient->ReceiveMessages();
+                if (nStep % options.nClientTickMs == 0 && pClient->IsConnected())
+                {
+                    pClient->SendUnreliableMessageToServer(byteInput);
+                }
+            }
+            ++nStep;
+        };
+        transport.RunFor(SteamNetworkingMicroseconds(options.flSeconds * 1e6), 1000, tick);
+
+        for (auto &pClient : vecClients)
+        {
+            pClient->Disconnect();
+        }
+        transport.RunFor(1000000, 1000, [&]() { server.Poll(); });
+
+        result.stats = transport.GetStats();
+        result.flWallSeconds =
+            std::chrono::duration<double>(std::chrono::steady_clock::now() - tWallStart).count();
+        return result;
+    }
+
+    void PrintResult(std::ostream &out, const Options &options, RunResult &result)
+    {
+        out << std::fixed << std::setprecision(2);
+        out << "  clients connected       " << result.nConnected << " / " << options.nClients << "\n";
+        out << "  inputs received         " << result.nInputsReceived << "\n";
+        out << "  state updates received  " << result.nStatesReceived << "\n";
+        out << "  state latency ms        p50 " << Percentile(result.vecStateLatencyMs, 50) << ", p99 "
+            << Percentile(result.vecStateLatencyMs, 99) << ", max " << Percentile(result.vecStateLatencyMs, 100)
+            << "\n";
+        out << "  max send queue ms       " << result.usecMaxQueueTime / 1000.0 << "\n";
+        out << "  max pending reliable    " << result.cbMaxPendingReliable << " bytes\n";
+        out << "  transport               " << result.stats.nMessagesSent << " sent, "
+            << result.stats.nMessagesDelivered << " delivered, " << result.stats.nMessagesDropped << " dropped, "
+            << result.stats.nRetransmits << " retransmits\n";
+        out << "  wall time               " << result.flWallSeconds << " s ("
+            << std::setprecision(0) << options.flSeconds / std::max(result.flWallSeconds, 1e-9)
+            << "x real time)\n";
+        out << "  digest                  " << std::hex << std::setw(16) << std::setfill('0') << result.nDigest
+            << std::dec << std::setfill(' ') << "\n";
+    }
+} // namespace
+
+int main(int argc, char **argv)
+{
+    Options options;
+    if (!ParseOptions(argc, argv, options))
+    {
+        PrintUsage();
+        return 1;
+    }
+
+    // Results go to the real stdout; the library's per-connection logging is discarded unless --verbose.
+    std::ostream out(std::cout.rdbuf());
+    NullBuffer nullBuffer;
+    if (!options.bVerbose)
+    {
+        std::cout.rdbuf(&nullBuffer);
+    }
+
+    out << "Simulation: seed " << options.nSeed << ", " << options.nClients << " clients, " << options.flSeconds
+        << " s, latency " << options.link.nLatencyMs << " ms, jitter " << options.link.nJitterMs << " ms, loss "
+        << options.link.flLossPercent << "%, bandwidth "
+        << (options.link.nBandwidthBytesPerSec ? std::to_string(options.link.nBandwidthBytesPerSec) + " B/s"
+                                               : std::string("unlimited"))
+        << "\n\n";
+
+    int nExitCode = 0;
+    RunResult result = RunScenario(options);
+    PrintResult(out, options, result);
+    if (result.nConnected == 0)
+    {
+        std::cerr << "No client connected." << std::endl;
+        nExitCode = 1;
+    }
+
+    if (options.bVerify)
+    {
+        RunResult replay = RunScenario(options);
+        const bool bIdentical = replay.nDigest == result.nDigest;
+        out << "\nReplay: " << (bIdentical ? "identical" : "DIFFERENT") << " (digest " << std::hex
+            << std::setw(16) << std::setfill('0') << replay.nDigest << std::dec << std::setfill(' ') << ")\n";
+        if (!bIdentical)
+        {
+            nExitCode = 1;
+        }
+    }
+
+    std::cout.rdbuf(out.rdbuf());
+    return nExitCode;
+}
\ No newline at end of file
@@ -0,0 +1,216 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <list>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include <steam/steamnetworkingsockets.h>
+
+namespace QNET
+{
+    class Transport;
+
+    /// @brief Settings for connect-time authentication.
+    struct AuthConfig
+    {
+        /// @brief HMAC-SHA256 key used by the default token verifier.
+        std::string strSecret;
+
+        /// @brief Number of worker threads verifying tokens off the network thread.
+        uint32_t nWorkerThreads = 2;
+
+        /// @brief Maximum number of tokens a worker verifies per queue pass.
+        size_t nMaxBatchSize = 64;
+
+        /// @brief Maximum number of verdicts kept in the cache of recently verified tokens.
+        size_t nCacheCapacity = 65536;
+
+        /// @brief How long a cached verdict stays valid, in seconds. An accepted token is never cached past its
+        /// expiry.
+        uint32_t nCacheTtlSeconds = 300;
+
+        /// @brief How long a rejection is cached, in seconds; 0 to verify a rejected token again every time. Kept
+        /// short so that a token rejected while, e.g., a key was being rotated is not refused for the full TTL.
+        uint32_t nRejectCacheTtlSeconds = 5;
+
+        /// @brief Connections that have not authenticated within this time are closed, in milliseconds.
+        uint32_t nHandshakeTimeoutMs = 5000;
+    };
+
+    /// @brief What a verifier read from an accepted token.
+    struct AuthClaims
+    {
+        /// @brief Who the token authenticates, e.g. a user id; the payload of a CreateToken() token.
+        std::string strIdentity;
+
+        /// @brief When the token expires, in Unix seconds; 0 if it does not.
+        int64_t nExpiresAt = 0;
+    };
+
+    /// @brief Verifies one token and fills in its claims if it is accepted. Called on a worker thread; must be
+    /// thread-safe.
+    using TokenVerifier = std::function<bool(const std::string &strToken, AuthClaims &claims)>;
+
+    /// @brief Verdict for one submitted connection.
+    struct AuthResult
+    {
+        HSteamNetConnection hConn;
+        bool bAccepted;
+
+        /// @brief The identity of the accepted token, see AuthClaims.
+        std::string strIdentity;
+    };
+
+    /// @brief Counters describing the authenticator's work since construction.
+    struct AuthStats
+    {
+        uint64_t nSubmitted = 0;
+        uint64_t nCacheHits = 0;
+        uint64_t nVerified = 0;
+        uint64_t nRejected = 0;
+        uint64_t nBatches = 0;
+    };
+
+    /// @brief Verifies connect-time tokens on a worker pool, with a bounded cache of recent verdicts.
+    /// @details The network thread calls Submit() and DrainResults(); it never verifies a signature itself. A token
+    /// whose verdict is cached is answered immediately, so a restart storm of clients presenting tokens they used a
+    /// moment ago skips verification entirely. Uncached tokens are queued; each worker takes up to nMaxBatchSize of
+    /// them per pass, verifies every distinct token once, and publishes the verdicts with a single cache update and
+    /// a single result-queue update.
+    ///
+    /// Cache expiry is measured on the transport's clock, so it follows the virtual clock of a SimTransport. The
+    /// clock is only read on the network thread, by Submit() and DrainResults(); the workers use the time of the
+    /// last such call.
+    ///
+    /// The default verifier accepts unexpired tokens created by CreateToken():
+    /// "<payload>.<expiry>.<hex HMAC-SHA256(secret, "<payload>.<expiry>")>", where the expiry is in Unix seconds.
+    /// The payload becomes the identity of the connection.
+    class Authenticator
+    {
+    public:
+        /// @brief Close reason sent to clients whose token was rejected or never arrived.
+        static constexpr int kEndReasonAuthFailed = k_ESteamNetConnectionEnd_App_Min + 1;
+
+        /// @brief Starts the worker threads.
+        /// @param transport The transport whose clock cache expiry is measured on.
+        /// @param config The authentication settings.
+        /// @param verifier Custom verification (e.g. a public-key signature check); HMAC with config.strSecret if unset.
+        Authenticator(Transport &transport, const AuthConfig &config, TokenVerifier verifier = TokenVerifier());
+
+        /// @brief Stops and joins the worker threads. Pending submissions are dropped.
+        ~Authenticator();
+
+        // Prevent copying and assignment
+        Authenticator(const Authenticator &) = delete;
+        Authenticator &operator=(const Authenticator &) = delete;
+
+        /// @brief Queues a token for verification, or answers it from the cache.
+        /// @param hConn The connection presenting the token.
+        /// @param strToken The token.
+        void Submit(HSteamNetConnection hConn, std::string strToken);
+
+        /// @brief Moves all available verdicts into vecOut (appending).
+        /// @return The number of verdicts appended.
+        size_t DrainResults(std::vector<AuthResult> &vecOut);
+
+        /// @brief Returns a snapshot of the counters.
+        AuthStats GetStats() const;
+
+        /// @brief Returns the settings this authenticator was created with.
+        const AuthConfig &GetConfig() const { return m_config; }
+
+        /// @brief Creates a token accepted by the default verifier.
+        /// @param strSecret The shared HMAC key.
+        /// @param strPayload Application data to sign (e.g. a user id). Must not contain '.'.
+        /// @param nExpiresAt When the token stops being accepted, in Unix seconds (e.g. std::time(nullptr) + 3600).
+        static std::string CreateToken(const std::string &strSecret, const std::string &strPayload, int64_t nExpiresAt);
+
+        /// @brief Checks a token created by CreateToken(), in constant time with respect to the signature, and that
+        /// it has not expired.
+        /// @param claims Receives the payload as the identity, and the expiry, if the token is accepted.
+        static bool VerifyToken(const std::string &strSecret, const std::string &strToken, AuthClaims &claims);
+
+        /// @brief Returns HMAC-SHA256(strKey, data) (RFC 2104), as used by the default verifier.
+        static std::array<uint8_t, 32> HmacSha256(const std::string &strKey, const void *pData, size_t cbSize);
+
+    private:
+        /// @brief A queued verification request.
+        struct Job
+        {
+            HSteamNetConnection hConn;
+            std::string strToken;
+        };
+
+        /// @brief A verdict and the identity of an accepted token.
+        struct Verdict
+        {
+            bool bAccepted;
+            std::string strIdentity;
+        };
+
+        /// @brief A cached verdict.
+        struct CacheEntry
+        {
+            Verdict verdict;
+            SteamNetworkingMicroseconds usecExpires;
+            std::list<std::string>::iterator itLru;
+        };
+
+        /// @brief Worker thread body: takes batches of jobs and verifies them.
+        void WorkerLoop();
+
+        /// @brief Returns how long a fresh verdict may be cached; 0 if it may not.
+        SteamNetworkingMicroseconds GetCacheTtl(bool bAccepted, const AuthClaims &claims) const;
+
+        /// @brief Looks up a verdict. Must be called with m_cacheMutex held.
+        bool LookupLocked(const std::string &strToken, SteamNetworkingMicroseconds usecNow, Verdict &verdict);
+
+        /// @brief Stores a verdict until usecExpires, evicting the least recently used one if full. Must be called
+        /// with m_cacheMutex held.
+        void InsertLocked(const std::string &strToken, const Verdict &verdict, SteamNetworkingMicroseconds usecExpires);
+
+        /// @brief Reads the transport clock and publishes it to the workers. Called on the network thread.
+        SteamNetworkingMicroseconds UpdateNow();
+
+    private:
+        Transport &m_transport;
+        AuthConfig m_config;
+        TokenVerifier m_verifier;
+
+        /// @brief The transport clock as of the last Submit() or DrainResults().
+        std::atomic<SteamNetworkingMicroseconds> m_usecNow{0};
+
+        /// @brief Pending verification requests.
+        std::mutex m_queueMutex;
+        std::condition_variable m_queueCondition;
+        std::deque<Job> m_dequeJobs;
+        bool m_bStopping = false;
+
+        /// @brief Verdicts waiting for DrainResults().
+        std::mutex m_resultMutex;
+        std::vector<AuthResult> m_vecResults;
+
+        /// @brief LRU cache of recent verdicts, keyed by token.
+        std::mutex m_cacheMutex;
+        std::unordered_map<std::string, CacheEntry> m_mapCache;
+        std::list<std::string> m_listLru;
+
+        /// @brief Counters.
+        std::atomic<uint64_t> m_nSubmitted{0};
+        std::atomic<uint64_t> m_nCacheHits{0};
+        std::atomic<uint64_t> m_nVerified{0};
+        std::atomic<uint64_t> m_nRejected{0};
+        std::atomic<uint64_t> m_nBatches{0};
+
+        std::vector<std::thread> m_vecWorkers;
+    };
+} // namespace QNET
\ No newline at end of file
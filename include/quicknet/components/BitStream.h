@@ -0,0 +1,228 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include <steam/steamnetworkingsockets.h>
+
+namespace QNET
+{
+    /// @brief Returns the number of bits needed to represent every value in [0, nRange].
+    int BitsRequired(uint64_t nRange);
+
+    /// @brief Packs values into a bit-granular little-endian stream.
+    /// @details Bits are accumulated in a 64-bit scratch word and written out a whole word at a time, so most writes
+    /// are a shift, an OR and a compare. The writer either owns a growable buffer or writes in place into a fixed
+    /// buffer such as the payload of a message returned by ConnectionManager::AllocateMessage(). Writing past the
+    /// end of a fixed buffer sets the overflow flag instead of writing out of bounds.
+    class BitWriter
+    {
+    public:
+        /// @brief Constructs a writer that owns a growable buffer.
+        BitWriter();
+
+        /// @brief Constructs a writer over a fixed external buffer.
+        /// @param pBuffer The buffer to write into. It must outlive the writer.
+        /// @param cbCapacity The size of the buffer in bytes.
+        BitWriter(void *pBuffer, size_t cbCapacity);
+
+        /// @brief Constructs a writer over the payload of a GNS message, sized by its m_cbSize.
+        /// @param pMsg A message obtained from ConnectionManager::AllocateMessage().
+        explicit BitWriter(ISteamNetworkingMessage *pMsg);
+
+        /// @brief Writes the low nBits bits of nValue.
+        /// @param nValue The value to write; bits above nBits are ignored.
+        /// @param nBits The number of bits to write, from 0 to 64.
+        inline void WriteBits(uint64_t nValue, int nBits)
+        {
+            if (nBits <= 0)
+                return;
+            if (nBits < 64)
+                nValue &= (uint64_t(1) << nBits) - 1;
+
+            m_nScratch |= nValue << m_nScratchBits;
+            if (m_nScratchBits + nBits >= 64)
+            {
+                FlushWord();
+                const int nConsumed = 64 - m_nScratchBits;
+                m_nScratch = nConsumed < 64 ? nValue >> nConsumed : 0;
+                m_nScratchBits = m_nScratchBits + nBits - 64;
+            }
+            else
+            {
+                m_nScratchBits += nBits;
+            }
+        }
+
+        /// @brief Writes a single bit.
+        void WriteBool(bool bValue) { WriteBits(bValue ? 1 : 0, 1); }
+
+        /// @brief Writes an integer known to lie in [nMin, nMax] using only BitsRequired(nMax - nMin) bits.
+        /// Values outside the range are clamped.
+        void WriteRangedInt(int64_t nValue, int64_t nMin, int64_t nMax);
+
+        /// @brief Writes a float quantized to a fixed precision inside [flMin, flMax].
+        /// @param flValue The value to write; it is clamped to the range.
+        /// @param flMin The lower bound of the range.
+        /// @param flMax The upper bound of the range.
+        /// @param flPrecision The size of one quantization step (e.g. 0.01f for centimetres).
+        void WriteQuantizedFloat(float flValue, float flMin, float flMax, float flPrecision);
+
+        /// @brief Writes a full-precision 32-bit float.
+        void WriteFloat(float flValue);
+
+        /// @brief Writes an unsigned integer as a varint: 7 bits per group plus a continuation bit.
+        void WriteVarUInt(uint64_t nValue);
+
+        /// @brief Writes a signed integer as a zig-zag encoded varint, so small negative values stay small.
+        void WriteVarInt(int64_t nValue);
+
+        /// @brief Aligns to the next byte boundary and writes raw bytes.
+        void WriteBytes(const void *pData, size_t cbSize);
+
+        /// @brief Pads with zero bits up to the next byte boundary.
+        void AlignToByte();
+
+        /// @brief Writes out any buffered bits. Must be called before the data is read or sent.
+        /// @return The number of bytes used.
+        size_t Finish();
+
+        /// @brief Returns the number of bits written so far.
+        size_t GetBitsWritten() const { return m_cbOffset * 8 + m_nScratchBits; }
+
+        /// @brief Returns the number of bytes needed for the bits written so far.
+        size_t GetBytesWritten() const { return (GetBitsWritten() + 7) / 8; }
+
+        /// @brief Returns true if a write did not fit into a fixed buffer. The contents are then incomplete.
+        bool IsOverflowed() const { return m_bOverflowed; }
+
+        /// @brief Returns the start of the written data. Call Finish() first.
+        const uint8_t *GetData() const { return m_pBuffer; }
+
+        /// @brief Finishes the stream and returns a copy of the written bytes, for the std::vector send functions.
+        std::vector<uint8_t> ToVector();
+
+    private:
+        /// @brief Writes the full scratch word to the buffer and advances by eight bytes.
+        void FlushWord();
+
+        /// @brief Makes room for cbBytes more bytes. Returns false (and sets the overflow flag) if that is impossible.
+        bool Reserve(size_t cbBytes);
+
+    private:
+        /// @brief Backing storage when the writer owns its buffer.
+        std::vector<uint8_t> m_vecOwned;
+
+        /// @brief The buffer being written, either m_vecOwned.data() or an external buffer.
+        uint8_t *m_pBuffer = nullptr;
+
+        /// @brief The size of m_pBuffer in bytes.
+        size_t m_cbCapacity = 0;
+
+        /// @brief Number of whole bytes already written to m_pBuffer.
+        size_t m_cbOffset = 0;
+
+        /// @brief Bits not yet written to the buffer, lowest bit first.
+        uint64_t m_nScratch = 0;
+
+        /// @brief Number of valid bits in m_nScratch, always below 64.
+        int m_nScratchBits = 0;
+
+        /// @brief True if the writer owns and may grow its buffer.
+        bool m_bOwnsBuffer = false;
+
+        /// @brief Set when a write did not fit.
+        bool m_bOverflowed = false;
+    };
+
+    /// @brief Reads values written by a BitWriter.
+    /// @details The reader loads up to 64 bits at a time into a scratch word. Reading past the end of the data sets
+    /// the overflow flag and returns zeros; callers check IsOverflowed() once after decoding a whole message.
+    class BitReader
+    {
+    public:
+        /// @brief Constructs a reader over a buffer. The buffer must outlive the reader.
+        BitReader(const void *pData, size_t cbSize);
+
+        /// @brief Constructs a reader over a received message, as passed to OnMessageReceived.
+        explicit BitReader(const std::vector<uint8_t> &byteMessage);
+
+        /// @brief Constructs a reader directly over the payload of a GNS message.
+        explicit BitReader(const ISteamNetworkingMessage *pMsg);
+
+        /// @brief Reads nBits bits (0 to 64).
+        inline uint64_t ReadBits(int nBits)
+        {
+            if (nBits <= 0)
+                return 0;
+
+            const uint64_t nMask = nBits < 64 ? (uint64_t(1) << nBits) - 1 : ~uint64_t(0);
+            if (nBits <= m_nScratchBits)
+            {
+                const uint64_t nValue = m_nScratch & nMask;
+                m_nScratch = nBits < 64 ? m_nScratch >> nBits : 0;
+                m_nScratchBits -= nBits;
+                return nValue;
+            }
+            return ReadBitsSlow(nBits, nMask);
+        }
+
+        /// @brief Reads a single bit.
+        bool ReadBool() { return ReadBits(1) != 0; }
+
+        /// @brief Reads an integer written with BitWriter::WriteRangedInt() and the same range.
+        int64_t ReadRangedInt(int64_t nMin, int64_t nMax);
+
+        /// @brief Reads a float written with BitWriter::WriteQuantizedFloat() and the same parameters.
+        float ReadQuantizedFloat(float flMin, float flMax, float flPrecision);
+
+        /// @brief Reads a full-precision 32-bit float.
+        float ReadFloat();
+
+        /// @brief Reads an unsigned varint.
+        uint64_t ReadVarUInt();
+
+        /// @brief Reads a zig-zag encoded signed varint.
+        int64_t ReadVarInt();
+
+        /// @brief Aligns to the next byte boundary and reads raw bytes.
+        /// @return False if fewer than cbSize bytes remain.
+        bool ReadBytes(void *pOut, size_t cbSize);
+
+        /// @brief Skips the padding bits up to the next byte boundary.
+        void AlignToByte();
+
+        /// @brief Returns the number of bits consumed so far.
+        size_t GetBitsRead() const { return m_cbOffset * 8 - m_nScratchBits; }
+
+        /// @brief Returns the number of unread bits, including the padding of the last byte.
+        size_t GetBitsRemaining() const { return m_cbSize * 8 - GetBitsRead(); }
+
+        /// @brief Returns true if a read went past the end of the data.
+        bool IsOverflowed() const { return m_bOverflowed; }
+
+    private:
+        /// @brief Refills the scratch word and completes a read that spans it.
+        uint64_t ReadBitsSlow(int nBits, uint64_t nMask);
+
+    private:
+        /// @brief The data being read.
+        const uint8_t *m_pData;
+
+        /// @brief The size of m_pData in bytes.
+        size_t m_cbSize;
+
+        /// @brief Number of bytes already loaded into the scratch word.
+        size_t m_cbOffset = 0;
+
+        /// @brief Loaded bits not yet consumed, lowest bit first.
+        uint64_t m_nScratch = 0;
+
+        /// @brief Number of valid bits in m_nScratch.
+        int m_nScratchBits = 0;
+
+        /// @brief Set when a read went past the end of the data.
+        bool m_bOverflowed = false;
+    };
+} // namespace QNET
\ No newline at end of file
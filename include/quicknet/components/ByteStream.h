@@ -0,0 +1,76 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace QNET
+{
+    /// @brief Appends the low cbSize bytes of nValue to a std::string or std::vector<uint8_t>, little-endian.
+    template <typename Buffer>
+    inline void AppendLittleEndian(Buffer &out, uint64_t nValue, int cbSize)
+    {
+        for (int i = 0; i < cbSize; ++i)
+        {
+            out.push_back(static_cast<typename Buffer::value_type>(uint8_t(nValue >> (8 * i))));
+        }
+    }
+
+    /// @brief Reads the little-endian integers and raw bytes of a binary format (flight recorder dumps, session
+    /// snapshots, publish batches) out of a buffer, failing instead of reading once it runs past the end.
+    /// @details The reader only refers to the buffer, which must outlive it. A failed read leaves the position
+    /// unchanged.
+    class ByteReader
+    {
+    public:
+        explicit ByteReader(const std::string &strData) : m_strData(strData) {}
+
+        size_t GetPos() const { return m_nPos; }
+        size_t GetRemaining() const { return m_strData.size() - m_nPos; }
+        bool AtEnd() const { return m_nPos >= m_strData.size(); }
+
+        /// @brief Reads a cbSize-byte integer into value, by default as wide as value.
+        template <typename T>
+        bool Read(T &value, int cbSize = int(sizeof(T)))
+        {
+            if (cbSize < 0 || cbSize > 8 || GetRemaining() < size_t(cbSize))
+                return false;
+
+            uint64_t nValue = 0;
+            for (int i = 0; i < cbSize; ++i)
+            {
+                nValue |= uint64_t(uint8_t(m_strData[m_nPos + i])) << (8 * i);
+            }
+            value = T(nValue);
+            m_nPos += cbSize;
+            return true;
+        }
+
+        /// @brief Copies the next cbSize bytes into strValue.
+        bool ReadString(std::string &strValue, size_t cbSize)
+        {
+            if (GetRemaining() < cbSize)
+                return false;
+
+            strValue.assign(m_strData, m_nPos, cbSize);
+            m_nPos += cbSize;
+            return true;
+        }
+
+        /// @brief Steps over the next cbSize bytes.
+        /// @return The skipped bytes, which stay in the buffer, or nullptr if fewer than cbSize remain.
+        const char *Skip(size_t cbSize)
+        {
+            if (GetRemaining() < cbSize)
+                return nullptr;
+
+            const char *pData = m_strData.data() + m_nPos;
+            m_nPos += cbSize;
+            return pData;
+        }
+
+    private:
+        const std::string &m_strData;
+        size_t m_nPos = 0;
+    };
+} // namespace QNET
\ No newline at end of file
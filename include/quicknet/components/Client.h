@@ -13,6 +13,9 @@ namespace QNET
     class Client : public ConnectionManager
     {
     public:
+        /// @brief Uses GameNetworkingSockets, or a caller-owned Transport such as a SimTransport.
+        using ConnectionManager::ConnectionManager;
+
         /// @brief Attempts to connect to a server at the specified address.
         /// @param strServerAddress The IP address and port of the server (e.g., "127.0.0.1:27020").
         /// @return True if the connection attempt was initiated successfully, false otherwise.
@@ -23,35 +26,82 @@ namespace QNET
 
         /// @brief Sends a reliable message to the connected server.
         /// @param byteMessage The message content to send.
-        void SendReliableMessageToServer(const std::vector<uint8_t> &byteMessage);
+        /// @return The message number assigned by GNS, or 0 if the message could not be sent.
+        int64 SendReliableMessageToServer(const std::vector<uint8_t> &byteMessage);
 
         /// @brief Sends an unreliable message to the connected server.
         /// @param byteMessage The message content to send.
-        void SendUnreliableMessageToServer(const std::vector<uint8_t> &byteMessage);
+        /// @return The message number assigned by GNS, or 0 if the message could not be sent.
+        int64 SendUnreliableMessageToServer(const std::vector<uint8_t> &byteMessage);
+
+        /// @brief Enables or disables delivery receipts (OnDeliveryReceipt) for the connection to the server.
+        /// Call after Connect(); the setting does not carry over to a later connection.
+        /// @param bEnable True to enable receipts, false to disable them.
+        void EnableServerDeliveryReceipts(bool bEnable = true);
 
         /// @brief Receives pending messages from the server.
-        /// Calls the OnMessageReceived callback for each message.
+        /// Calls the OnMessageReceived callback for each message, until none are left or the receive budget runs out
+        /// (see SetReceiveBudget()).
         void ReceiveMessages();
 
+        /// @brief Receives like ReceiveMessages(), but hands up to nMaxMessages messages to the caller instead of
+        /// invoking OnMessageReceived. Empty messages are consumed and not returned. The caller owns the returned
+        /// messages, whose m_pData and m_cbSize are the payload, and must Release() each of them.
+        /// @param ppOutMessages Receives up to nMaxMessages messages.
+        /// @param nMaxMessages The size of ppOutMessages.
+        /// @return The number of messages stored in ppOutMessages.
+        int ReceiveBatch(ISteamNetworkingMessage **ppOutMessages, int nMaxMessages);
+
         /// @brief Checks if the client is currently connected to a server.
         /// @return True if connected, false otherwise.
         bool IsConnected() const;
 
+        /// @brief Returns the handle of the connection to the server, for the per-connection ConnectionManager
+        /// functions (lanes, status, delivery receipts). k_HSteamNetConnection_Invalid if not connected.
+        HSteamNetConnection GetConnection() const { return m_hConnection; }
+
+        /// @brief Sets a token that is sent as the first (reliable) message once the connection is established,
+        /// for servers that call Server::EnableAuthentication(). Call before Connect().
+        /// @param strToken The token, e.g. from Authenticator::CreateToken().
+        void SetAuthToken(const std::string &strToken);
+
     public:
         /// @brief Callback function invoked when a message is received from the server.
         /// Assign a function to this member to handle incoming messages.
         /// The function should take a const std::string& (the message content) as a parameter.
         std::function<void(const std::vector<uint8_t> &)> OnMessageReceived;
 
+        /// @brief Callback function invoked once the connection to the server has been established.
+        std::function<void()> OnConnected;
+
+        /// @brief Callback function invoked when the connection was closed by the server or lost.
+        /// Not invoked for Disconnect(), nor when the server hands the client off.
+        std::function<void()> OnDisconnected;
+
+        /// @brief Callback function invoked when the server handed the client off to another process (see
+        /// SessionHandoff), with the address the client now connects to. The client resumes its session there
+        /// without invoking OnConnected again; if the new server does not resume it, OnDisconnected is invoked.
+        std::function<void(const std::string &)> OnHandoff;
+
     protected:
         /// @brief Handles connection status changes for the client.
         /// Overrides the base class method to manage client-specific connection states.
         /// @param pInfo Pointer to the SteamNetConnectionStatusChangedCallback_t structure.
         virtual void HandleConnectionStatusChanged(SteamNetConnectionStatusChangedCallback_t *pInfo) override;
 
+    private:
+        /// @brief Invokes OnMessageReceived for one batch of messages and releases them.
+        void DispatchMessages(HSteamNetConnection hConn, ISteamNetworkingMessage **ppMsgs, int nMsgs);
+
     private:
         /// @brief Handle to the current connection to the server.
         /// k_HSteamNetConnection_Invalid if not connected.
-        HSteamNetConnection m_hConnection;
+        HSteamNetConnection m_hConnection = k_HSteamNetConnection_Invalid;
+
+        /// @brief Token sent as the first message after connecting; empty if authentication is not used.
+        std::string m_strAuthToken;
+
+        /// @brief Token of the session to resume, sent in place of m_strAuthToken; set while following a handoff.
+        std::string m_strResumeToken;
     };
 } // namespace QNET
\ No newline at end of file
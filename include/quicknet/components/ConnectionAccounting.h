@@ -0,0 +1,93 @@
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+#include <steam/steamnetworkingsockets.h>
+
+namespace QNET
+{
+    /// @brief Resources one connection consumed on the network thread over the accounting window.
+    struct ConnectionUsage
+    {
+        HSteamNetConnection hConn = k_HSteamNetConnection_Invalid;
+
+        /// @brief Time spent receiving and dispatching the connection's messages (including OnMessageReceived).
+        uint64_t usecTime = 0;
+
+        /// @brief Payload bytes and messages received.
+        uint64_t cbBytes = 0;
+        uint64_t nMessages = 0;
+    };
+
+    /// @brief Attributes receive and dispatch time, bytes and messages to connections over a sliding window.
+    /// @details Each connection keeps a small ring of time buckets, so recording is a hash lookup and a few additions
+    /// and the window slides without any per-message history. Connections that have been idle for a whole window are
+    /// swept once per bucket period, so churn does not grow the table. Record() and GetTop() may be called from
+    /// different threads.
+    class ConnectionAccounting
+    {
+    public:
+        using Clock = std::chrono::steady_clock;
+
+        /// @brief What GetTop() ranks connections by.
+        enum class SortBy
+        {
+            Time,
+            Bytes,
+            Messages
+        };
+
+        /// @param nWindowSeconds Length of the sliding window.
+        explicit ConnectionAccounting(uint32_t nWindowSeconds = 10);
+
+        /// @brief Adds one receive pass of a connection.
+        /// @param hConn The connection.
+        /// @param tStart When the pass started.
+        /// @param tEnd When the pass (including dispatch) ended.
+        /// @param cbBytes Payload bytes received in the pass.
+        /// @param nMessages Messages received in the pass.
+        void Record(HSteamNetConnection hConn, Clock::time_point tStart, Clock::time_point tEnd, uint64_t cbBytes,
+                    uint64_t nMessages);
+
+        /// @brief Returns up to nCount connections with the highest usage over the window, heaviest first.
+        std::vector<ConnectionUsage> GetTop(size_t nCount, SortBy eSortBy = SortBy::Time) const;
+
+        /// @brief Returns the usage of one connection over the window (all zero if unknown).
+        ConnectionUsage GetUsage(HSteamNetConnection hConn) const;
+
+    private:
+        static constexpr size_t kBucketCount = 10;
+
+        struct Bucket
+        {
+            int64_t nEpoch = -1;
+            uint64_t usecTime = 0;
+            uint64_t cbBytes = 0;
+            uint64_t nMessages = 0;
+        };
+
+        struct Entry
+        {
+            std::array<Bucket, kBucketCount> buckets;
+            int64_t nLastEpoch = -1;
+        };
+
+        /// @brief Index of the bucket period containing t.
+        int64_t EpochOf(Clock::time_point t) const;
+
+        /// @brief Sums the buckets of an entry that are still inside the window ending at nEpochNow.
+        ConnectionUsage Sum(HSteamNetConnection hConn, const Entry &entry, int64_t nEpochNow) const;
+
+    private:
+        const Clock::duration m_bucketPeriod;
+
+        mutable std::mutex m_mutex;
+        std::unordered_map<HSteamNetConnection, Entry> m_mapEntries;
+        int64_t m_nLastSweepEpoch = -1;
+    };
+} // namespace QNET
\ No newline at end of file
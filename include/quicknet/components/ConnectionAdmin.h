@@ -0,0 +1,162 @@
+#pragma once
+
+#include "quicknet/components/HttpServer.h"
+#include "quicknet/components/Json.h"
+#include "quicknet/components/MpscQueue.h"
+#include "quicknet/components/Server.h"
+
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace QNET
+{
+    /// @brief Settings for a ConnectionAdmin.
+    struct ConnectionAdminConfig
+    {
+        /// @brief Path prefix of the admin routes.
+        std::string strPrefix = "/admin";
+
+        /// @brief If set, requests must carry "Authorization: Bearer <token>". Without it, anyone who can reach the
+        /// HTTP server can list, throttle and close connections.
+        std::string strBearerToken;
+
+        /// @brief Least time between two snapshots. Taking one reads the status of every connection, so this bounds
+        /// the cost on the network thread.
+        uint32 nSnapshotIntervalMs = 250;
+
+        /// @brief Largest page the list route returns.
+        uint32 nMaxPageSize = 1000;
+    };
+
+    /// @brief One connection as of the last snapshot.
+    struct ConnectionSnapshot
+    {
+        HSteamNetConnection hConn = k_HSteamNetConnection_Invalid;
+        std::string strDescription;
+
+        /// @brief False while the connection is still authenticating.
+        bool bClient = false;
+
+        ESteamNetworkingConnectionState eState = k_ESteamNetworkingConnectionState_None;
+        SteamNetworkingMicroseconds usecAge = 0;
+        int nPingMs = -1;
+
+        /// @brief Fraction of packets delivered, as seen by us and by the peer; negative if unknown.
+        float flQualityLocal = -1.0f;
+        float flQualityRemote = -1.0f;
+
+        float flInBytesPerSec = 0.0f;
+        float flOutBytesPerSec = 0.0f;
+
+        /// @brief The send queue: bytes waiting to go out, reliable bytes sent but unacknowledged, and how long a
+        /// message sent now would wait.
+        int cbPendingReliable = 0;
+        int cbPendingUnreliable = 0;
+        int cbSentUnackedReliable = 0;
+        SteamNetworkingMicroseconds usecQueueTime = 0;
+
+        uint64 cbReceived = 0;
+        uint64 nMessagesReceived = 0;
+
+        /// @brief The cap set with Server::ThrottleConnection(), or 0.
+        uint32 nThrottle = 0;
+    };
+
+    /// @brief Serves an admin view of a Server's connections over an HttpServer, and lets operators act on them.
+    /// @details Registers these routes on an HttpServer (with the default prefix):
+    ///   - GET  /admin/connections                  a page of connections, as JSON
+    ///   - GET  /admin/connections/:id              one connection
+    ///   - POST /admin/connections/:id/kick         disconnects it; "reason" is the debug text the peer sees
+    ///   - POST /admin/connections/:id/throttle     caps its messages per receive call to "limit" (0 removes the cap)
+    /// The list takes "offset", "limit", "sort" (id, age, ping, quality, queue, pending, in, out, bytes, messages)
+    /// and "order" (asc or desc) query parameters.
+    ///
+    /// The network thread publishes a snapshot of every connection from a Server tick handler, at most every
+    /// nSnapshotIntervalMs, and requests are answered from the latest one: sorting, paging and JSON happen on the
+    /// HTTP threads. Actions are queued for the network thread and applied on its next tick, so they are answered
+    /// with 202 and show in the snapshot after that.
+    ///
+    /// Create before HttpServer::Run() and Server::Run(), and destroy after both have returned.
+    class ConnectionAdmin
+    {
+    public:
+        /// @brief End reason of connections closed by the kick route.
+        static constexpr int kEndReasonKicked = k_ESteamNetConnectionEnd_App_Min + 2;
+
+        /// @param server The server whose connections are shown.
+        /// @param http The HTTP server to register the routes on.
+        /// @param config The route prefix, authorization and snapshot interval.
+        ConnectionAdmin(Server &server, HttpServer &http,
+                        const ConnectionAdminConfig &config = ConnectionAdminConfig());
+
+        /// @brief Unregisters the tick handler. Actions not applied yet are dropped.
+        ~ConnectionAdmin();
+
+        ConnectionAdmin(const ConnectionAdmin &) = delete;
+        ConnectionAdmin &operator=(const ConnectionAdmin &) = delete;
+
+        /// @brief Returns the connections as of the last snapshot, or null before the first one. May be called
+        /// from any thread.
+        std::shared_ptr<const std::vector<ConnectionSnapshot>> GetSnapshot() const;
+
+    private:
+        /// @brief An action queued for the network thread.
+        struct Action
+        {
+            enum class Type
+            {
+                Kick,
+                Throttle
+            };
+
+            Type eType = Type::Kick;
+            HSteamNetConnection hConn = k_HSteamNetConnection_Invalid;
+            uint32 nLimit = 0;
+            std::string strReason;
+        };
+
+        /// @brief The published state: the connections and when they were taken.
+        struct Snapshot
+        {
+            std::shared_ptr<const std::vector<ConnectionSnapshot>> pConnections;
+            std::chrono::steady_clock::time_point tTaken;
+        };
+
+        void HandleList(const Request &req, Response &res);
+        void HandleGet(const Request &req, Response &res);
+        void HandleAction(const Request &req, Response &res, Action::Type eType);
+
+        /// @brief Applies the queued actions and takes a snapshot if it is due. Runs on the network thread.
+        void Tick();
+
+        /// @brief Builds a snapshot of every connection. Runs on the network thread.
+        void TakeSnapshot();
+
+        /// @brief Returns the published state.
+        Snapshot LoadSnapshot() const;
+
+        /// @brief Parses a connection handle from a route parameter; returns k_HSteamNetConnection_Invalid if it is
+        /// not one.
+        static HSteamNetConnection ParseConnection(const std::string &strId);
+
+        /// @brief Writes one connection as a JSON object.
+        static void WriteConnection(JsonWriter &writer, const ConnectionSnapshot &conn);
+
+    private:
+        Server &m_server;
+        const ConnectionAdminConfig m_config;
+        uint32 m_nTickHandlerId = 0;
+
+        MpscQueue<Action> m_queueActions;
+
+        /// @brief When the network thread last took a snapshot; only touched by the network thread.
+        std::chrono::steady_clock::time_point m_tLastSnapshot;
+
+        /// @brief The latest snapshot. The lock is held only to copy or replace the pointer.
+        mutable std::mutex m_snapshotMutex;
+        Snapshot m_snapshot;
+    };
+} // namespace QNET
\ No newline at end of file
@@ -1,6 +1,16 @@
 #pragma once
 
+#include "quicknet/components/MessageAccounting.h"
+#include "quicknet/components/ReceiveScheduler.h"
+#include "quicknet/components/Transport.h"
+#include "quicknet/components/Watchdog.h"
+
+#include <deque>
 #include <functional>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <utility>
 #include <vector>
 
 #include <steam/steamnetworkingsockets.h>
@@ -14,11 +24,17 @@ namespace QNET
     {
     public:
         /// @brief Constructor for ConnectionManager.
-        /// Initializes the SteamNetworkingSockets library and acquires the interface.
+        /// Initializes the SteamNetworkingSockets library (once per process) and acquires the interface.
         ConnectionManager();
 
+        /// @brief Constructor for ConnectionManager over a caller-owned transport, e.g. a SimTransport.
+        /// The GameNetworkingSockets library is not initialized; the transport must outlive this instance.
+        /// @param transport The transport every network call goes through.
+        explicit ConnectionManager(Transport &transport);
+
         /// @brief Virtual destructor for ConnectionManager.
-        /// Ensures proper cleanup of network resources, including shutting down the SteamNetworkingSockets library.
+        /// Ensures proper cleanup of network resources, including shutting down the SteamNetworkingSockets library
+        /// when the last instance in the process is destroyed.
         virtual ~ConnectionManager();
 
         /// @brief Polls for network events.
@@ -28,12 +44,101 @@ namespace QNET
         /// @brief Sends a Reliable message to a specific connection. (Guarantees delivery and order)
         /// @param hConn The connection handle.
         /// @param byteMessage The message content to send.
-        void SendReliableMessage(HSteamNetConnection hConn, const std::vector<uint8_t> &byteMessage);
+        /// @return The message number assigned by GNS, or 0 if the message could not be sent.
+        int64 SendReliableMessage(HSteamNetConnection hConn, const std::vector<uint8_t> &byteMessage);
 
         /// @brief Sends an Unreliable message to a specific connection. (Faster than reliable, no guarantees on delivery)
         /// @param hConn The connection handle.
         /// @param byteMessage The message content to send.
-        void SendUnreliableMessage(HSteamNetConnection hConn, const std::vector<uint8_t> &byteMessage);
+        /// @return The message number assigned by GNS, or 0 if the message could not be sent.
+        int64 SendUnreliableMessage(HSteamNetConnection hConn, const std::vector<uint8_t> &byteMessage);
+
+        /// @brief Allocates a GNS message whose payload can be filled in place (e.g. with a BitWriter) and then
+        /// handed to SendAllocatedMessage() without an intermediate copy.
+        /// @param cbCapacity The payload size to allocate, in bytes.
+        /// @return The message, or nullptr if the network interface is not available.
+        ISteamNetworkingMessage *AllocateMessage(uint32 cbCapacity);
+
+        /// @brief Sends a message obtained from AllocateMessage(). Ownership passes to GNS, even on failure.
+        /// @param hConn The connection handle.
+        /// @param pMsg The message to send.
+        /// @param cbSize The number of payload bytes actually used (at most the allocated capacity).
+        /// @param nSendFlags The k_nSteamNetworkingSend_* flags, e.g. k_nSteamNetworkingSend_Reliable.
+        /// @param nLane The lane to send on (see ConfigureLanes()); lane 0 if the connection has no lanes.
+        /// @return The message number assigned by GNS, or 0 if the message could not be sent.
+        int64 SendAllocatedMessage(HSteamNetConnection hConn, ISteamNetworkingMessage *pMsg, uint32 cbSize,
+                                   int nSendFlags, uint16 nLane = 0);
+
+        /// @brief Splits a connection's outgoing traffic into lanes that are scheduled independently.
+        /// @details Lanes with a lower priority value are always serviced first; lanes of equal priority share the
+        /// bandwidth in proportion to their weights. Messages are put on a lane with SendAllocatedMessage().
+        /// Delivery receipts assume in-order acknowledgement and are only exact on connections with a single lane.
+        /// @param hConn The connection handle.
+        /// @param vecPriorities The priority of each lane; its size is the number of lanes.
+        /// @param vecWeights The weight of each lane, or empty for equal weights.
+        /// @return True on success, false if the arguments are invalid or GNS rejected the configuration.
+        bool ConfigureLanes(HSteamNetConnection hConn, const std::vector<int> &vecPriorities,
+                            const std::vector<uint16> &vecWeights = {});
+
+        /// @brief Reads a connection's current ping, quality, throughput and send queue sizes.
+        /// @param hConn The connection handle.
+        /// @param status Receives the status.
+        /// @return True on success, false if the connection is unknown.
+        bool GetRealTimeStatus(HSteamNetConnection hConn, SteamNetConnectionRealTimeStatus_t &status);
+
+        /// @brief Returns the current time on the transport's clock, which connection timestamps are measured on.
+        /// @return The time in microseconds, or 0 if the network interface is not available.
+        SteamNetworkingMicroseconds GetLocalTimestamp() const
+        {
+            return m_pInterface ? m_pInterface->GetLocalTimestamp() : 0;
+        }
+
+        /// @brief Opts a connection in to (or out of) delivery receipts for its reliable messages.
+        /// @details While enabled, OnDeliveryReceipt fires from Poll() whenever the peer has acknowledged more of
+        /// the reliable messages sent on the connection. Acknowledgement is derived from the reliable bytes that GNS
+        /// still reports as pending or unacknowledged; because those counts include framing overhead, a receipt can
+        /// lag slightly behind the real acknowledgement but never precedes it.
+        /// @param hConn The connection handle.
+        /// @param bEnable True to enable receipts, false to disable them and drop the tracked state.
+        void EnableDeliveryReceipts(HSteamNetConnection hConn, bool bEnable = true);
+
+        /// @brief Opts this manager's poll loop in to stall detection by a Watchdog.
+        /// @details Poll() heartbeats and every OnMessageReceived call is bracketed as a callback, so a handler that
+        /// blocks the loop is reported with its connection and message type. Call from the thread that runs the loop.
+        /// @param pWatchdog The watchdog, or nullptr to stop being watched.
+        /// @param strName The name reported in StallReport::strLoop.
+        /// @param extractor Reads the message type from a payload for the report; types are reported as -1 if unset.
+        void SetWatchdog(Watchdog *pWatchdog, const std::string &strName,
+                         MessageTypeExtractor extractor = MessageTypeExtractor());
+
+        /// @brief Starts attributing the messages, bytes and message sizes this manager sends and receives to
+        /// message types, for finding out which messages use the bandwidth.
+        /// @details Every message sent through this manager and every message its ReceiveMessages() takes from the
+        /// transport is counted, including those of connections still authenticating. Counting costs the extractor
+        /// call and three increments per message. Call before the loop runs.
+        /// @param extractor Reads the message type from a payload; the first byte is the type if unset.
+        /// @param nMaxTypes Types counted separately, from 0 to nMaxTypes - 1; others are counted as -1.
+        /// @return The accounting, e.g. for MessageAccounting::ServeMetrics().
+        MessageAccounting &EnableMessageAccounting(MessageTypeExtractor extractor = MessageTypeExtractor(),
+                                                   uint32 nMaxTypes = 256);
+
+        /// @brief Returns the accounting set up by EnableMessageAccounting(), or nullptr.
+        MessageAccounting *GetMessageAccounting() const { return m_pMessageAccounting.get(); }
+
+        /// @brief Limits how much one ReceiveMessages() call dispatches. By default every connection is drained.
+        /// @details Connections are served in weighted round-robin batches of ReceiveBudget::nQuantum messages, so a
+        /// budget bounds the loop's tick time without letting one chatty connection starve the others.
+        /// @param budget The message and time budget per call.
+        void SetReceiveBudget(const ReceiveBudget &budget) { m_receiveScheduler.SetBudget(budget); }
+
+        /// @brief Returns what the last ReceiveMessages() call dispatched and how many connections it left with a
+        /// backlog.
+        const ReceiveStats &GetLastReceiveStats() const { return m_receiveScheduler.GetLastStats(); }
+
+    public:
+        /// @brief Callback function invoked when the peer has acknowledged every reliable message on a connection up
+        /// to and including the given message number (as returned by SendReliableMessage()).
+        std::function<void(HSteamNetConnection, int64)> OnDeliveryReceipt;
 
     protected:
         /// @brief Pure virtual function to handle connection status changes.
@@ -47,10 +152,68 @@ namespace QNET
         /// @param pInfo Pointer to the SteamNetConnectionStatusChangedCallback_t structure.
         static void OnGlobalConnectionStatusChanged(SteamNetConnectionStatusChangedCallback_t *pInfo);
 
+        /// @brief Returns the monitor set by SetWatchdog(), or nullptr if the loop is not watched.
+        LoopMonitor *GetLoopMonitor() const { return m_pLoopMonitor.get(); }
+
+        /// @brief Returns the message type of a payload for the watchdog, or -1 if the loop is not watched or has
+        /// no MessageTypeExtractor.
+        int32 GetMessageType(const void *pData, uint32 cbSize) const;
+
+        /// @brief Counts a sent or received message for EnableMessageAccounting(); does nothing if accounting is not
+        /// enabled.
+        void AccountSent(const void *pData, uint32 cbSize)
+        {
+            if (m_pMessageAccounting)
+            {
+                m_pMessageAccounting->RecordSent(pData, cbSize);
+            }
+        }
+
+        void AccountReceived(const void *pData, uint32 cbSize)
+        {
+            if (m_pMessageAccounting)
+            {
+                m_pMessageAccounting->RecordReceived(pData, cbSize);
+            }
+        }
+
     protected:
-        /// @brief Pointer to the ISteamNetworkingSockets interface.
-        ISteamNetworkingSockets *m_pInterface;
+        /// @brief Pointer to the transport: a SteamTransport over ISteamNetworkingSockets, or the caller's.
+        Transport *m_pInterface;
+
+        /// @brief Schedules the receive passes of ReceiveMessages().
+        ReceiveScheduler m_receiveScheduler;
 
     private:
+        /// @brief Reliable messages in flight on a connection with delivery receipts enabled.
+        struct ReceiptTracker
+        {
+            /// @brief Total reliable payload bytes sent on the connection since receipts were enabled.
+            uint64 nBytesSent = 0;
+
+            /// @brief Message number and the value of nBytesSent right after it, oldest first.
+            std::deque<std::pair<int64, uint64>> dequeInFlight;
+        };
+
+        /// @brief Records a reliable message for delivery receipts, if the connection has them enabled.
+        void TrackReliableMessage(HSteamNetConnection hConn, int64 nMessageNumber, uint32 cbSize);
+
+        /// @brief Compares the bytes still outstanding on every tracked connection with the bytes sent and fires
+        /// OnDeliveryReceipt for newly acknowledged messages. Called from Poll().
+        void UpdateDeliveryReceipts();
+
+    private:
+        /// @brief The SteamTransport created by the default constructor; null for a caller-owned transport.
+        std::unique_ptr<Transport> m_pOwnedTransport;
+
+        /// @brief Delivery receipt state, by connection.
+        std::unordered_map<HSteamNetConnection, ReceiptTracker> m_mapReceiptTrackers;
+
+        /// @brief Stall detection state, set by SetWatchdog().
+        std::shared_ptr<LoopMonitor> m_pLoopMonitor;
+        MessageTypeExtractor m_messageTypeExtractor;
+
+        /// @brief Per-message-type traffic, set by EnableMessageAccounting().
+        std::unique_ptr<MessageAccounting> m_pMessageAccounting;
     };
 } // namespace QNET
\ No newline at end of file
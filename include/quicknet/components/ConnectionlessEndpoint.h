@@ -0,0 +1,110 @@
+#pragma once
+
+#include "quicknet/components/ConnectionManager.h"
+
+#include <functional>
+#include <string>
+#include <vector>
+
+#include <steam/steamnetworkingsockets.h>
+
+class ISteamNetworkingMessages;
+struct SteamNetworkingMessagesSessionRequest_t;
+struct SteamNetworkingMessagesSessionFailed_t;
+
+namespace QNET
+{
+    /// @brief Sends and receives messages without explicit connections, using GNS's ISteamNetworkingMessages.
+    /// @details Peers are addressed by SteamNetworkingIdentity. GNS creates a session the first time a peer is
+    /// messaged (or messages us) and times it out automatically once it has been idle for a while, so the endpoint
+    /// keeps no per-peer state of its own: no accept step, no client list and no registry slot. This suits telemetry
+    /// beacons and sporadic peers, where the cost of a full Server connection per peer is wasted.
+    ///
+    /// ISteamNetworkingMessages is a process-wide singleton, so at most one ConnectionlessEndpoint may be
+    /// initialized at a time. Call Poll() and ReceiveMessages() regularly, exactly as for a Server.
+    class ConnectionlessEndpoint : public ConnectionManager
+    {
+    public:
+        /// @brief Constructs an endpoint. Call Initialize() before sending or receiving.
+        ConnectionlessEndpoint();
+
+        /// @brief Destructor. Unregisters the session callbacks if this endpoint registered them.
+        ~ConnectionlessEndpoint() override;
+
+        /// @brief Acquires the ISteamNetworkingMessages interface and registers the session callbacks.
+        /// @return True on success, false if the interface is unavailable or another endpoint is already active.
+        bool Initialize();
+
+        /// @brief Adds a local channel to drain in ReceiveMessages(). Channel 0 is listened on by default.
+        /// @param nChannel The local channel number.
+        void ListenOnChannel(int nChannel);
+
+        /// @brief Sends a reliable message to a peer, creating a session if needed.
+        /// @param identityRemote The peer's identity.
+        /// @param byteMessage The message content to send.
+        /// @param nChannel The remote channel to deliver to.
+        /// @return True if the message was queued, false otherwise.
+        bool SendReliableMessageToPeer(const SteamNetworkingIdentity &identityRemote,
+                                       const std::vector<uint8_t> &byteMessage, int nChannel = 0);
+
+        /// @brief Sends an unreliable message to a peer, creating a session if needed.
+        /// @param identityRemote The peer's identity.
+        /// @param byteMessage The message content to send.
+        /// @param nChannel The remote channel to deliver to.
+        /// @return True if the message was queued, false otherwise.
+        bool SendUnreliableMessageToPeer(const SteamNetworkingIdentity &identityRemote,
+                                         const std::vector<uint8_t> &byteMessage, int nChannel = 0);
+
+        /// @brief Sends a message to a peer identified by an IP address and port (e.g. "10.0.0.5:27021").
+        /// @param strAddress The peer's address.
+        /// @param byteMessage The message content to send.
+        /// @param bReliable True to send reliably, false to send unreliably.
+        /// @param nChannel The remote channel to deliver to.
+        /// @return True if the address was valid and the message was queued, false otherwise.
+        bool SendMessageToAddress(const std::string &strAddress, const std::vector<uint8_t> &byteMessage,
+                                  bool bReliable, int nChannel = 0);
+
+        /// @brief Receives pending messages on every listened channel and invokes OnMessageReceived for each.
+        void ReceiveMessages();
+
+        /// @brief Closes the session with a peer right away instead of waiting for it to time out.
+        /// @param identityRemote The peer's identity.
+        void CloseSession(const SteamNetworkingIdentity &identityRemote);
+
+    public:
+        /// @brief Callback function invoked when a message is received from a peer.
+        /// The parameters are the sender's identity, the local channel and the message content.
+        std::function<void(const SteamNetworkingIdentity &, int, const std::vector<uint8_t> &)> OnMessageReceived;
+
+        /// @brief Optional filter invoked when an unknown peer opens a session. Return false to reject it.
+        /// If unset, every session request is accepted.
+        std::function<bool(const SteamNetworkingIdentity &)> OnSessionRequest;
+
+        /// @brief Callback function invoked when a session could not be established or failed.
+        /// The parameters are the peer's identity and the debug reason reported by GNS.
+        std::function<void(const SteamNetworkingIdentity &, const char *)> OnSessionFailed;
+
+    protected:
+        /// @brief Sessions have no connection status changes; this handler does nothing.
+        virtual void HandleConnectionStatusChanged(SteamNetConnectionStatusChangedCallback_t *pInfo) override;
+
+    private:
+        /// @brief Sends a message with the given GNS send flags.
+        bool SendToPeer(const SteamNetworkingIdentity &identityRemote, const std::vector<uint8_t> &byteMessage,
+                        int nSendFlags, int nChannel);
+
+        /// @brief Global GNS callbacks, dispatched to the active endpoint.
+        static void OnGlobalSessionRequest(SteamNetworkingMessagesSessionRequest_t *pInfo);
+        static void OnGlobalSessionFailed(SteamNetworkingMessagesSessionFailed_t *pInfo);
+
+    private:
+        /// @brief Pointer to the ISteamNetworkingMessages interface, nullptr until Initialize() succeeds.
+        ISteamNetworkingMessages *m_pMessages = nullptr;
+
+        /// @brief Local channels drained by ReceiveMessages().
+        std::vector<int> m_vecChannels;
+
+        /// @brief The endpoint that receives the global session callbacks.
+        static ConnectionlessEndpoint *s_pActiveEndpoint;
+    };
+} // namespace QNET
\ No newline at end of file
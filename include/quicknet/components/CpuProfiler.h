@@ -0,0 +1,75 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+
+namespace QNET
+{
+    /// @brief Settings of a CPU profile (see CpuProfiler::Start()).
+    struct CpuProfilerConfig
+    {
+        /// @brief Samples per second of CPU time consumed by the process, 1 to 1000. The default avoids running in
+        /// lockstep with timers that fire at round frequencies.
+        uint32_t nFrequencyHz = 99;
+
+        /// @brief Samples the buffer holds; later samples are counted as dropped. The buffer takes nMaxSamples *
+        /// nMaxDepth pointers and is allocated by Start().
+        uint32_t nMaxSamples = 100000;
+
+        /// @brief Deepest stack recorded; deeper stacks lose their outermost frames.
+        uint32_t nMaxDepth = 64;
+    };
+
+    /// @brief The result of a CPU profile.
+    struct CpuProfile
+    {
+        /// @brief One line per distinct stack, "outermost;...;innermost count", the input of flamegraph.pl and
+        /// speedscope. Frames are function names, or "module+0xoffset" for addresses without a symbol.
+        std::string strFolded;
+
+        /// @brief Samples recorded, samples lost to a full buffer, and how long the profile ran.
+        uint64_t nSamples = 0;
+        uint64_t nDropped = 0;
+        uint64_t usecDuration = 0;
+    };
+
+    /// @brief Names the function containing pAddress as profiles show it: the demangled symbol, "module+0xoffset"
+    /// for an address without one, or the bare address where symbols cannot be looked up. Functions of the
+    /// executable only have symbols when it is linked with -rdynamic.
+    std::string SymbolizeAddress(const void *pAddress);
+
+    /// @brief A sampling CPU profiler for the whole process, for when perf cannot be attached.
+    /// @details While running, a CPU-time timer (ITIMER_PROF) sends SIGPROF to whichever thread is on a CPU
+    /// nFrequencyHz times per second of process CPU time, and the signal handler records that thread's stack into a
+    /// buffer allocated by Start(). The handler only unwinds and writes into that buffer; symbols are resolved by
+    /// Stop(). When no profile runs the timer is off and no signal is sent, so the profiler costs nothing. The
+    /// handler stays installed after the first profile, ignoring signals, unless another one was installed before.
+    ///
+    /// Only one profile runs at a time in a process. Supported on Linux with glibc on x86-64, x86 and AArch64; stacks
+    /// are unwound by following frame pointers with WalkSignalStack(), since backtrace() is not async-signal-safe, so
+    /// the application should be compiled with -fno-omit-frame-pointer like the library. Functions of the executable
+    /// only get names when it is linked with -rdynamic. Blocking system calls may return EINTR while a profile runs,
+    /// as with any SIGPROF profiler.
+    class CpuProfiler
+    {
+    public:
+        /// @brief Returns true if profiles can be taken on this platform.
+        static bool IsSupported();
+
+        /// @brief Starts a profile.
+        /// @param pstrError If not null, receives the reason on failure.
+        /// @return False if unsupported, the config is invalid or a profile is already running.
+        static bool Start(const CpuProfilerConfig &config = CpuProfilerConfig(), std::string *pstrError = nullptr);
+
+        /// @brief Stops the profile and folds the recorded stacks.
+        /// @return False if no profile was running.
+        static bool Stop(CpuProfile &profile);
+
+        /// @brief Returns true while a profile runs.
+        static bool IsRunning();
+
+        /// @brief Runs a profile for nDurationMs, blocking the calling thread.
+        static bool Profile(uint32_t nDurationMs, CpuProfile &profile,
+                            const CpuProfilerConfig &config = CpuProfilerConfig(), std::string *pstrError = nullptr);
+    };
+} // namespace QNET
\ No newline at end of file
@@ -0,0 +1,191 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <steam/steamnetworkingsockets.h>
+
+namespace QNET
+{
+    /// @brief Settings for a FlightRecorder.
+    struct FlightRecorderConfig
+    {
+        /// @brief Ticks kept in the ring. Server::Run() ticks about 100 times per second, so the default holds the
+        /// last 30 seconds.
+        uint32 nCapacity = 3000;
+
+        /// @brief A tick slower than this triggers a dump; 0 to dump only on request.
+        uint32 nThresholdMicroseconds = 50000;
+
+        /// @brief Least time between two dumps, so a run of slow ticks produces one file.
+        uint32 nMinDumpIntervalMs = 10000;
+
+        /// @brief Where dumps are written, as <strDirectory>/<strFilePrefix>-<unix time ms>-<sequence>.qnfr.
+        std::string strDirectory = ".";
+        std::string strFilePrefix = "qnet_flight";
+    };
+
+    /// @brief One of the connections that cost the most in a tick.
+    struct FlightConnection
+    {
+        HSteamNetConnection hConn = k_HSteamNetConnection_Invalid;
+
+        /// @brief Receive and dispatch time, messages and payload bytes in the tick.
+        uint32 usecTime = 0;
+        uint32 nMessages = 0;
+        uint32 cbBytes = 0;
+
+        /// @brief Link status at the end of the tick: ping, send queue bytes and queue time.
+        int32 nPingMs = -1;
+        int32 cbPendingReliable = 0;
+        int32 cbPendingUnreliable = 0;
+        uint32 usecQueueTime = 0;
+    };
+
+    /// @brief Metrics of one Server tick (one ReceiveMessages() call).
+    struct FlightTick
+    {
+        static constexpr uint32 kMaxWorstConnections = 4;
+
+        /// @brief When the tick started, on the transport's clock.
+        SteamNetworkingMicroseconds usecTimestamp = 0;
+
+        /// @brief Wall time of the whole tick, and of dispatching messages within it.
+        uint32 usecDuration = 0;
+        uint32 usecDispatch = 0;
+
+        uint32 nMessages = 0;
+        uint64 cbBytes = 0;
+
+        uint32 nClients = 0;
+        uint32 nAuthenticating = 0;
+
+        /// @brief Receive queue depth, as far as GNS exposes it (see ReceiveStats).
+        uint32 nBacklogConnections = 0;
+        uint32 nThrottledConnections = 0;
+        bool bBudgetExhausted = false;
+
+        /// @brief The connections with the most dispatch time, heaviest first.
+        uint32 nWorstConnections = 0;
+        FlightConnection aWorstConnections[kMaxWorstConnections];
+    };
+
+    /// @brief The contents of a dump file.
+    struct FlightDump
+    {
+        /// @brief Why the dump was taken: "threshold" or the reason passed to RequestDump().
+        std::string strReason;
+
+        /// @brief The threshold in effect, and the timestamp of the tick that triggered the dump.
+        uint32 nThresholdMicroseconds = 0;
+        SteamNetworkingMicroseconds usecTrigger = 0;
+
+        /// @brief The ticks in the ring, oldest first; the last one is the trigger.
+        std::vector<FlightTick> vecTicks;
+    };
+
+    /// @brief Keeps the metrics of the last ticks of a Server in a fixed ring and dumps them to a file when a tick
+    /// is slow or when asked to.
+    /// @details The ring is allocated once and a tick is recorded by copying one fixed-size entry, so the recorder
+    /// can stay on in production. A dump copies the ring on the network thread and writes it from a thread of its
+    /// own, so the slow tick is not made slower by file I/O. Files are compact binary (see WriteDump()) and are
+    /// decoded by ReadDump() or the qnet_flightdump tool.
+    ///
+    /// BeginTick(), RecordBatch(), GetCurrentTick() and EndTick() are called by the Server on its network thread.
+    /// RequestDump() may be called from any thread.
+    class FlightRecorder
+    {
+    public:
+        explicit FlightRecorder(const FlightRecorderConfig &config = FlightRecorderConfig());
+
+        /// @brief Writes the dumps that are still queued, then stops the writer thread.
+        ~FlightRecorder();
+
+        FlightRecorder(const FlightRecorder &) = delete;
+        FlightRecorder &operator=(const FlightRecorder &) = delete;
+
+        /// @brief Asks for a dump at the end of the current tick, e.g. from a callback that noticed a problem.
+        /// Not rate-limited by nMinDumpIntervalMs.
+        /// @param strReason Stored in the file.
+        void RequestDump(const std::string &strReason);
+
+        /// @brief Starts a tick.
+        void BeginTick(SteamNetworkingMicroseconds usecTimestamp);
+
+        /// @brief Adds one batch of a connection's messages to the current tick.
+        void RecordBatch(HSteamNetConnection hConn, uint32 usecTime, uint32 nMessages, uint64 cbBytes);
+
+        /// @brief Returns the current tick, for the Server to fill in its totals and link status.
+        FlightTick &GetCurrentTick() { return m_current; }
+
+        /// @brief Stores the current tick in the ring and dumps the ring if the tick was slow or a dump was
+        /// requested.
+        /// @param usecDuration The wall time of the tick.
+        /// @return True if a dump was queued.
+        bool EndTick(uint32 usecDuration);
+
+        /// @brief Returns the number of dumps queued since construction.
+        uint64 GetDumpCount() const { return m_nDumps.load(std::memory_order_relaxed); }
+
+        /// @brief Writes a dump file.
+        /// @details The format is little-endian: the magic "QNFLIGHT", u32 version (1), u32 threshold, i64 trigger
+        /// timestamp, u16 reason length and the reason, u32 tick count, then per tick: i64 timestamp, u32 duration,
+        /// u32 dispatch time, u32 messages, u64 bytes, u32 clients, u32 authenticating, u32 backlog, u32 throttled,
+        /// u8 budget exhausted, u8 connection count and that many connections of u32 handle, u32 time,
+        /// u32 messages, u32 bytes, i32 ping, i32 pending reliable, i32 pending unreliable, u32 queue time.
+        /// @return False if the file could not be written.
+        static bool WriteDump(const std::string &strPath, const FlightDump &dump);
+
+        /// @brief Reads a file written by WriteDump().
+        /// @return False if the file cannot be read or is not a valid dump.
+        static bool ReadDump(const std::string &strPath, FlightDump &dump);
+
+    public:
+        /// @brief Invoked on the writer thread after each dump, with the path written or an empty string if writing
+        /// failed.
+        std::function<void(const std::string &strPath)> OnDump;
+
+    private:
+        /// @brief Copies the ring, oldest first, and queues it for the writer thread.
+        void QueueDump(std::string strReason);
+
+        /// @brief Writer thread body.
+        void WriterLoop();
+
+    private:
+        const FlightRecorderConfig m_config;
+
+        /// @brief The ring, and where the next tick goes.
+        std::vector<FlightTick> m_vecRing;
+        size_t m_nNext = 0;
+        size_t m_nStored = 0;
+
+        FlightTick m_current;
+
+        /// @brief Steady-clock time of the last dump, in microseconds; only touched by the network thread.
+        int64 m_usecLastDump = 0;
+        bool m_bDumped = false;
+
+        /// @brief A dump asked for by RequestDump().
+        std::atomic<bool> m_bDumpRequested{false};
+        std::mutex m_requestMutex;
+        std::string m_strRequestReason;
+
+        /// @brief Dumps waiting for the writer thread.
+        std::mutex m_writerMutex;
+        std::condition_variable m_writerCondition;
+        std::deque<FlightDump> m_dequeDumps;
+        bool m_bStopping = false;
+        uint32 m_nSequence = 0;
+        std::thread m_writer;
+
+        std::atomic<uint64> m_nDumps{0};
+    };
+} // namespace QNET
\ No newline at end of file
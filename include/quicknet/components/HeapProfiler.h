@@ -0,0 +1,99 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace QNET
+{
+    /// @brief Settings of a heap profile (see HeapProfiler::Start()).
+    struct HeapProfilerConfig
+    {
+        /// @brief Mean bytes allocated between samples. Each sample stands for about this many bytes, so smaller
+        /// intervals see smaller sites at a higher cost; the default costs a few stack unwinds per megabyte.
+        uint64_t cbSampleInterval = 512 * 1024;
+
+        /// @brief Distinct allocation stacks recorded; samples of further stacks are counted as dropped.
+        uint32_t nMaxSites = 4096;
+
+        /// @brief Sampled allocations tracked until freed; samples beyond it are counted as dropped.
+        uint32_t nMaxLiveSamples = 65536;
+
+        /// @brief Deepest stack recorded; deeper stacks lose their outermost frames.
+        uint32_t nMaxDepth = 32;
+    };
+
+    /// @brief The allocations made from one stack, estimated from the samples taken there.
+    struct HeapSite
+    {
+        /// @brief The allocating stack, innermost first, as named by SymbolizeAddress().
+        std::vector<std::string> vecStack;
+
+        /// @brief Samples taken at the site, and those of them freed since.
+        uint64_t nAllocSamples = 0;
+        uint64_t nFreeSamples = 0;
+
+        /// @brief Estimated bytes allocated at the site, and freed since.
+        uint64_t cbAllocated = 0;
+        uint64_t cbFreed = 0;
+
+        uint64_t GetLiveSamples() const { return nAllocSamples - nFreeSamples; }
+        uint64_t GetLiveBytes() const { return cbAllocated - cbFreed; }
+    };
+
+    /// @brief A snapshot of a heap profile.
+    struct HeapProfile
+    {
+        /// @brief The sites with the most live bytes first; ties are broken by bytes allocated.
+        std::vector<HeapSite> vecSites;
+
+        /// @brief Estimated totals over all sites, including those left out of vecSites.
+        uint64_t cbAllocated = 0;
+        uint64_t cbFreed = 0;
+
+        /// @brief Samples taken, samples lost to a full table, the sample interval and how long the profile ran.
+        uint64_t nSamples = 0;
+        uint64_t nDropped = 0;
+        uint64_t cbSampleInterval = 0;
+        uint64_t usecDuration = 0;
+        bool bRunning = false;
+    };
+
+    /// @brief A sampling profiler of operator new for the whole process, to find where memory that is never freed
+    /// comes from.
+    /// @details Only built when the library is configured with QNET_ENABLE_HEAP_PROFILER=ON, which replaces the
+    /// global operator new and delete with ones that call malloc and free. While no profile runs, the replacements
+    /// cost one load of a flag per call. While one runs, each thread counts down the bytes it allocates and records
+    /// the stack of the allocation that reaches zero, then draws the next distance from an exponential distribution
+    /// around cbSampleInterval, so every byte is equally likely to be sampled whatever the allocation sizes. Each
+    /// sample is weighted by the bytes it stands for, and sampled allocations are remembered until freed, so the
+    /// profile tells live memory apart from memory already given back. Deletes then also look the pointer up in a
+    /// lock-free table, which is usually a single empty slot.
+    ///
+    /// Start() allocates tables of the sizes in its config, and a later Start() with other sizes gets new ones. The
+    /// tables are never freed, since a delete racing with Stop() may still read them; each set is reused by every
+    /// later Start() with the same sizes, so only distinct configs cost memory. Allocations made before Start() and
+    /// with malloc are not seen. Supported on Linux with glibc.
+    class HeapProfiler
+    {
+    public:
+        /// @brief Returns true if the library was built with the heap profiler on a supported platform.
+        static bool IsSupported();
+
+        /// @brief Clears the previous profile and starts sampling.
+        /// @param pstrError If not null, receives the reason on failure.
+        /// @return False if unsupported, the config is invalid or a profile is already running.
+        static bool Start(const HeapProfilerConfig &config = HeapProfilerConfig(), std::string *pstrError = nullptr);
+
+        /// @brief Stops sampling and tracking frees. The profile stays readable with GetProfile().
+        /// @return False if no profile was running.
+        static bool Stop();
+
+        /// @brief Returns true while a profile runs.
+        static bool IsRunning();
+
+        /// @brief Reads the running or last profile, keeping the nMaxSites sites with the most live bytes.
+        /// @return False if no profile was ever started.
+        static bool GetProfile(HeapProfile &profile, size_t nMaxSites = 50);
+    };
+} // namespace QNET
\ No newline at end of file
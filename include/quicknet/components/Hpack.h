@@ -0,0 +1,103 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <string>
+#include <vector>
+
+namespace QNET
+{
+    /// @brief One header field of an HTTP/2 header block.
+    struct HpackHeader
+    {
+        std::string strName;
+        std::string strValue;
+
+        /// @brief Never store the field in a compression table, here or in intermediaries (e.g. credentials).
+        bool bNeverIndex = false;
+    };
+
+    /// @brief Appends the Huffman encoding of strIn (RFC 7541 section 5.2) to strOut, padded with ones.
+    void HpackHuffmanEncode(const std::string &strIn, std::string &strOut);
+
+    /// @brief Returns the size in bytes of the Huffman encoding of strIn.
+    size_t HpackHuffmanEncodedLength(const std::string &strIn);
+
+    /// @brief Appends the decoding of a Huffman-encoded string to strOut.
+    /// @return False if the input is invalid: it contains EOS, or its padding is longer than 7 bits or not all ones.
+    bool HpackHuffmanDecode(const uint8_t *pData, size_t cbData, std::string &strOut);
+
+    /// @brief Decodes HPACK header blocks (RFC 7541) received on one HTTP/2 connection.
+    /// @details The dynamic table is shared by every block of the connection, so blocks must be decoded in the
+    /// order they arrive, including blocks of streams that are then refused.
+    class HpackDecoder
+    {
+    public:
+        /// @param cbMaxTableSize The SETTINGS_HEADER_TABLE_SIZE advertised to the peer.
+        explicit HpackDecoder(uint32_t cbMaxTableSize = 4096);
+
+        /// @brief Decodes one complete header block (HEADERS plus CONTINUATION payloads) and appends its fields.
+        /// @param cbMaxHeaderList Limit of the decoded list, counted as in SETTINGS_MAX_HEADER_LIST_SIZE (name and
+        /// value plus 32 bytes per field). Fields past it are decoded to keep the table in sync, but not stored.
+        /// @param pbTooLarge If not null, set to whether the limit was exceeded.
+        /// @return False on a compression error, after which the connection cannot continue.
+        bool Decode(const uint8_t *pData, size_t cbData, std::vector<HpackHeader> &vecHeaders,
+                    size_t cbMaxHeaderList = SIZE_MAX, bool *pbTooLarge = nullptr);
+
+        /// @brief Returns the number of bytes the dynamic table holds, as counted by RFC 7541.
+        size_t GetTableSize() const { return m_cbTableSize; }
+
+    private:
+        /// @brief Returns the entry at an HPACK index (static first, then dynamic), or nullptr if out of range.
+        const HpackHeader *Lookup(uint64_t nIndex) const;
+
+        void Insert(HpackHeader header);
+        void EvictTo(size_t cbSize);
+
+    private:
+        /// @brief Newest entry first.
+        std::deque<HpackHeader> m_dequeTable;
+        size_t m_cbTableSize = 0;
+
+        /// @brief The current table size, set by the encoder within the advertised limit.
+        size_t m_cbMaxTableSize;
+        const size_t m_cbSettingsMaxTableSize;
+    };
+
+    /// @brief Encodes HPACK header blocks (RFC 7541) sent on one HTTP/2 connection.
+    /// @details Fields matching a static or dynamic table entry are sent as an index. Other fields are sent as
+    /// literals and added to the dynamic table, except values that rarely repeat (content-length, date, etag...)
+    /// and fields marked bNeverIndex. Strings are Huffman-coded when that is shorter.
+    class HpackEncoder
+    {
+    public:
+        /// @param cbMaxTableSize The dynamic table size to use; at most the peer's SETTINGS_HEADER_TABLE_SIZE.
+        explicit HpackEncoder(uint32_t cbMaxTableSize = 4096);
+
+        /// @brief Applies a new SETTINGS_HEADER_TABLE_SIZE from the peer. The size update is signalled at the start
+        /// of the next block.
+        void SetMaxTableSize(uint32_t cbMaxTableSize);
+
+        /// @brief Appends the encoding of a header list to strOut.
+        void Encode(const std::vector<HpackHeader> &vecHeaders, std::string &strOut);
+
+    private:
+        /// @brief Finds the best index for a field: nFull is an index matching name and value, nName one matching
+        /// the name only; 0 if none.
+        void Find(const HpackHeader &header, uint64_t &nFull, uint64_t &nName) const;
+
+        void Insert(const HpackHeader &header);
+        void EvictTo(size_t cbSize);
+
+    private:
+        /// @brief Newest entry first.
+        std::deque<HpackHeader> m_dequeTable;
+        size_t m_cbTableSize = 0;
+        size_t m_cbMaxTableSize;
+
+        /// @brief A size update to emit before the next block, and the smallest size set since the last block.
+        bool m_bPendingSizeUpdate = false;
+        size_t m_cbMinPendingSize = 0;
+    };
+} // namespace QNET
\ No newline at end of file
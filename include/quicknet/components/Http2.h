@@ -0,0 +1,193 @@
+#pragma once
+
+#include "quicknet/components/Hpack.h"
+
+#include "httplib.h"
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace QNET
+{
+    /// @brief Frame types of RFC 9113 section 6.
+    enum class Http2FrameType : uint8_t
+    {
+        Data = 0x0,
+        Headers = 0x1,
+        Priority = 0x2,
+        RstStream = 0x3,
+        Settings = 0x4,
+        PushPromise = 0x5,
+        Ping = 0x6,
+        GoAway = 0x7,
+        WindowUpdate = 0x8,
+        Continuation = 0x9
+    };
+
+    /// @brief Frame flags. END_STREAM and ACK share a bit; which applies depends on the frame type.
+    constexpr uint8_t kHttp2FlagEndStream = 0x1;
+    constexpr uint8_t kHttp2FlagAck = 0x1;
+    constexpr uint8_t kHttp2FlagEndHeaders = 0x4;
+    constexpr uint8_t kHttp2FlagPadded = 0x8;
+    constexpr uint8_t kHttp2FlagPriority = 0x20;
+
+    /// @brief SETTINGS parameters.
+    constexpr uint16_t kHttp2SettingsHeaderTableSize = 0x1;
+    constexpr uint16_t kHttp2SettingsEnablePush = 0x2;
+    constexpr uint16_t kHttp2SettingsMaxConcurrentStreams = 0x3;
+    constexpr uint16_t kHttp2SettingsInitialWindowSize = 0x4;
+    constexpr uint16_t kHttp2SettingsMaxFrameSize = 0x5;
+    constexpr uint16_t kHttp2SettingsMaxHeaderListSize = 0x6;
+
+    /// @brief Error codes of RST_STREAM and GOAWAY.
+    enum class Http2Error : uint32_t
+    {
+        NoError = 0x0,
+        ProtocolError = 0x1,
+        InternalError = 0x2,
+        FlowControlError = 0x3,
+        SettingsTimeout = 0x4,
+        StreamClosed = 0x5,
+        FrameSizeError = 0x6,
+        RefusedStream = 0x7,
+        Cancel = 0x8,
+        CompressionError = 0x9,
+        ConnectError = 0xa,
+        EnhanceYourCalm = 0xb,
+        InadequateSecurity = 0xc,
+        Http11Required = 0xd
+    };
+
+    /// @brief The client connection preface, sent before its first frame.
+    constexpr const char *kHttp2Preface = "PRI * HTTP/2.0\r\n\r\nSM\r\n\r\n";
+    constexpr size_t kHttp2PrefaceSize = 24;
+
+    constexpr size_t kHttp2FrameHeaderSize = 9;
+    constexpr uint32_t kHttp2DefaultWindowSize = 65535;
+    constexpr uint32_t kHttp2MaxWindowSize = 0x7FFFFFFF;
+    constexpr uint32_t kHttp2MinFrameSize = 16384;
+    constexpr uint32_t kHttp2MaxFrameSize = 0xFFFFFF;
+
+    /// @brief The fixed 9-byte header of a frame.
+    struct Http2FrameHeader
+    {
+        uint32_t cbLength = 0;
+        uint8_t nType = 0;
+        uint8_t nFlags = 0;
+        uint32_t nStreamId = 0;
+    };
+
+    /// @brief Appends a frame to strOut.
+    void AppendHttp2Frame(std::string &strOut, Http2FrameType eType, uint8_t nFlags, uint32_t nStreamId,
+                          const char *pPayload, size_t cbPayload);
+
+    /// @brief Appends a header block as a HEADERS frame followed by as many CONTINUATION frames as cbMaxFrame
+    /// requires.
+    void AppendHttp2Headers(std::string &strOut, uint32_t nStreamId, const std::string &strBlock, bool bEndStream,
+                            uint32_t cbMaxFrame);
+
+    /// @brief Appends a SETTINGS frame with the given parameters.
+    void AppendHttp2Settings(std::string &strOut, const std::vector<std::pair<uint16_t, uint32_t>> &vecSettings);
+
+    /// @brief Appends a WINDOW_UPDATE frame.
+    void AppendHttp2WindowUpdate(std::string &strOut, uint32_t nStreamId, uint32_t nIncrement);
+
+    /// @brief Parses the 9-byte frame header at pData.
+    Http2FrameHeader ParseHttp2FrameHeader(const uint8_t *pData);
+
+    /// @brief Settings of the HTTP/2 listener of an HttpServer (see HttpServer::StartHttp2()).
+    struct Http2Config
+    {
+        /// @brief Streams a client may have open at once (SETTINGS_MAX_CONCURRENT_STREAMS).
+        uint32_t nMaxConcurrentStreams = 100;
+
+        /// @brief Receive window of each stream, and of the connection as a whole. Received data is acknowledged
+        /// as soon as it is read, so these bound what a client may have in flight, not what is buffered.
+        uint32_t cbStreamWindow = 1024 * 1024;
+        uint32_t cbConnectionWindow = 4 * 1024 * 1024;
+
+        /// @brief Largest frame payload accepted (SETTINGS_MAX_FRAME_SIZE), 16384 to 16777215.
+        uint32_t cbMaxFrameSize = 16384;
+
+        /// @brief Largest decoded header list (SETTINGS_MAX_HEADER_LIST_SIZE); larger requests get 431.
+        uint32_t cbMaxHeaderListSize = 64 * 1024;
+
+        /// @brief Largest request body; larger requests get 413.
+        size_t cbMaxBody = 8 * 1024 * 1024;
+
+        /// @brief Threads running the handlers of all connections.
+        uint32_t nWorkerThreads = 8;
+
+        /// @brief Most connections served at once; more are closed on accept.
+        uint32_t nMaxConnections = 1024;
+
+        /// @brief A connection without open streams for this long is closed with GOAWAY.
+        uint32_t nIdleTimeoutSeconds = 60;
+    };
+
+    class Http2Connection;
+
+    /// @brief Serves HTTP/2 over cleartext TCP (h2c with prior knowledge, RFC 9113 section 3.3) on its own port.
+    /// @details Each connection has a reader thread, which parses frames, decodes headers and enforces limits, and
+    /// a writer thread, which encodes responses and interleaves their DATA frames within the peer's flow control
+    /// windows. Complete requests are handed to the dispatch function on a shared pool of worker threads, so the
+    /// streams of one connection are served concurrently. Server push and prioritization are not implemented;
+    /// PRIORITY frames are accepted and ignored.
+    class Http2Listener
+    {
+    public:
+        /// @brief Fills in a response for a complete request. Called on the worker threads.
+        using Dispatch = std::function<void(httplib::Request &req, httplib::Response &res)>;
+
+        Http2Listener(Dispatch dispatch, const Http2Config &config);
+
+        /// @brief Stops the listener if it is running.
+        ~Http2Listener();
+
+        Http2Listener(const Http2Listener &) = delete;
+        Http2Listener &operator=(const Http2Listener &) = delete;
+
+        /// @brief Binds the port and starts accepting connections on a thread of its own.
+        /// @return False if the port could not be bound.
+        bool Start(const std::string &strHost, uint16_t nPort);
+
+        /// @brief Stops accepting, closes every connection and waits for running handlers to return.
+        void Stop();
+
+        /// @brief Returns the number of connections being served.
+        size_t GetConnectionCount() const;
+
+    private:
+        /// @brief Accept thread body.
+        void AcceptLoop();
+
+        /// @brief Joins the threads of connections that have ended. Called with m_mutex held.
+        void ReapConnections();
+
+    private:
+        struct ConnectionThread
+        {
+            std::shared_ptr<Http2Connection> pConnection;
+            std::thread thread;
+        };
+
+        const Dispatch m_dispatch;
+        const Http2Config m_config;
+
+        std::intptr_t m_listenSocket = -1;
+        std::atomic<bool> m_bStopping{false};
+        std::thread m_acceptThread;
+
+        mutable std::mutex m_mutex;
+        std::vector<ConnectionThread> m_vecConnections;
+
+        std::unique_ptr<httplib::ThreadPool> m_pool;
+    };
+} // namespace QNET
\ No newline at end of file
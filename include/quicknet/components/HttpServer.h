@@ -1,12 +1,24 @@
 #pragma once
 
+#include "quicknet/components/Http2.h"
+#include "quicknet/components/Json.h"
+#include "quicknet/components/RequestArena.h"
+#include "quicknet/components/Watchdog.h"
+
 #include "httplib.h"
 
+#include <cstddef>
 #include <functional>
 #include <iostream>
+#include <map>
 #include <memory>
+#include <mutex>
+#include <regex>
 #include <stdexcept>
 #include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
 
 namespace QNET
 {
@@ -15,6 +27,64 @@ namespace QNET
     using Response = httplib::Response;
     using Handler = std::function<void(const Request &, Response &)>;
 
+    /// @brief Limits of the batch endpoint (see HttpServer::EnableBatch()).
+    struct HttpBatchConfig
+    {
+        /// @brief Most sub-requests in one batch.
+        uint32_t nMaxRequests = 50;
+
+        /// @brief Largest batch request body, in bytes.
+        size_t cbMaxBody = 1024 * 1024;
+
+        /// @brief Largest sum of the sub-response bodies, in bytes as sent, so base64-encoded bodies count 4/3 of
+        /// their size. Sub-requests not started once it is reached are not run, and responses past it are replaced
+        /// by a 413 entry.
+        size_t cbMaxResponse = 8 * 1024 * 1024;
+
+        /// @brief Threads shared by batches that ask for parallel dispatch; 0 runs every batch sequentially.
+        uint32_t nWorkerThreads = 4;
+
+        /// @brief Most threads one batch uses, counting the one that received it.
+        uint32_t nMaxParallelism = 4;
+    };
+
+    /// @brief Limits of a bulkhead: a group of routes served by a worker pool of its own (see
+    /// HttpServer::AddBulkhead()).
+    struct HttpBulkheadConfig
+    {
+        /// @brief Threads running the group's handlers; at most this many of its requests run at once.
+        uint32_t nWorkerThreads = 4;
+
+        /// @brief Requests that may wait for a worker; requests past it are answered with 503 at once.
+        uint32_t nMaxQueue = 32;
+
+        /// @brief A request still waiting for a worker after this long is answered with 503; 0 waits indefinitely.
+        uint32_t nQueueTimeoutMs = 5000;
+    };
+
+    /// @brief Counters of a bulkhead (see HttpServer::GetBulkheadStats()).
+    struct HttpBulkheadStats
+    {
+        std::string strName;
+        uint32_t nWorkerThreads = 0;
+        uint32_t nMaxQueue = 0;
+
+        /// @brief Handlers running and requests waiting right now, and the most requests that have waited at once.
+        uint32_t nBusy = 0;
+        uint32_t nQueued = 0;
+        uint32_t nPeakQueued = 0;
+
+        /// @brief Requests served, refused because the queue was full, and given up on in the queue.
+        uint64_t nCompleted = 0;
+        uint64_t nRejected = 0;
+        uint64_t nTimedOut = 0;
+
+        /// @brief Total time spent in handlers, and waiting for a worker by the requests that got one. The
+        /// utilization over an interval is the growth of usecBusy divided by the interval times nWorkerThreads.
+        uint64_t usecBusy = 0;
+        uint64_t usecQueued = 0;
+    };
+
     /// @brief Manages a simple, high-level HTTP server.
     /// @details This class provides a wrapper around the cpp-httplib library
     /// to simplify the creation of HTTP endpoints for web services or APIs.
@@ -37,16 +107,38 @@ namespace QNET
         /// @brief Registers a handler for HTTP GET requests on a specific path.
         /// @param path The URL path to handle (e.g., "/").
         /// @param handler The function to execute when a request matches the path.
-        void Get(const std::string &path, Handler handler);
+        /// @param bulkhead The bulkhead whose workers run the handler (see AddBulkhead()), or empty to run it on
+        /// the thread that read the request.
+        void Get(const std::string &path, Handler handler, const std::string &bulkhead = std::string());
 
         /// @brief Registers a handler for HTTP POST requests on a specific path.
         /// @param path The URL path to handle (e.g., "/api/submit").
         /// @param handler The function to execute when a request matches the path.
-        void Post(const std::string &path, Handler handler);
+        /// @param bulkhead The bulkhead whose workers run the handler, or empty.
+        void Post(const std::string &path, Handler handler, const std::string &bulkhead = std::string());
 
-        void Put(const std::string &path, Handler handler);
+        void Put(const std::string &path, Handler handler, const std::string &bulkhead = std::string());
 
-        void Delete(const std::string &path, Handler handler);
+        void Delete(const std::string &path, Handler handler, const std::string &bulkhead = std::string());
+
+        /// @brief Creates a bulkhead: a named group of routes with a worker pool and queue of its own, so that a
+        /// burst on one group (e.g. slow exports) cannot take the threads the other routes need.
+        /// @details Routes registered with the bulkhead's name are routed as usual, then handed to its pool; the
+        /// thread that read the request waits for the handler, so a bulkhead holds at most nWorkerThreads +
+        /// nMaxQueue of the server's threads. Requests that find the queue full, or wait longer than
+        /// nQueueTimeoutMs, get 503 with Retry-After. Routes without a bulkhead run on the thread that read them,
+        /// as before. Applies to HTTP/1.1, HTTP/2 and batch sub-requests alike. Call before registering the routes.
+        /// @param name The name routes refer to, and reported in the stats.
+        /// @param config Pool size, queue limit and queue timeout.
+        /// @return False if the name is empty or already taken.
+        bool AddBulkhead(const std::string &name, const HttpBulkheadConfig &config = HttpBulkheadConfig());
+
+        /// @brief Returns the counters of every bulkhead, ordered by name.
+        std::vector<HttpBulkheadStats> GetBulkheadStats() const;
+
+        /// @brief Adds a GET route that reports GetBulkheadStats() as JSON.
+        /// @param path The route of the report.
+        void ServeBulkheadStats(const std::string &path = "/metrics/bulkheads");
 
         /// @brief Sets a directory to be served as static files.
         /// @param mount_point The URL path to serve from (e.g., "/").
@@ -59,10 +151,118 @@ namespace QNET
         /// @param port The port number to listen on.
         void Run(uint16_t port);
 
-        /// @brief Stops the HTTP server if it is running.
+        /// @brief Stops the HTTP server, and the HTTP/2 listener, if they are running.
         void Stop();
 
+        /// @brief Serves the routes over HTTP/2 as well, on a port of its own.
+        /// @details Speaks cleartext HTTP/2 with prior knowledge (h2c, e.g. curl --http2-prior-knowledge or a
+        /// reverse proxy's HTTP/2 upstream); the HTTP/1.1 Upgrade handshake and TLS are not supported, so browsers
+        /// reach it through a proxy. Requests on many streams share one connection and its compressed headers, and
+        /// run concurrently on config.nWorkerThreads threads through the same handlers as HTTP/1.1 requests,
+        /// including the batch route. Static files are not served over HTTP/2. Returns immediately; the listener
+        /// runs until Stop(). Register the routes first.
+        /// @param port The port to listen on.
+        /// @param config Stream, window, size and thread limits.
+        /// @return False if the port could not be bound or the listener already runs.
+        bool StartHttp2(uint16_t port, const Http2Config &config = Http2Config());
+
+        /// @brief Reports route handlers that run longer than the watchdog's threshold.
+        /// @details Each worker thread gets its own monitor, and the report's context is the route (e.g.
+        /// "GET /api/users/:id"). Applies to handlers registered before and after the call. May be called while the
+        /// server runs; handlers already running keep their previous monitor until they return.
+        /// @param pWatchdog The watchdog, or nullptr to stop watching handlers.
+        void SetWatchdog(Watchdog *pWatchdog);
+
+        /// @brief Sizes the arena each worker thread keeps for the route handlers it runs.
+        /// @details While a handler runs, RequestArena::Resource() returns its worker's arena, from which it can
+        /// allocate temporary data (std::pmr containers and strings) without calling malloc; everything is released
+        /// when the handler returns. The arena starts at cbInitialSize bytes and grows to fit the largest request
+        /// seen, up to cbMaxRetained. The default is 64 KiB growing to 1 MiB; 0 disables the arenas. Call before
+        /// Run().
+        /// @param cbInitialSize The size each worker's arena starts with.
+        /// @param cbMaxRetained The most each worker's arena keeps between requests.
+        void SetRequestArena(size_t cbInitialSize, size_t cbMaxRetained);
+
+        /// @brief Adds a route that runs many small API calls in one round trip.
+        /// @details The route takes a POST with a JSON body such as
+        ///   {"parallel": false, "requests": [{"method": "GET", "path": "/api/users/7?fields=name",
+        ///                                    "headers": {"X-Trace": "1"}, "body": ""}, ...]}
+        /// and runs each sub-request through the handlers registered with Get(), Post(), Put() and Delete(), in the
+        /// order they were registered, as if it had arrived on its own. Sub-requests inherit the batch's headers
+        /// (e.g. Authorization) except the Content-* ones, and their own headers take precedence. It answers
+        ///   {"responses": [{"status": 200, "headers": {...}, "body": "..."}, ...]}
+        /// in request order; a body that is not valid UTF-8 is base64-encoded and the entry gets
+        /// "encoding": "base64". An unknown route is a 404 entry and a handler that throws a 500 entry. Static files
+        /// and nested batches are not served. With "parallel": true the sub-requests run concurrently on a pool of
+        /// config.nWorkerThreads threads, so only ask for it when they do not depend on each other. Call before
+        /// Run(), and at most once.
+        /// @param path The route of the batch endpoint.
+        /// @param config Per-batch limits and the worker pool size.
+        /// @return False if a batch route was already added.
+        bool EnableBatch(const std::string &path = "/batch", const HttpBatchConfig &config = HttpBatchConfig());
+
+        /// @brief Responds with an error status and {"error": message}, the error body of the admin routes.
+        static void RespondError(Response &res, int status, const std::string &message);
+
+        /// @brief Checks that a request carries "Authorization: Bearer <token>", for routes guarded by a shared
+        /// secret. The header is compared in constant time, so response timings do not reveal how much of a guess
+        /// was right. An empty token accepts every request.
+        /// @return False, after responding 401 through RespondError(), if the header does not match.
+        static bool CheckBearerToken(const Request &req, Response &res, const std::string &token);
+
+        /// @brief Reads an unsigned decimal query parameter, leaving value unchanged if the request has none.
+        /// @return False if the parameter is present but not a non-negative integer.
+        static bool ReadUIntParam(const Request &req, const char *name, uint64_t &value);
+
     private:
+        /// @brief A route registered with Get(), Post(), Put() or Delete(), kept for the batch endpoint.
+        struct route_entry
+        {
+            std::string method;
+            std::regex pattern;
+            Handler handler;
+        };
+
+        /// @brief A sub-request of a batch and its response. Built in place and never moved, since req.matches
+        /// refers into req.path.
+        struct batch_item
+        {
+            Request req;
+            Response res;
+            bool run = false;
+            std::string error;
+        };
+
+        /// @brief A batch in flight, shared with the pool threads helping with it.
+        struct batch_state;
+
+        /// @brief The worker pool and queue of a bulkhead.
+        class bulkhead;
+
+        /// @brief Registers a handler with httplib and in the route table.
+        void add_route(const std::string &method, const std::string &path, Handler handler,
+                       const std::string &bulkhead_name);
+
+        /// @brief Handles a request to the batch route.
+        void handle_batch(const Request &req, Response &res);
+
+        /// @brief Fills a sub-request from its JSON description; returns false with strError set if it is invalid.
+        bool prepare_batch_item(const Request &outer, const JsonValue &desc, batch_item &item, std::string &strError);
+
+        /// @brief Runs the sub-requests of a batch that no other thread has claimed yet.
+        void run_batch_items(batch_state &state);
+
+        /// @brief Routes a sub-request to its handler and stores the response.
+        void run_batch_item(batch_item &item);
+
+        /// @brief Runs the first route matching the request's method and path, as httplib would.
+        /// @return False, with a 404 response, if no route matches. A handler that throws gets a 500 response
+        /// and its message in error.
+        bool route_request(Request &req, Response &res, std::string &error);
+
+        /// @brief Serves a request received by the HTTP/2 listener. Runs on its worker threads.
+        void serve_http2(Request &req, Response &res);
+
         /// @brief Logs an error message to the standard error stream.
         /// @param msg The message to log.
         void log_message(const std::string &msg);
@@ -73,8 +273,46 @@ namespace QNET
         /// @return regular expression conversion of the path
         std::string path_to_regex(const std::string &path);
 
+        /// @brief Wraps a handler so that it runs on its bulkhead, if any, with its worker's arena, and is watched
+        /// while a watchdog is set.
+        /// @param route Method and path, reported as the stall context.
+        /// @param handler The handler to wrap.
+        /// @param group The bulkhead to run it on, or nullptr.
+        Handler wrap_handler(const std::string &route, Handler handler, bulkhead *group);
+
+        /// @brief Returns the calling worker thread's monitor, creating it on first use; nullptr if not watched.
+        /// @details Shared with the caller, so a handler's monitor outlives a SetWatchdog() call made while it runs.
+        std::shared_ptr<LoopMonitor> get_thread_monitor();
+
+        /// @brief Returns the calling worker thread's arena, creating it on first use; nullptr if disabled.
+        RequestArena *get_thread_arena();
+
         /// @brief The underlying httplib server instance.
         /// @details std::unique_ptr is used to manage its lifetime.
         std::unique_ptr<httplib::Server> m_server;
+
+        /// @brief Watchdog set by SetWatchdog(), and one monitor per worker thread.
+        Watchdog *m_watchdog = nullptr;
+        std::mutex m_monitor_mutex;
+        std::unordered_map<std::thread::id, std::shared_ptr<LoopMonitor>> m_monitors;
+
+        /// @brief Sizes of the worker arenas, set by SetRequestArena().
+        size_t m_arena_size = 64 * 1024;
+        size_t m_arena_max_size = 1024 * 1024;
+
+        /// @brief Routes in registration order. Written before Run() only, so read without a lock.
+        std::vector<route_entry> m_routes;
+
+        /// @brief The batch route, its limits, and the pool parallel batches run on (null if sequential only).
+        std::string m_batch_path;
+        HttpBatchConfig m_batch_config;
+        std::unique_ptr<httplib::ThreadPool> m_batch_pool;
+
+        /// @brief Bulkheads by name. Created before the routes referring to them and never removed, so the wrappers
+        /// hold plain pointers.
+        std::map<std::string, std::unique_ptr<bulkhead>> m_bulkheads;
+
+        /// @brief The HTTP/2 listener started by StartHttp2().
+        std::unique_ptr<Http2Listener> m_http2;
     };
 } // namespace QNET
\ No newline at end of file
@@ -0,0 +1,200 @@
+#pragma once
+
+#include "quicknet/components/HttpServer.h"
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+namespace QNET
+{
+    /// @brief Settings of an HttpSessionStore.
+    struct HttpSessionConfig
+    {
+        /// @brief Name of the cookie that carries the session id.
+        std::string strCookieName = "qnet_session";
+
+        /// @brief A session not looked up or updated for this long expires.
+        uint32_t nIdleTimeoutSeconds = 1800;
+
+        /// @brief Independently locked parts of the table. More shards let more handler threads look up sessions
+        /// at once.
+        uint32_t nShards = 64;
+
+        /// @brief Largest session value, in bytes.
+        uint32_t cbMaxValue = 16 * 1024;
+
+        /// @brief Path and Secure attribute of the cookie; the cookie is always HttpOnly and SameSite=Lax.
+        std::string strCookiePath = "/";
+        bool bSecureCookie = false;
+
+        /// @brief If set, the sessions are loaded from this file on construction, written to it every
+        /// nSnapshotIntervalSeconds, and once more on destruction, so they survive a restart.
+        std::string strSnapshotPath;
+        uint32_t nSnapshotIntervalSeconds = 60;
+    };
+
+    /// @brief Keeps the login sessions of an HttpServer in memory, so handlers look them up without a round trip
+    /// to a database.
+    /// @details A session is an opaque value (e.g. the user id and roles, serialized by the application) found by a
+    /// random 128-bit id, which the client presents in a cookie:
+    ///   server.Post("/login", [&](const QNET::Request &req, QNET::Response &res) {
+    ///       ...
+    ///       sessions.StartSession(res, strUserId);
+    ///   });
+    ///   server.Get("/api/me", [&](const QNET::Request &req, QNET::Response &res) {
+    ///       std::string strUserId;
+    ///       if (!sessions.GetSession(req, strUserId))
+    ///           return void(res.status = 401);
+    ///       ...
+    ///   });
+    ///
+    /// The table is split into shards by id, each with its own lock, hash map and value arena, so concurrent
+    /// handlers rarely wait for each other and a lookup is a hash probe and a copy of the value. Values are packed
+    /// into one byte array per shard, which is compacted once more than half of it is left over from removed or
+    /// grown values. Sessions expire after nIdleTimeoutSeconds without use: a lookup only moves the expiry time, and
+    /// each shard's timer wheel of one-second slots finds the expired sessions as it advances, on Create(),
+    /// Update() and snapshots. Expired sessions are never returned, even before they are swept.
+    ///
+    /// All functions may be called from any thread.
+    class HttpSessionStore
+    {
+    public:
+        /// @brief Creates the store, loading the snapshot file and starting the snapshot thread if configured.
+        explicit HttpSessionStore(const HttpSessionConfig &config = HttpSessionConfig());
+
+        /// @brief Stops the snapshot thread and writes a last snapshot, if configured.
+        ~HttpSessionStore();
+
+        HttpSessionStore(const HttpSessionStore &) = delete;
+        HttpSessionStore &operator=(const HttpSessionStore &) = delete;
+
+        /// @brief Creates a session.
+        /// @return The new session's id, or an empty string if the value is larger than cbMaxValue.
+        std::string Create(const std::string &strValue);
+
+        /// @brief Copies a session's value into strValue and extends its expiry.
+        /// @return False if the id is malformed, unknown or expired.
+        bool Get(const std::string &strId, std::string &strValue);
+
+        /// @brief Replaces a session's value and extends its expiry.
+        /// @return False if the session does not exist or the value is larger than cbMaxValue.
+        bool Update(const std::string &strId, const std::string &strValue);
+
+        /// @brief Removes a session, e.g. on logout; returns false if it did not exist.
+        bool Remove(const std::string &strId);
+
+        /// @brief Returns the number of sessions, including expired ones not swept yet.
+        size_t GetCount() const;
+
+        /// @brief Returns the session id in the request's cookie, or an empty string if it has none.
+        std::string GetSessionId(const Request &req) const;
+
+        /// @brief Looks up the session of the request's cookie; see Get().
+        bool GetSession(const Request &req, std::string &strValue);
+
+        /// @brief Creates a session and sets its cookie on the response.
+        /// @return The new session's id, or an empty string if the value is too large; then no cookie is set.
+        std::string StartSession(Response &res, const std::string &strValue);
+
+        /// @brief Removes the session of the request's cookie, if any, and clears the cookie.
+        void EndSession(const Request &req, Response &res);
+
+        /// @brief Drops the expired sessions of every shard.
+        void ExpireSessions();
+
+        /// @brief Writes every live session with its remaining time to a file. The file is replaced atomically, so
+        /// a crash while writing leaves the previous snapshot, and is only readable by the owner (mode 0600).
+        bool SaveSnapshot(const std::string &strPath) const;
+
+        /// @brief Adds the sessions of a snapshot, less the time since it was written; sessions that expired in the
+        /// meantime and ids already present are skipped.
+        /// @return The number of sessions added, or -1 if the file could not be read or is malformed; then none
+        /// were added.
+        int64_t LoadSnapshot(const std::string &strPath);
+
+    private:
+        /// @brief A session id as two integers; ids are random, so either half is a good hash.
+        struct Key
+        {
+            uint64_t nHigh;
+            uint64_t nLow;
+
+            bool operator==(const Key &other) const { return nHigh == other.nHigh && nLow == other.nLow; }
+        };
+
+        struct KeyHash
+        {
+            size_t operator()(const Key &key) const { return size_t(key.nLow); }
+        };
+
+        /// @brief Where a session's value lives in its shard's arena, and when it expires.
+        struct Entry
+        {
+            uint32_t nOffset;
+            uint32_t cbSize;
+            uint32_t cbCapacity;
+
+            /// @brief Expiry in seconds on the store's clock, and the wheel slot the entry is filed under.
+            uint32_t nExpires;
+            uint32_t nSlot;
+        };
+
+        struct alignas(64) Shard
+        {
+            mutable std::mutex mutex;
+            std::unordered_map<Key, Entry, KeyHash> mapEntries;
+
+            /// @brief The values, and the bytes in it no entry uses.
+            std::vector<char> vecArena;
+            size_t cbGarbage = 0;
+
+            /// @brief One list of keys per second; a key can be stale (removed, or moved to another slot) and is
+            /// then skipped.
+            std::vector<std::vector<Key>> vecWheel;
+            std::vector<Key> vecExpiring;
+            uint32_t nWheelTime = 0;
+        };
+
+        /// @brief Parses a 32-digit hex id; returns false if strId is not one.
+        static bool ParseId(const std::string &strId, Key &key);
+        static std::string FormatId(const Key &key);
+
+        Shard &GetShard(const Key &key) const { return *m_vecShards[key.nHigh % m_vecShards.size()]; }
+
+        /// @brief Seconds since the store was created.
+        uint32_t GetNow() const;
+
+        /// @brief Adds an entry with the value; the shard must be locked and the key absent.
+        bool Insert(Shard &shard, const Key &key, const char *pValue, size_t cbValue, uint32_t nExpires);
+
+        /// @brief Removes an entry; the shard must be locked.
+        void Erase(Shard &shard, std::unordered_map<Key, Entry, KeyHash>::iterator it);
+
+        /// @brief Files an entry under the wheel slot of its expiry; the shard must be locked.
+        void Schedule(Shard &shard, const Key &key, Entry &entry);
+
+        /// @brief Processes the wheel slots up to nNow, dropping expired entries and refiling extended ones, then
+        /// compacts the arena if it is mostly garbage. The shard must be locked.
+        void Advance(Shard &shard, uint32_t nNow);
+
+        /// @brief Writes a snapshot every interval until stopped.
+        void SnapshotLoop();
+
+    private:
+        const HttpSessionConfig m_config;
+        const std::chrono::steady_clock::time_point m_tStart;
+        std::vector<std::unique_ptr<Shard>> m_vecShards;
+
+        std::mutex m_snapshotMutex;
+        std::condition_variable m_snapshotCondition;
+        bool m_bStopping = false;
+        std::thread m_snapshotThread;
+    };
+} // namespace QNET
\ No newline at end of file
@@ -0,0 +1,118 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace QNET
+{
+    /// @brief Builds a compact JSON document incrementally.
+    /// @details Separators and string escaping are handled by the writer: open containers with BeginObject() or
+    /// BeginArray(), name object members with Key(), then write values. Begin/End calls must be balanced by the
+    /// caller. Non-finite doubles are written as null, since JSON has no representation for them.
+    class JsonWriter
+    {
+    public:
+        JsonWriter &BeginObject();
+        JsonWriter &EndObject();
+        JsonWriter &BeginArray();
+        JsonWriter &EndArray();
+
+        /// @brief Writes an object member name; the next call must write its value.
+        JsonWriter &Key(const std::string &strKey);
+
+        JsonWriter &String(const std::string &strValue);
+        JsonWriter &Int(int64_t nValue);
+        JsonWriter &UInt(uint64_t nValue);
+        JsonWriter &Double(double flValue);
+        JsonWriter &Bool(bool bValue);
+        JsonWriter &Null();
+
+        /// @brief Writes an already serialized JSON value verbatim.
+        JsonWriter &Raw(const std::string &strJson);
+
+        /// @brief Returns the document written so far.
+        const std::string &GetString() const { return m_strOut; }
+
+        /// @brief Discards the document so the writer can be reused.
+        void Clear();
+
+        /// @brief Appends strValue to strOut as a quoted, escaped JSON string.
+        static void AppendQuoted(std::string &strOut, const std::string &strValue);
+
+    private:
+        /// @brief Writes the separator needed before a value or a member name.
+        void BeforeValue();
+
+    private:
+        std::string m_strOut;
+
+        /// @brief For each open container, whether it already holds an element.
+        std::vector<bool> m_vecHasElements;
+
+        /// @brief True right after Key(), when the member's value needs no separator.
+        bool m_bAfterKey = false;
+    };
+
+    /// @brief A parsed JSON document: null, a bool, a number, a string, an array or an object.
+    /// @details Objects keep their members in document order; Find() returns the first member with a name. Numbers
+    /// are held as doubles. Parse() accepts RFC 8259 JSON, decoding \u escapes (surrogate pairs included) to UTF-8,
+    /// and rejects documents nested deeper than kMaxDepth so that hostile input cannot exhaust the stack.
+    class JsonValue
+    {
+    public:
+        enum class Type
+        {
+            Null,
+            Bool,
+            Number,
+            String,
+            Array,
+            Object
+        };
+
+        static constexpr int kMaxDepth = 64;
+
+        Type GetType() const { return m_eType; }
+        bool IsNull() const { return m_eType == Type::Null; }
+        bool IsBool() const { return m_eType == Type::Bool; }
+        bool IsNumber() const { return m_eType == Type::Number; }
+        bool IsString() const { return m_eType == Type::String; }
+        bool IsArray() const { return m_eType == Type::Array; }
+        bool IsObject() const { return m_eType == Type::Object; }
+
+        /// @brief The value, or the given default if this is not of that type.
+        bool GetBool(bool bDefault = false) const { return IsBool() ? m_bValue : bDefault; }
+        double GetNumber(double flDefault = 0.0) const { return IsNumber() ? m_flValue : flDefault; }
+
+        /// @brief The string; empty if this is not a string.
+        const std::string &GetString() const { return m_strValue; }
+
+        /// @brief The elements; empty if this is not an array.
+        const std::vector<JsonValue> &GetArray() const { return m_vecElements; }
+
+        /// @brief The members in document order; empty if this is not an object.
+        const std::vector<std::pair<std::string, JsonValue>> &GetMembers() const { return m_vecMembers; }
+
+        /// @brief Returns the first member named strKey, or nullptr if there is none or this is not an object.
+        const JsonValue *Find(const std::string &strKey) const;
+
+        /// @brief Parses a complete document; trailing content other than whitespace is an error.
+        /// @param strJson The document.
+        /// @param value Receives the document on success.
+        /// @param pstrError If not null, receives a description and offset of the error on failure.
+        /// @return True on success.
+        static bool Parse(const std::string &strJson, JsonValue &value, std::string *pstrError = nullptr);
+
+    private:
+        friend class JsonParser;
+
+        Type m_eType = Type::Null;
+        bool m_bValue = false;
+        double m_flValue = 0.0;
+        std::string m_strValue;
+        std::vector<JsonValue> m_vecElements;
+        std::vector<std::pair<std::string, JsonValue>> m_vecMembers;
+    };
+} // namespace QNET
\ No newline at end of file
@@ -0,0 +1,116 @@
+#pragma once
+
+#include "quicknet/components/Watchdog.h"
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+namespace QNET
+{
+    class HttpServer;
+
+    /// @brief Traffic of one message type in one direction.
+    struct MessageTrafficStats
+    {
+        uint64_t nMessages = 0;
+        uint64_t cbBytes = 0;
+
+        /// @brief Messages per size bucket; see MessageAccounting::GetSizeBucketLimit().
+        std::array<uint64_t, 12> anSizes = {};
+    };
+
+    /// @brief Traffic of one message type since accounting was enabled.
+    struct MessageTypeStats
+    {
+        /// @brief The type read by the extractor, or -1 for messages whose type is unknown or out of range.
+        int32 nType = -1;
+
+        MessageTrafficStats sent;
+        MessageTrafficStats received;
+    };
+
+    /// @brief Attributes sent and received messages, bytes and message sizes to message types.
+    /// @details The type of each message is read from its payload by a MessageTypeExtractor; without one, the first
+    /// byte is the type. Types from 0 to nMaxTypes - 1 are counted separately, and anything else as type -1.
+    ///
+    /// Each thread that records gets counters of its own, found through a thread-local cache, so recording a
+    /// message is the extractor call and three increments without atomic read-modify-writes or locks, and sends
+    /// from several threads do not contend. GetStats() adds up the threads' counters; they are never reset, so
+    /// rates are the difference between two reads.
+    class MessageAccounting
+    {
+    public:
+        /// @brief Number of size buckets: up to 64 bytes, up to 128, and so on doubling to 64 KiB, then larger.
+        static constexpr size_t kSizeBucketCount = 12;
+
+        /// @param extractor Reads the message type from a payload; the first byte is the type if unset.
+        /// @param nMaxTypes Types counted separately, from 0 to nMaxTypes - 1. Each recording thread has
+        /// nMaxTypes * 224 bytes of counters.
+        explicit MessageAccounting(MessageTypeExtractor extractor = MessageTypeExtractor(), uint32 nMaxTypes = 256);
+        ~MessageAccounting();
+
+        MessageAccounting(const MessageAccounting &) = delete;
+        MessageAccounting &operator=(const MessageAccounting &) = delete;
+
+        /// @brief Counts a message handed to the transport.
+        void RecordSent(const void *pData, uint32 cbSize) { Record(pData, cbSize, false); }
+
+        /// @brief Counts a message received from the transport.
+        void RecordReceived(const void *pData, uint32 cbSize) { Record(pData, cbSize, true); }
+
+        /// @brief Returns the types with any traffic, in type order, with -1 (if any) first. May be called from any
+        /// thread.
+        std::vector<MessageTypeStats> GetStats() const;
+
+        /// @brief Returns the time since the accounting was created, over which GetStats() counted.
+        std::chrono::steady_clock::duration GetElapsed() const { return std::chrono::steady_clock::now() - m_tStart; }
+
+        /// @brief Returns the largest message size of a bucket, or UINT32_MAX for the last one.
+        static uint32 GetSizeBucketLimit(size_t nBucket);
+
+        /// @brief Serves GetStats() as JSON on an HttpServer. The accounting must outlive the server's Run().
+        /// @details The response is {"elapsedMs", "sizeBuckets": [64, 128, ...], "types": [{"type", "sent":
+        /// {"messages", "bytes", "sizes": [...]}, "received": {...}}]}, with null as the last bucket's limit.
+        void ServeMetrics(HttpServer &http, const std::string &strPath = "/metrics/messages") const;
+
+    private:
+        struct Counters
+        {
+            std::atomic<uint64_t> nMessages{0};
+            std::atomic<uint64_t> cbBytes{0};
+            std::array<std::atomic<uint64_t>, kSizeBucketCount> anSizes{};
+        };
+
+        /// @brief The counters of one thread: nMaxTypes + 1 per direction, the last for type -1. Only that thread
+        /// writes them.
+        struct Shard
+        {
+            std::unique_ptr<Counters[]> pSent;
+            std::unique_ptr<Counters[]> pReceived;
+        };
+
+        void Record(const void *pData, uint32 cbSize, bool bReceived);
+
+        /// @brief Returns the calling thread's counters, creating them on its first message.
+        Shard &GetLocalShard();
+
+    private:
+        const MessageTypeExtractor m_extractor;
+        const uint32 m_nMaxTypes;
+        const std::chrono::steady_clock::time_point m_tStart;
+
+        /// @brief Identifies this instance in the threads' caches; never reused, unlike the address.
+        const uint64_t m_nId;
+
+        mutable std::mutex m_mutex;
+        std::unordered_map<std::thread::id, std::unique_ptr<Shard>> m_mapShards;
+    };
+} // namespace QNET
\ No newline at end of file
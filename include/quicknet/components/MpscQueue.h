@@ -0,0 +1,77 @@
+#pragma once
+
+#include <atomic>
+#include <utility>
+
+namespace QNET
+{
+    /// @brief Unbounded lock-free queue for many producer threads and one consumer thread.
+    /// @details Push() is one atomic exchange plus one store, so producers never wait on each other or on the
+    /// consumer. Each element costs one node allocation. A Pop() that races with a Push() in progress may not see
+    /// that element yet; it is returned by a later Pop(). T must be default constructible and movable.
+    template <typename T>
+    class MpscQueue
+    {
+    public:
+        MpscQueue() : m_pHead(&m_stub), m_pTail(&m_stub) {}
+
+        /// @brief Destroys the elements that were never popped. No thread may still be pushing.
+        ~MpscQueue()
+        {
+            T value;
+            while (Pop(value))
+            {
+            }
+            if (m_pTail != &m_stub)
+            {
+                delete m_pTail;
+            }
+        }
+
+        MpscQueue(const MpscQueue &) = delete;
+        MpscQueue &operator=(const MpscQueue &) = delete;
+
+        /// @brief Appends an element. May be called from any thread.
+        void Push(T value)
+        {
+            Node *pNode = new Node();
+            pNode->value = std::move(value);
+            Node *pPrev = m_pHead.exchange(pNode, std::memory_order_acq_rel);
+            pPrev->pNext.store(pNode, std::memory_order_release);
+        }
+
+        /// @brief Removes the oldest element. Only the consumer thread may call this.
+        /// @return False if the queue is empty.
+        bool Pop(T &value)
+        {
+            Node *pTail = m_pTail;
+            Node *pNext = pTail->pNext.load(std::memory_order_acquire);
+            if (!pNext)
+                return false;
+
+            // The popped node's successor becomes the new sentinel, so its value is moved out and left empty.
+            value = std::move(pNext->value);
+            m_pTail = pNext;
+            if (pTail != &m_stub)
+            {
+                delete pTail;
+            }
+            return true;
+        }
+
+    private:
+        struct Node
+        {
+            std::atomic<Node *> pNext{nullptr};
+            T value;
+        };
+
+        Node m_stub;
+
+        /// @brief The most recently pushed node, swapped by producers.
+        std::atomic<Node *> m_pHead;
+
+        /// @brief The sentinel before the oldest element; only touched by the consumer.
+        Node *m_pTail;
+    };
+} // namespace QNET
\ No newline at end of file
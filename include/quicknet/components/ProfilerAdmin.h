@@ -0,0 +1,66 @@
+#pragma once
+
+#include "quicknet/components/CpuProfiler.h"
+#include "quicknet/components/HeapProfiler.h"
+#include "quicknet/components/HttpServer.h"
+
+#include <cstdint>
+#include <string>
+
+namespace QNET
+{
+    /// @brief Settings for a ProfilerAdmin.
+    struct ProfilerAdminConfig
+    {
+        /// @brief Path prefix of the profiling routes.
+        std::string strPrefix = "/admin/profile";
+
+        /// @brief If set, requests must carry "Authorization: Bearer <token>". Profiles cost CPU time and reveal
+        /// symbol names, so set one unless the routes are on an internal listener.
+        std::string strBearerToken;
+
+        /// @brief Longest profile a request may ask for.
+        uint32_t nMaxSeconds = 60;
+
+        /// @brief Bulkhead the routes run on (see HttpServer::AddBulkhead()). A profile holds its worker for its
+        /// whole duration, so a small bulkhead keeps profiles from taking the workers of the other routes.
+        std::string strBulkhead;
+    };
+
+    /// @brief Serves on-demand profiles of the process over an HttpServer.
+    /// @details Registers these routes on an HttpServer (with the default prefix):
+    ///   - GET /admin/profile/cpu         samples the CPU for "seconds" (default 10) at "hz" (default 99) and answers
+    ///                                    with folded stacks as text/plain, ready for flamegraph.pl or speedscope
+    ///   - POST /admin/profile/heap/start starts the heap profiler, sampling every "interval" bytes (default 524288)
+    ///   - POST /admin/profile/heap/stop  stops it, keeping the profile readable
+    ///   - GET /admin/profile/heap        the top "limit" (default 20) allocation sites of the running or last heap
+    ///                                    profile by live bytes, as JSON, or as folded stacks of live bytes with
+    ///                                    "format=folded"
+    /// A CPU profile blocks the request for its duration. Only one profile of each kind runs at a time: a second
+    /// start gets 409, and builds without a profiler get 501. The CPU sample and drop counts are in the
+    /// X-Profile-Samples and X-Profile-Dropped headers.
+    ///
+    ///   curl -s 'http://host:8080/admin/profile/cpu?seconds=30' > cpu.folded && flamegraph.pl cpu.folded > cpu.svg
+    ///
+    /// The heap profiler may also be started by the application at startup with HeapProfiler::Start(), so that the
+    /// profile covers the allocations of the whole run.
+    class ProfilerAdmin
+    {
+    public:
+        /// @param http The HTTP server to register the routes on.
+        /// @param config The route prefix, authorization and limits.
+        explicit ProfilerAdmin(HttpServer &http, const ProfilerAdminConfig &config = ProfilerAdminConfig());
+
+        ProfilerAdmin(const ProfilerAdmin &) = delete;
+        ProfilerAdmin &operator=(const ProfilerAdmin &) = delete;
+
+    private:
+        void HandleCpu(const Request &req, Response &res);
+        void HandleHeapStart(const Request &req, Response &res);
+        void HandleHeapStop(const Request &req, Response &res);
+        void HandleHeap(const Request &req, Response &res);
+
+    private:
+        const ProfilerAdminConfig m_config;
+    };
+} // namespace QNET
\ No newline at end of file
@@ -0,0 +1,176 @@
+#pragma once
+
+#include "quicknet/components/HttpServer.h"
+#include "quicknet/components/MpscQueue.h"
+#include "quicknet/components/Server.h"
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace QNET
+{
+    /// @brief Settings for a PublishBridge.
+    struct PublishBridgeConfig
+    {
+        /// @brief Path prefix of the publish routes.
+        std::string strPrefix = "/publish";
+
+        /// @brief If set, requests must carry "Authorization: Bearer <token>".
+        std::string strBearerToken;
+
+        /// @brief Request bytes waiting for the network thread beyond which requests are refused with 503.
+        size_t cbMaxQueued = 64 * 1024 * 1024;
+
+        /// @brief Most messages one batch request may contain.
+        uint32 nMaxBatchMessages = 65536;
+    };
+
+    /// @brief Counters since the bridge was created.
+    struct PublishBridgeStats
+    {
+        uint64 nRequests = 0;
+
+        /// @brief Requests refused as malformed, unauthorized or over the queue limit.
+        uint64 nRejected = 0;
+
+        /// @brief Messages accepted from HTTP, and messages handed to GNS (one per recipient).
+        uint64 nMessagesQueued = 0;
+        uint64 nMessagesSent = 0;
+
+        /// @brief Sends that failed, or targeted connections that are not clients.
+        uint64 nMessagesFailed = 0;
+    };
+
+    /// @brief Publishes HTTP request bodies to the clients of a Server.
+    /// @details Registers these routes on an HttpServer (with the default prefix):
+    ///   - POST /publish/all                 the body goes to every client
+    ///   - POST /publish/group/:group        to every member of a group (see Server::JoinGroup())
+    ///   - POST /publish/connection/:id      to one client
+    ///   - POST /publish/batch               many messages with their own targets, see AppendToAll() and friends
+    /// A "reliable=0" query parameter sends the single-target routes unreliably. Accepted requests are answered
+    /// with 202 and {"queued": <messages>}.
+    ///
+    /// The request body is copied once into a reference-counted buffer and handed to the Server's network thread
+    /// through a lock-free queue, and every message sent from it (to any number of recipients) points into that
+    /// buffer instead of copying it. The network thread drains the queue from a Server tick handler, so the bridge
+    /// works with Server::Run() and with custom loops that call ReceiveMessages().
+    ///
+    /// Create the bridge before HttpServer::Run() and Server::Run(), and destroy it after both have returned.
+    class PublishBridge
+    {
+    public:
+        /// @param server The server whose clients receive the messages.
+        /// @param http The HTTP server to register the routes on.
+        /// @param config The route prefix, authorization and limits.
+        PublishBridge(Server &server, HttpServer &http, const PublishBridgeConfig &config = PublishBridgeConfig());
+
+        /// @brief Unregisters the tick handler and drops the messages that were not sent yet.
+        ~PublishBridge();
+
+        PublishBridge(const PublishBridge &) = delete;
+        PublishBridge &operator=(const PublishBridge &) = delete;
+
+        /// @brief Returns the counters. May be called from any thread.
+        PublishBridgeStats GetStats() const;
+
+        /// @brief Appends a message for every client to a batch request body.
+        /// @details A batch body is a sequence of records, all integers little-endian:
+        ///   u8 target (0 = all clients, 1 = group, 2 = connection), u8 flags (bit 0 = reliable),
+        ///   for a group: u16 name length and the name; for a connection: u32 connection handle,
+        ///   u32 payload length and the payload.
+        static void AppendToAll(std::vector<uint8_t> &byteBatch, const std::vector<uint8_t> &bytePayload,
+                                bool bReliable = true);
+
+        /// @brief Appends a message for every member of a group to a batch request body.
+        static void AppendToGroup(std::vector<uint8_t> &byteBatch, const std::string &strGroup,
+                                  const std::vector<uint8_t> &bytePayload, bool bReliable = true);
+
+        /// @brief Appends a message for one client to a batch request body.
+        static void AppendToConnection(std::vector<uint8_t> &byteBatch, HSteamNetConnection hConn,
+                                       const std::vector<uint8_t> &bytePayload, bool bReliable = true);
+
+    private:
+        enum class Target : uint8
+        {
+            All = 0,
+            Group = 1,
+            Connection = 2
+        };
+
+        /// @brief One message of a request, pointing into the request's payload buffer.
+        struct Record
+        {
+            Target eTarget = Target::All;
+            bool bReliable = true;
+            HSteamNetConnection hConn = k_HSteamNetConnection_Invalid;
+            std::string strGroup;
+            uint32 nOffset = 0;
+            uint32 cbSize = 0;
+        };
+
+        /// @brief A copy of a request body, freed when the network thread and every message sent from it are done
+        /// with it. Allocated with the body in the same block.
+        struct Payload
+        {
+            std::atomic<uint32> nRefs;
+            uint8 *pData;
+        };
+
+        /// @brief One accepted request, as queued for the network thread.
+        struct Publish
+        {
+            Payload *pPayload = nullptr;
+            size_t cbSize = 0;
+            std::vector<Record> vecRecords;
+        };
+
+        /// @brief Handles a single-target route.
+        void HandleSingle(const Request &req, Response &res, Target eTarget);
+
+        /// @brief Handles the batch route.
+        void HandleBatch(const Request &req, Response &res);
+
+        /// @brief HttpServer::CheckBearerToken() with the configured token, counting failures as rejections.
+        bool Authorize(const Request &req, Response &res);
+
+        /// @brief Copies the body and queues its records for the network thread, or responds with 503.
+        void Enqueue(const std::string &strBody, std::vector<Record> vecRecords, Response &res);
+
+        /// @brief Responds through HttpServer::RespondError() and counts the rejection.
+        void Reject(Response &res, int nStatus, const std::string &strMessage);
+
+        /// @brief Sends everything queued. Runs on the network thread.
+        void Drain();
+
+        /// @brief Sends one record to one connection without copying the payload.
+        void SendToConnection(Payload *pPayload, const Record &record, HSteamNetConnection hConn);
+
+        static Payload *CreatePayload(const std::string &strBody);
+        static void ReleasePayload(Payload *pPayload);
+
+        /// @brief m_pfnFreeData of the messages sent from a payload.
+        static void FreeMessageData(SteamNetworkingMessage_t *pMsg);
+
+        static void AppendHeader(std::vector<uint8_t> &byteBatch, Target eTarget, bool bReliable);
+        static void AppendPayload(std::vector<uint8_t> &byteBatch, const std::vector<uint8_t> &bytePayload);
+
+    private:
+        Server &m_server;
+        const PublishBridgeConfig m_config;
+        uint32 m_nTickHandlerId = 0;
+
+        MpscQueue<std::unique_ptr<Publish>> m_queue;
+
+        /// @brief Request bytes accepted but not yet drained.
+        std::atomic<size_t> m_cbQueued{0};
+
+        std::atomic<uint64> m_nRequests{0};
+        std::atomic<uint64> m_nRejected{0};
+        std::atomic<uint64> m_nMessagesQueued{0};
+        std::atomic<uint64> m_nMessagesSent{0};
+        std::atomic<uint64> m_nMessagesFailed{0};
+    };
+} // namespace QNET
\ No newline at end of file
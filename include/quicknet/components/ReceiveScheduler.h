@@ -0,0 +1,123 @@
+#pragma once
+
+#include "quicknet/components/Transport.h"
+
+#include <chrono>
+#include <functional>
+#include <unordered_map>
+#include <vector>
+
+namespace QNET
+{
+    /// @brief Limits on one receive pass (one ReceiveMessages() call).
+    struct ReceiveBudget
+    {
+        /// @brief Messages to dispatch per pass; 0 to drain every connection.
+        uint32 nMaxMessages = 0;
+
+        /// @brief Time a pass may take, including OnMessageReceived; 0 for no limit. Checked after every batch, so
+        /// a pass can overrun by one batch.
+        uint32 nMaxMicroseconds = 0;
+
+        /// @brief Messages a connection of weight 1 may dispatch per round before the next connection's turn.
+        uint32 nQuantum = 32;
+    };
+
+    /// @brief What the last receive pass did and what it left behind.
+    struct ReceiveStats
+    {
+        uint32 nMessages = 0;
+        uint64 cbBytes = 0;
+
+        /// @brief Round-robin rounds over the connections.
+        uint32 nRounds = 0;
+
+        /// @brief True if the pass stopped on its budget rather than because every connection was drained.
+        bool bBudgetExhausted = false;
+
+        /// @brief Connections that may still have messages queued: the ones the pass did not reach, or whose last
+        /// batch came back full. GNS does not expose the length of a receive queue, so this is an upper bound.
+        uint32 nBacklogConnections = 0;
+
+        /// @brief Backlog connections that stopped at their limit (see ReceiveScheduler::SetLimit()).
+        uint32 nThrottledConnections = 0;
+    };
+
+    /// @brief Drains connections in weighted round-robin order within a ReceiveBudget.
+    /// @details Each round gives every connection with messages left a batch of up to nQuantum times its weight.
+    /// A connection is done for the pass once a batch comes back short. When the budget runs out mid-round, the
+    /// next pass starts with the connection that was next in line, so a chatty connection cannot starve the ones
+    /// behind it even across passes.
+    class ReceiveScheduler
+    {
+    public:
+        using Clock = std::chrono::steady_clock;
+
+        /// @brief Handles one batch of a connection. Takes ownership of the messages and must release them.
+        using BatchHandler = std::function<void(HSteamNetConnection hConn, ISteamNetworkingMessage **ppMessages,
+                                                int nMessages)>;
+
+        void SetBudget(const ReceiveBudget &budget) { m_budget = budget; }
+        const ReceiveBudget &GetBudget() const { return m_budget; }
+
+        /// @brief Sets a connection's share of each round (default 1).
+        void SetWeight(HSteamNetConnection hConn, uint32 nWeight);
+
+        /// @brief Returns a connection's share of each round.
+        uint32 GetWeight(HSteamNetConnection hConn) const;
+
+        /// @brief Caps the messages a connection may dispatch per pass, whatever its weight; 0 removes the cap.
+        /// Messages beyond the cap stay queued in the transport until a later pass.
+        void SetLimit(HSteamNetConnection hConn, uint32 nMaxMessages);
+
+        /// @brief Returns a connection's cap, or 0 if it has none.
+        uint32 GetLimit(HSteamNetConnection hConn) const;
+
+        /// @brief Forgets a connection's weight and cap.
+        void Remove(HSteamNetConnection hConn)
+        {
+            m_mapWeights.erase(hConn);
+            m_mapLimits.erase(hConn);
+        }
+
+        /// @brief Runs one pass over the connections.
+        /// @param transport The transport to receive from.
+        /// @param vecConnections The connections to drain. Copied, so the handler may change the original.
+        /// @param fnHandler Invoked for every batch received.
+        /// @param nMaxMessages Caps the pass below the budget, e.g. to the room in a caller's buffer; 0 for no cap.
+        /// Reaching it counts as running out of budget.
+        /// @return What the pass did; also available from GetLastStats().
+        const ReceiveStats &Run(Transport &transport, const std::vector<HSteamNetConnection> &vecConnections,
+                                const BatchHandler &fnHandler, uint32 nMaxMessages = 0);
+
+        /// @brief Returns the stats of the last pass.
+        const ReceiveStats &GetLastStats() const { return m_lastStats; }
+
+    private:
+        /// @brief A connection still being drained in the current pass.
+        struct ActiveConnection
+        {
+            HSteamNetConnection hConn;
+
+            /// @brief Position in the caller's list.
+            size_t nPosition;
+
+            /// @brief Messages it may still dispatch this pass.
+            uint32 nLeft;
+        };
+
+    private:
+        ReceiveBudget m_budget;
+        ReceiveStats m_lastStats;
+        std::unordered_map<HSteamNetConnection, uint32> m_mapWeights;
+        std::unordered_map<HSteamNetConnection, uint32> m_mapLimits;
+
+        /// @brief Where the next pass starts in the connection list.
+        size_t m_nNextStart = 0;
+
+        /// @brief Scratch state, kept to avoid allocating on every pass: the connections still being drained and the
+        /// batch buffer.
+        std::vector<ActiveConnection> m_vecActive;
+        std::vector<ISteamNetworkingMessage *> m_vecBatch;
+    };
+} // namespace QNET
\ No newline at end of file
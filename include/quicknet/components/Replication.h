@@ -0,0 +1,338 @@
+#pragma once
+
+#include "quicknet/components/ConnectionManager.h"
+
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <type_traits>
+#include <vector>
+
+#include <steam/steamnetworkingsockets.h>
+
+namespace QNET
+{
+    /// @brief Identifier of a replicated entity. Entity ids are dense slot indices and are recycled after destruction.
+    using EntityId = uint32_t;
+
+    /// @brief Identifier of a replicated property, in registration order.
+    using PropertyId = uint8_t;
+
+    /// @brief Selects the send path used for a replicated property.
+    enum class PropertyClass : uint8_t
+    {
+        /// @brief Changes are delivered reliably and in order (e.g. inventory, health).
+        Reliable,
+        /// @brief Only the latest value matters; changes are sent unreliably (e.g. position, rotation).
+        Unreliable
+    };
+
+    /// @brief Limits the unreliable updates a ReplicationManager sends to each connection per Flush() to what the
+    /// connection's measured send rate can carry.
+    struct ReplicationBudget
+    {
+        /// @brief Share of the connection's estimated send rate that one Flush() may fill, for the time since the
+        /// previous Flush(). The rest is left for application messages.
+        float flRateFraction = 0.8f;
+
+        /// @brief Bytes a connection is allowed per Flush() even while its queue is full. The update with the highest
+        /// priority is sent on every Flush() regardless, so no entity starves.
+        uint32_t cbMinPerFlush = 0;
+
+        /// @brief Bytes per Flush() that are never exceeded, however high the estimate.
+        uint32_t cbMaxPerFlush = 256 * 1024;
+
+        /// @brief Longest time since the previous Flush() that is credited, so that a stalled tick does not turn
+        /// into a burst.
+        uint32_t nMaxIntervalMs = 100;
+    };
+
+    /// @brief Replicates entity state to connected peers by sending only the properties that changed.
+    /// @details Properties are registered once and stored as a structure of arrays: one contiguous column per
+    /// property, indexed by entity id. Every write that changes a value sets a bit in the entity's dirty mask.
+    /// Flush() is called at the end of a tick; it merges the dirty masks into each connection's pending masks
+    /// and serializes only the changed properties, split into one reliable and one unreliable message per
+    /// connection. The first state of an entity, and everything sent to a newly added connection, always goes on
+    /// the reliable path so that a peer never misses a baseline value. The receiving side feeds those messages to
+    /// ApplyMessage() on an instance with the same property registrations.
+    ///
+    /// Wire format (little-endian): [tag u8][PropertyClass u8] followed by records of [entity u32][generation u16]
+    /// [mask u64][property bytes...], where the property bytes are the values of the set mask bits in ascending
+    /// property order. A record with an empty mask announces that the entity was destroyed. The generation counts
+    /// the entities created in the id's slot, so that records of a destroyed entity are not applied to the one
+    /// that reuses its id: an unreliable update sent before a destruction can arrive after the reliable
+    /// destruction and re-creation. Only records of reliable messages create entities; unreliable records for an
+    /// entity that is not alive, or for another generation, are dropped.
+    ///
+    /// With EnableBandwidthBudget(), unreliable changes no longer all go out on the next Flush(). Each connection
+    /// keeps an accumulated priority per entity, which grows by the entity's SetPriority() value on every Flush()
+    /// the entity has unsent changes, and the highest priorities that fit the connection's byte budget are sent;
+    /// the rest stay pending and are sent later with their latest values. Baselines, reliable changes and
+    /// destructions are always sent, and count against the budget.
+    ///
+    /// Unreliable updates are not acknowledged, so Flush() also resends the unreliable properties of a slice of the
+    /// live entities every time, covering all of them every SetRefreshInterval() calls. A lost update is then
+    /// repaired within that many ticks.
+    class ReplicationManager
+    {
+    public:
+        /// @brief Maximum number of properties; one bit per property in a 64-bit dirty mask.
+        static constexpr size_t kMaxProperties = 64;
+
+        /// @brief Default first byte of every replication message, used to tell them apart from application messages.
+        static constexpr uint8_t kDefaultMessageTag = 0xA5;
+
+        /// @brief Messages are split once they grow past this size (well below the GNS send limit).
+        static constexpr size_t kMaxMessageBytes = 256 * 1024;
+
+        /// @brief Default number of Flush() calls over which every unreliable property is sent again (see
+        /// SetRefreshInterval()).
+        static constexpr uint32_t kDefaultRefreshFlushes = 60;
+
+        /// @brief Default limit on the entity ids ApplyMessage() accepts (see SetMaxEntities()).
+        static constexpr uint32_t kDefaultMaxEntities = 1u << 20;
+
+        /// @brief Constructs a replication manager that sends through the given connection manager.
+        /// @param connectionManager The Server (or Client) whose per-connection send path is used by Flush().
+        explicit ReplicationManager(ConnectionManager &connectionManager);
+
+        // Prevent copying and assignment
+        ReplicationManager(const ReplicationManager &) = delete;
+        ReplicationManager &operator=(const ReplicationManager &) = delete;
+
+        /// @brief Registers a fixed-size property column. All properties must be registered before entities are
+        /// replicated, and in the same order on both sides.
+        /// @param cbSize The size of the property value in bytes.
+        /// @param eClass Whether changes are sent reliably or unreliably.
+        /// @return The new property id, or kMaxProperties if the property could not be registered.
+        PropertyId RegisterProperty(uint32_t cbSize, PropertyClass eClass);
+
+        /// @brief Registers a property sized for the trivially copyable type T.
+        template <typename T> PropertyId RegisterProperty(PropertyClass eClass)
+        {
+            static_assert(std::is_trivially_copyable<T>::value, "Replicated properties must be trivially copyable");
+            return RegisterProperty(static_cast<uint32_t>(sizeof(T)), eClass);
+        }
+
+        /// @brief Creates a new entity with zero-initialized properties. Its full state is sent on the next Flush().
+        /// @return The id of the new entity.
+        EntityId CreateEntity();
+
+        /// @brief Destroys an entity. Connected peers are told about it reliably on the next Flush().
+        /// @param id The entity to destroy.
+        void DestroyEntity(EntityId id);
+
+        /// @brief Checks whether an entity id refers to a live entity.
+        bool IsAlive(EntityId id) const;
+
+        /// @brief Writes a property value from raw bytes. The dirty bit is only set if the value actually changed.
+        /// @param id The entity to modify.
+        /// @param prop The property to write.
+        /// @param pData Pointer to exactly the registered number of bytes.
+        /// @return True if the entity and property are valid, false otherwise.
+        bool SetRaw(EntityId id, PropertyId prop, const void *pData);
+
+        /// @brief Returns a pointer to the stored value of a property, or nullptr if the entity or property is invalid.
+        const void *GetRaw(EntityId id, PropertyId prop) const;
+
+        /// @brief Writes a typed property value. sizeof(T) must match the registered size.
+        template <typename T> bool Set(EntityId id, PropertyId prop, const T &value)
+        {
+            static_assert(std::is_trivially_copyable<T>::value, "Replicated properties must be trivially copyable");
+            if (prop >= m_vecProperties.size() || m_vecProperties[prop].cbSize != sizeof(T))
+                return false;
+            return SetRaw(id, prop, &value);
+        }
+
+        /// @brief Reads a typed property value, or a value-initialized T if the entity or property is invalid.
+        template <typename T> T Get(EntityId id, PropertyId prop) const
+        {
+            static_assert(std::is_trivially_copyable<T>::value, "Replicated properties must be trivially copyable");
+            T value{};
+            const void *pData = GetRaw(id, prop);
+            if (pData && m_vecProperties[prop].cbSize == sizeof(T))
+            {
+                std::memcpy(&value, pData, sizeof(T));
+            }
+            return value;
+        }
+
+        /// @brief Starts replicating to a connection. The full state of every live entity is sent on the next Flush().
+        /// @param hConn The connection handle (typically from Server::OnClientConnected).
+        void AddConnection(HSteamNetConnection hConn);
+
+        /// @brief Stops replicating to a connection and discards its pending state.
+        /// @param hConn The connection handle (typically from Server::OnClientDisconnected).
+        void RemoveConnection(HSteamNetConnection hConn);
+
+        /// @brief Sends all changes since the previous Flush() to every replicated connection and clears the dirty
+        /// masks. Call once at the end of each tick, on the network thread.
+        void Flush();
+
+        /// @brief Resends the unreliable properties of every live entity once per nFlushes calls to Flush(), a slice of
+        /// the entities each time, so a value whose update was lost does not stay stale until it changes again.
+        /// Defaults to kDefaultRefreshFlushes; 0 turns the refresh off.
+        void SetRefreshInterval(uint32_t nFlushes) { m_nRefreshFlushes = nFlushes; }
+
+        /// @brief Limits the unreliable updates per connection and Flush() to a share of the connection's measured
+        /// send rate, sending the entities with the highest accumulated priority first.
+        void EnableBandwidthBudget(const ReplicationBudget &budget = ReplicationBudget());
+
+        /// @brief Sends every change on the next Flush() again, the default.
+        void DisableBandwidthBudget() { m_bBudgetEnabled = false; }
+
+        /// @brief Sets how much an entity's accumulated priority grows on every Flush() that its unreliable changes
+        /// are held back by the budget. Defaults to 1 and is reset when the entity is destroyed.
+        /// @return True if the entity is alive and the priority is not negative.
+        bool SetPriority(EntityId id, float flPriority);
+
+        /// @brief Returns the number of entity updates the budget held back in the last Flush(), summed over the
+        /// connections.
+        size_t GetDeferredCount() const { return m_nDeferred; }
+
+        /// @brief Checks whether a received message was produced by a ReplicationManager.
+        bool IsReplicationMessage(const std::vector<uint8_t> &byteMessage) const;
+
+        /// @brief Applies a received replication message, creating entities as needed. Unreliable updates for
+        /// entities that are not alive, or for an earlier entity with the same id, are skipped, since they arrived
+        /// after the destruction or before the baseline.
+        /// @param byteMessage The message content, as passed to OnMessageReceived.
+        /// @return True if the whole message was decoded, false if it was malformed, not a replication message, or
+        /// named an entity id at or above the SetMaxEntities() limit.
+        bool ApplyMessage(const std::vector<uint8_t> &byteMessage);
+
+        /// @brief Limits the entity ids ApplyMessage() accepts, since every id sizes the property columns. Must be
+        /// above the highest id the sender uses. Defaults to kDefaultMaxEntities.
+        void SetMaxEntities(uint32_t nMaxEntities) { m_nMaxEntities = nMaxEntities; }
+
+        /// @brief Changes the first byte used to identify replication messages. Must match on both sides.
+        void SetMessageTag(uint8_t nTag) { m_nMessageTag = nTag; }
+
+    public:
+        /// @brief Callback invoked by ApplyMessage() for every property value that was received.
+        std::function<void(EntityId, PropertyId)> OnPropertyReceived;
+
+        /// @brief Callback invoked by ApplyMessage() when the sender destroyed an entity.
+        std::function<void(EntityId)> OnEntityDestroyed;
+
+    private:
+        /// @brief Storage and metadata for one property: one value per entity slot.
+        struct PropertyColumn
+        {
+            uint32_t cbSize;
+            PropertyClass eClass;
+            std::vector<uint8_t> vecData;
+        };
+
+        /// @brief Replication state kept for every connection.
+        struct ConnectionState
+        {
+            HSteamNetConnection hConn;
+            std::vector<uint64_t> vecPending;
+            bool bInitial;
+
+            /// @brief Per-entity accumulated priorities; only kept while the budget is enabled.
+            std::vector<float> vecAccumulated;
+        };
+
+        /// @brief An entity destroyed since the previous Flush(), with the generation its destruction names, since
+        /// the slot may be reused before the Flush().
+        struct DestroyedEntity
+        {
+            EntityId id;
+            uint16_t nGeneration;
+        };
+
+        /// @brief An entity with unsent unreliable changes, competing for a connection's budget.
+        struct BudgetCandidate
+        {
+            EntityId id;
+            uint32_t cbRecord;
+            float flPriority;
+        };
+
+        /// @brief Grows every per-entity array so that id is a valid slot.
+        void EnsureCapacity(EntityId id);
+
+        /// @brief Destroys an entity whose destruction was received, or which a newer generation replaces.
+        void DestroyReceived(EntityId id);
+
+        /// @brief Returns a mask with one bit set for every registered property.
+        uint64_t AllPropertiesMask() const;
+
+        /// @brief Appends one entity record containing the properties in nMask to byteMessage.
+        void WriteRecord(std::vector<uint8_t> &byteMessage, EntityId id, uint64_t nMask) const;
+
+        /// @brief Returns the size of the record WriteRecord() writes for nMask.
+        size_t GetRecordSize(uint64_t nMask) const;
+
+        /// @brief Returns the unreliable bytes a connection may be sent by this Flush().
+        size_t GetBudget(HSteamNetConnection hConn, SteamNetworkingMicroseconds usecInterval);
+
+        /// @brief Writes the records of the highest-priority candidates that fit cbBudget and clears their pending
+        /// masks and accumulated priorities.
+        void SendWithinBudget(ConnectionState &state, size_t cbBudget);
+
+        /// @brief Sends byteMessage if it contains any records and resets it to just the message header.
+        void SendAndReset(HSteamNetConnection hConn, std::vector<uint8_t> &byteMessage, PropertyClass eClass);
+
+        /// @brief Sets byteMessage to the header of a message of eClass.
+        void ResetMessage(std::vector<uint8_t> &byteMessage, PropertyClass eClass) const;
+
+    private:
+        /// @brief The connection manager whose send path is used.
+        ConnectionManager &m_connectionManager;
+
+        /// @brief One column per registered property.
+        std::vector<PropertyColumn> m_vecProperties;
+
+        /// @brief Bit set for every property registered as PropertyClass::Reliable.
+        uint64_t m_nReliableMask = 0;
+
+        /// @brief Per-entity dirty masks, indexed by entity id.
+        std::vector<uint64_t> m_vecDirty;
+
+        /// @brief Per-entity liveness flags, indexed by entity id.
+        std::vector<uint8_t> m_vecAlive;
+
+        /// @brief Per-entity flags for entities created since the previous Flush(), indexed by entity id.
+        std::vector<uint8_t> m_vecSpawned;
+
+        /// @brief Per-entity priorities for the budget, indexed by entity id.
+        std::vector<float> m_vecPriority;
+
+        /// @brief Per-slot generations, indexed by entity id: incremented by every CreateEntity() that uses the slot,
+        /// and taken from the records on the receiving side. Wraps around after 65536 reuses of one slot.
+        std::vector<uint16_t> m_vecGeneration;
+
+        /// @brief Recycled entity ids.
+        std::vector<EntityId> m_vecFreeIds;
+
+        /// @brief Entities destroyed since the previous Flush().
+        std::vector<DestroyedEntity> m_vecDestroyed;
+
+        /// @brief Per-connection pending masks.
+        std::vector<ConnectionState> m_vecConnections;
+
+        /// @brief Scratch buffers reused across Flush() calls.
+        std::vector<uint8_t> m_vecReliableScratch;
+        std::vector<uint8_t> m_vecUnreliableScratch;
+        std::vector<BudgetCandidate> m_vecCandidates;
+
+        /// @brief The bandwidth budget, used while m_bBudgetEnabled is set.
+        ReplicationBudget m_budget;
+        bool m_bBudgetEnabled = false;
+        SteamNetworkingMicroseconds m_usecLastFlush = 0;
+        size_t m_nDeferred = 0;
+
+        /// @brief First byte of every replication message.
+        uint8_t m_nMessageTag = kDefaultMessageTag;
+
+        /// @brief Flush() calls per refresh of every entity, and the first entity of the next slice.
+        uint32_t m_nRefreshFlushes = kDefaultRefreshFlushes;
+        size_t m_nRefreshCursor = 0;
+
+        /// @brief Received entity ids must be below this.
+        uint32_t m_nMaxEntities = kDefaultMaxEntities;
+    };
+} // namespace QNET
\ No newline at end of file
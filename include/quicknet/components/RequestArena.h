@@ -0,0 +1,106 @@
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <memory_resource>
+
+namespace QNET
+{
+    /// @brief A monotonic memory resource for the temporary data of one request.
+    /// @details Allocations bump a pointer through a block owned by the arena; deallocation does nothing, and
+    /// Reset() makes the whole block available again. Requests that outgrow the block get overflow blocks from the
+    /// upstream resource, which Reset() frees, and the block is then grown to fit them (up to cbMaxRetained), so
+    /// after a warm-up a worker serves its requests without calling malloc. Not thread-safe: each worker thread
+    /// has its own.
+    ///
+    /// HttpServer makes its worker's arena current for the duration of each route handler:
+    ///   server.Get("/api/items", [](const QNET::Request &req, QNET::Response &res) {
+    ///       std::pmr::memory_resource *pArena = QNET::RequestArena::Resource();
+    ///       std::pmr::vector<int> vecIds(pArena);
+    ///       std::pmr::string strBody(pArena);
+    ///       ...
+    ///       res.set_content(strBody.data(), strBody.size(), "application/json");
+    ///   });
+    /// The memory is released when the handler returns, so nothing allocated from it may be kept past that.
+    /// Response bodies are copied into the response, so building them in the arena is safe.
+    class RequestArena : public std::pmr::memory_resource
+    {
+    public:
+        /// @param cbInitialSize Size of the block allocated up front.
+        /// @param cbMaxRetained Largest the block grows to; requests needing more use overflow blocks every time.
+        /// @param pUpstream Where the block and overflow blocks come from.
+        explicit RequestArena(size_t cbInitialSize = 64 * 1024, size_t cbMaxRetained = 1024 * 1024,
+                              std::pmr::memory_resource *pUpstream = std::pmr::new_delete_resource());
+
+        ~RequestArena() override;
+
+        RequestArena(const RequestArena &) = delete;
+        RequestArena &operator=(const RequestArena &) = delete;
+
+        /// @brief Releases everything allocated since the last reset, and grows the block if it overflowed.
+        void Reset();
+
+        /// @brief Returns the bytes handed out since the last reset, including overflow.
+        size_t GetBytesUsed() const { return m_cbUsed + m_cbOverflowUsed; }
+
+        /// @brief Returns the size of the block reused by every request.
+        size_t GetCapacity() const { return m_cbBlock; }
+
+        /// @brief Returns the number of overflow blocks allocated over the arena's lifetime; a count that keeps
+        /// growing means requests regularly need more than cbMaxRetained.
+        size_t GetOverflowCount() const { return m_nOverflowCount; }
+
+        /// @brief Returns the arena of the request the calling thread is serving, or nullptr outside a handler.
+        static RequestArena *Current();
+
+        /// @brief Returns Current(), or the default memory resource outside a handler, so code shared with other
+        /// callers can always allocate from it.
+        static std::pmr::memory_resource *Resource();
+
+        /// @brief Makes an arena current on the calling thread, and resets it when the scope ends. Scopes may
+        /// nest; the arena is only reset when the outermost scope using it ends.
+        class Scope
+        {
+        public:
+            explicit Scope(RequestArena *pArena);
+            ~Scope();
+
+            Scope(const Scope &) = delete;
+            Scope &operator=(const Scope &) = delete;
+
+        private:
+            RequestArena *m_pArena;
+            RequestArena *m_pPrevious;
+        };
+
+    protected:
+        void *do_allocate(size_t cbSize, size_t cbAlignment) override;
+        void do_deallocate(void *, size_t, size_t) override {}
+        bool do_is_equal(const std::pmr::memory_resource &other) const noexcept override { return this == &other; }
+
+    private:
+        /// @brief Header of an overflow block; the blocks form a list freed by Reset().
+        struct OverflowBlock
+        {
+            OverflowBlock *pNext;
+            size_t cbSize;
+            size_t nAlignment;
+        };
+
+        void AllocateBlock(size_t cbSize);
+
+    private:
+        std::pmr::memory_resource *const m_pUpstream;
+        const size_t m_cbMaxRetained;
+
+        char *m_pBlock = nullptr;
+        size_t m_cbBlock = 0;
+        size_t m_cbUsed = 0;
+
+        /// @brief Newest overflow block first, and the bytes taken from the newest one.
+        OverflowBlock *m_pOverflow = nullptr;
+        size_t m_cbOverflowOffset = 0;
+        size_t m_cbOverflowUsed = 0;
+        size_t m_nOverflowCount = 0;
+    };
+} // namespace QNET
\ No newline at end of file
@@ -1,19 +1,52 @@
 #pragma once
 
+#include "quicknet/components/Authenticator.h"
+#include "quicknet/components/ConnectionAccounting.h"
 #include "quicknet/components/ConnectionManager.h"
+#include "quicknet/components/FlightRecorder.h"
 
 #include <functional>
+#include <memory>
 #include <string>
+#include <unordered_map>
+#include <utility>
 #include <vector>
 
 namespace QNET
 {
+    class SessionHandoff;
+
+    /// @brief What a Server keeps about a connection from the time it is connected until it goes away.
+    struct ConnectionRecord
+    {
+        /// @brief When the connection reached the Connected state, on the transport's clock.
+        SteamNetworkingMicroseconds usecConnected = 0;
+
+        /// @brief The GNS connection description, which includes the remote address.
+        std::string strDescription;
+
+        /// @brief What the client authenticated as (AuthResult::strIdentity); empty without authentication. Set
+        /// before OnClientConnected is invoked, and carried over when a session is handed off.
+        std::string strIdentity;
+
+        /// @brief Payload bytes and messages dispatched from the connection since it became a client.
+        uint64 cbReceived = 0;
+        uint64 nMessagesReceived = 0;
+
+        /// @brief Set once the connection's first message was handled, or it authenticated or resumed a session.
+        /// Only a connection without it may present a resume hello (see SessionHandoff).
+        bool bPastHello = false;
+    };
+
     /// @brief Manages the server-side network operations, including listening for client connections.
     /// This class handles starting and stopping the server, broadcasting messages to clients,
     /// and managing connected clients. It inherits from ConnectionManager.
     class Server : public ConnectionManager
     {
     public:
+        /// @brief Uses GameNetworkingSockets, or a caller-owned Transport such as a SimTransport.
+        using ConnectionManager::ConnectionManager;
+
         /// @brief Starts the server and begins listening for incoming connections on the specified port.
         /// @param nPort The port number to listen on.
         /// @return True if the server started successfully and is listening, false otherwise.
@@ -35,9 +68,142 @@ namespace QNET
         void BroadcastUnreliableMessage(const std::vector<uint8_t> &byteMessage);
 
         /// @brief Receives and processes pending messages from all connected clients.
-        /// This method should be called regularly to handle incoming data.
+        /// This method should be called regularly to handle incoming data. Clients are drained in weighted
+        /// round-robin batches until they are empty or the receive budget runs out (see SetReceiveBudget() and
+        /// GetLastReceiveStats()).
         void ReceiveMessages();
 
+        /// @brief Receives like ReceiveMessages(), but hands the messages to the caller instead of invoking
+        /// OnMessageReceived, so an application can process them in batches of its own (e.g. sorted by type).
+        /// @details Authentication, resume hellos, weights, throttles, the receive budget and accounting apply as in
+        /// ReceiveMessages(); resume hellos and empty messages are consumed and not returned. Each message's m_conn
+        /// is the client it came from, and m_pData and m_cbSize its payload. The caller owns the returned messages
+        /// and must Release() each of them. Messages that do not fit, such as those held while a client
+        /// authenticated, are returned by the next call. Tick handlers do not run and the flight recorder does not
+        /// record a tick; call RunTickHandlers() once per tick. Call on the network thread.
+        /// @param ppOutMessages Receives up to nMaxMessages messages.
+        /// @param nMaxMessages The size of ppOutMessages.
+        /// @return The number of messages stored in ppOutMessages.
+        int ReceiveBatch(ISteamNetworkingMessage **ppOutMessages, int nMaxMessages);
+
+        /// @brief Calls the functions registered with AddTickHandler(). ReceiveMessages() calls it after dispatching;
+        /// applications receiving with ReceiveBatch() call it once per tick.
+        void RunTickHandlers();
+
+        /// @brief Gives a client a larger share of each receive round, e.g. for a relay or a trusted peer.
+        /// @param hConn The client's connection.
+        /// @param nWeight Batches of ReceiveBudget::nQuantum messages per round; 1 (the default) to reset.
+        void SetConnectionWeight(HSteamNetConnection hConn, uint32 nWeight);
+
+        /// @brief Caps how many of a client's messages one ReceiveMessages() call dispatches, regardless of its
+        /// weight. Messages beyond the cap stay queued in GNS for later calls.
+        /// @param hConn The client's connection.
+        /// @param nMaxMessages Messages per call; 0 to remove the cap.
+        void ThrottleConnection(HSteamNetConnection hConn, uint32 nMaxMessages);
+
+        /// @brief Returns a client's weight set with SetConnectionWeight().
+        uint32 GetConnectionWeight(HSteamNetConnection hConn) const { return m_receiveScheduler.GetWeight(hConn); }
+
+        /// @brief Returns a client's cap set with ThrottleConnection(), or 0 if it has none.
+        uint32 GetConnectionThrottle(HSteamNetConnection hConn) const { return m_receiveScheduler.GetLimit(hConn); }
+
+        /// @brief Closes a client or a connection that is still authenticating. Unlike a disconnect by the peer,
+        /// this happens right away: the connection is removed from the client list and its groups, and
+        /// OnClientDisconnected is invoked, before the call returns. Reliable messages already sent are still
+        /// flushed to the peer.
+        /// @param hConn The connection to close.
+        /// @param nReason The end reason the peer sees, between k_ESteamNetConnectionEnd_App_Min and _App_Max.
+        /// @param strDebug The debug text the peer sees.
+        /// @return False if the connection is neither a client nor authenticating.
+        bool DisconnectClient(HSteamNetConnection hConn, int nReason = k_ESteamNetConnectionEnd_App_Generic,
+                              const std::string &strDebug = "");
+
+        /// @brief Requires every client to present a token before it is added to the client list.
+        /// @details Connections are still accepted right away, but they only become clients (and OnClientConnected
+        /// only fires) once their token has been verified. The token is taken from the remote identity if it is a
+        /// generic string, and otherwise from the first message the client sends (see Client::SetAuthToken()).
+        /// Verification runs on the Authenticator's worker pool; connections that are rejected or do not present a
+        /// token within config.nHandshakeTimeoutMs are closed with Authenticator::kEndReasonAuthFailed.
+        /// Call before Initialize().
+        /// @param config The authentication settings.
+        /// @param verifier Custom token verification; HMAC-SHA256 with config.strSecret if unset.
+        /// @return True on success, false if the network interface is not available.
+        bool EnableAuthentication(const AuthConfig &config, TokenVerifier verifier = TokenVerifier());
+
+        /// @brief Starts attributing receive and dispatch time, bytes and messages to each client.
+        /// @details ReceiveMessages() reads the clock before and after dispatching each batch of a client's
+        /// messages, so the time includes the client's OnMessageReceived calls. The cost is two clock reads and one
+        /// table update per batch; clients without messages cost nothing.
+        /// Call before Run().
+        /// @param nWindowSeconds Length of the sliding window GetTopConnections() reports on.
+        void EnableConnectionAccounting(uint32 nWindowSeconds = 10);
+
+        /// @brief Returns the clients that used the most over the accounting window, heaviest first.
+        /// @details May be called from any thread. Clients that disconnected during the window are still reported.
+        /// @param nCount Maximum number of connections to return.
+        /// @param eSortBy What to rank the connections by.
+        /// @return The heaviest connections, or an empty list if accounting is not enabled.
+        std::vector<ConnectionUsage> GetTopConnections(
+            size_t nCount, ConnectionAccounting::SortBy eSortBy = ConnectionAccounting::SortBy::Time) const;
+
+        /// @brief Starts recording the metrics of every ReceiveMessages() call in a ring, dumped to a file when a call
+        /// is slower than config.nThresholdMicroseconds or on FlightRecorder::RequestDump().
+        /// @details Each tick records its duration, dispatch time, messages, bytes, client counts, receive backlog
+        /// and the few connections with the most dispatch time, with their ping and send queue. Dispatch is timed
+        /// per batch as for connection accounting, and the link status is read only for those few connections.
+        /// Call before Run().
+        /// @param config The ring size, threshold and dump location.
+        /// @return The recorder, e.g. to set FlightRecorder::OnDump.
+        FlightRecorder &EnableFlightRecorder(const FlightRecorderConfig &config = FlightRecorderConfig());
+
+        /// @brief Returns the recorder set up by EnableFlightRecorder(), or nullptr.
+        FlightRecorder *GetFlightRecorder() const { return m_pFlightRecorder.get(); }
+
+        /// @brief Returns the connected clients (authenticated, if authentication is required).
+        const std::vector<HSteamNetConnection> &GetClients() const { return m_vecClients; }
+
+        /// @brief Returns true if the connection is in the client list (connected and, if required, authenticated).
+        bool IsClient(HSteamNetConnection hConn) const;
+
+        /// @brief Returns the record of every connected connection, clients and those still authenticating.
+        /// Call from the network thread.
+        const std::unordered_map<HSteamNetConnection, ConnectionRecord> &GetConnectionRecords() const
+        {
+            return m_mapConnectionRecords;
+        }
+
+        /// @brief Adds a client to a named group, e.g. a match or a chat channel. Groups exist while they have
+        /// members; clients leave all their groups when they disconnect.
+        /// @param hConn The client's connection.
+        /// @param strGroup The group name.
+        /// @return False if the connection is not a client.
+        bool JoinGroup(HSteamNetConnection hConn, const std::string &strGroup);
+
+        /// @brief Removes a client from a group.
+        void LeaveGroup(HSteamNetConnection hConn, const std::string &strGroup);
+
+        /// @brief Returns the members of a group, in the order they joined; empty if the group does not exist.
+        const std::vector<HSteamNetConnection> &GetGroupMembers(const std::string &strGroup) const;
+
+        /// @brief Returns the groups of a client, in the order it joined them.
+        const std::vector<std::string> &GetClientGroups(HSteamNetConnection hConn) const;
+
+        /// @brief Lets connections resume sessions handed off by another process, or stops it with nullptr.
+        /// @details Called by the SessionHandoff constructor and destructor. A connection whose first message is a
+        /// resume hello (see SessionHandoff::MakeResumeHello()) then takes over the session of its token, in place
+        /// of authenticating, and the hello is not dispatched.
+        void SetSessionHandoff(SessionHandoff *pHandoff) { m_pSessionHandoff = pHandoff; }
+
+        /// @brief Registers a function that ReceiveMessages() calls on the network thread after dispatching, e.g. to
+        /// drain work handed over from other threads.
+        /// @param fnHandler The function to call.
+        /// @return An id for RemoveTickHandler().
+        uint32 AddTickHandler(std::function<void()> fnHandler);
+
+        /// @brief Unregisters a function added with AddTickHandler(). Call from the network thread or while the
+        /// server is not running.
+        void RemoveTickHandler(uint32 nHandlerId);
+
     public:
         /// @brief Callback function invoked when a message is received from a client.
         /// Assign a function to this member to handle incoming messages.
@@ -45,6 +211,12 @@ namespace QNET
         /// const std::string& (the message content) as parameters.
         std::function<void(HSteamNetConnection, const std::vector<uint8_t> &)> OnMessageReceived;
 
+        /// @brief Callback function invoked when a client has finished connecting and was added to the client list.
+        std::function<void(HSteamNetConnection)> OnClientConnected;
+
+        /// @brief Callback function invoked when a client has disconnected and was removed from the client list.
+        std::function<void(HSteamNetConnection)> OnClientDisconnected;
+
     protected:
         /// @brief Handles connection status changes for the server.
         /// Overrides the base class method to manage server-specific connection events,
@@ -52,15 +224,90 @@ namespace QNET
         /// @param pInfo Pointer to the SteamNetConnectionStatusChangedCallback_t structure.
         virtual void HandleConnectionStatusChanged(SteamNetConnectionStatusChangedCallback_t *pInfo) override;
 
+    private:
+        /// @brief A connection that has been accepted but has not authenticated yet.
+        struct PendingClient
+        {
+            /// @brief When the connection reached the Connected state.
+            SteamNetworkingMicroseconds usecConnected;
+
+            /// @brief True once a token has been handed to the authenticator.
+            bool bSubmitted;
+
+            /// @brief Messages that arrived after the token, delivered once the client is accepted.
+            std::vector<ISteamNetworkingMessage *> vecHeld;
+        };
+
+        /// @brief Adds a connection to the client list and invokes OnClientConnected.
+        void AddClient(HSteamNetConnection hConn);
+
+        /// @brief Invokes OnMessageReceived for one batch of a client's messages and releases them, or collects them
+        /// for ReceiveBatch().
+        void DispatchMessages(HSteamNetConnection hConn, ISteamNetworkingMessage **ppMsgs, int nMsgs);
+
+        /// @brief Invokes OnMessageReceived for a client's message and releases it, or collects it for ReceiveBatch().
+        void DeliverMessage(HSteamNetConnection hConn, ISteamNetworkingMessage *pMsg);
+
+        /// @brief Collects tokens from pending connections, applies verdicts and closes timed-out handshakes.
+        void ProcessAuthentication();
+
+        /// @brief Resumes the session of a resume hello on a client or a pending connection, or closes the connection
+        /// with SessionHandoff::kEndReasonResumeRejected if its token is not known.
+        /// @return False if the message is not a resume hello.
+        bool ResumeSession(HSteamNetConnection hConn, const ISteamNetworkingMessage *pMsg);
+
+        /// @brief Releases the held messages of a pending connection.
+        void ReleaseHeldMessages(PendingClient &pending);
+
+        /// @brief Removes a departing client from every group it joined.
+        void LeaveAllGroups(HSteamNetConnection hConn);
+
     private:
         /// @brief Handle to the listen socket used by the server.
         /// k_HSteamListenSocket_Invalid if the server is not listening.
-        HSteamListenSocket m_hListenSocket;
+        HSteamListenSocket m_hListenSocket = k_HSteamListenSocket_Invalid;
 
         /// @brief Vector storing the connection handles of all currently connected clients.
         std::vector<HSteamNetConnection> m_vecClients;
 
         /// @brief Flag indicating whether the ServerManager is currently running.
         bool m_isRunning = false;
+
+        /// @brief Token verifier, set by EnableAuthentication().
+        std::unique_ptr<Authenticator> m_pAuthenticator;
+
+        /// @brief Connections waiting for their token to be verified.
+        std::unordered_map<HSteamNetConnection, PendingClient> m_mapPendingClients;
+
+        /// @brief Poll group holding the pending connections, so their first messages are read with a single call.
+        HSteamNetPollGroup m_hPendingPollGroup = k_HSteamNetPollGroup_Invalid;
+
+        /// @brief Per-connection usage, set by EnableConnectionAccounting().
+        std::unique_ptr<ConnectionAccounting> m_pAccounting;
+
+        /// @brief Per-tick metrics, set by EnableFlightRecorder().
+        std::unique_ptr<FlightRecorder> m_pFlightRecorder;
+
+        /// @brief Scratch buffer for verdicts drained from the authenticator.
+        std::vector<AuthResult> m_vecAuthResults;
+
+        /// @brief Records of the connected connections, see GetConnectionRecords().
+        std::unordered_map<HSteamNetConnection, ConnectionRecord> m_mapConnectionRecords;
+
+        /// @brief Members of each group, and the groups of each member.
+        std::unordered_map<std::string, std::vector<HSteamNetConnection>> m_mapGroups;
+        std::unordered_map<HSteamNetConnection, std::vector<std::string>> m_mapClientGroups;
+
+        /// @brief Sessions handed off by another process, set by SessionHandoff.
+        SessionHandoff *m_pSessionHandoff = nullptr;
+
+        /// @brief Set while ReceiveBatch() receives; messages are then collected into m_vecCollected instead of
+        /// dispatched. Messages left there are returned by the next call.
+        bool m_bCollecting = false;
+        std::vector<ISteamNetworkingMessage *> m_vecCollected;
+
+        /// @brief Functions registered with AddTickHandler(), by id.
+        std::vector<std::pair<uint32, std::function<void()>>> m_vecTickHandlers;
+        uint32 m_nNextTickHandlerId = 1;
     };
 } // namespace QNET
\ No newline at end of file
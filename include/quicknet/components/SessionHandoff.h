@@ -0,0 +1,171 @@
+#pragma once
+
+#include <steam/steamnetworkingtypes.h>
+
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace QNET
+{
+    class HttpServer;
+    class Server;
+
+    /// @brief Settings of a SessionHandoff.
+    struct SessionHandoffConfig
+    {
+        /// @brief Path prefix of the route that receives sessions (see SessionHandoff::ServeHandoff()).
+        std::string strPrefix = "/admin/handoff";
+
+        /// @brief The old process sends "Authorization: Bearer <token>" with the sessions, and the new one only
+        /// accepts sessions that carry it. Both processes need the same value; ServeHandoff() refuses to run without
+        /// one, since a forged session makes its bearer a client without authentication.
+        std::string strBearerToken;
+
+        /// @brief How long a received session waits for its client. Clients that come later are rejected and
+        /// reconnect from scratch.
+        uint32 nResumeTimeoutMs = 60000;
+
+        /// @brief Sessions per request when sending; bounds the memory either side holds for one request.
+        uint32 nBatchSize = 1000;
+
+        /// @brief How long the old process waits for each request to be answered.
+        uint32 nRequestTimeoutMs = 10000;
+    };
+
+    /// @brief What a Server carries of a client from one process to the next.
+    struct SessionState
+    {
+        /// @brief The groups the client was in, in the order it joined them.
+        std::vector<std::string> vecGroups;
+
+        /// @brief What the client authenticated as, see ConnectionRecord::strIdentity.
+        std::string strIdentity;
+
+        /// @brief The settings of Server::SetConnectionWeight() and Server::ThrottleConnection().
+        uint32 nWeight = 1;
+        uint32 nThrottle = 0;
+
+        /// @brief The application's state of the client, from SessionHandoff::OnExportSession.
+        std::vector<uint8_t> vecAppState;
+    };
+
+    /// @brief Moves the clients of a Server to a Server in another process without making them start over, so a
+    /// new build can be deployed without a reconnect and resync storm.
+    /// @details Both processes create a SessionHandoff for their Server. The new process listens on another port
+    /// and calls ServeHandoff() on its admin HttpServer; then the old process calls HandOff(), which:
+    ///   1. gives every client a random resume token and collects its SessionState, with the application's part
+    ///      from OnExportSession;
+    ///   2. sends the sessions in batches to the new process over HTTP, e.g. on the loopback interface, which keeps
+    ///      them for SessionHandoffConfig::nResumeTimeoutMs;
+    ///   3. once every batch was accepted, closes each client with kEndReasonHandoff and a debug text that names the
+    ///      new address and the client's token.
+    /// A Client closed this way connects to the new address and sends its token as the first message, in place of
+    /// an authentication token. The new Server makes it a client without authenticating it, restores its identity,
+    /// groups, weight and throttle, and invokes OnSessionResumed with the state; no other message of the client is
+    /// dispatched before that. A token that is unknown, expired or used twice closes the connection with
+    /// kEndReasonResumeRejected, which the client reports through Client::OnDisconnected as any other disconnect.
+    ///
+    /// If a batch is refused, HandOff() fails and closes nobody, so the old process keeps serving. Connections
+    /// still authenticating are not handed off, and messages that were on their way to the old process when it closed
+    /// a client are lost with that connection.
+    ///
+    /// Create before Server::Run() and HttpServer::Run(), and destroy after both have returned.
+    class SessionHandoff
+    {
+    public:
+        /// @brief End reason of clients closed by HandOff().
+        static constexpr int kEndReasonHandoff = k_ESteamNetConnectionEnd_App_Min + 3;
+
+        /// @brief End reason of connections whose resume token was not accepted.
+        static constexpr int kEndReasonResumeRejected = k_ESteamNetConnectionEnd_App_Min + 4;
+
+        /// @brief Sends one batch of serialized sessions to the new process; returns false, with the reason in
+        /// pstrError, if it was not accepted.
+        using BatchSender = std::function<bool(const std::string &strBatch, std::string *pstrError)>;
+
+        /// @brief Lets the server resume the sessions this handoff receives.
+        /// @param server The server whose clients are handed off or resumed.
+        /// @param config The route, authorization, timeouts and batch size.
+        explicit SessionHandoff(Server &server, const SessionHandoffConfig &config = SessionHandoffConfig());
+
+        /// @brief Stops the server from resuming sessions. Sessions not resumed yet are dropped.
+        ~SessionHandoff();
+
+        SessionHandoff(const SessionHandoff &) = delete;
+        SessionHandoff &operator=(const SessionHandoff &) = delete;
+
+        /// @brief Registers POST {prefix}/sessions, which takes a batch of sessions and answers {"accepted": n}.
+        /// Called in the new process.
+        /// @return False, without registering the route, if no bearer token is configured.
+        bool ServeHandoff(HttpServer &http);
+
+        /// @brief Keeps the sessions of a batch for their clients. May be called from any thread.
+        /// @return The number of sessions, or -1 if the batch is malformed; then none of it is kept.
+        int64_t ImportSessions(const std::string &strBatch);
+
+        /// @brief Returns the number of received sessions still waiting for their client.
+        size_t GetPendingCount();
+
+        /// @brief Hands every client off to the process serving handoffs at strTargetUrl. Call on the network
+        /// thread; it blocks while the sessions are sent.
+        /// @param strTargetUrl The new process's HTTP server, e.g. "http://127.0.0.1:8081".
+        /// @param strReconnectAddress The address the clients connect to, e.g. "127.0.0.1:27021".
+        /// @param pstrError If not null, receives the reason on failure.
+        /// @return False if the address is too long or a batch was refused; no client was closed then.
+        bool HandOff(const std::string &strTargetUrl, const std::string &strReconnectAddress,
+                     std::string *pstrError = nullptr);
+
+        /// @brief Hands every client off, sending the sessions through another channel, e.g. a pipe or a test.
+        bool HandOff(const BatchSender &fnSend, const std::string &strReconnectAddress,
+                     std::string *pstrError = nullptr);
+
+        /// @brief Returns the first message a client sends to resume the session of strToken.
+        static std::vector<uint8_t> MakeResumeHello(const std::string &strToken);
+
+        /// @brief Reads the token of a resume hello; returns false if the message is not one.
+        static bool ParseResumeHello(const void *pData, uint32 cbSize, std::string &strToken);
+
+        /// @brief Reads the address and token from the debug text of a connection closed with kEndReasonHandoff.
+        static bool ParseHandoffNotice(const char *pszDebug, std::string &strAddress, std::string &strToken);
+
+        /// @brief Removes the session of strToken and returns it in state; returns false if there is none or it
+        /// expired. Called by the Server on the network thread when a connection sends a resume hello.
+        bool TakeSession(const std::string &strToken, SessionState &state);
+
+        /// @brief Restores a taken session on a connection that was made a client, then invokes OnSessionResumed.
+        void RestoreSession(HSteamNetConnection hConn, const SessionState &state);
+
+    public:
+        /// @brief Returns the application's state of a client being handed off; invoked by HandOff() on the network
+        /// thread. Sessions carry no application state if unset.
+        std::function<std::vector<uint8_t>(HSteamNetConnection)> OnExportSession;
+
+        /// @brief Invoked on the network thread when a client resumed its session, after OnClientConnected and
+        /// after its groups, weight and throttle were restored.
+        std::function<void(HSteamNetConnection, const SessionState &)> OnSessionResumed;
+
+    private:
+        /// @brief A received session and when it stops waiting for its client.
+        struct PendingSession
+        {
+            SessionState state;
+            std::chrono::steady_clock::time_point tExpires;
+        };
+
+        /// @brief Drops the sessions whose client did not come in time. Called with the lock held.
+        void ExpireSessions(std::chrono::steady_clock::time_point tNow);
+
+    private:
+        Server &m_server;
+        const SessionHandoffConfig m_config;
+
+        /// @brief Received sessions by resume token, filled by HTTP threads and taken by the network thread.
+        std::mutex m_mutex;
+        std::unordered_map<std::string, PendingSession> m_mapSessions;
+    };
+} // namespace QNET
\ No newline at end of file
@@ -0,0 +1,249 @@
+#pragma once
+
+#include "quicknet/components/Transport.h"
+
+#include <deque>
+#include <functional>
+#include <map>
+#include <queue>
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace QNET
+{
+    /// @brief Link characteristics of simulated connections, per direction.
+    struct SimLinkConfig
+    {
+        /// @brief One-way base latency.
+        uint32 nLatencyMs = 20;
+
+        /// @brief Extra one-way delay, uniformly distributed in [0, nJitterMs].
+        uint32 nJitterMs = 0;
+
+        /// @brief Chance that a message is lost. Unreliable messages are dropped; reliable ones are resent after
+        /// a round trip plus 10 ms, for as long as they keep being lost.
+        float flLossPercent = 0.0f;
+
+        /// @brief Bytes per second each direction of a connection can carry; 0 for unlimited. Messages beyond the
+        /// rate queue up and show as pending bytes and queue time in GetConnectionRealTimeStatus().
+        uint32 nBandwidthBytesPerSec = 0;
+
+        /// @brief How long a connection may stay in the Connecting state before it fails with
+        /// k_ESteamNetConnectionEnd_Misc_Timeout.
+        uint32 nConnectTimeoutMs = 10000;
+    };
+
+    /// @brief Counters over the lifetime of a SimTransport.
+    struct SimStats
+    {
+        uint64 nMessagesSent = 0;
+        uint64 nMessagesDelivered = 0;
+        uint64 nMessagesDropped = 0;
+        uint64 nRetransmits = 0;
+        uint64 cbSent = 0;
+    };
+
+    /// @brief An in-memory network driven by a virtual clock, for deterministic tests and experiments.
+    /// @details Servers and clients constructed with the same SimTransport talk to each other by port, as if over
+    /// UDP on one host, but nothing moves until the clock is advanced with AdvanceTime() or RunFor(). Latency,
+    /// jitter, loss and bandwidth come from SimLinkConfig, and every random draw comes from one generator seeded in
+    /// the constructor, so a run with the same seed and the same sequence of calls produces exactly the same
+    /// message timings. Connection status callbacks are dispatched by RunCallbacks(), which every
+    /// ConnectionManager::Poll() calls, just as GNS dispatches them for the whole process.
+    ///
+    /// Not simulated: lane scheduling (lanes are accepted but share one queue), per-lane status, packet
+    /// fragmentation and connection-level timeouts after the handshake. Not thread-safe: drive all endpoints from
+    /// one thread.
+    class SimTransport : public Transport
+    {
+    public:
+        /// @param nSeed Seed for every random draw.
+        /// @param config Default link characteristics of every connection.
+        explicit SimTransport(uint64 nSeed = 1, const SimLinkConfig &config = SimLinkConfig());
+
+        /// @brief Releases every message that is still queued or in flight.
+        ~SimTransport() override;
+
+        SimTransport(const SimTransport &) = delete;
+        SimTransport &operator=(const SimTransport &) = delete;
+
+        /// @brief Advances the virtual clock. Messages and status changes that became due are applied on the next
+        /// call that reads them.
+        /// @param usecDelta How far to advance, in microseconds.
+        void AdvanceTime(SteamNetworkingMicroseconds usecDelta);
+
+        /// @brief Calls fnTick and advances the clock by usecStep, until usecDuration has passed.
+        /// @param usecDuration Total virtual time to run for.
+        /// @param usecStep Virtual time between ticks.
+        /// @param fnTick One iteration of the application's loop (e.g. Poll() and ReceiveMessages() on every
+        /// endpoint).
+        void RunFor(SteamNetworkingMicroseconds usecDuration, SteamNetworkingMicroseconds usecStep,
+                    const std::function<void()> &fnTick);
+
+        /// @brief Returns the time of the next scheduled delivery or status change, or INT64_MAX if there is none.
+        SteamNetworkingMicroseconds GetNextEventTime() const;
+
+        /// @brief Changes the default link characteristics, for messages sent from now on.
+        void SetLinkConfig(const SimLinkConfig &config);
+
+        /// @brief Overrides the link characteristics of the messages sent on one connection (one direction).
+        /// @return False if the connection is unknown.
+        bool SetConnectionLinkConfig(HSteamNetConnection hConn, const SimLinkConfig &config);
+
+        /// @brief Returns the counters since construction.
+        const SimStats &GetStats() const { return m_stats; }
+
+        HSteamListenSocket CreateListenSocketIP(const SteamNetworkingIPAddr &localAddress, int nOptions,
+                                                const SteamNetworkingConfigValue_t *pOptions) override;
+        HSteamNetConnection ConnectByIPAddress(const SteamNetworkingIPAddr &address, int nOptions,
+                                               const SteamNetworkingConfigValue_t *pOptions) override;
+        EResult AcceptConnection(HSteamNetConnection hConn) override;
+        bool CloseConnection(HSteamNetConnection hPeer, int nReason, const char *pszDebug, bool bEnableLinger) override;
+        bool CloseListenSocket(HSteamListenSocket hSocket) override;
+        EResult SendMessageToConnection(HSteamNetConnection hConn, const void *pData, uint32 cbData, int nSendFlags,
+                                        int64 *pOutMessageNumber) override;
+        void SendMessages(int nMessages, SteamNetworkingMessage_t *const *pMessages,
+                          int64 *pOutMessageNumberOrResult) override;
+        int ReceiveMessagesOnConnection(HSteamNetConnection hConn, SteamNetworkingMessage_t **ppOutMessages,
+                                        int nMaxMessages) override;
+        HSteamNetPollGroup CreatePollGroup() override;
+        bool SetConnectionPollGroup(HSteamNetConnection hConn, HSteamNetPollGroup hPollGroup) override;
+        int ReceiveMessagesOnPollGroup(HSteamNetPollGroup hPollGroup, SteamNetworkingMessage_t **ppOutMessages,
+                                       int nMaxMessages) override;
+        EResult GetConnectionRealTimeStatus(HSteamNetConnection hConn, SteamNetConnectionRealTimeStatus_t *pStatus,
+                                            int nLanes, SteamNetConnectionRealTimeLaneStatus_t *pLanes) override;
+        EResult ConfigureConnectionLanes(HSteamNetConnection hConn, int nNumLanes, const int *pLanePriorities,
+                                         const uint16 *pLaneWeights) override;
+        void RunCallbacks() override;
+        SteamNetworkingMessage_t *AllocateMessage(int cbAllocateBuffer) override;
+        SteamNetworkingMicroseconds GetLocalTimestamp() override { return m_usecNow; }
+
+    private:
+        /// @brief A sent message, kept until it has left the send queue and, if reliable, been acknowledged.
+        struct SentRecord
+        {
+            SteamNetworkingMicroseconds usecStart;
+            SteamNetworkingMicroseconds usecAcked;
+            uint32 cbSize;
+            bool bReliable;
+        };
+
+        struct Connection
+        {
+            HSteamNetConnection hPeer = k_HSteamNetConnection_Invalid;
+            HSteamListenSocket hListenSocket = k_HSteamListenSocket_Invalid;
+            ESteamNetworkingConnectionState eState = k_ESteamNetworkingConnectionState_None;
+            int nEndReason = 0;
+            std::string strEndDebug;
+            std::string strDescription;
+            SteamNetworkingIPAddr addrRemote;
+            int64 nUserData = -1;
+            FnSteamNetConnectionStatusChanged fnCallback = nullptr;
+            HSteamNetPollGroup hPollGroup = k_HSteamNetPollGroup_Invalid;
+            std::deque<SteamNetworkingMessage_t *> dequeInbox;
+
+            SimLinkConfig link;
+            bool bCustomLink = false;
+            int nLanes = 1;
+            int64 nNextMessageNumber = 1;
+
+            /// @brief When the link is free to start the next message, and when the last reliable one arrives.
+            SteamNetworkingMicroseconds usecLinkFree = 0;
+            SteamNetworkingMicroseconds usecLastReliableArrival = 0;
+
+            /// @brief Messages that are queued or unacknowledged, oldest first.
+            std::deque<SentRecord> dequeSent;
+        };
+
+        struct ListenSocket
+        {
+            uint16 nPort;
+            int64 nUserData = -1;
+            FnSteamNetConnectionStatusChanged fnCallback = nullptr;
+        };
+
+        enum class EventType
+        {
+            ConnectRequest,
+            ConnectTimeout,
+            StateChange,
+            Deliver
+        };
+
+        struct Event
+        {
+            SteamNetworkingMicroseconds usecTime;
+            uint64 nSequence;
+            EventType eType;
+            HSteamNetConnection hConn;
+            ESteamNetworkingConnectionState eState;
+            int nEndReason;
+            std::string strEndDebug;
+            SteamNetworkingMessage_t *pMsg;
+            uint16 nPort;
+        };
+
+        struct EventLater
+        {
+            bool operator()(const Event &a, const Event &b) const
+            {
+                return a.usecTime != b.usecTime ? a.usecTime > b.usecTime : a.nSequence > b.nSequence;
+            }
+        };
+
+        /// @brief Queues an event; events due at the same time are applied in the order they were scheduled.
+        void Schedule(Event event);
+
+        /// @brief Applies every event that is due.
+        void Pump();
+
+        /// @brief Changes a connection's state and queues its status callback.
+        void SetState(HSteamNetConnection hConn, Connection &conn, ESteamNetworkingConnectionState eState);
+
+        /// @brief Handles a connection request arriving at a listen socket.
+        void OnConnectRequest(HSteamNetConnection hClient, uint16 nPort);
+
+        /// @brief Sends one message and returns its number, or a negated EResult.
+        int64 Send(HSteamNetConnection hConn, const void *pData, uint32 cbData, int nSendFlags, uint16 nLane);
+
+        /// @brief Returns one-way latency plus jitter for a message on the link.
+        SteamNetworkingMicroseconds DrawDelay(const SimLinkConfig &link);
+
+        /// @brief Returns a uniformly distributed value in [0, 1). Deterministic across platforms.
+        double DrawUniform();
+
+        /// @brief Drops the queued and acknowledged records of a connection.
+        void PruneSent(Connection &conn);
+
+        /// @brief Reads the callback and user data options.
+        static void ReadOptions(int nOptions, const SteamNetworkingConfigValue_t *pOptions,
+                                FnSteamNetConnectionStatusChanged &fnCallback, int64 &nUserData);
+
+        /// @brief Creates a message whose payload is owned by the message.
+        static SteamNetworkingMessage_t *CreateMessage(int cbSize);
+
+    private:
+        SteamNetworkingMicroseconds m_usecNow;
+        SimLinkConfig m_link;
+        std::mt19937_64 m_rng;
+        SimStats m_stats;
+
+        uint32 m_nNextHandle = 1;
+        uint64 m_nNextSequence = 0;
+        uint32 m_nNextClientAddress = 1;
+
+        std::map<HSteamNetConnection, Connection> m_mapConnections;
+        std::map<HSteamListenSocket, ListenSocket> m_mapListenSockets;
+
+        /// @brief Connections with pending messages on each poll group, one entry per message, in arrival order.
+        std::map<HSteamNetPollGroup, std::deque<HSteamNetConnection>> m_mapPollGroups;
+
+        std::priority_queue<Event, std::vector<Event>, EventLater> m_queueEvents;
+
+        /// @brief Status callbacks waiting for RunCallbacks().
+        std::deque<std::pair<FnSteamNetConnectionStatusChanged, SteamNetConnectionStatusChangedCallback_t>>
+            m_dequeCallbacks;
+    };
+} // namespace QNET
\ No newline at end of file
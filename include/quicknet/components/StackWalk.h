@@ -0,0 +1,25 @@
+#pragma once
+
+#include <cstdint>
+
+namespace QNET
+{
+    /// @brief Prepares WalkSignalStack(); call outside of signal handlers before installing one that uses it. Safe to
+    /// call more than once and from several threads.
+    /// @return False where stacks cannot be walked (only Linux on x86-64, x86 and AArch64 is supported).
+    bool InitStackWalk();
+
+    /// @brief Records the stack of the code a signal interrupted, innermost frame first: the interrupted PC, then the
+    /// return address of every frame on the frame-pointer chain.
+    /// @details Async-signal-safe: it takes no locks and does not allocate, unlike backtrace(), whose unwinder locks
+    /// the loader's tables and can deadlock when the signal lands during exception unwinding or dlopen(). The walk
+    /// starts at the frame pointer of the interrupted context, only follows frame pointers that move up the stack
+    /// within the stack size limit above the interrupted stack pointer, and checks that every stack page it reads is
+    /// mapped, so a function built without frame pointers ends the walk instead of crashing it. Code must be
+    /// compiled with -fno-omit-frame-pointer to be walked through; the library is, and applications that want their
+    /// own frames in profiles should be too.
+    /// @param pContext The ucontext_t passed to an SA_SIGINFO signal handler.
+    /// @param ppFrames Receives up to nMaxFrames addresses.
+    /// @return The number of frames written; 0 if unsupported or InitStackWalk() failed.
+    uint32_t WalkSignalStack(const void *pContext, void **ppFrames, uint32_t nMaxFrames);
+} // namespace QNET
\ No newline at end of file
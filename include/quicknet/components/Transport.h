@@ -0,0 +1,98 @@
+#pragma once
+
+#include <steam/isteamnetworkingutils.h>
+#include <steam/steamnetworkingsockets.h>
+
+namespace QNET
+{
+    /// @brief The subset of ISteamNetworkingSockets (plus the two ISteamNetworkingUtils calls) that QNET uses.
+    /// @details The functions have the same names and signatures as their GNS counterparts, so ConnectionManager and
+    /// its subclasses call them exactly as they would call GNS. SteamTransport forwards to the real library;
+    /// SimTransport runs connections in memory on a virtual clock.
+    class Transport
+    {
+    public:
+        virtual ~Transport() = default;
+
+        virtual HSteamListenSocket CreateListenSocketIP(const SteamNetworkingIPAddr &localAddress, int nOptions,
+                                                        const SteamNetworkingConfigValue_t *pOptions) = 0;
+
+        virtual HSteamNetConnection ConnectByIPAddress(const SteamNetworkingIPAddr &address, int nOptions,
+                                                       const SteamNetworkingConfigValue_t *pOptions) = 0;
+
+        virtual EResult AcceptConnection(HSteamNetConnection hConn) = 0;
+
+        virtual bool CloseConnection(HSteamNetConnection hPeer, int nReason, const char *pszDebug,
+                                     bool bEnableLinger) = 0;
+
+        virtual bool CloseListenSocket(HSteamListenSocket hSocket) = 0;
+
+        virtual EResult SendMessageToConnection(HSteamNetConnection hConn, const void *pData, uint32 cbData,
+                                                int nSendFlags, int64 *pOutMessageNumber) = 0;
+
+        virtual void SendMessages(int nMessages, SteamNetworkingMessage_t *const *pMessages,
+                                  int64 *pOutMessageNumberOrResult) = 0;
+
+        virtual int ReceiveMessagesOnConnection(HSteamNetConnection hConn, SteamNetworkingMessage_t **ppOutMessages,
+                                                int nMaxMessages) = 0;
+
+        virtual HSteamNetPollGroup CreatePollGroup() = 0;
+
+        virtual bool SetConnectionPollGroup(HSteamNetConnection hConn, HSteamNetPollGroup hPollGroup) = 0;
+
+        virtual int ReceiveMessagesOnPollGroup(HSteamNetPollGroup hPollGroup, SteamNetworkingMessage_t **ppOutMessages,
+                                               int nMaxMessages) = 0;
+
+        virtual EResult GetConnectionRealTimeStatus(HSteamNetConnection hConn,
+                                                    SteamNetConnectionRealTimeStatus_t *pStatus, int nLanes,
+                                                    SteamNetConnectionRealTimeLaneStatus_t *pLanes) = 0;
+
+        virtual EResult ConfigureConnectionLanes(HSteamNetConnection hConn, int nNumLanes, const int *pLanePriorities,
+                                                 const uint16 *pLaneWeights) = 0;
+
+        /// @brief Dispatches pending connection status callbacks.
+        virtual void RunCallbacks() = 0;
+
+        /// @brief ISteamNetworkingUtils::AllocateMessage().
+        virtual SteamNetworkingMessage_t *AllocateMessage(int cbAllocateBuffer) = 0;
+
+        /// @brief ISteamNetworkingUtils::GetLocalTimestamp(). All QNET timeouts are measured on this clock.
+        virtual SteamNetworkingMicroseconds GetLocalTimestamp() = 0;
+    };
+
+    /// @brief Forwards every call to GameNetworkingSockets. Used by the default ConnectionManager constructor.
+    class SteamTransport : public Transport
+    {
+    public:
+        /// @param pSockets The GNS interface, from SteamNetworkingSockets().
+        explicit SteamTransport(ISteamNetworkingSockets *pSockets);
+
+        HSteamListenSocket CreateListenSocketIP(const SteamNetworkingIPAddr &localAddress, int nOptions,
+                                                const SteamNetworkingConfigValue_t *pOptions) override;
+        HSteamNetConnection ConnectByIPAddress(const SteamNetworkingIPAddr &address, int nOptions,
+                                               const SteamNetworkingConfigValue_t *pOptions) override;
+        EResult AcceptConnection(HSteamNetConnection hConn) override;
+        bool CloseConnection(HSteamNetConnection hPeer, int nReason, const char *pszDebug, bool bEnableLinger) override;
+        bool CloseListenSocket(HSteamListenSocket hSocket) override;
+        EResult SendMessageToConnection(HSteamNetConnection hConn, const void *pData, uint32 cbData, int nSendFlags,
+                                        int64 *pOutMessageNumber) override;
+        void SendMessages(int nMessages, SteamNetworkingMessage_t *const *pMessages,
+                          int64 *pOutMessageNumberOrResult) override;
+        int ReceiveMessagesOnConnection(HSteamNetConnection hConn, SteamNetworkingMessage_t **ppOutMessages,
+                                        int nMaxMessages) override;
+        HSteamNetPollGroup CreatePollGroup() override;
+        bool SetConnectionPollGroup(HSteamNetConnection hConn, HSteamNetPollGroup hPollGroup) override;
+        int ReceiveMessagesOnPollGroup(HSteamNetPollGroup hPollGroup, SteamNetworkingMessage_t **ppOutMessages,
+                                       int nMaxMessages) override;
+        EResult GetConnectionRealTimeStatus(HSteamNetConnection hConn, SteamNetConnectionRealTimeStatus_t *pStatus,
+                                            int nLanes, SteamNetConnectionRealTimeLaneStatus_t *pLanes) override;
+        EResult ConfigureConnectionLanes(HSteamNetConnection hConn, int nNumLanes, const int *pLanePriorities,
+                                         const uint16 *pLaneWeights) override;
+        void RunCallbacks() override;
+        SteamNetworkingMessage_t *AllocateMessage(int cbAllocateBuffer) override;
+        SteamNetworkingMicroseconds GetLocalTimestamp() override;
+
+    private:
+        ISteamNetworkingSockets *m_pSockets;
+    };
+} // namespace QNET
\ No newline at end of file
@@ -0,0 +1,172 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <steam/steamnetworkingsockets.h>
+
+namespace QNET
+{
+    /// @brief Reads the application's message type from a payload, for diagnostics. Returns -1 if unknown.
+    using MessageTypeExtractor = std::function<int32(const uint8 *pData, uint32 cbSize)>;
+
+    /// @brief What a stalled loop was doing when the watchdog noticed it.
+    struct StallReport
+    {
+        /// @brief The name the loop was watched under.
+        std::string strLoop;
+
+        /// @brief True if the loop was stuck inside a callback, false if it simply stopped heartbeating.
+        bool bInCallback = false;
+
+        /// @brief The connection whose message was being handled, or k_HSteamNetConnection_Invalid.
+        HSteamNetConnection hConn = k_HSteamNetConnection_Invalid;
+
+        /// @brief The message type reported by the loop's MessageTypeExtractor, or -1.
+        int32 nMessageType = -1;
+
+        /// @brief Additional context given by the loop (e.g. the HTTP route), or empty.
+        std::string strContext;
+
+        /// @brief How long the loop had been stuck when the report was made.
+        uint32 nStalledMs = 0;
+
+        /// @brief The stuck thread's stack, innermost frame first. Only captured on Linux with glibc, by following
+        /// frame pointers (see WalkSignalStack()), so frames of code built without them are missing; link with
+        /// -rdynamic to get function names instead of addresses.
+        std::vector<std::string> vecStack;
+    };
+
+    /// @brief Settings for a Watchdog.
+    struct WatchdogConfig
+    {
+        /// @brief A callback or heartbeat gap longer than this is reported as a stall.
+        uint32 nThresholdMs = 250;
+
+        /// @brief How often the watchdog thread checks the loops.
+        uint32 nCheckIntervalMs = 50;
+
+        /// @brief Capture the stuck thread's stack for every report.
+        bool bCaptureStack = true;
+    };
+
+    /// @brief Progress markers of one watched loop, written by the loop's thread and read by the watchdog thread.
+    /// @details All updates are relaxed atomic stores plus one clock read, so a monitor can stay attached to a
+    /// production loop. Obtain one from Watchdog::Watch().
+    class LoopMonitor
+    {
+    public:
+        /// @brief Marks one iteration of the loop. Loops that never heartbeat are only checked inside callbacks.
+        void Heartbeat();
+
+        /// @brief Marks the start of a callback that must not block the loop.
+        /// @param hConn The connection the callback handles, or k_HSteamNetConnection_Invalid.
+        /// @param nMessageType The message type, or -1.
+        /// @param pszContext Additional context that outlives the callback (e.g. a route), or nullptr.
+        void BeginCallback(HSteamNetConnection hConn, int32 nMessageType, const char *pszContext = nullptr);
+
+        /// @brief Marks the end of the current callback.
+        void EndCallback();
+
+        /// @brief Stops checking the heartbeat until the next Heartbeat(), e.g. when the loop exits.
+        void Suspend();
+
+        /// @brief Brackets a callback with BeginCallback()/EndCallback(); does nothing for a null monitor.
+        class CallbackScope
+        {
+        public:
+            CallbackScope(LoopMonitor *pMonitor, HSteamNetConnection hConn, int32 nMessageType,
+                          const char *pszContext = nullptr);
+            ~CallbackScope();
+
+            CallbackScope(const CallbackScope &) = delete;
+            CallbackScope &operator=(const CallbackScope &) = delete;
+
+        private:
+            LoopMonitor *m_pMonitor;
+        };
+
+    private:
+        friend class Watchdog;
+
+        explicit LoopMonitor(std::string strName);
+
+        /// @brief Records the calling thread as the one to capture stacks from.
+        void NoteThread();
+
+    private:
+        const std::string m_strName;
+
+        /// @brief Steady-clock microseconds of the last heartbeat and of the current callback's start, 0 if none.
+        std::atomic<int64> m_usecHeartbeat{0};
+        std::atomic<int64> m_usecCallbackStart{0};
+
+        std::atomic<HSteamNetConnection> m_hConn{k_HSteamNetConnection_Invalid};
+        std::atomic<int32> m_nMessageType{-1};
+        std::atomic<const char *> m_pszContext{nullptr};
+
+        /// @brief Native handle of the loop thread (pthread_t where stacks can be captured).
+        std::atomic<uint64> m_nThread{0};
+        std::atomic<bool> m_bHasThread{false};
+
+        /// @brief The callback start and heartbeat that were last reported, so each stall is reported once.
+        /// Only used by the watchdog thread.
+        int64 m_usecReportedCallback = 0;
+        int64 m_usecReportedHeartbeat = 0;
+    };
+
+    /// @brief Watches poll loops from a separate thread and reports callbacks that block them.
+    /// @details A loop is stalled when its current callback has been running, or its last heartbeat is, older
+    /// than the threshold. Each stall is reported once through OnStall, on the watchdog thread, with the
+    /// connection and message type being handled and the stuck thread's stack. Server, Client and
+    /// ConnectionlessEndpoint opt in with ConnectionManager::SetWatchdog(), HttpServer with
+    /// HttpServer::SetWatchdog(), and any other loop with Watch().
+    class Watchdog
+    {
+    public:
+        /// @param config The thresholds; the thread starts with the first Watch().
+        explicit Watchdog(const WatchdogConfig &config = WatchdogConfig());
+
+        /// @brief Stops the watchdog thread.
+        ~Watchdog();
+
+        Watchdog(const Watchdog &) = delete;
+        Watchdog &operator=(const Watchdog &) = delete;
+
+        /// @brief Starts watching a loop. The loop is watched until the returned monitor is destroyed.
+        /// @param strName The name reported in StallReport::strLoop.
+        /// @return The monitor the loop's thread updates.
+        std::shared_ptr<LoopMonitor> Watch(const std::string &strName);
+
+        /// @brief Returns the current time in the monitors' clock, in microseconds.
+        static int64 Now();
+
+    public:
+        /// @brief Invoked on the watchdog thread for every stall. Set before the first Watch().
+        /// If unset, stalls are logged to std::cerr.
+        std::function<void(const StallReport &)> OnStall;
+
+    private:
+        /// @brief Body of the watchdog thread.
+        void ThreadMain();
+
+        /// @brief Checks one monitor and fills report if it is newly stalled.
+        bool CheckMonitor(LoopMonitor &monitor, int64 usecNow, StallReport &report);
+
+    private:
+        const WatchdogConfig m_config;
+
+        std::mutex m_mutex;
+        std::condition_variable m_cvStop;
+        bool m_bStop = false;
+        std::vector<std::weak_ptr<LoopMonitor>> m_vecMonitors;
+        std::thread m_thread;
+    };
+} // namespace QNET
\ No newline at end of file
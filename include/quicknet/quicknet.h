@@ -1,3 +1,24 @@
+#include "quicknet/components/BitStream.h"
+#include "quicknet/components/ByteStream.h"
 #include "quicknet/components/Client.h"
+#include "quicknet/components/ConnectionAdmin.h"
+#include "quicknet/components/ConnectionlessEndpoint.h"
+#include "quicknet/components/CpuProfiler.h"
+#include "quicknet/components/FlightRecorder.h"
+#include "quicknet/components/HeapProfiler.h"
+#include "quicknet/components/Hpack.h"
+#include "quicknet/components/Http2.h"
 #include "quicknet/components/HttpServer.h"
-#include "quicknet/components/Server.h"
\ No newline at end of file
+#include "quicknet/components/HttpSessionStore.h"
+#include "quicknet/components/Json.h"
+#include "quicknet/components/MessageAccounting.h"
+#include "quicknet/components/ProfilerAdmin.h"
+#include "quicknet/components/PublishBridge.h"
+#include "quicknet/components/Replication.h"
+#include "quicknet/components/RequestArena.h"
+#include "quicknet/components/Server.h"
+#include "quicknet/components/SessionHandoff.h"
+#include "quicknet/components/SimTransport.h"
+#include "quicknet/components/StackWalk.h"
+#include "quicknet/components/Transport.h"
+#include "quicknet/components/Watchdog.h"
\ No newline at end of file
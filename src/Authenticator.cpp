@@ -0,0 +1,468 @@
+#include "quicknet/components/Authenticator.h"
+#include "quicknet/components/Transport.h"
+
+#include <algorithm>
+#include <array>
+#include <ctime>
+#include <cstring>
+
+namespace QNET
+{
+    namespace
+    {
+        /// @brief Minimal SHA-256 (FIPS 180-4), used for HMAC token signatures.
+        class Sha256
+        {
+        public:
+            static constexpr size_t kBlockSize = 64;
+            static constexpr size_t kDigestSize = 32;
+            using Digest = std::array<uint8_t, kDigestSize>;
+
+            Sha256() { Reset(); }
+
+            void Reset()
+            {
+                static const uint32_t kInit[8] = {0x6a09e667, 0xbb67ae85, 0x3c6ef372, 0xa54ff53a,
+                                                  0x510e527f, 0x9b05688c, 0x1f83d9ab, 0x5be0cd19};
+                std::memcpy(m_state, kInit, sizeof(m_state));
+                m_nTotalBytes = 0;
+                m_cbBuffered = 0;
+            }
+
+            void Update(const void *pData, size_t cbSize)
+            {
+                const uint8_t *pBytes = static_cast<const uint8_t *>(pData);
+                m_nTotalBytes += cbSize;
+                while (cbSize > 0)
+                {
+                    const size_t cbCopy = std::min(cbSize, kBlockSize - m_cbBuffered);
+                    std::memcpy(m_buffer + m_cbBuffered, pBytes, cbCopy);
+                    m_cbBuffered += cbCopy;
+                    pBytes += cbCopy;
+                    cbSize -= cbCopy;
+                    if (m_cbBuffered == kBlockSize)
+                    {
+                        Transform(m_buffer);
+                        m_cbBuffered = 0;
+                    }
+                }
+            }
+
+            Digest Final()
+            {
+                const uint64_t nTotalBits = m_nTotalBytes * 8;
+                const uint8_t nPadStart = 0x80;
+                Update(&nPadStart, 1);
+                const uint8_t nZero = 0;
+                while (m_cbBuffered != kBlockSize - 8)
+                {
+                    Update(&nZero, 1);
+                }
+                uint8_t lengthBytes[8];
+                for (int i = 0; i < 8; ++i)
+                {
+                    lengthBytes[i] = static_cast<uint8_t>(nTotalBits >> (56 - 8 * i));
+                }
+                Update(lengthBytes, 8);
+
+                Digest digest;
+                for (int i = 0; i < 8; ++i)
+                {
+                    digest[4 * i + 0] = static_cast<uint8_t>(m_state[i] >> 24);
+                    digest[4 * i + 1] = static_cast<uint8_t>(m_state[i] >> 16);
+                    digest[4 * i + 2] = static_cast<uint8_t>(m_state[i] >> 8);
+                    digest[4 * i + 3] = static_cast<uint8_t>(m_state[i]);
+                }
+                return digest;
+            }
+
+        private:
+            static uint32_t Rotr(uint32_t x, int n) { return (x >> n) | (x << (32 - n)); }
+
+            void Transform(const uint8_t *pBlock)
+            {
+                static const uint32_t kRound[64] = {
+                    0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5, 0x3956c25b, 0x59f111f1, 0x923f82a4, 0xab1c5ed5,
+                    0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3, 0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174,
+                    0xe49b69c1, 0xefbe4786, 0x0fc19dc6, 0x240ca1cc, 0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
+                    0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7, 0xc6e00bf3, 0xd5a79147, 0x06ca6351, 0x14292967,
+                    0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13, 0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85,
+                    0xa2bfe8a1, 0xa81a664b, 0xc24b8b70, 0xc76c51a3, 0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
+                    0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5, 0x391c0cb3, 0x4ed8aa4a, 0x5b9cca4f, 0x682e6ff3,
+                    0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208, 0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2};
+
+                uint32_t w[64];
+                for (int i = 0; i < 16; ++i)
+                {
+                    w[i] = (uint32_t(pBlock[4 * i]) << 24) | (uint32_t(pBlock[4 * i + 1]) << 16) |
+                           (uint32_t(pBlock[4 * i + 2]) << 8) | uint32_t(pBlock[4 * i + 3]);
+                }
+                for (int i = 16; i < 64; ++i)
+                {
+                    const uint32_t s0 = Rotr(w[i - 15], 7) ^ Rotr(w[i - 15], 18) ^ (w[i - 15] >> 3);
+                    const uint32_t s1 = Rotr(w[i - 2], 17) ^ Rotr(w[i - 2], 19) ^ (w[i - 2] >> 10);
+                    w[i] = w[i - 16] + s0 + w[i - 7] + s1;
+                }
+
+                uint32_t a = m_state[0], b = m_state[1], c = m_state[2], d = m_state[3];
+                uint32_t e = m_state[4], f = m_state[5], g = m_state[6], h = m_state[7];
+                for (int i = 0; i < 64; ++i)
+                {
+                    const uint32_t S1 = Rotr(e, 6) ^ Rotr(e, 11) ^ Rotr(e, 25);
+                    const uint32_t ch = (e & f) ^ (~e & g);
+                    const uint32_t t1 = h + S1 + ch + kRound[i] + w[i];
+                    const uint32_t S0 = Rotr(a, 2) ^ Rotr(a, 13) ^ Rotr(a, 22);
+                    const uint32_t maj = (a & b) ^ (a & c) ^ (b & c);
+                    const uint32_t t2 = S0 + maj;
+                    h = g;
+                    g = f;
+                    f = e;
+                    e = d + t1;
+                    d = c;
+                    c = b;
+                    b = a;
+                    a = t1 + t2;
+                }
+                m_state[0] += a;
+                m_state[1] += b;
+                m_state[2] += c;
+                m_state[3] += d;
+                m_state[4] += e;
+                m_state[5] += f;
+                m_state[6] += g;
+                m_state[7] += h;
+            }
+
+            uint32_t m_state[8];
+            uint64_t m_nTotalBytes;
+            uint8_t m_buffer[kBlockSize];
+            size_t m_cbBuffered;
+        };
+
+        std::string ToHex(const uint8_t *pData, size_t cbSize)
+        {
+            static const char kHexDigits[] = "0123456789abcdef";
+            std::string strHex(cbSize * 2, '0');
+            for (size_t i = 0; i < cbSize; ++i)
+            {
+                strHex[2 * i] = kHexDigits[pData[i] >> 4];
+                strHex[2 * i + 1] = kHexDigits[pData[i] & 0x0F];
+            }
+            return strHex;
+        }
+    } // namespace
+
+    Authenticator::Authenticator(Transport &transport, const AuthConfig &config, TokenVerifier verifier)
+        : m_transport(transport), m_config(config), m_verifier(std::move(verifier))
+    {
+        UpdateNow();
+        if (!m_verifier)
+        {
+            const std::string strSecret = m_config.strSecret;
+            m_verifier = [strSecret](const std::string &strToken, AuthClaims &claims)
+            { return VerifyToken(strSecret, strToken, claims); };
+        }
+
+        m_config.nWorkerThreads = std::max<uint32_t>(m_config.nWorkerThreads, 1);
+        m_config.nMaxBatchSize = std::max<size_t>(m_config.nMaxBatchSize, 1);
+        for (uint32_t i = 0; i < m_config.nWorkerThreads; ++i)
+        {
+            m_vecWorkers.emplace_back(&Authenticator::WorkerLoop, this);
+        }
+    }
+
+    Authenticator::~Authenticator()
+    {
+        {
+            std::lock_guard<std::mutex> lock(m_queueMutex);
+            m_bStopping = true;
+            m_dequeJobs.clear();
+        }
+        m_queueCondition.notify_all();
+        for (std::thread &worker : m_vecWorkers)
+        {
+            worker.join();
+        }
+    }
+
+    /// @brief Answers from the cache when possible; otherwise hands the token to the workers.
+    void Authenticator::Submit(HSteamNetConnection hConn, std::string strToken)
+    {
+        ++m_nSubmitted;
+
+        Verdict verdict;
+        bool bCached;
+        {
+            std::lock_guard<std::mutex> lock(m_cacheMutex);
+            bCached = LookupLocked(strToken, UpdateNow(), verdict);
+        }
+
+        if (bCached)
+        {
+            ++m_nCacheHits;
+            std::lock_guard<std::mutex> lock(m_resultMutex);
+            m_vecResults.push_back({hConn, verdict.bAccepted, std::move(verdict.strIdentity)});
+            return;
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(m_queueMutex);
+            m_dequeJobs.push_back({hConn, std::move(strToken)});
+        }
+        m_queueCondition.notify_one();
+    }
+
+    size_t Authenticator::DrainResults(std::vector<AuthResult> &vecOut)
+    {
+        UpdateNow();
+
+        std::lock_guard<std::mutex> lock(m_resultMutex);
+        const size_t nResults = m_vecResults.size();
+        vecOut.insert(vecOut.end(), m_vecResults.begin(), m_vecResults.end());
+        m_vecResults.clear();
+        return nResults;
+    }
+
+    SteamNetworkingMicroseconds Authenticator::UpdateNow()
+    {
+        // A SimTransport clock is not thread-safe, so the workers never read it themselves.
+        const SteamNetworkingMicroseconds usecNow = m_transport.GetLocalTimestamp();
+        m_usecNow.store(usecNow);
+        return usecNow;
+    }
+
+    std::array<uint8_t, 32> Authenticator::HmacSha256(const std::string &strKey, const void *pData, size_t cbSize)
+    {
+        uint8_t key[Sha256::kBlockSize] = {};
+        if (strKey.size() > Sha256::kBlockSize)
+        {
+            Sha256 keyHash;
+            keyHash.Update(strKey.data(), strKey.size());
+            const Sha256::Digest keyDigest = keyHash.Final();
+            std::memcpy(key, keyDigest.data(), keyDigest.size());
+        }
+        else
+        {
+            std::memcpy(key, strKey.data(), strKey.size());
+        }
+
+        uint8_t innerPad[Sha256::kBlockSize];
+        uint8_t outerPad[Sha256::kBlockSize];
+        for (size_t i = 0; i < Sha256::kBlockSize; ++i)
+        {
+            innerPad[i] = key[i] ^ 0x36;
+            outerPad[i] = key[i] ^ 0x5c;
+        }
+
+        Sha256 inner;
+        inner.Update(innerPad, sizeof(innerPad));
+        inner.Update(pData, cbSize);
+        const Sha256::Digest innerDigest = inner.Final();
+
+        Sha256 outer;
+        outer.Update(outerPad, sizeof(outerPad));
+        outer.Update(innerDigest.data(), innerDigest.size());
+        return outer.Final();
+    }
+
+    AuthStats Authenticator::GetStats() const
+    {
+        AuthStats stats;
+        stats.nSubmitted = m_nSubmitted.load();
+        stats.nCacheHits = m_nCacheHits.load();
+        stats.nVerified = m_nVerified.load();
+        stats.nRejected = m_nRejected.load();
+        stats.nBatches = m_nBatches.load();
+        return stats;
+    }
+
+    std::string Authenticator::CreateToken(const std::string &strSecret, const std::string &strPayload,
+                                           int64_t nExpiresAt)
+    {
+        const std::string strSigned = strPayload + "." + std::to_string(nExpiresAt);
+        const Sha256::Digest mac = HmacSha256(strSecret, strSigned.data(), strSigned.size());
+        return strSigned + "." + ToHex(mac.data(), mac.size());
+    }
+
+    bool Authenticator::VerifyToken(const std::string &strSecret, const std::string &strToken, AuthClaims &claims)
+    {
+        const size_t nDot = strToken.rfind('.');
+        if (nDot == std::string::npos || nDot == 0 || strToken.size() - nDot - 1 != Sha256::kDigestSize * 2)
+            return false;
+
+        const Sha256::Digest mac = HmacSha256(strSecret, strToken.data(), nDot);
+        const std::string strExpected = ToHex(mac.data(), mac.size());
+
+        uint8_t nDiff = 0;
+        for (size_t i = 0; i < strExpected.size(); ++i)
+        {
+            nDiff |= static_cast<uint8_t>(strExpected[i] ^ strToken[nDot + 1 + i]);
+        }
+        if (nDiff != 0)
+            return false;
+
+        // The signature covers the expiry, so it can be trusted from here on.
+        const size_t nExpiryDot = strToken.rfind('.', nDot - 1);
+        const size_t cbExpiry = nExpiryDot == std::string::npos ? 0 : nDot - nExpiryDot - 1;
+        if (cbExpiry == 0 || cbExpiry > 18)
+            return false;
+
+        int64_t nExpiresAt = 0;
+        for (size_t i = nExpiryDot + 1; i < nDot; ++i)
+        {
+            if (strToken[i] < '0' || strToken[i] > '9')
+                return false;
+            nExpiresAt = nExpiresAt * 10 + (strToken[i] - '0');
+        }
+        if (nExpiresAt <= int64_t(std::time(nullptr)))
+            return false;
+
+        claims.strIdentity = strToken.substr(0, nExpiryDot);
+        claims.nExpiresAt = nExpiresAt;
+        return true;
+    }
+
+    /// @brief Takes up to nMaxBatchSize jobs per pass, verifies each distinct token once, and publishes the whole
+    /// batch with one cache lock and one result lock.
+    void Authenticator::WorkerLoop()
+    {
+        // A verdict, and until when it may be cached; 0 for verdicts that came from the cache.
+        struct BatchVerdict
+        {
+            Verdict verdict;
+            SteamNetworkingMicroseconds usecCacheUntil;
+        };
+
+        std::vector<Job> vecBatch;
+        std::unordered_map<std::string, BatchVerdict> mapVerdicts;
+        std::vector<AuthResult> vecResults;
+
+        while (true)
+        {
+            vecBatch.clear();
+            {
+                std::unique_lock<std::mutex> lock(m_queueMutex);
+                m_queueCondition.wait(lock, [this] { return m_bStopping || !m_dequeJobs.empty(); });
+                if (m_bStopping)
+                    return;
+
+                const size_t nTake = std::min(m_dequeJobs.size(), m_config.nMaxBatchSize);
+                for (size_t i = 0; i < nTake; ++i)
+                {
+                    vecBatch.push_back(std::move(m_dequeJobs.front()));
+                    m_dequeJobs.pop_front();
+                }
+            }
+            ++m_nBatches;
+
+            // Another worker may have verified the same token since it was queued.
+            mapVerdicts.clear();
+            const SteamNetworkingMicroseconds usecNow = m_usecNow.load();
+            {
+                std::lock_guard<std::mutex> lock(m_cacheMutex);
+                for (const Job &job : vecBatch)
+                {
+                    Verdict verdict;
+                    if (LookupLocked(job.strToken, usecNow, verdict))
+                    {
+                        mapVerdicts.emplace(job.strToken, BatchVerdict{std::move(verdict), 0});
+                    }
+                }
+            }
+
+            const size_t nCached = mapVerdicts.size();
+            vecResults.clear();
+            for (const Job &job : vecBatch)
+            {
+                auto it = mapVerdicts.find(job.strToken);
+                if (it == mapVerdicts.end())
+                {
+                    AuthClaims claims;
+                    const bool bAccepted = m_verifier(job.strToken, claims);
+                    ++m_nVerified;
+
+                    const SteamNetworkingMicroseconds usecTtl = GetCacheTtl(bAccepted, claims);
+                    BatchVerdict batchVerdict{{bAccepted, bAccepted ? std::move(claims.strIdentity) : std::string()},
+                                              usecTtl > 0 ? usecNow + usecTtl : 0};
+                    it = mapVerdicts.emplace(job.strToken, std::move(batchVerdict)).first;
+                }
+                if (!it->second.verdict.bAccepted)
+                {
+                    ++m_nRejected;
+                }
+                vecResults.push_back({job.hConn, it->second.verdict.bAccepted, it->second.verdict.strIdentity});
+            }
+
+            if (mapVerdicts.size() > nCached)
+            {
+                std::lock_guard<std::mutex> lock(m_cacheMutex);
+                for (const auto &entry : mapVerdicts)
+                {
+                    if (entry.second.usecCacheUntil > 0)
+                    {
+                        InsertLocked(entry.first, entry.second.verdict, entry.second.usecCacheUntil);
+                    }
+                }
+            }
+
+            std::lock_guard<std::mutex> lock(m_resultMutex);
+            m_vecResults.insert(m_vecResults.end(), std::make_move_iterator(vecResults.begin()),
+                                std::make_move_iterator(vecResults.end()));
+        }
+    }
+
+    /// @brief Rejections are cached briefly, and an accepted token never past its own expiry.
+    SteamNetworkingMicroseconds Authenticator::GetCacheTtl(bool bAccepted, const AuthClaims &claims) const
+    {
+        const uint32_t nTtlSeconds = bAccepted ? m_config.nCacheTtlSeconds : m_config.nRejectCacheTtlSeconds;
+        int64_t nSeconds = nTtlSeconds;
+        if (bAccepted && claims.nExpiresAt > 0)
+        {
+            nSeconds = std::min(nSeconds, claims.nExpiresAt - int64_t(std::time(nullptr)));
+        }
+        return SteamNetworkingMicroseconds(std::max<int64_t>(nSeconds, 0)) * 1000000;
+    }
+
+    bool Authenticator::LookupLocked(const std::string &strToken, SteamNetworkingMicroseconds usecNow, Verdict &verdict)
+    {
+        auto it = m_mapCache.find(strToken);
+        if (it == m_mapCache.end())
+            return false;
+
+        if (it->second.usecExpires <= usecNow)
+        {
+            m_listLru.erase(it->second.itLru);
+            m_mapCache.erase(it);
+            return false;
+        }
+
+        m_listLru.splice(m_listLru.begin(), m_listLru, it->second.itLru);
+        verdict = it->second.verdict;
+        return true;
+    }
+
+    void Authenticator::InsertLocked(const std::string &strToken, const Verdict &verdict,
+                                     SteamNetworkingMicroseconds usecExpires)
+    {
+        if (m_config.nCacheCapacity == 0)
+            return;
+
+        auto it = m_mapCache.find(strToken);
+        if (it != m_mapCache.end())
+        {
+            it->second.verdict = verdict;
+            it->second.usecExpires = usecExpires;
+            m_listLru.splice(m_listLru.begin(), m_listLru, it->second.itLru);
+            return;
+        }
+
+        while (m_mapCache.size() >= m_config.nCacheCapacity && !m_listLru.empty())
+        {
+            m_mapCache.erase(m_listLru.back());
+            m_listLru.pop_back();
+        }
+
+        m_listLru.push_front(strToken);
+        m_mapCache.emplace(strToken, CacheEntry{verdict, usecExpires, m_listLru.begin()});
+    }
+} // namespace QNET
\ No newline at end of file
@@ -0,0 +1,317 @@
+#include "quicknet/components/BitStream.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+namespace QNET
+{
+    namespace
+    {
+        /// @brief Initial size of an owned buffer; large enough for most snapshot messages.
+        constexpr size_t kInitialOwnedCapacity = 256;
+
+        /// @brief Stores a 64-bit word in little-endian byte order.
+        inline void StoreLE64(uint8_t *pOut, uint64_t nValue)
+        {
+            for (int i = 0; i < 8; ++i)
+            {
+                pOut[i] = static_cast<uint8_t>(nValue >> (8 * i));
+            }
+        }
+
+        /// @brief Loads up to eight bytes in little-endian byte order; missing bytes read as zero.
+        inline uint64_t LoadLE64(const uint8_t *pData, size_t cbAvailable)
+        {
+            uint64_t nValue = 0;
+            const size_t cbLoad = std::min<size_t>(cbAvailable, 8);
+            for (size_t i = 0; i < cbLoad; ++i)
+            {
+                nValue |= static_cast<uint64_t>(pData[i]) << (8 * i);
+            }
+            return nValue;
+        }
+
+        /// @brief Number of quantization steps for a float range, as the upper bound of a ranged int.
+        inline int64_t QuantizationSteps(float flMin, float flMax, float flPrecision)
+        {
+            if (!(flMax > flMin) || !(flPrecision > 0.0f))
+                return 0;
+            return static_cast<int64_t>(std::ceil((static_cast<double>(flMax) - flMin) / flPrecision));
+        }
+    } // namespace
+
+    /// @brief Computes floor(log2(nRange)) + 1, and 0 for a range of 0.
+    int BitsRequired(uint64_t nRange)
+    {
+        if (nRange == 0)
+            return 0;
+#if defined(_MSC_VER)
+        unsigned long nIndex;
+        _BitScanReverse64(&nIndex, nRange);
+        return static_cast<int>(nIndex) + 1;
+#else
+        return 64 - __builtin_clzll(nRange);
+#endif
+    }
+
+    // ---------------------------------------------------------------------------------------------------------------
+    // BitWriter
+    // ---------------------------------------------------------------------------------------------------------------
+
+    BitWriter::BitWriter() : m_bOwnsBuffer(true)
+    {
+        m_vecOwned.resize(kInitialOwnedCapacity);
+        m_pBuffer = m_vecOwned.data();
+        m_cbCapacity = m_vecOwned.size();
+    }
+
+    BitWriter::BitWriter(void *pBuffer, size_t cbCapacity)
+        : m_pBuffer(static_cast<uint8_t *>(pBuffer)), m_cbCapacity(pBuffer ? cbCapacity : 0)
+    {
+    }
+
+    BitWriter::BitWriter(ISteamNetworkingMessage *pMsg)
+        : BitWriter(pMsg ? pMsg->m_pData : nullptr, pMsg && pMsg->m_cbSize > 0 ? size_t(pMsg->m_cbSize) : 0)
+    {
+    }
+
+    void BitWriter::WriteRangedInt(int64_t nValue, int64_t nMin, int64_t nMax)
+    {
+        if (nMax <= nMin)
+            return;
+
+        nValue = std::min(std::max(nValue, nMin), nMax);
+        const uint64_t nRange = static_cast<uint64_t>(nMax) - static_cast<uint64_t>(nMin);
+        WriteBits(static_cast<uint64_t>(nValue) - static_cast<uint64_t>(nMin), BitsRequired(nRange));
+    }
+
+    void BitWriter::WriteQuantizedFloat(float flValue, float flMin, float flMax, float flPrecision)
+    {
+        const int64_t nSteps = QuantizationSteps(flMin, flMax, flPrecision);
+        if (nSteps == 0)
+            return;
+
+        // NaN compares false against everything, so it is treated as flMin.
+        const double flClamped = flValue > flMin ? std::min<double>(flValue, flMax) : flMin;
+        const int64_t nQuantized = static_cast<int64_t>(std::llround((flClamped - flMin) / flPrecision));
+        WriteRangedInt(nQuantized, 0, nSteps);
+    }
+
+    void BitWriter::WriteFloat(float flValue)
+    {
+        uint32_t nBits;
+        std::memcpy(&nBits, &flValue, sizeof(nBits));
+        WriteBits(nBits, 32);
+    }
+
+    void BitWriter::WriteVarUInt(uint64_t nValue)
+    {
+        while (nValue >= 0x80)
+        {
+            WriteBits((nValue & 0x7F) | 0x80, 8);
+            nValue >>= 7;
+        }
+        WriteBits(nValue, 8);
+    }
+
+    void BitWriter::WriteVarInt(int64_t nValue)
+    {
+        const uint64_t nZigZag = (static_cast<uint64_t>(nValue) << 1) ^ static_cast<uint64_t>(nValue >> 63);
+        WriteVarUInt(nZigZag);
+    }
+
+    void BitWriter::WriteBytes(const void *pData, size_t cbSize)
+    {
+        AlignToByte();
+        const uint8_t *pBytes = static_cast<const uint8_t *>(pData);
+        while (cbSize >= 8)
+        {
+            WriteBits(LoadLE64(pBytes, 8), 64);
+            pBytes += 8;
+            cbSize -= 8;
+        }
+        if (cbSize > 0)
+        {
+            WriteBits(LoadLE64(pBytes, cbSize), static_cast<int>(cbSize * 8));
+        }
+    }
+
+    void BitWriter::AlignToByte()
+    {
+        const int nPadding = (8 - (m_nScratchBits & 7)) & 7;
+        WriteBits(0, nPadding);
+    }
+
+    size_t BitWriter::Finish()
+    {
+        const size_t cbPending = (m_nScratchBits + 7) / 8;
+        if (cbPending > 0 && Reserve(cbPending))
+        {
+            for (size_t i = 0; i < cbPending; ++i)
+            {
+                m_pBuffer[m_cbOffset + i] = static_cast<uint8_t>(m_nScratch >> (8 * i));
+            }
+        }
+
+        // The bytes stay logically part of the scratch word, so further writes after Finish() remain valid.
+        return GetBytesWritten();
+    }
+
+    std::vector<uint8_t> BitWriter::ToVector()
+    {
+        const size_t cbUsed = std::min(Finish(), m_cbCapacity);
+        return std::vector<uint8_t>(m_pBuffer, m_pBuffer + cbUsed);
+    }
+
+    void BitWriter::FlushWord()
+    {
+        if (Reserve(8))
+        {
+            StoreLE64(m_pBuffer + m_cbOffset, m_nScratch);
+        }
+        m_cbOffset += 8;
+    }
+
+    bool BitWriter::Reserve(size_t cbBytes)
+    {
+        if (m_cbOffset + cbBytes <= m_cbCapacity)
+            return true;
+
+        if (!m_bOwnsBuffer)
+        {
+            m_bOverflowed = true;
+            return false;
+        }
+
+        m_vecOwned.resize(std::max(m_vecOwned.size() * 2, m_cbOffset + cbBytes));
+        m_pBuffer = m_vecOwned.data();
+        m_cbCapacity = m_vecOwned.size();
+        return true;
+    }
+
+    // ---------------------------------------------------------------------------------------------------------------
+    // BitReader
+    // ---------------------------------------------------------------------------------------------------------------
+
+    BitReader::BitReader(const void *pData, size_t cbSize)
+        : m_pData(static_cast<const uint8_t *>(pData)), m_cbSize(pData ? cbSize : 0)
+    {
+    }
+
+    BitReader::BitReader(const std::vector<uint8_t> &byteMessage) : BitReader(byteMessage.data(), byteMessage.size()) {}
+
+    BitReader::BitReader(const ISteamNetworkingMessage *pMsg)
+        : BitReader(pMsg ? pMsg->m_pData : nullptr, pMsg && pMsg->m_cbSize > 0 ? size_t(pMsg->m_cbSize) : 0)
+    {
+    }
+
+    uint64_t BitReader::ReadBitsSlow(int nBits, uint64_t nMask)
+    {
+        const size_t cbAvailable = m_cbSize - m_cbOffset;
+        const int nLoadedBits = static_cast<int>(std::min<size_t>(cbAvailable, 8) * 8);
+        const int nFromNext = nBits - m_nScratchBits;
+        if (nFromNext > nLoadedBits)
+        {
+            m_bOverflowed = true;
+            m_cbOffset = m_cbSize;
+            m_nScratch = 0;
+            m_nScratchBits = 0;
+            return 0;
+        }
+
+        const uint64_t nNext = LoadLE64(m_pData + m_cbOffset, cbAvailable);
+        m_cbOffset += nLoadedBits / 8;
+
+        const uint64_t nValue = (m_nScratch | (nNext << m_nScratchBits)) & nMask;
+        m_nScratch = nFromNext < 64 ? nNext >> nFromNext : 0;
+        m_nScratchBits = nLoadedBits - nFromNext;
+        return nValue;
+    }
+
+    int64_t BitReader::ReadRangedInt(int64_t nMin, int64_t nMax)
+    {
+        if (nMax <= nMin)
+            return nMin;
+
+        const uint64_t nRange = static_cast<uint64_t>(nMax) - static_cast<uint64_t>(nMin);
+        const uint64_t nOffset = ReadBits(BitsRequired(nRange));
+        return static_cast<int64_t>(static_cast<uint64_t>(nMin) + std::min(nOffset, nRange));
+    }
+
+    float BitReader::ReadQuantizedFloat(float flMin, float flMax, float flPrecision)
+    {
+        const int64_t nSteps = QuantizationSteps(flMin, flMax, flPrecision);
+        if (nSteps == 0)
+            return flMin;
+
+        const int64_t nQuantized = ReadRangedInt(0, nSteps);
+        return static_cast<float>(std::min<double>(flMin + static_cast<double>(nQuantized) * flPrecision, flMax));
+    }
+
+    float BitReader::ReadFloat()
+    {
+        const uint32_t nBits = static_cast<uint32_t>(ReadBits(32));
+        float flValue;
+        std::memcpy(&flValue, &nBits, sizeof(flValue));
+        return flValue;
+    }
+
+    uint64_t BitReader::ReadVarUInt()
+    {
+        uint64_t nValue = 0;
+        for (int nShift = 0; nShift < 64; nShift += 7)
+        {
+            const uint64_t nByte = ReadBits(8);
+            nValue |= (nByte & 0x7F) << nShift;
+            if ((nByte & 0x80) == 0 || m_bOverflowed)
+                return nValue;
+        }
+
+        // More than ten groups cannot come from WriteVarUInt().
+        m_bOverflowed = true;
+        return 0;
+    }
+
+    int64_t BitReader::ReadVarInt()
+    {
+        const uint64_t nZigZag = ReadVarUInt();
+        return static_cast<int64_t>((nZigZag >> 1) ^ (~(nZigZag & 1) + 1));
+    }
+
+    bool BitReader::ReadBytes(void *pOut, size_t cbSize)
+    {
+        AlignToByte();
+        if (GetBitsRemaining() < cbSize * 8)
+        {
+            m_bOverflowed = true;
+            return false;
+        }
+
+        uint8_t *pBytes = static_cast<uint8_t *>(pOut);
+        while (cbSize >= 8)
+        {
+            StoreLE64(pBytes, ReadBits(64));
+            pBytes += 8;
+            cbSize -= 8;
+        }
+        for (size_t i = 0; i < cbSize; ++i)
+        {
+            pBytes[i] = static_cast<uint8_t>(ReadBits(8));
+        }
+        return true;
+    }
+
+    void BitReader::AlignToByte()
+    {
+        const int nPadding = static_cast<int>(GetBitsRead() & 7);
+        if (nPadding != 0)
+        {
+            ReadBits(8 - nPadding);
+        }
+    }
+} // namespace QNET
\ No newline at end of file
@@ -1,5 +1,7 @@
 #include "quicknet/components/Client.h"
 
+#include "quicknet/components/SessionHandoff.h"
+
 #include <iostream>
 
 namespace QNET
@@ -51,22 +53,28 @@ namespace QNET
 
         m_pInterface->CloseConnection(m_hConnection, 0, "Client disconnecting", true);
         m_hConnection = k_HSteamNetConnection_Invalid;
+        m_strResumeToken.clear();
     }
 
     /// @brief Sends an Unreliable message to the connected server.
     /// @param byteMessage The message content to send.
-    void Client::SendUnreliableMessageToServer(const std::vector<uint8_t> &byteMessage)
+    /// @return The GNS message number, or 0 on failure.
+    int64 Client::SendUnreliableMessageToServer(const std::vector<uint8_t> &byteMessage)
     {
-        SendUnreliableMessage(m_hConnection, byteMessage);
+        return SendUnreliableMessage(m_hConnection, byteMessage);
     }
 
     /// @brief Sends an Reliable message to the connected server.
     /// @param byteMessage The message content to send.
-    void Client::SendReliableMessageToServer(const std::vector<uint8_t> &byteMessage)
+    /// @return The GNS message number, or 0 on failure.
+    int64 Client::SendReliableMessageToServer(const std::vector<uint8_t> &byteMessage)
     {
-        SendReliableMessage(m_hConnection, byteMessage);
+        return SendReliableMessage(m_hConnection, byteMessage);
     }
 
+    /// @brief Enables or disables delivery receipts for the current connection.
+    void Client::EnableServerDeliveryReceipts(bool bEnable) { EnableDeliveryReceipts(m_hConnection, bEnable); }
+
     /// @brief Checks if the client is currently connected to a server.
     /// A connection is considered active if its handle is not k_HSteamNetConnection_Invalid.
     /// @return True if connected, false otherwise.
@@ -76,6 +84,9 @@ namespace QNET
         return m_hConnection != k_HSteamNetConnection_Invalid;
     }
 
+    /// @brief Sets the token sent as the first message after connecting.
+    void Client::SetAuthToken(const std::string &strToken) { m_strAuthToken = strToken; }
+
     /// @brief Handles connection status changes for the client.
     /// This method is called by the global connection status callback. It processes events
     /// like successful connection, disconnection by peer, or local problem detection.
@@ -91,6 +102,26 @@ namespace QNET
         case k_ESteamNetworkingConnectionState_Connected:
             /// @brief Logs successful connection to the server.
             std::cout << "Client: Successfully connected to server." << std::endl;
+
+            // A handed-off session is resumed rather than started again, so the application is not told.
+            if (!m_strResumeToken.empty())
+            {
+                SendReliableMessage(m_hConnection, SessionHandoff::MakeResumeHello(m_strResumeToken));
+                m_strResumeToken.clear();
+                break;
+            }
+
+            // The server treats the first message as the authentication token, so it must precede everything else.
+            if (!m_strAuthToken.empty())
+            {
+                SendReliableMessage(m_hConnection,
+                                    std::vector<uint8_t>(m_strAuthToken.begin(), m_strAuthToken.end()));
+            }
+
+            if (OnConnected)
+            {
+                OnConnected();
+            }
             break;
 
         case k_ESteamNetworkingConnectionState_ClosedByPeer:
@@ -100,6 +131,28 @@ namespace QNET
             std::cout << "Client: Disconnected from server. Reason: " << pInfo->m_info.m_szEndDebug << std::endl;
             m_pInterface->CloseConnection(pInfo->m_hConn, 0, nullptr, false); // Close the connection formally.
             m_hConnection = k_HSteamNetConnection_Invalid;                    // Mark as disconnected.
+            m_strResumeToken.clear();
+
+            // A server being replaced names the new one and the token of our session there.
+            std::string strAddress;
+            std::string strToken;
+            if (pInfo->m_info.m_eState == k_ESteamNetworkingConnectionState_ClosedByPeer &&
+                pInfo->m_info.m_eEndReason == SessionHandoff::kEndReasonHandoff &&
+                SessionHandoff::ParseHandoffNotice(pInfo->m_info.m_szEndDebug, strAddress, strToken) &&
+                Connect(strAddress))
+            {
+                m_strResumeToken = strToken;
+                if (OnHandoff)
+                {
+                    OnHandoff(strAddress);
+                }
+                break;
+            }
+
+            if (OnDisconnected)
+            {
+                OnDisconnected();
+            }
             break;
         }
 
@@ -113,35 +166,64 @@ namespace QNET
     }
 
     /// @brief Receives pending messages from the server.
-    /// If connected, it polls for incoming messages. For each received message,
-    /// if the OnMessageReceived callback is set, it's invoked with the message content.
+    /// If connected, it drains the connection in batches until it is empty or the receive budget runs out. For each
+    /// received message, if the OnMessageReceived callback is set, it's invoked with the message content.
     /// Messages are released after processing.
     void Client::ReceiveMessages()
     {
         if (!IsConnected())
             return;
 
-        ISteamNetworkingMessage *pIncomingMsgs[16]; // Buffer for incoming messages.
-        int numMsgs = m_pInterface->ReceiveMessagesOnConnection(m_hConnection, pIncomingMsgs, 16);
-        if (numMsgs > 0)
-        {
-            for (int i = 0; i < numMsgs; ++i)
+        m_receiveScheduler.Run(*m_pInterface, {m_hConnection},
+                               [this](HSteamNetConnection hConn, ISteamNetworkingMessage **ppMsgs, int nMsgs)
+                               { DispatchMessages(hConn, ppMsgs, nMsgs); });
+    }
+
+    int Client::ReceiveBatch(ISteamNetworkingMessage **ppOutMessages, int nMaxMessages)
+    {
+        if (!IsConnected() || !ppOutMessages || nMaxMessages <= 0)
+            return 0;
+
+        int nOut = 0;
+        m_receiveScheduler.Run(
+            *m_pInterface, {m_hConnection},
+            [this, ppOutMessages, &nOut](HSteamNetConnection, ISteamNetworkingMessage **ppMsgs, int nMsgs)
             {
-                if (pIncomingMsgs[i] && pIncomingMsgs[i]->m_cbSize > 0)
+                for (int i = 0; i < nMsgs; ++i)
                 {
-                    std::vector<uint8_t> msg((const char *)pIncomingMsgs[i]->m_pData,
-                                             (const char *)pIncomingMsgs[i]->m_pData + pIncomingMsgs[i]->m_cbSize);
-
-                    // If the application has set a callback, use it.
-                    if (OnMessageReceived)
+                    ISteamNetworkingMessage *pMsg = ppMsgs[i];
+                    AccountReceived(pMsg->m_pData, uint32(pMsg->m_cbSize));
+                    if (pMsg->m_cbSize > 0)
                     {
-                        /// @brief Invokes the application-defined callback for the received message.
-                        OnMessageReceived(msg);
+                        ppOutMessages[nOut++] = pMsg;
+                    }
+                    else
+                    {
+                        pMsg->Release();
                     }
-
-                    pIncomingMsgs[i]->Release(); // Release the message resource.
                 }
+            },
+            uint32(nMaxMessages));
+        return nOut;
+    }
+
+    void Client::DispatchMessages(HSteamNetConnection hConn, ISteamNetworkingMessage **ppMsgs, int nMsgs)
+    {
+        for (int i = 0; i < nMsgs; ++i)
+        {
+            ISteamNetworkingMessage *pMsg = ppMsgs[i];
+            AccountReceived(pMsg->m_pData, uint32(pMsg->m_cbSize));
+
+            // If the application has set a callback, use it.
+            if (pMsg->m_cbSize > 0 && OnMessageReceived)
+            {
+                std::vector<uint8_t> msg((const char *)pMsg->m_pData, (const char *)pMsg->m_pData + pMsg->m_cbSize);
+
+                /// @brief Invokes the application-defined callback for the received message.
+                LoopMonitor::CallbackScope scope(GetLoopMonitor(), hConn, GetMessageType(msg.data(), pMsg->m_cbSize));
+                OnMessageReceived(msg);
             }
+            pMsg->Release(); // Release the message resource.
         }
     }
 } // namespace QNET
\ No newline at end of file
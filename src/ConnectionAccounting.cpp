@@ -0,0 +1,122 @@
+#include "quicknet/components/ConnectionAccounting.h"
+
+#include <algorithm>
+
+namespace QNET
+{
+    ConnectionAccounting::ConnectionAccounting(uint32_t nWindowSeconds)
+        : m_bucketPeriod(std::chrono::duration_cast<Clock::duration>(
+                             std::chrono::seconds(std::max(nWindowSeconds, 1u))) /
+                         int(kBucketCount))
+    {
+    }
+
+    void ConnectionAccounting::Record(HSteamNetConnection hConn, Clock::time_point tStart, Clock::time_point tEnd,
+                                      uint64_t cbBytes, uint64_t nMessages)
+    {
+        const int64_t nEpoch = EpochOf(tEnd);
+        const uint64_t usecTime =
+            static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::microseconds>(tEnd - tStart).count());
+
+        std::lock_guard<std::mutex> lock(m_mutex);
+
+        // Once per bucket period, forget connections that have been idle for the whole window.
+        if (nEpoch != m_nLastSweepEpoch)
+        {
+            m_nLastSweepEpoch = nEpoch;
+            for (auto it = m_mapEntries.begin(); it != m_mapEntries.end();)
+            {
+                if (it->second.nLastEpoch <= nEpoch - int64_t(kBucketCount))
+                    it = m_mapEntries.erase(it);
+                else
+                    ++it;
+            }
+        }
+
+        Entry &entry = m_mapEntries[hConn];
+        Bucket &bucket = entry.buckets[static_cast<size_t>(nEpoch) % kBucketCount];
+        if (bucket.nEpoch != nEpoch)
+        {
+            bucket = Bucket();
+            bucket.nEpoch = nEpoch;
+        }
+        bucket.usecTime += usecTime;
+        bucket.cbBytes += cbBytes;
+        bucket.nMessages += nMessages;
+        entry.nLastEpoch = nEpoch;
+    }
+
+    std::vector<ConnectionUsage> ConnectionAccounting::GetTop(size_t nCount, SortBy eSortBy) const
+    {
+        const int64_t nEpochNow = EpochOf(Clock::now());
+
+        std::vector<ConnectionUsage> vecUsage;
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            vecUsage.reserve(m_mapEntries.size());
+            for (const auto &entry : m_mapEntries)
+            {
+                ConnectionUsage usage = Sum(entry.first, entry.second, nEpochNow);
+                if (usage.nMessages > 0)
+                {
+                    vecUsage.push_back(usage);
+                }
+            }
+        }
+
+        auto Key = [eSortBy](const ConnectionUsage &usage)
+        {
+            switch (eSortBy)
+            {
+            case SortBy::Bytes:
+                return usage.cbBytes;
+            case SortBy::Messages:
+                return usage.nMessages;
+            default:
+                return usage.usecTime;
+            }
+        };
+        auto Heavier = [&Key](const ConnectionUsage &a, const ConnectionUsage &b) { return Key(a) > Key(b); };
+
+        nCount = std::min(nCount, vecUsage.size());
+        std::partial_sort(vecUsage.begin(), vecUsage.begin() + nCount, vecUsage.end(), Heavier);
+        vecUsage.resize(nCount);
+        return vecUsage;
+    }
+
+    ConnectionUsage ConnectionAccounting::GetUsage(HSteamNetConnection hConn) const
+    {
+        const int64_t nEpochNow = EpochOf(Clock::now());
+
+        std::lock_guard<std::mutex> lock(m_mutex);
+        auto it = m_mapEntries.find(hConn);
+        if (it == m_mapEntries.end())
+        {
+            ConnectionUsage usage;
+            usage.hConn = hConn;
+            return usage;
+        }
+        return Sum(hConn, it->second, nEpochNow);
+    }
+
+    int64_t ConnectionAccounting::EpochOf(Clock::time_point t) const
+    {
+        return static_cast<int64_t>(t.time_since_epoch() / m_bucketPeriod);
+    }
+
+    ConnectionUsage ConnectionAccounting::Sum(HSteamNetConnection hConn, const Entry &entry, int64_t nEpochNow) const
+    {
+        ConnectionUsage usage;
+        usage.hConn = hConn;
+        for (const Bucket &bucket : entry.buckets)
+        {
+            if (bucket.nEpoch > nEpochNow - int64_t(kBucketCount) && bucket.nEpoch <= nEpochNow)
+            {
+                usage.usecTime += bucket.usecTime;
+                usage.cbBytes += bucket.cbBytes;
+                usage.nMessages += bucket.nMessages;
+            }
+        }
+        return usage;
+    }
+} // namespace QNET
\ No newline at end of file
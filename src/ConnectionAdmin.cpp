@@ -0,0 +1,310 @@
+#include "quicknet/components/ConnectionAdmin.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <functional>
+
+namespace QNET
+{
+    namespace
+    {
+        const char *GetStateName(ESteamNetworkingConnectionState eState)
+        {
+            switch (eState)
+            {
+            case k_ESteamNetworkingConnectionState_Connecting:
+                return "connecting";
+            case k_ESteamNetworkingConnectionState_FindingRoute:
+                return "finding_route";
+            case k_ESteamNetworkingConnectionState_Connected:
+                return "connected";
+            case k_ESteamNetworkingConnectionState_ClosedByPeer:
+                return "closed_by_peer";
+            case k_ESteamNetworkingConnectionState_ProblemDetectedLocally:
+                return "problem_detected_locally";
+            default:
+                return "none";
+            }
+        }
+
+        using SortKey = std::function<double(const ConnectionSnapshot &)>;
+
+        /// @brief Returns the value the list is sorted by, or an empty function for an unknown name.
+        SortKey GetSortKey(const std::string &strSort)
+        {
+            if (strSort == "id")
+                return [](const ConnectionSnapshot &conn) { return double(conn.hConn); };
+            if (strSort == "age")
+                return [](const ConnectionSnapshot &conn) { return double(conn.usecAge); };
+            if (strSort == "ping")
+                return [](const ConnectionSnapshot &conn) { return double(conn.nPingMs); };
+            if (strSort == "quality")
+                return [](const ConnectionSnapshot &conn) { return double(conn.flQualityLocal); };
+            if (strSort == "queue")
+                return [](const ConnectionSnapshot &conn) { return double(conn.usecQueueTime); };
+            if (strSort == "pending")
+                return [](const ConnectionSnapshot &conn)
+                { return double(conn.cbPendingReliable) + double(conn.cbPendingUnreliable); };
+            if (strSort == "in")
+                return [](const ConnectionSnapshot &conn) { return double(conn.flInBytesPerSec); };
+            if (strSort == "out")
+                return [](const ConnectionSnapshot &conn) { return double(conn.flOutBytesPerSec); };
+            if (strSort == "bytes")
+                return [](const ConnectionSnapshot &conn) { return double(conn.cbReceived); };
+            if (strSort == "messages")
+                return [](const ConnectionSnapshot &conn) { return double(conn.nMessagesReceived); };
+            return SortKey();
+        }
+    } // namespace
+
+    ConnectionAdmin::ConnectionAdmin(Server &server, HttpServer &http, const ConnectionAdminConfig &config)
+        : m_server(server), m_config(config)
+    {
+        const std::string &strPrefix = m_config.strPrefix;
+        http.Get(strPrefix + "/connections", [this](const Request &req, Response &res) { HandleList(req, res); });
+        http.Get(strPrefix + "/connections/:id", [this](const Request &req, Response &res) { HandleGet(req, res); });
+        http.Post(strPrefix + "/connections/:id/kick",
+                  [this](const Request &req, Response &res) { HandleAction(req, res, Action::Type::Kick); });
+        http.Post(strPrefix + "/connections/:id/throttle",
+                  [this](const Request &req, Response &res) { HandleAction(req, res, Action::Type::Throttle); });
+
+        m_nTickHandlerId = m_server.AddTickHandler([this]() { Tick(); });
+    }
+
+    ConnectionAdmin::~ConnectionAdmin() { m_server.RemoveTickHandler(m_nTickHandlerId); }
+
+    std::shared_ptr<const std::vector<ConnectionSnapshot>> ConnectionAdmin::GetSnapshot() const
+    {
+        return LoadSnapshot().pConnections;
+    }
+
+    ConnectionAdmin::Snapshot ConnectionAdmin::LoadSnapshot() const
+    {
+        std::lock_guard<std::mutex> lock(m_snapshotMutex);
+        return m_snapshot;
+    }
+
+    void ConnectionAdmin::Tick()
+    {
+        Action action;
+        while (m_queueActions.Pop(action))
+        {
+            if (action.eType == Action::Type::Kick)
+            {
+                m_server.DisconnectClient(action.hConn, kEndReasonKicked,
+                                          action.strReason.empty() ? "Kicked by admin" : action.strReason);
+            }
+            else if (m_server.IsClient(action.hConn))
+            {
+                m_server.ThrottleConnection(action.hConn, action.nLimit);
+            }
+        }
+
+        const std::chrono::steady_clock::time_point tNow = std::chrono::steady_clock::now();
+        if (tNow - m_tLastSnapshot >= std::chrono::milliseconds(m_config.nSnapshotIntervalMs))
+        {
+            m_tLastSnapshot = tNow;
+            TakeSnapshot();
+        }
+    }
+
+    void ConnectionAdmin::TakeSnapshot()
+    {
+        const std::unordered_map<HSteamNetConnection, ConnectionRecord> &mapRecords = m_server.GetConnectionRecords();
+        const SteamNetworkingMicroseconds usecNow = m_server.GetLocalTimestamp();
+
+        auto pConnections = std::make_shared<std::vector<ConnectionSnapshot>>();
+        pConnections->reserve(mapRecords.size());
+        for (const auto &entry : mapRecords)
+        {
+            ConnectionSnapshot conn;
+            conn.hConn = entry.first;
+            conn.strDescription = entry.second.strDescription;
+            conn.bClient = m_server.IsClient(entry.first);
+            conn.usecAge = usecNow - entry.second.usecConnected;
+            conn.cbReceived = entry.second.cbReceived;
+            conn.nMessagesReceived = entry.second.nMessagesReceived;
+            conn.nThrottle = m_server.GetConnectionThrottle(entry.first);
+
+            SteamNetConnectionRealTimeStatus_t status;
+            if (m_server.GetRealTimeStatus(entry.first, status))
+            {
+                conn.eState = status.m_eState;
+                conn.nPingMs = status.m_nPing;
+                conn.flQualityLocal = status.m_flConnectionQualityLocal;
+                conn.flQualityRemote = status.m_flConnectionQualityRemote;
+                conn.flInBytesPerSec = status.m_flInBytesPerSec;
+                conn.flOutBytesPerSec = status.m_flOutBytesPerSec;
+                conn.cbPendingReliable = status.m_cbPendingReliable;
+                conn.cbPendingUnreliable = status.m_cbPendingUnreliable;
+                conn.cbSentUnackedReliable = status.m_cbSentUnackedReliable;
+                conn.usecQueueTime = status.m_usecQueueTime;
+            }
+            pConnections->push_back(std::move(conn));
+        }
+
+        Snapshot snapshot;
+        snapshot.pConnections = std::move(pConnections);
+        snapshot.tTaken = m_tLastSnapshot;
+
+        // The old snapshot is released outside the lock, by whichever thread drops the last reference.
+        std::lock_guard<std::mutex> lock(m_snapshotMutex);
+        std::swap(m_snapshot, snapshot);
+    }
+
+    void ConnectionAdmin::HandleList(const Request &req, Response &res)
+    {
+        if (!HttpServer::CheckBearerToken(req, res, m_config.strBearerToken))
+            return;
+
+        uint64_t nOffset = 0;
+        uint64_t nLimit = std::min<uint64_t>(100, m_config.nMaxPageSize);
+        if (!HttpServer::ReadUIntParam(req, "offset", nOffset) ||
+            !HttpServer::ReadUIntParam(req, "limit", nLimit))
+            return HttpServer::RespondError(res, 400, "offset and limit must be non-negative integers");
+        nLimit = std::min<uint64_t>(nLimit, m_config.nMaxPageSize);
+
+        const std::string strSort = req.has_param("sort") ? req.get_param_value("sort") : "id";
+        const SortKey fnKey = GetSortKey(strSort);
+        if (!fnKey)
+            return HttpServer::RespondError(res, 400, "unknown sort key: " + strSort);
+
+        const std::string strOrder = req.has_param("order") ? req.get_param_value("order") : "asc";
+        if (strOrder != "asc" && strOrder != "desc")
+            return HttpServer::RespondError(res, 400, "order must be asc or desc");
+        const bool bDescending = strOrder == "desc";
+
+        const Snapshot snapshot = LoadSnapshot();
+        if (!snapshot.pConnections)
+            return HttpServer::RespondError(res, 503, "no snapshot yet");
+
+        // Only the requested page is sorted into place; the snapshot itself is shared and stays untouched.
+        const std::vector<ConnectionSnapshot> &vecConnections = *snapshot.pConnections;
+        std::vector<const ConnectionSnapshot *> vecOrder;
+        vecOrder.reserve(vecConnections.size());
+        for (const ConnectionSnapshot &conn : vecConnections)
+        {
+            vecOrder.push_back(&conn);
+        }
+
+        const size_t nBegin = size_t(std::min<uint64_t>(nOffset, vecOrder.size()));
+        const size_t nEnd = size_t(std::min<uint64>(nBegin + nLimit, vecOrder.size()));
+        std::partial_sort(vecOrder.begin(), vecOrder.begin() + nEnd, vecOrder.end(),
+                          [&](const ConnectionSnapshot *pA, const ConnectionSnapshot *pB)
+                          {
+                              const double flA = fnKey(*pA);
+                              const double flB = fnKey(*pB);
+                              if (flA != flB)
+                                  return bDescending ? flA > flB : flA < flB;
+                              return pA->hConn < pB->hConn;
+                          });
+
+        const auto msAge = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() -
+                                                                                 snapshot.tTaken);
+
+        JsonWriter writer;
+        writer.BeginObject();
+        writer.Key("snapshotAgeMs").Int(msAge.count());
+        writer.Key("total").UInt(vecOrder.size());
+        writer.Key("offset").UInt(nBegin);
+        writer.Key("sort").String(strSort);
+        writer.Key("order").String(strOrder);
+        writer.Key("connections").BeginArray();
+        for (size_t i = nBegin; i < nEnd; ++i)
+        {
+            WriteConnection(writer, *vecOrder[i]);
+        }
+        writer.EndArray();
+        writer.EndObject();
+        res.set_content(writer.GetString(), "application/json");
+    }
+
+    void ConnectionAdmin::HandleGet(const Request &req, Response &res)
+    {
+        if (!HttpServer::CheckBearerToken(req, res, m_config.strBearerToken))
+            return;
+
+        const HSteamNetConnection hConn = ParseConnection(req.matches[1]);
+        if (hConn == k_HSteamNetConnection_Invalid)
+            return HttpServer::RespondError(res, 400, "invalid connection id");
+
+        const Snapshot snapshot = LoadSnapshot();
+        if (!snapshot.pConnections)
+            return HttpServer::RespondError(res, 503, "no snapshot yet");
+
+        for (const ConnectionSnapshot &conn : *snapshot.pConnections)
+        {
+            if (conn.hConn == hConn)
+            {
+                JsonWriter writer;
+                WriteConnection(writer, conn);
+                res.set_content(writer.GetString(), "application/json");
+                return;
+            }
+        }
+        HttpServer::RespondError(res, 404, "unknown connection");
+    }
+
+    void ConnectionAdmin::HandleAction(const Request &req, Response &res, Action::Type eType)
+    {
+        if (!HttpServer::CheckBearerToken(req, res, m_config.strBearerToken))
+            return;
+
+        Action action;
+        action.eType = eType;
+        action.hConn = ParseConnection(req.matches[1]);
+        if (action.hConn == k_HSteamNetConnection_Invalid)
+            return HttpServer::RespondError(res, 400, "invalid connection id");
+
+        if (eType == Action::Type::Throttle)
+        {
+            uint64_t nLimit = UINT64_MAX;
+            if (!HttpServer::ReadUIntParam(req, "limit", nLimit) || nLimit > UINT32_MAX)
+                return HttpServer::RespondError(res, 400, "limit must be a message count, or 0 to remove the cap");
+            action.nLimit = uint32(nLimit);
+        }
+        else
+        {
+            action.strReason = req.get_param_value("reason");
+        }
+        m_queueActions.Push(std::move(action));
+
+        JsonWriter writer;
+        writer.BeginObject().Key("queued").Bool(true).EndObject();
+        res.status = 202;
+        res.set_content(writer.GetString(), "application/json");
+    }
+
+    HSteamNetConnection ConnectionAdmin::ParseConnection(const std::string &strId)
+    {
+        char *pszEnd = nullptr;
+        const unsigned long nId = std::strtoul(strId.c_str(), &pszEnd, 10);
+        if (strId.empty() || *pszEnd != '\0' || nId > UINT32_MAX)
+            return k_HSteamNetConnection_Invalid;
+
+        return HSteamNetConnection(nId);
+    }
+
+    void ConnectionAdmin::WriteConnection(JsonWriter &writer, const ConnectionSnapshot &conn)
+    {
+        writer.BeginObject();
+        writer.Key("id").UInt(conn.hConn);
+        writer.Key("description").String(conn.strDescription);
+        writer.Key("client").Bool(conn.bClient);
+        writer.Key("state").String(GetStateName(conn.eState));
+        writer.Key("ageMs").Int(conn.usecAge / 1000);
+        writer.Key("pingMs").Int(conn.nPingMs);
+        writer.Key("qualityLocal").Double(conn.flQualityLocal);
+        writer.Key("qualityRemote").Double(conn.flQualityRemote);
+        writer.Key("inBytesPerSec").Double(conn.flInBytesPerSec);
+        writer.Key("outBytesPerSec").Double(conn.flOutBytesPerSec);
+        writer.Key("pendingReliableBytes").Int(conn.cbPendingReliable);
+        writer.Key("pendingUnreliableBytes").Int(conn.cbPendingUnreliable);
+        writer.Key("unackedReliableBytes").Int(conn.cbSentUnackedReliable);
+        writer.Key("queueTimeUs").Int(conn.usecQueueTime);
+        writer.Key("bytesReceived").UInt(conn.cbReceived);
+        writer.Key("messagesReceived").UInt(conn.nMessagesReceived);
+        writer.Key("throttle").UInt(conn.nThrottle);
+        writer.EndObject();
+    }
+} // namespace QNET
\ No newline at end of file
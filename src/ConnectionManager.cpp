@@ -1,6 +1,8 @@
 #include "quicknet/components/ConnectionManager.h"
 
+#include <algorithm>
 #include <iostream>
+#include <mutex>
 
 namespace QNET
 {
@@ -14,36 +16,68 @@ namespace QNET
         ConnectionManager *manager = (ConnectionManager *)pInfo->m_info.m_nUserData;
         if (manager)
         {
+            // Receipts can no longer arrive for, and messages no longer be received from, a connection that is
+            // going away.
+            if (pInfo->m_info.m_eState == k_ESteamNetworkingConnectionState_ClosedByPeer ||
+                pInfo->m_info.m_eState == k_ESteamNetworkingConnectionState_ProblemDetectedLocally)
+            {
+                manager->m_mapReceiptTrackers.erase(pInfo->m_hConn);
+                manager->m_receiveScheduler.Remove(pInfo->m_hConn);
+            }
+
             /// @brief Calls the instance-specific handler for connection status changes.
             manager->HandleConnectionStatusChanged(pInfo);
         }
     }
 
+    namespace
+    {
+        /// @brief Guards the library reference count below.
+        std::mutex s_libraryMutex;
+
+        /// @brief Number of live instances holding the library. The first initializes it and the last shuts it down,
+        /// so any number of clients and servers can share one process.
+        int s_nLibraryRefs = 0;
+    } // namespace
+
     /// @brief Constructor for ConnectionManager.
-    /// Initializes the GameNetworkingSockets library. If initialization fails,
-    /// an error message is printed to std::cerr. It also acquires the
-    /// ISteamNetworkingSockets interface.
+    /// Initializes the GameNetworkingSockets library if no other instance has done so yet. If initialization
+    /// fails, an error message is printed to std::cerr. It also acquires the ISteamNetworkingSockets interface.
     ConnectionManager::ConnectionManager() : m_pInterface(nullptr)
     {
-        // Initialize the GameNetworkingSockets library.
-        SteamDatagramErrMsg errMsg;
-        if (!GameNetworkingSockets_Init(nullptr, errMsg))
-        {
-            /// @brief Logs a fatal error if GameNetworkingSockets_Init fails.
-            std::cerr << "FATAL: GameNetworkingSockets_Init failed. " << errMsg << std::endl;
-        }
-        else
+        std::lock_guard<std::mutex> lock(s_libraryMutex);
+        if (s_nLibraryRefs == 0)
         {
-            m_pInterface = SteamNetworkingSockets();
+            // Initialize the GameNetworkingSockets library.
+            SteamDatagramErrMsg errMsg;
+            if (!GameNetworkingSockets_Init(nullptr, errMsg))
+            {
+                /// @brief Logs a fatal error if GameNetworkingSockets_Init fails.
+                std::cerr << "FATAL: GameNetworkingSockets_Init failed. " << errMsg << std::endl;
+                return;
+            }
         }
+
+        ++s_nLibraryRefs;
+        m_pOwnedTransport = std::make_unique<SteamTransport>(SteamNetworkingSockets());
+        m_pInterface = m_pOwnedTransport.get();
     }
 
+    ConnectionManager::ConnectionManager(Transport &transport) : m_pInterface(&transport) {}
+
     /// @brief Destructor for ConnectionManager.
-    /// Shuts down the GameNetworkingSockets library.
+    /// Shuts down the GameNetworkingSockets library once the last instance is destroyed.
     ConnectionManager::~ConnectionManager()
     {
-        // Shutdown the library.
-        GameNetworkingSockets_Kill();
+        if (!m_pOwnedTransport)
+            return;
+
+        std::lock_guard<std::mutex> lock(s_libraryMutex);
+        if (--s_nLibraryRefs == 0)
+        {
+            // Shutdown the library.
+            GameNetworkingSockets_Kill();
+        }
     }
 
     /// @brief Polls for network events by running callbacks.
@@ -51,36 +85,209 @@ namespace QNET
     /// This method is crucial for processing network messages and status updates.
     void ConnectionManager::Poll()
     {
+        if (m_pLoopMonitor)
+        {
+            m_pLoopMonitor->Heartbeat();
+        }
+
         if (!m_pInterface)
             return;
         // This is the heart of the manager. It triggers all callbacks for connection
         // status changes, which are then handled by the derived classes.
         m_pInterface->RunCallbacks();
+
+        UpdateDeliveryReceipts();
     }
 
     /// @brief Sends a reliable message to a specific connection.
-    void ConnectionManager::SendReliableMessage(HSteamNetConnection hConn, const std::vector<uint8_t> &byteMessage)
+    /// @return The GNS message number, or 0 on failure.
+    int64 ConnectionManager::SendReliableMessage(HSteamNetConnection hConn, const std::vector<uint8_t> &byteMessage)
     {
         if (hConn == k_HSteamNetConnection_Invalid)
-            return;
+            return 0;
 
         if (!m_pInterface)
-            return;
+            return 0;
+
+        int64 nMessageNumber = 0;
+        if (m_pInterface->SendMessageToConnection(hConn, byteMessage.data(), byteMessage.size(),
+                                                  k_nSteamNetworkingSend_Reliable, &nMessageNumber) != k_EResultOK)
+            return 0;
 
-        m_pInterface->SendMessageToConnection(hConn, byteMessage.data(), byteMessage.size(), k_nSteamNetworkingSend_Reliable,
-                                              nullptr);
+        AccountSent(byteMessage.data(), static_cast<uint32>(byteMessage.size()));
+        TrackReliableMessage(hConn, nMessageNumber, static_cast<uint32>(byteMessage.size()));
+        return nMessageNumber;
     }
 
     /// @brief Sends an unreliable message to a specific connection.
-    void ConnectionManager::SendUnreliableMessage(HSteamNetConnection hConn, const std::vector<uint8_t> &byteMessage)
+    /// @return The GNS message number, or 0 on failure.
+    int64 ConnectionManager::SendUnreliableMessage(HSteamNetConnection hConn, const std::vector<uint8_t> &byteMessage)
     {
         if (hConn == k_HSteamNetConnection_Invalid)
-            return;
+            return 0;
+
+        if (!m_pInterface)
+            return 0;
+
+        int64 nMessageNumber = 0;
+        if (m_pInterface->SendMessageToConnection(hConn, byteMessage.data(), byteMessage.size(),
+                                                  k_nSteamNetworkingSend_UnreliableNoDelay,
+                                                  &nMessageNumber) != k_EResultOK)
+            return 0;
+
+        AccountSent(byteMessage.data(), static_cast<uint32>(byteMessage.size()));
+        return nMessageNumber;
+    }
 
+    /// @brief Allocates a message buffer owned by GNS.
+    ISteamNetworkingMessage *ConnectionManager::AllocateMessage(uint32 cbCapacity)
+    {
         if (!m_pInterface)
+            return nullptr;
+
+        return m_pInterface->AllocateMessage(static_cast<int>(cbCapacity));
+    }
+
+    /// @brief Sends a message that was filled in place. The message is always consumed: it is either handed to
+    /// GNS or released here if it cannot be sent.
+    int64 ConnectionManager::SendAllocatedMessage(HSteamNetConnection hConn, ISteamNetworkingMessage *pMsg,
+                                                  uint32 cbSize, int nSendFlags, uint16 nLane)
+    {
+        if (!pMsg)
+            return 0;
+
+        if (hConn == k_HSteamNetConnection_Invalid || !m_pInterface || cbSize > uint32(pMsg->m_cbSize))
+        {
+            pMsg->Release();
+            return 0;
+        }
+
+        pMsg->m_conn = hConn;
+        pMsg->m_cbSize = static_cast<int>(cbSize);
+        pMsg->m_nFlags = nSendFlags;
+        pMsg->m_idxLane = nLane;
+
+        // The payload belongs to GNS once sent, so the message is counted before it is known to be accepted.
+        AccountSent(pMsg->m_pData, cbSize);
+
+        // SendMessages reports a message number on success and a negated EResult on failure.
+        int64 nMessageNumberOrResult = 0;
+        m_pInterface->SendMessages(1, &pMsg, &nMessageNumberOrResult);
+        if (nMessageNumberOrResult <= 0)
+            return 0;
+
+        if (nSendFlags & k_nSteamNetworkingSend_Reliable)
+        {
+            TrackReliableMessage(hConn, nMessageNumberOrResult, cbSize);
+        }
+        return nMessageNumberOrResult;
+    }
+
+    bool ConnectionManager::ConfigureLanes(HSteamNetConnection hConn, const std::vector<int> &vecPriorities,
+                                           const std::vector<uint16> &vecWeights)
+    {
+        if (hConn == k_HSteamNetConnection_Invalid || !m_pInterface || vecPriorities.empty())
+            return false;
+
+        if (!vecWeights.empty() && vecWeights.size() != vecPriorities.size())
+            return false;
+
+        return m_pInterface->ConfigureConnectionLanes(hConn, static_cast<int>(vecPriorities.size()),
+                                                      vecPriorities.data(),
+                                                      vecWeights.empty() ? nullptr : vecWeights.data()) == k_EResultOK;
+    }
+
+    bool ConnectionManager::GetRealTimeStatus(HSteamNetConnection hConn, SteamNetConnectionRealTimeStatus_t &status)
+    {
+        if (hConn == k_HSteamNetConnection_Invalid || !m_pInterface)
+            return false;
+
+        return m_pInterface->GetConnectionRealTimeStatus(hConn, &status, 0, nullptr) == k_EResultOK;
+    }
+
+    void ConnectionManager::EnableDeliveryReceipts(HSteamNetConnection hConn, bool bEnable)
+    {
+        if (hConn == k_HSteamNetConnection_Invalid)
+            return;
+
+        if (bEnable)
+            m_mapReceiptTrackers.emplace(hConn, ReceiptTracker());
+        else
+            m_mapReceiptTrackers.erase(hConn);
+    }
+
+    void ConnectionManager::TrackReliableMessage(HSteamNetConnection hConn, int64 nMessageNumber, uint32 cbSize)
+    {
+        if (m_mapReceiptTrackers.empty())
+            return;
+
+        auto it = m_mapReceiptTrackers.find(hConn);
+        if (it == m_mapReceiptTrackers.end())
             return;
 
-        m_pInterface->SendMessageToConnection(hConn, byteMessage.data(), byteMessage.size(),
-                                              k_nSteamNetworkingSend_UnreliableNoDelay, nullptr);
+        ReceiptTracker &tracker = it->second;
+        tracker.nBytesSent += cbSize;
+        tracker.dequeInFlight.emplace_back(nMessageNumber, tracker.nBytesSent);
+    }
+
+    /// @brief Reliable data is acknowledged in order, so everything sent minus what GNS still reports as pending or
+    /// unacknowledged has been acknowledged. Every message that ends within that prefix is delivered.
+    void ConnectionManager::UpdateDeliveryReceipts()
+    {
+        for (auto it = m_mapReceiptTrackers.begin(); it != m_mapReceiptTrackers.end();)
+        {
+            ReceiptTracker &tracker = it->second;
+            if (tracker.dequeInFlight.empty())
+            {
+                ++it;
+                continue;
+            }
+
+            SteamNetConnectionRealTimeStatus_t status;
+            if (m_pInterface->GetConnectionRealTimeStatus(it->first, &status, 0, nullptr) != k_EResultOK)
+            {
+                it = m_mapReceiptTrackers.erase(it);
+                continue;
+            }
+
+            const uint64 nOutstanding = uint64(std::max(status.m_cbPendingReliable, 0)) +
+                                        uint64(std::max(status.m_cbSentUnackedReliable, 0));
+            const uint64 nAckedBytes = tracker.nBytesSent > nOutstanding ? tracker.nBytesSent - nOutstanding : 0;
+
+            int64 nAckedMessageNumber = 0;
+            while (!tracker.dequeInFlight.empty() && tracker.dequeInFlight.front().second <= nAckedBytes)
+            {
+                nAckedMessageNumber = tracker.dequeInFlight.front().first;
+                tracker.dequeInFlight.pop_front();
+            }
+
+            const HSteamNetConnection hConn = it->first;
+            ++it;
+            if (nAckedMessageNumber != 0 && OnDeliveryReceipt)
+            {
+                OnDeliveryReceipt(hConn, nAckedMessageNumber);
+            }
+        }
+    }
+
+    void ConnectionManager::SetWatchdog(Watchdog *pWatchdog, const std::string &strName,
+                                        MessageTypeExtractor extractor)
+    {
+        m_pLoopMonitor = pWatchdog ? pWatchdog->Watch(strName) : nullptr;
+        m_messageTypeExtractor = std::move(extractor);
+    }
+
+    MessageAccounting &ConnectionManager::EnableMessageAccounting(MessageTypeExtractor extractor, uint32 nMaxTypes)
+    {
+        m_pMessageAccounting = std::make_unique<MessageAccounting>(std::move(extractor), nMaxTypes);
+        return *m_pMessageAccounting;
+    }
+
+    int32 ConnectionManager::GetMessageType(const void *pData, uint32 cbSize) const
+    {
+        if (!m_pLoopMonitor || !m_messageTypeExtractor)
+            return -1;
+
+        return m_messageTypeExtractor(static_cast<const uint8 *>(pData), cbSize);
     }
 } // namespace QNET
\ No newline at end of file
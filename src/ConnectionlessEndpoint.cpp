@@ -0,0 +1,173 @@
+#include "quicknet/components/ConnectionlessEndpoint.h"
+
+#include <steam/isteamnetworkingmessages.h>
+#include <steam/isteamnetworkingutils.h>
+
+#include <algorithm>
+#include <iostream>
+
+namespace QNET
+{
+    ConnectionlessEndpoint *ConnectionlessEndpoint::s_pActiveEndpoint = nullptr;
+
+    ConnectionlessEndpoint::ConnectionlessEndpoint() : m_vecChannels{0} {}
+
+    /// @brief Unregisters the global session callbacks before the base class shuts the library down.
+    ConnectionlessEndpoint::~ConnectionlessEndpoint()
+    {
+        if (s_pActiveEndpoint == this)
+        {
+            SteamNetworkingUtils()->SetGlobalCallback_MessagesSessionRequest(nullptr);
+            SteamNetworkingUtils()->SetGlobalCallback_MessagesSessionFailed(nullptr);
+            s_pActiveEndpoint = nullptr;
+        }
+    }
+
+    /// @brief Acquires the messages interface and routes the global session callbacks to this instance.
+    bool ConnectionlessEndpoint::Initialize()
+    {
+        if (!m_pInterface)
+            return false;
+
+        if (s_pActiveEndpoint && s_pActiveEndpoint != this)
+        {
+            std::cerr << "ConnectionlessEndpoint: Another endpoint is already active." << std::endl;
+            return false;
+        }
+
+        m_pMessages = SteamNetworkingMessages();
+        if (!m_pMessages)
+        {
+            std::cerr << "ConnectionlessEndpoint: ISteamNetworkingMessages is not available." << std::endl;
+            return false;
+        }
+
+        s_pActiveEndpoint = this;
+        ISteamNetworkingUtils *pUtils = SteamNetworkingUtils();
+        pUtils->SetGlobalCallback_MessagesSessionRequest(&ConnectionlessEndpoint::OnGlobalSessionRequest);
+        pUtils->SetGlobalCallback_MessagesSessionFailed(&ConnectionlessEndpoint::OnGlobalSessionFailed);
+        return true;
+    }
+
+    void ConnectionlessEndpoint::ListenOnChannel(int nChannel)
+    {
+        if (std::find(m_vecChannels.begin(), m_vecChannels.end(), nChannel) == m_vecChannels.end())
+        {
+            m_vecChannels.push_back(nChannel);
+        }
+    }
+
+    bool ConnectionlessEndpoint::SendReliableMessageToPeer(const SteamNetworkingIdentity &identityRemote,
+                                                           const std::vector<uint8_t> &byteMessage, int nChannel)
+    {
+        return SendToPeer(identityRemote, byteMessage, k_nSteamNetworkingSend_Reliable, nChannel);
+    }
+
+    bool ConnectionlessEndpoint::SendUnreliableMessageToPeer(const SteamNetworkingIdentity &identityRemote,
+                                                             const std::vector<uint8_t> &byteMessage, int nChannel)
+    {
+        return SendToPeer(identityRemote, byteMessage, k_nSteamNetworkingSend_UnreliableNoDelay, nChannel);
+    }
+
+    /// @brief Parses an IP address into an identity of type k_ESteamNetworkingIdentityType_IPAddress and sends.
+    bool ConnectionlessEndpoint::SendMessageToAddress(const std::string &strAddress,
+                                                      const std::vector<uint8_t> &byteMessage, bool bReliable,
+                                                      int nChannel)
+    {
+        SteamNetworkingIPAddr addr;
+        if (!addr.ParseString(strAddress.c_str()))
+        {
+            std::cerr << "ConnectionlessEndpoint: Invalid address: " << strAddress << std::endl;
+            return false;
+        }
+
+        SteamNetworkingIdentity identity;
+        identity.Clear();
+        identity.SetIPAddr(addr);
+        return SendToPeer(identity, byteMessage,
+                          bReliable ? k_nSteamNetworkingSend_Reliable : k_nSteamNetworkingSend_UnreliableNoDelay,
+                          nChannel);
+    }
+
+    /// @brief Drains every listened channel. Messages are released after the callback returns.
+    void ConnectionlessEndpoint::ReceiveMessages()
+    {
+        if (!m_pMessages)
+            return;
+
+        constexpr int kBatchSize = 32;
+        ISteamNetworkingMessage *pIncomingMsgs[kBatchSize];
+        for (int nChannel : m_vecChannels)
+        {
+            int numMsgs;
+            do
+            {
+                numMsgs = m_pMessages->ReceiveMessagesOnChannel(nChannel, pIncomingMsgs, kBatchSize);
+                for (int i = 0; i < numMsgs; ++i)
+                {
+                    ISteamNetworkingMessage *pMsg = pIncomingMsgs[i];
+                    AccountReceived(pMsg->m_pData, uint32(pMsg->m_cbSize));
+                    if (pMsg->m_cbSize > 0 && OnMessageReceived)
+                    {
+                        std::vector<uint8_t> msg((const uint8_t *)pMsg->m_pData,
+                                                 (const uint8_t *)pMsg->m_pData + pMsg->m_cbSize);
+                        LoopMonitor::CallbackScope scope(GetLoopMonitor(), k_HSteamNetConnection_Invalid,
+                                                         GetMessageType(msg.data(), pMsg->m_cbSize));
+                        OnMessageReceived(pMsg->m_identityPeer, nChannel, msg);
+                    }
+                    pMsg->Release();
+                }
+            } while (numMsgs == kBatchSize);
+        }
+    }
+
+    void ConnectionlessEndpoint::CloseSession(const SteamNetworkingIdentity &identityRemote)
+    {
+        if (m_pMessages)
+        {
+            m_pMessages->CloseSessionWithUser(identityRemote);
+        }
+    }
+
+    void ConnectionlessEndpoint::HandleConnectionStatusChanged(SteamNetConnectionStatusChangedCallback_t *) {}
+
+    bool ConnectionlessEndpoint::SendToPeer(const SteamNetworkingIdentity &identityRemote,
+                                            const std::vector<uint8_t> &byteMessage, int nSendFlags, int nChannel)
+    {
+        if (!m_pMessages)
+            return false;
+
+        // k_nSteamNetworkingSend_AutoRestartBrokenSession lets a timed-out session be re-created transparently.
+        EResult eResult = m_pMessages->SendMessageToUser(identityRemote, byteMessage.data(),
+                                                         static_cast<uint32>(byteMessage.size()),
+                                                         nSendFlags | k_nSteamNetworkingSend_AutoRestartBrokenSession,
+                                                         nChannel);
+        if (eResult != k_EResultOK)
+            return false;
+
+        AccountSent(byteMessage.data(), static_cast<uint32>(byteMessage.size()));
+        return true;
+    }
+
+    /// @brief Accepts a new session unless the application-defined filter rejects the peer.
+    void ConnectionlessEndpoint::OnGlobalSessionRequest(SteamNetworkingMessagesSessionRequest_t *pInfo)
+    {
+        ConnectionlessEndpoint *pEndpoint = s_pActiveEndpoint;
+        if (!pEndpoint || !pEndpoint->m_pMessages)
+            return;
+
+        if (!pEndpoint->OnSessionRequest || pEndpoint->OnSessionRequest(pInfo->m_identityRemote))
+        {
+            pEndpoint->m_pMessages->AcceptSessionWithUser(pInfo->m_identityRemote);
+        }
+    }
+
+    void ConnectionlessEndpoint::OnGlobalSessionFailed(SteamNetworkingMessagesSessionFailed_t *pInfo)
+    {
+        ConnectionlessEndpoint *pEndpoint = s_pActiveEndpoint;
+        if (pEndpoint && pEndpoint->OnSessionFailed)
+        {
+            pEndpoint->OnSessionFailed(pInfo->m_info.m_identityRemote, pInfo->m_info.m_szEndDebug);
+        }
+    }
+} // namespace QNET
\ No newline at end of file
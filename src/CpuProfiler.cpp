@@ -0,0 +1,314 @@
+#include "quicknet/components/CpuProfiler.h"
+#include "quicknet/components/StackWalk.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <mutex>
+#include <thread>
+
+#if defined(__linux__) && defined(__GLIBC__)
+#define QNET_CPU_PROFILER 1
+#include <atomic>
+#include <cerrno>
+#include <csignal>
+#include <cstdlib>
+#include <cstring>
+#include <cxxabi.h>
+#include <dlfcn.h>
+#include <map>
+#include <memory>
+#include <sys/time.h>
+#include <unordered_map>
+#include <vector>
+#endif
+
+namespace QNET
+{
+    namespace
+    {
+#ifdef QNET_CPU_PROFILER
+        /// @brief Serializes Start() and Stop().
+        std::mutex s_controlMutex;
+
+        /// @brief The sample buffer: s_nMaxSamples slots of s_nMaxDepth frames starting at the interrupted PC, and the
+        /// frame count of each, which is stored last so that a non-zero count marks a complete stack.
+        void **s_apFrames = nullptr;
+        std::atomic<uint32_t> *s_anDepth = nullptr;
+        uint32_t s_nMaxSamples = 0;
+        uint32_t s_nMaxDepth = 0;
+
+        std::atomic<uint32_t> s_nNextSample{0};
+        std::atomic<uint64_t> s_nDropped{0};
+
+        /// @brief Set while the handler may write to the buffer, and the handlers running at this moment.
+        std::atomic<bool> s_bActive{false};
+        std::atomic<int> s_nInHandler{0};
+
+        /// @brief The SIGPROF disposition found by the first Start(), before the profiler's handler.
+        struct sigaction s_previousAction = {};
+        std::chrono::steady_clock::time_point s_tStart;
+
+        size_t SlotSize() { return static_cast<size_t>(s_nMaxDepth); }
+
+        void OnProfSignal(int, siginfo_t *, void *pContext)
+        {
+            const int nSavedErrno = errno;
+            s_nInHandler.fetch_add(1);
+            if (s_bActive.load())
+            {
+                const uint32_t nSample = s_nNextSample.fetch_add(1, std::memory_order_relaxed);
+                if (nSample < s_nMaxSamples)
+                {
+                    void **ppSlot = s_apFrames + nSample * SlotSize();
+                    const uint32_t nFrames = WalkSignalStack(pContext, ppSlot, s_nMaxDepth);
+                    s_anDepth[nSample].store(nFrames, std::memory_order_release);
+                }
+                else
+                {
+                    s_nDropped.fetch_add(1, std::memory_order_relaxed);
+                }
+            }
+            s_nInHandler.fetch_sub(1);
+            errno = nSavedErrno;
+        }
+
+        void FreeBuffer()
+        {
+            delete[] s_apFrames;
+            delete[] s_anDepth;
+            s_apFrames = nullptr;
+            s_anDepth = nullptr;
+        }
+
+        /// @brief Folds the recorded stacks into strFolded, heaviest first. Returns the number of samples.
+        uint64_t Fold(std::string &strFolded)
+        {
+            const uint32_t nSamples = std::min(s_nNextSample.load(), s_nMaxSamples);
+            std::map<std::vector<void *>, uint64_t> mapStacks;
+            uint64_t nRecorded = 0;
+            for (uint32_t i = 0; i < nSamples; ++i)
+            {
+                const uint32_t nDepth = s_anDepth[i].load(std::memory_order_acquire);
+                if (nDepth == 0)
+                    continue;
+
+                void **ppFrames = s_apFrames + i * SlotSize();
+                ++mapStacks[std::vector<void *>(ppFrames, ppFrames + nDepth)];
+                ++nRecorded;
+            }
+
+            // Stacks that differ only in addresses within the same functions fold into one line.
+            std::unordered_map<void *, std::string> mapNames;
+            std::unordered_map<std::string, uint64_t> mapLines;
+            for (const auto &entry : mapStacks)
+            {
+                std::string strLine;
+                const std::vector<void *> &vecFrames = entry.first;
+                for (size_t i = vecFrames.size(); i-- > 0;)
+                {
+                    // Every frame but the interrupted one holds a return address, which may already belong to the
+                    // next function; the address before it is inside the call.
+                    void *pAddress = i == 0 ? vecFrames[i] : static_cast<char *>(vecFrames[i]) - 1;
+                    auto it = mapNames.find(pAddress);
+                    if (it == mapNames.end())
+                    {
+                        it = mapNames.emplace(pAddress, SymbolizeAddress(pAddress)).first;
+                    }
+                    if (!strLine.empty())
+                    {
+                        strLine += ';';
+                    }
+                    strLine += it->second;
+                }
+                mapLines[strLine] += entry.second;
+            }
+
+            std::vector<std::pair<std::string, uint64_t>> vecLines(mapLines.begin(), mapLines.end());
+            std::sort(vecLines.begin(), vecLines.end(), [](const auto &a, const auto &b)
+                      { return a.second != b.second ? a.second > b.second : a.first < b.first; });
+            strFolded.clear();
+            for (const auto &line : vecLines)
+            {
+                strFolded += line.first + ' ' + std::to_string(line.second) + '\n';
+            }
+            return nRecorded;
+        }
+#endif
+    } // namespace
+
+    std::string SymbolizeAddress(const void *pAddress)
+    {
+#ifdef QNET_CPU_PROFILER
+        Dl_info info;
+        if (dladdr(pAddress, &info) != 0)
+        {
+            std::string strName;
+            if (info.dli_sname)
+            {
+                int nStatus = 0;
+                char *pszDemangled = abi::__cxa_demangle(info.dli_sname, nullptr, nullptr, &nStatus);
+                strName = nStatus == 0 && pszDemangled ? pszDemangled : info.dli_sname;
+                std::free(pszDemangled);
+            }
+            else
+            {
+                const char *pszModule = info.dli_fname ? info.dli_fname : "?";
+                const char *pszSlash = std::strrchr(pszModule, '/');
+                char szOffset[32];
+                std::snprintf(szOffset, sizeof(szOffset), "+0x%zx",
+                              static_cast<size_t>(static_cast<const char *>(pAddress) -
+                                                  static_cast<const char *>(info.dli_fbase)));
+                strName = std::string(pszSlash ? pszSlash + 1 : pszModule) + szOffset;
+            }
+
+            // ';' separates frames in the folded format.
+            std::replace(strName.begin(), strName.end(), ';', ':');
+            return strName;
+        }
+#endif
+        char szAddress[32];
+        std::snprintf(szAddress, sizeof(szAddress), "%p", pAddress);
+        return szAddress;
+    }
+
+    bool CpuProfiler::IsSupported()
+    {
+#ifdef QNET_CPU_PROFILER
+        return InitStackWalk();
+#else
+        return false;
+#endif
+    }
+
+    bool CpuProfiler::Start(const CpuProfilerConfig &config, std::string *pstrError)
+    {
+        auto fail = [pstrError](const char *pszReason)
+        {
+            if (pstrError)
+                *pstrError = pszReason;
+            return false;
+        };
+
+#ifdef QNET_CPU_PROFILER
+        if (config.nFrequencyHz == 0 || config.nFrequencyHz > 1000)
+            return fail("the frequency must be between 1 and 1000 Hz");
+        if (config.nMaxSamples == 0 || config.nMaxDepth == 0)
+            return fail("the sample buffer is too small");
+        if (!InitStackWalk())
+            return fail("stacks cannot be walked");
+
+        std::lock_guard<std::mutex> lock(s_controlMutex);
+        if (s_bActive.load())
+            return fail("a profile is already running");
+
+        s_nMaxSamples = config.nMaxSamples;
+        s_nMaxDepth = config.nMaxDepth;
+        s_apFrames = new void *[s_nMaxSamples * SlotSize()];
+        s_anDepth = new std::atomic<uint32_t>[s_nMaxSamples];
+        for (uint32_t i = 0; i < s_nMaxSamples; ++i)
+        {
+            s_anDepth[i].store(0, std::memory_order_relaxed);
+        }
+        s_nNextSample.store(0);
+        s_nDropped.store(0);
+
+        struct sigaction action = {};
+        action.sa_sigaction = OnProfSignal;
+        sigemptyset(&action.sa_mask);
+        action.sa_flags = SA_RESTART | SA_SIGINFO;
+        struct sigaction previous = {};
+        if (sigaction(SIGPROF, &action, &previous) != 0)
+        {
+            FreeBuffer();
+            return fail("could not install the SIGPROF handler");
+        }
+        if (previous.sa_sigaction != OnProfSignal)
+        {
+            s_previousAction = previous;
+        }
+
+        s_bActive.store(true);
+        s_tStart = std::chrono::steady_clock::now();
+
+        itimerval timer = {};
+        const uint32_t usecInterval = 1000000 / config.nFrequencyHz;
+        timer.it_interval.tv_sec = static_cast<time_t>(usecInterval / 1000000);
+        timer.it_interval.tv_usec = static_cast<suseconds_t>(usecInterval % 1000000);
+        timer.it_value = timer.it_interval;
+        if (setitimer(ITIMER_PROF, &timer, nullptr) != 0)
+        {
+            s_bActive.store(false);
+            FreeBuffer();
+            return fail("could not start the profiling timer");
+        }
+        return true;
+#else
+        (void)config;
+        return fail("CPU profiling is only supported on Linux with glibc");
+#endif
+    }
+
+    bool CpuProfiler::Stop(CpuProfile &profile)
+    {
+#ifdef QNET_CPU_PROFILER
+        std::lock_guard<std::mutex> lock(s_controlMutex);
+        if (!s_bActive.load())
+            return false;
+
+        itimerval timer = {};
+        setitimer(ITIMER_PROF, &timer, nullptr);
+
+        // A SIGPROF already pending may still arrive; once inactive the handler returns without touching the
+        // buffer, and handlers that saw it active are waited for before it is read.
+        s_bActive.store(false);
+        while (s_nInHandler.load() != 0)
+        {
+            std::this_thread::yield();
+        }
+
+        const auto usecDuration =
+            std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - s_tStart);
+        profile.usecDuration = static_cast<uint64_t>(usecDuration.count());
+        profile.nSamples = Fold(profile.strFolded);
+        profile.nDropped = s_nDropped.load();
+        FreeBuffer();
+
+        // A handler installed by someone else gets SIGPROF back. Otherwise the profiler's handler stays: it ignores
+        // signals while inactive, whereas the default action would end the process if a late one arrived.
+        if (s_previousAction.sa_handler != SIG_DFL && s_previousAction.sa_handler != SIG_IGN)
+        {
+            sigaction(SIGPROF, &s_previousAction, nullptr);
+        }
+        return true;
+#else
+        (void)profile;
+        return false;
+#endif
+    }
+
+    bool CpuProfiler::IsRunning()
+    {
+#ifdef QNET_CPU_PROFILER
+        return s_bActive.load();
+#else
+        return false;
+#endif
+    }
+
+    bool CpuProfiler::Profile(uint32_t nDurationMs, CpuProfile &profile, const CpuProfilerConfig &config,
+                              std::string *pstrError)
+    {
+        if (!Start(config, pstrError))
+            return false;
+
+        std::this_thread::sleep_for(std::chrono::milliseconds(nDurationMs));
+        if (!Stop(profile))
+        {
+            if (pstrError)
+                *pstrError = "the profile was stopped by another caller";
+            return false;
+        }
+        return true;
+    }
+} // namespace QNET
\ No newline at end of file
@@ -0,0 +1,302 @@
+#include "quicknet/components/FlightRecorder.h"
+
+#include "quicknet/components/ByteStream.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+
+namespace QNET
+{
+    namespace
+    {
+        const char kMagic[8] = {'Q', 'N', 'F', 'L', 'I', 'G', 'H', 'T'};
+        constexpr uint32 kVersion = 1;
+
+        /// @brief Size of a tick without its connections, and of one connection, in the file.
+        constexpr size_t kTickSize = 8 + 4 * 3 + 8 + 4 * 4 + 2;
+        constexpr size_t kConnectionSize = 4 * 8;
+
+        int64 SteadyMicroseconds()
+        {
+            return std::chrono::duration_cast<std::chrono::microseconds>(
+                       std::chrono::steady_clock::now().time_since_epoch())
+                .count();
+        }
+    } // namespace
+
+    FlightRecorder::FlightRecorder(const FlightRecorderConfig &config)
+        : m_config(config), m_vecRing(std::max<uint32>(config.nCapacity, 1))
+    {
+    }
+
+    FlightRecorder::~FlightRecorder()
+    {
+        {
+            std::lock_guard<std::mutex> lock(m_writerMutex);
+            m_bStopping = true;
+        }
+        m_writerCondition.notify_all();
+        if (m_writer.joinable())
+        {
+            m_writer.join();
+        }
+    }
+
+    void FlightRecorder::RequestDump(const std::string &strReason)
+    {
+        {
+            std::lock_guard<std::mutex> lock(m_requestMutex);
+            m_strRequestReason = strReason;
+        }
+        m_bDumpRequested.store(true, std::memory_order_release);
+    }
+
+    void FlightRecorder::BeginTick(SteamNetworkingMicroseconds usecTimestamp)
+    {
+        m_current = FlightTick();
+        m_current.usecTimestamp = usecTimestamp;
+    }
+
+    void FlightRecorder::RecordBatch(HSteamNetConnection hConn, uint32 usecTime, uint32 nMessages, uint64 cbBytes)
+    {
+        const uint32 cbClamped = uint32(std::min<uint64>(cbBytes, UINT32_MAX));
+        FlightConnection *pBegin = m_current.aWorstConnections;
+        FlightConnection *pEnd = pBegin + m_current.nWorstConnections;
+
+        // A connection can have several batches in a tick. The list only holds a few entries, so a linear scan is
+        // cheaper than any index.
+        FlightConnection *pEntry =
+            std::find_if(pBegin, pEnd, [hConn](const FlightConnection &conn) { return conn.hConn == hConn; });
+        if (pEntry == pEnd)
+        {
+            if (m_current.nWorstConnections < FlightTick::kMaxWorstConnections)
+            {
+                ++m_current.nWorstConnections;
+            }
+            else
+            {
+                pEntry = std::min_element(pBegin, pEnd, [](const FlightConnection &a, const FlightConnection &b)
+                                          { return a.usecTime < b.usecTime; });
+                if (pEntry->usecTime >= usecTime)
+                    return;
+            }
+            *pEntry = FlightConnection();
+            pEntry->hConn = hConn;
+        }
+
+        pEntry->usecTime += usecTime;
+        pEntry->nMessages += nMessages;
+        pEntry->cbBytes = uint32(std::min<uint64>(uint64(pEntry->cbBytes) + cbClamped, UINT32_MAX));
+    }
+
+    bool FlightRecorder::EndTick(uint32 usecDuration)
+    {
+        m_current.usecDuration = usecDuration;
+        std::sort(m_current.aWorstConnections, m_current.aWorstConnections + m_current.nWorstConnections,
+                  [](const FlightConnection &a, const FlightConnection &b) { return a.usecTime > b.usecTime; });
+
+        m_vecRing[m_nNext] = m_current;
+        m_nNext = (m_nNext + 1) % m_vecRing.size();
+        m_nStored = std::min(m_nStored + 1, m_vecRing.size());
+
+        if (m_bDumpRequested.load(std::memory_order_acquire))
+        {
+            std::string strReason;
+            {
+                std::lock_guard<std::mutex> lock(m_requestMutex);
+                strReason = std::move(m_strRequestReason);
+                m_bDumpRequested.store(false, std::memory_order_relaxed);
+            }
+            QueueDump(strReason.empty() ? "requested" : std::move(strReason));
+            return true;
+        }
+
+        if (m_config.nThresholdMicroseconds == 0 || usecDuration <= m_config.nThresholdMicroseconds)
+            return false;
+
+        const int64 usecNow = SteadyMicroseconds();
+        if (m_bDumped && usecNow - m_usecLastDump < int64(m_config.nMinDumpIntervalMs) * 1000)
+            return false;
+
+        QueueDump("threshold");
+        return true;
+    }
+
+    void FlightRecorder::QueueDump(std::string strReason)
+    {
+        m_bDumped = true;
+        m_usecLastDump = SteadyMicroseconds();
+
+        FlightDump dump;
+        dump.strReason = std::move(strReason);
+        dump.nThresholdMicroseconds = m_config.nThresholdMicroseconds;
+        dump.usecTrigger = m_current.usecTimestamp;
+        dump.vecTicks.reserve(m_nStored);
+        const size_t nOldest = (m_nNext + m_vecRing.size() - m_nStored) % m_vecRing.size();
+        for (size_t i = 0; i < m_nStored; ++i)
+        {
+            dump.vecTicks.push_back(m_vecRing[(nOldest + i) % m_vecRing.size()]);
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(m_writerMutex);
+            m_dequeDumps.push_back(std::move(dump));
+        }
+        m_nDumps.fetch_add(1, std::memory_order_relaxed);
+
+        // Started with the first dump, so a recorder that never dumps costs no thread.
+        if (!m_writer.joinable())
+        {
+            m_writer = std::thread(&FlightRecorder::WriterLoop, this);
+        }
+        m_writerCondition.notify_one();
+    }
+
+    void FlightRecorder::WriterLoop()
+    {
+        std::unique_lock<std::mutex> lock(m_writerMutex);
+        while (true)
+        {
+            m_writerCondition.wait(lock, [this] { return m_bStopping || !m_dequeDumps.empty(); });
+            if (m_dequeDumps.empty())
+                return; // Stopping, and everything queued has been written.
+
+            FlightDump dump = std::move(m_dequeDumps.front());
+            m_dequeDumps.pop_front();
+            const uint32 nSequence = m_nSequence++;
+            lock.unlock();
+
+            const int64 msNow = std::chrono::duration_cast<std::chrono::milliseconds>(
+                                    std::chrono::system_clock::now().time_since_epoch())
+                                    .count();
+            std::string strPath = m_config.strDirectory + "/" + m_config.strFilePrefix + "-" +
+                                  std::to_string(msNow) + "-" + std::to_string(nSequence) + ".qnfr";
+            if (WriteDump(strPath, dump))
+            {
+                std::cout << "FlightRecorder: wrote " << dump.vecTicks.size() << " ticks (" << dump.strReason
+                          << ") to " << strPath << std::endl;
+            }
+            else
+            {
+                std::cerr << "FlightRecorder: failed to write " << strPath << std::endl;
+                strPath.clear();
+            }
+
+            if (OnDump)
+            {
+                OnDump(strPath);
+            }
+            lock.lock();
+        }
+    }
+
+    bool FlightRecorder::WriteDump(const std::string &strPath, const FlightDump &dump)
+    {
+        std::string strOut;
+        strOut.reserve(64 + dump.strReason.size() +
+                       dump.vecTicks.size() * (kTickSize + FlightTick::kMaxWorstConnections * kConnectionSize));
+
+        const std::string strReason = dump.strReason.substr(0, UINT16_MAX);
+        strOut.append(kMagic, sizeof(kMagic));
+        AppendLittleEndian(strOut, kVersion, 4);
+        AppendLittleEndian(strOut, dump.nThresholdMicroseconds, 4);
+        AppendLittleEndian(strOut, uint64(dump.usecTrigger), 8);
+        AppendLittleEndian(strOut, strReason.size(), 2);
+        strOut += strReason;
+        AppendLittleEndian(strOut, dump.vecTicks.size(), 4);
+
+        for (const FlightTick &tick : dump.vecTicks)
+        {
+            AppendLittleEndian(strOut, uint64(tick.usecTimestamp), 8);
+            AppendLittleEndian(strOut, tick.usecDuration, 4);
+            AppendLittleEndian(strOut, tick.usecDispatch, 4);
+            AppendLittleEndian(strOut, tick.nMessages, 4);
+            AppendLittleEndian(strOut, tick.cbBytes, 8);
+            AppendLittleEndian(strOut, tick.nClients, 4);
+            AppendLittleEndian(strOut, tick.nAuthenticating, 4);
+            AppendLittleEndian(strOut, tick.nBacklogConnections, 4);
+            AppendLittleEndian(strOut, tick.nThrottledConnections, 4);
+            AppendLittleEndian(strOut, tick.bBudgetExhausted ? 1 : 0, 1);
+
+            const uint32 nConnections = std::min(tick.nWorstConnections, FlightTick::kMaxWorstConnections);
+            AppendLittleEndian(strOut, nConnections, 1);
+            for (uint32 i = 0; i < nConnections; ++i)
+            {
+                const FlightConnection &conn = tick.aWorstConnections[i];
+                AppendLittleEndian(strOut, conn.hConn, 4);
+                AppendLittleEndian(strOut, conn.usecTime, 4);
+                AppendLittleEndian(strOut, conn.nMessages, 4);
+                AppendLittleEndian(strOut, conn.cbBytes, 4);
+                AppendLittleEndian(strOut, uint32(conn.nPingMs), 4);
+                AppendLittleEndian(strOut, uint32(conn.cbPendingReliable), 4);
+                AppendLittleEndian(strOut, uint32(conn.cbPendingUnreliable), 4);
+                AppendLittleEndian(strOut, conn.usecQueueTime, 4);
+            }
+        }
+
+        std::ofstream file(strPath, std::ios::binary | std::ios::trunc);
+        if (!file)
+            return false;
+
+        file.write(strOut.data(), std::streamsize(strOut.size()));
+        return bool(file);
+    }
+
+    bool FlightRecorder::ReadDump(const std::string &strPath, FlightDump &dump)
+    {
+        std::ifstream file(strPath, std::ios::binary);
+        if (!file)
+            return false;
+
+        const std::string strData((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+        if (strData.size() < sizeof(kMagic) || std::memcmp(strData.data(), kMagic, sizeof(kMagic)) != 0)
+            return false;
+
+        ByteReader reader(strData);
+        std::string strMagic;
+        uint32 nVersion = 0;
+        uint16 cbReason = 0;
+        uint32 nTicks = 0;
+        if (!reader.ReadString(strMagic, sizeof(kMagic)) || !reader.Read(nVersion) || nVersion != kVersion ||
+            !reader.Read(dump.nThresholdMicroseconds) || !reader.Read(dump.usecTrigger) || !reader.Read(cbReason) ||
+            !reader.ReadString(dump.strReason, cbReason) || !reader.Read(nTicks))
+            return false;
+
+        // Every tick takes at least kTickSize bytes, which bounds the reservation for a corrupt count.
+        if (reader.GetRemaining() / kTickSize < nTicks)
+            return false;
+
+        dump.vecTicks.clear();
+        dump.vecTicks.reserve(nTicks);
+        for (uint32 i = 0; i < nTicks; ++i)
+        {
+            FlightTick tick;
+            uint8 bExhausted = 0;
+            uint8 nConnections = 0;
+            if (!reader.Read(tick.usecTimestamp) || !reader.Read(tick.usecDuration) ||
+                !reader.Read(tick.usecDispatch) || !reader.Read(tick.nMessages) || !reader.Read(tick.cbBytes) ||
+                !reader.Read(tick.nClients) || !reader.Read(tick.nAuthenticating) ||
+                !reader.Read(tick.nBacklogConnections) || !reader.Read(tick.nThrottledConnections) ||
+                !reader.Read(bExhausted) || !reader.Read(nConnections) ||
+                nConnections > FlightTick::kMaxWorstConnections)
+                return false;
+
+            tick.bBudgetExhausted = bExhausted != 0;
+            tick.nWorstConnections = nConnections;
+            for (uint32 j = 0; j < nConnections; ++j)
+            {
+                FlightConnection &conn = tick.aWorstConnections[j];
+                if (!reader.Read(conn.hConn) || !reader.Read(conn.usecTime) || !reader.Read(conn.nMessages) ||
+                    !reader.Read(conn.cbBytes) || !reader.Read(conn.nPingMs) || !reader.Read(conn.cbPendingReliable) ||
+                    !reader.Read(conn.cbPendingUnreliable) || !reader.Read(conn.usecQueueTime))
+                    return false;
+            }
+            dump.vecTicks.push_back(tick);
+        }
+        return true;
+    }
+} // namespace QNET
\ No newline at end of file
@@ -0,0 +1,605 @@
+#include "quicknet/components/HeapProfiler.h"
+
+#include "quicknet/components/CpuProfiler.h"
+
+#include <algorithm>
+#include <chrono>
+#include <mutex>
+#include <utility>
+
+#if defined(QNET_ENABLE_HEAP_PROFILER) && defined(__linux__) && defined(__GLIBC__)
+#define QNET_HEAP_PROFILER 1
+#include <atomic>
+#include <cmath>
+#include <cstddef>
+#include <cstdlib>
+#include <execinfo.h>
+#include <map>
+#include <new>
+#include <unordered_map>
+#include <vector>
+#endif
+
+namespace QNET
+{
+    namespace
+    {
+#ifdef QNET_HEAP_PROFILER
+        /// @brief An allocation stack and the samples taken there. The stack and hash are written under
+        /// s_sampleMutex; the counters are also updated by frees, without it.
+        struct Site
+        {
+            uint64_t nHash;
+            uint32_t nDepth;
+            std::atomic<uint64_t> nAllocSamples;
+            std::atomic<uint64_t> nFreeSamples;
+            std::atomic<uint64_t> cbAllocated;
+            std::atomic<uint64_t> cbFreed;
+        };
+
+        /// @brief A sampled allocation not yet freed. The address is stored last, so a slot holding it is complete;
+        /// a free swaps it for kTombstone, and only then may the slot be reused.
+        struct LiveSample
+        {
+            std::atomic<uintptr_t> nAddress;
+            std::atomic<uint32_t> nSite;
+            std::atomic<uint32_t> cbSize;
+        };
+
+        constexpr uintptr_t kEmpty = 0;
+        constexpr uintptr_t kTombstone = 1;
+        constexpr uint32_t kNoSite = UINT32_MAX;
+
+        /// @brief Slots probed for a site or sample before giving up; keeps a delete's lookup short.
+        constexpr uint32_t kMaxProbes = 16;
+
+        /// @brief Frames above the allocating code: the sampler and operator new.
+        constexpr uint32_t kSkipFrames = 2;
+        constexpr uint32_t kMaxDepth = 128;
+
+        /// @brief Serializes sampling, Start() and GetProfile(); taken once per sample, not per allocation.
+        std::mutex s_sampleMutex;
+
+        /// @brief The tables of one configuration. Sites are an open-addressing table of nSiteMask + 1 slots, with
+        /// the frames of slot i at apFrames + i * nMaxDepth.
+        struct Tables
+        {
+            Site *aSites = nullptr;
+            void **apFrames = nullptr;
+            uint32_t nSiteMask = 0;
+            uint32_t nMaxSites = 0;
+            uint32_t nMaxDepth = 0;
+            LiveSample *aLive = nullptr;
+            uint32_t nLiveMask = 0;
+            uint32_t nMaxLiveSamples = 0;
+        };
+
+        /// @brief The tables of the running or last profile, and every set allocated so far. Start() switches to a
+        /// set matching its config, allocating one if needed. A set is never freed, since a delete that saw an
+        /// earlier profile running may still be probing it, so reconfiguring costs memory once per distinct config.
+        std::atomic<Tables *> s_pTables{nullptr};
+        std::vector<Tables *> s_vecTables;
+        uint32_t s_nSites = 0;
+
+        std::atomic<bool> s_bActive{false};
+        std::atomic<uint64_t> s_cbSampleInterval{0};
+        uint64_t s_nSamples = 0;
+        uint64_t s_nDropped = 0;
+        std::chrono::steady_clock::time_point s_tStart;
+        std::chrono::steady_clock::time_point s_tStop;
+
+        /// @brief Bumped by each Start(), so that threads draw a fresh distance to their next sample.
+        std::atomic<uint32_t> s_nGeneration{0};
+
+        /// @brief Per-thread sampling state. t_bInProfiler stops the profiler's own allocations from being sampled.
+        thread_local int64_t t_cbUntilSample = 0;
+        thread_local uint32_t t_nGeneration = 0;
+        thread_local uint64_t t_nRandom = 0;
+        thread_local bool t_bInProfiler = false;
+
+        uint32_t HashAddress(uintptr_t nAddress)
+        {
+            return static_cast<uint32_t>((static_cast<uint64_t>(nAddress) >> 4) * 0x9E3779B97F4A7C15ull >> 32);
+        }
+
+        uint32_t RoundUpToPowerOfTwo(uint32_t n)
+        {
+            uint32_t nPower = 1;
+            while (nPower < n)
+            {
+                nPower <<= 1;
+            }
+            return nPower;
+        }
+
+        /// @brief Draws the bytes until the next sample, exponentially distributed around s_cbSampleInterval.
+        int64_t NextInterval()
+        {
+            if (t_nRandom == 0)
+            {
+                t_nRandom = reinterpret_cast<uintptr_t>(&t_nRandom) ^
+                            static_cast<uint64_t>(std::chrono::steady_clock::now().time_since_epoch().count()) ^
+                            0x2545F4914F6CDD1Dull;
+            }
+            t_nRandom ^= t_nRandom >> 12;
+            t_nRandom ^= t_nRandom << 25;
+            t_nRandom ^= t_nRandom >> 27;
+            const double dUniform = static_cast<double>(((t_nRandom * 0x2545F4914F6CDD1Dull) >> 11) + 1) * 0x1.0p-53;
+            const double dMean = static_cast<double>(s_cbSampleInterval.load(std::memory_order_relaxed));
+            const double dInterval = -std::log(dUniform) * dMean;
+            return static_cast<int64_t>(std::min(dInterval, 1e15)) + 1;
+        }
+
+        /// @brief Estimated bytes allocated for each sampled allocation of cbSize: a sample of cbSize is taken with
+        /// probability 1 - exp(-cbSize / interval), so dividing by that keeps the totals unbiased.
+        uint64_t SampleWeight(uint64_t cbSize)
+        {
+            const double dSize = static_cast<double>(cbSize);
+            const double dMean = static_cast<double>(s_cbSampleInterval.load(std::memory_order_relaxed));
+            return static_cast<uint64_t>(dSize / -std::expm1(-dSize / dMean));
+        }
+
+        /// @brief Returns the slot of the stack, adding it if new, or kNoSite if the table is full. Called under
+        /// s_sampleMutex.
+        uint32_t FindSite(Tables &tables, void *const *ppFrames, uint32_t nDepth)
+        {
+            uint64_t nHash = 14695981039346656037ull;
+            for (uint32_t i = 0; i < nDepth; ++i)
+            {
+                nHash = (nHash ^ reinterpret_cast<uintptr_t>(ppFrames[i])) * 1099511628211ull;
+            }
+            nHash |= 1;
+
+            uint32_t nSlot = static_cast<uint32_t>(nHash >> 32) & tables.nSiteMask;
+            for (uint32_t nProbe = 0; nProbe <= tables.nSiteMask; ++nProbe, nSlot = (nSlot + 1) & tables.nSiteMask)
+            {
+                Site &site = tables.aSites[nSlot];
+                void **ppSiteFrames = tables.apFrames + static_cast<size_t>(nSlot) * tables.nMaxDepth;
+                if (site.nHash == nHash && site.nDepth == nDepth &&
+                    std::equal(ppFrames, ppFrames + nDepth, ppSiteFrames))
+                    return nSlot;
+                if (site.nHash != 0)
+                    continue;
+                if (s_nSites == tables.nMaxSites)
+                    return kNoSite;
+
+                std::copy(ppFrames, ppFrames + nDepth, ppSiteFrames);
+                site.nDepth = nDepth;
+                site.nHash = nHash;
+                ++s_nSites;
+                return nSlot;
+            }
+            return kNoSite;
+        }
+
+        /// @brief Remembers a sampled allocation until it is freed. Called under s_sampleMutex, so it is the only
+        /// writer of empty and tombstone slots.
+        bool TrackLive(Tables &tables, void *p, uint32_t nSite, uint64_t cbSize)
+        {
+            const uintptr_t nAddress = reinterpret_cast<uintptr_t>(p);
+            uint32_t nSlot = HashAddress(nAddress) & tables.nLiveMask;
+            for (uint32_t nProbe = 0; nProbe < kMaxProbes; ++nProbe, nSlot = (nSlot + 1) & tables.nLiveMask)
+            {
+                LiveSample &sample = tables.aLive[nSlot];
+                const uintptr_t nCurrent = sample.nAddress.load(std::memory_order_relaxed);
+                if (nCurrent != kEmpty && nCurrent != kTombstone)
+                    continue;
+
+                sample.nSite.store(nSite, std::memory_order_relaxed);
+                sample.cbSize.store(static_cast<uint32_t>(std::min<uint64_t>(cbSize, UINT32_MAX)),
+                                    std::memory_order_relaxed);
+                sample.nAddress.store(nAddress, std::memory_order_release);
+                return true;
+            }
+            return false;
+        }
+
+        __attribute__((noinline)) void RecordSample(void *p, size_t cbSize)
+        {
+            t_bInProfiler = true;
+            // The depth is checked again under the lock, since a new profile may have switched the tables since.
+            void *apFrames[kMaxDepth + kSkipFrames];
+            const uint32_t nMaxDepth = s_pTables.load(std::memory_order_acquire)->nMaxDepth;
+            const int nFrames = backtrace(apFrames, static_cast<int>(nMaxDepth + kSkipFrames));
+            const uint32_t nFound = nFrames > static_cast<int>(kSkipFrames) ? nFrames - kSkipFrames : 0;
+            {
+                std::lock_guard<std::mutex> lock(s_sampleMutex);
+                // The profile may have stopped while the stack was unwound; its sites must not change after Stop().
+                if (!s_bActive.load(std::memory_order_relaxed))
+                {
+                    t_bInProfiler = false;
+                    return;
+                }
+
+                Tables &tables = *s_pTables.load(std::memory_order_relaxed);
+                const uint32_t nDepth = std::min(nFound, tables.nMaxDepth);
+                const uint32_t nSite = FindSite(tables, apFrames + kSkipFrames, nDepth);
+                if (nSite != kNoSite && TrackLive(tables, p, nSite, cbSize))
+                {
+                    Site &site = tables.aSites[nSite];
+                    site.nAllocSamples.fetch_add(1, std::memory_order_relaxed);
+                    site.cbAllocated.fetch_add(SampleWeight(cbSize), std::memory_order_relaxed);
+                    ++s_nSamples;
+                }
+                else
+                {
+                    ++s_nDropped;
+                }
+            }
+            t_bInProfiler = false;
+        }
+
+        __attribute__((noinline)) void ForgetSample(void *p)
+        {
+            const Tables *pTables = s_pTables.load(std::memory_order_acquire);
+            if (!pTables)
+                return;
+
+            const uintptr_t nAddress = reinterpret_cast<uintptr_t>(p);
+            uint32_t nSlot = HashAddress(nAddress) & pTables->nLiveMask;
+            for (uint32_t nProbe = 0; nProbe < kMaxProbes; ++nProbe, nSlot = (nSlot + 1) & pTables->nLiveMask)
+            {
+                LiveSample &sample = pTables->aLive[nSlot];
+                uintptr_t nCurrent = sample.nAddress.load(std::memory_order_acquire);
+                if (nCurrent == kEmpty)
+                    return;
+                if (nCurrent != nAddress)
+                    continue;
+
+                const uint32_t nSite = sample.nSite.load(std::memory_order_relaxed);
+                const uint32_t cbSize = sample.cbSize.load(std::memory_order_relaxed);
+                if (sample.nAddress.compare_exchange_strong(nCurrent, kTombstone, std::memory_order_acq_rel))
+                {
+                    Site &site = pTables->aSites[nSite];
+                    site.cbFreed.fetch_add(SampleWeight(cbSize), std::memory_order_relaxed);
+                    site.nFreeSamples.fetch_add(1, std::memory_order_relaxed);
+                }
+                return;
+            }
+        }
+
+        /// @brief Counts an allocation against the thread's distance to its next sample. Always inlined, so the
+        /// sampled stack starts at operator new's caller.
+        __attribute__((always_inline)) inline void OnAllocate(void *p, size_t cbSize)
+        {
+            if (!s_bActive.load(std::memory_order_relaxed) || t_bInProfiler)
+                return;
+
+            const uint32_t nGeneration = s_nGeneration.load(std::memory_order_relaxed);
+            if (t_nGeneration != nGeneration)
+            {
+                t_nGeneration = nGeneration;
+                t_cbUntilSample = NextInterval();
+            }
+
+            t_cbUntilSample -= static_cast<int64_t>(std::min<size_t>(cbSize, INT64_MAX / 2));
+            if (t_cbUntilSample >= 0)
+                return;
+
+            t_cbUntilSample = NextInterval();
+            RecordSample(p, cbSize);
+        }
+
+        __attribute__((always_inline)) inline void OnFree(void *p)
+        {
+            if (p && s_bActive.load(std::memory_order_relaxed))
+            {
+                ForgetSample(p);
+            }
+        }
+
+        __attribute__((always_inline)) inline void *Allocate(size_t cbSize, size_t nAlignment, bool bThrow)
+        {
+            if (cbSize == 0)
+            {
+                cbSize = 1;
+            }
+            for (;;)
+            {
+                void *p = nullptr;
+                if (nAlignment <= alignof(std::max_align_t))
+                {
+                    p = std::malloc(cbSize);
+                }
+                else if (posix_memalign(&p, nAlignment, cbSize) != 0)
+                {
+                    p = nullptr;
+                }
+                if (p)
+                {
+                    OnAllocate(p, cbSize);
+                    return p;
+                }
+
+                const std::new_handler pfnHandler = std::get_new_handler();
+                if (!pfnHandler)
+                {
+                    if (bThrow)
+                        throw std::bad_alloc();
+                    return nullptr;
+                }
+                if (bThrow)
+                {
+                    pfnHandler();
+                    continue;
+                }
+                try
+                {
+                    pfnHandler();
+                }
+                catch (const std::bad_alloc &)
+                {
+                    return nullptr;
+                }
+            }
+        }
+
+        __attribute__((always_inline)) inline void Free(void *p)
+        {
+            OnFree(p);
+            std::free(p);
+        }
+#endif
+    } // namespace
+
+    bool HeapProfiler::IsSupported()
+    {
+#ifdef QNET_HEAP_PROFILER
+        return true;
+#else
+        return false;
+#endif
+    }
+
+    bool HeapProfiler::Start(const HeapProfilerConfig &config, std::string *pstrError)
+    {
+        auto fail = [pstrError](const char *pszReason)
+        {
+            if (pstrError)
+                *pstrError = pszReason;
+            return false;
+        };
+
+#ifdef QNET_HEAP_PROFILER
+        if (config.cbSampleInterval == 0)
+            return fail("the sample interval must not be zero");
+        if (config.nMaxSites == 0 || config.nMaxLiveSamples == 0 || config.nMaxSites > (1u << 24) ||
+            config.nMaxLiveSamples > (1u << 28))
+            return fail("the site and live sample limits must be between 1 and 2^24 and 2^28");
+        if (config.nMaxDepth == 0 || config.nMaxDepth > kMaxDepth)
+            return fail("the stack depth must be between 1 and 128");
+
+        std::lock_guard<std::mutex> lock(s_sampleMutex);
+        if (s_bActive.load())
+            return fail("a heap profile is already running");
+
+        Tables *pTables = nullptr;
+        for (Tables *pCandidate : s_vecTables)
+        {
+            if (pCandidate->nMaxSites == config.nMaxSites && pCandidate->nMaxDepth == config.nMaxDepth &&
+                pCandidate->nMaxLiveSamples == config.nMaxLiveSamples)
+            {
+                pTables = pCandidate;
+                break;
+            }
+        }
+        if (!pTables)
+        {
+            pTables = new Tables;
+            pTables->nMaxSites = config.nMaxSites;
+            pTables->nMaxDepth = config.nMaxDepth;
+            pTables->nMaxLiveSamples = config.nMaxLiveSamples;
+            pTables->nSiteMask = RoundUpToPowerOfTwo(config.nMaxSites * 2) - 1;
+            pTables->nLiveMask = RoundUpToPowerOfTwo(config.nMaxLiveSamples * 2) - 1;
+            pTables->aSites = new Site[static_cast<size_t>(pTables->nSiteMask) + 1];
+            pTables->apFrames = new void *[(static_cast<size_t>(pTables->nSiteMask) + 1) * pTables->nMaxDepth];
+            pTables->aLive = new LiveSample[static_cast<size_t>(pTables->nLiveMask) + 1];
+            s_vecTables.push_back(pTables);
+        }
+
+        for (uint32_t i = 0; i <= pTables->nSiteMask; ++i)
+        {
+            Site &site = pTables->aSites[i];
+            site.nHash = 0;
+            site.nDepth = 0;
+            site.nAllocSamples.store(0, std::memory_order_relaxed);
+            site.nFreeSamples.store(0, std::memory_order_relaxed);
+            site.cbAllocated.store(0, std::memory_order_relaxed);
+            site.cbFreed.store(0, std::memory_order_relaxed);
+        }
+        for (uint32_t i = 0; i <= pTables->nLiveMask; ++i)
+        {
+            pTables->aLive[i].nAddress.store(kEmpty, std::memory_order_relaxed);
+        }
+        s_pTables.store(pTables, std::memory_order_release);
+        s_nSites = 0;
+        s_nSamples = 0;
+        s_nDropped = 0;
+        s_cbSampleInterval.store(config.cbSampleInterval);
+
+        // backtrace() loads libgcc on first use, which is better done here than under the first sampled new.
+        void *apWarmup[1];
+        backtrace(apWarmup, 1);
+
+        s_tStart = std::chrono::steady_clock::now();
+        s_nGeneration.fetch_add(1);
+        s_bActive.store(true);
+        return true;
+#else
+        (void)config;
+        return fail("the heap profiler needs a build with QNET_ENABLE_HEAP_PROFILER=ON on Linux with glibc");
+#endif
+    }
+
+    bool HeapProfiler::Stop()
+    {
+#ifdef QNET_HEAP_PROFILER
+        std::lock_guard<std::mutex> lock(s_sampleMutex);
+        if (!s_bActive.load())
+            return false;
+
+        s_bActive.store(false);
+        s_tStop = std::chrono::steady_clock::now();
+        return true;
+#else
+        return false;
+#endif
+    }
+
+    bool HeapProfiler::IsRunning()
+    {
+#ifdef QNET_HEAP_PROFILER
+        return s_bActive.load();
+#else
+        return false;
+#endif
+    }
+
+    bool HeapProfiler::GetProfile(HeapProfile &profile, size_t nMaxSites)
+    {
+#ifdef QNET_HEAP_PROFILER
+        struct SiteCopy
+        {
+            HeapSite site;
+            std::vector<void *> vecFrames;
+        };
+
+        const bool bWasInProfiler = t_bInProfiler;
+        t_bInProfiler = true;
+        std::vector<SiteCopy> vecCopies;
+        {
+            std::lock_guard<std::mutex> lock(s_sampleMutex);
+            const Tables *pTables = s_pTables.load(std::memory_order_relaxed);
+            if (!pTables)
+            {
+                t_bInProfiler = bWasInProfiler;
+                return false;
+            }
+
+            profile = HeapProfile();
+            profile.bRunning = s_bActive.load();
+            profile.nSamples = s_nSamples;
+            profile.nDropped = s_nDropped;
+            profile.cbSampleInterval = s_cbSampleInterval.load();
+            const auto tEnd = profile.bRunning ? std::chrono::steady_clock::now() : s_tStop;
+            profile.usecDuration = static_cast<uint64_t>(
+                std::chrono::duration_cast<std::chrono::microseconds>(tEnd - s_tStart).count());
+
+            vecCopies.reserve(s_nSites);
+            for (uint32_t i = 0; i <= pTables->nSiteMask; ++i)
+            {
+                const Site &site = pTables->aSites[i];
+                if (site.nHash == 0)
+                    continue;
+
+                // Frees are counted after their allocation, so reading them first never shows more freed than
+                // allocated.
+                SiteCopy copy;
+                copy.site.nFreeSamples = site.nFreeSamples.load(std::memory_order_relaxed);
+                copy.site.cbFreed = site.cbFreed.load(std::memory_order_relaxed);
+                copy.site.nAllocSamples = site.nAllocSamples.load(std::memory_order_relaxed);
+                copy.site.cbAllocated = site.cbAllocated.load(std::memory_order_relaxed);
+                if (copy.site.nAllocSamples == 0)
+                    continue;
+
+                copy.site.cbFreed = std::min(copy.site.cbFreed, copy.site.cbAllocated);
+                void **ppFrames = pTables->apFrames + static_cast<size_t>(i) * pTables->nMaxDepth;
+                copy.vecFrames.assign(ppFrames, ppFrames + site.nDepth);
+                profile.cbAllocated += copy.site.cbAllocated;
+                profile.cbFreed += copy.site.cbFreed;
+                vecCopies.push_back(std::move(copy));
+            }
+        }
+
+        // Symbols are resolved outside the lock. The frames are return addresses; the address before each is inside
+        // the call. Stacks that differ only in addresses within the same functions merge into one site.
+        std::unordered_map<void *, std::string> mapNames;
+        std::map<std::vector<std::string>, HeapSite> mapSites;
+        for (SiteCopy &copy : vecCopies)
+        {
+            std::vector<std::string> vecStack;
+            for (void *pFrame : copy.vecFrames)
+            {
+                void *pAddress = static_cast<char *>(pFrame) - 1;
+                auto it = mapNames.find(pAddress);
+                if (it == mapNames.end())
+                {
+                    it = mapNames.emplace(pAddress, SymbolizeAddress(pAddress)).first;
+                }
+                // Allocators that wrap operator new (sanitizers, for one) can leave it on top of the stack.
+                if (!vecStack.empty() || it->second.compare(0, 12, "operator new") != 0)
+                {
+                    vecStack.push_back(it->second);
+                }
+            }
+
+            HeapSite &site = mapSites[vecStack];
+            site.nAllocSamples += copy.site.nAllocSamples;
+            site.nFreeSamples += copy.site.nFreeSamples;
+            site.cbAllocated += copy.site.cbAllocated;
+            site.cbFreed += copy.site.cbFreed;
+        }
+
+        for (auto &entry : mapSites)
+        {
+            entry.second.vecStack = entry.first;
+            profile.vecSites.push_back(std::move(entry.second));
+        }
+        std::sort(profile.vecSites.begin(), profile.vecSites.end(),
+                  [](const HeapSite &a, const HeapSite &b)
+                  {
+                      if (a.GetLiveBytes() != b.GetLiveBytes())
+                          return a.GetLiveBytes() > b.GetLiveBytes();
+                      return a.cbAllocated > b.cbAllocated;
+                  });
+        profile.vecSites.resize(std::min(profile.vecSites.size(), nMaxSites));
+        t_bInProfiler = bWasInProfiler;
+        return true;
+#else
+        (void)profile;
+        (void)nMaxSites;
+        return false;
+#endif
+    }
+} // namespace QNET
+
+#ifdef QNET_HEAP_PROFILER
+// The replacements of the global allocation functions. Every form is replaced, so that memory is always allocated
+// and freed by the same pair of functions.
+void *operator new(std::size_t cbSize) { return QNET::Allocate(cbSize, 0, true); }
+void *operator new[](std::size_t cbSize) { return QNET::Allocate(cbSize, 0, true); }
+void *operator new(std::size_t cbSize, const std::nothrow_t &) noexcept { return QNET::Allocate(cbSize, 0, false); }
+void *operator new[](std::size_t cbSize, const std::nothrow_t &) noexcept
+{
+    return QNET::Allocate(cbSize, 0, false);
+}
+void *operator new(std::size_t cbSize, std::align_val_t nAlignment)
+{
+    return QNET::Allocate(cbSize, static_cast<size_t>(nAlignment), true);
+}
+void *operator new[](std::size_t cbSize, std::align_val_t nAlignment)
+{
+    return QNET::Allocate(cbSize, static_cast<size_t>(nAlignment), true);
+}
+void *operator new(std::size_t cbSize, std::align_val_t nAlignment, const std::nothrow_t &) noexcept
+{
+    return QNET::Allocate(cbSize, static_cast<size_t>(nAlignment), false);
+}
+void *operator new[](std::size_t cbSize, std::align_val_t nAlignment, const std::nothrow_t &) noexcept
+{
+    return QNET::Allocate(cbSize, static_cast<size_t>(nAlignment), false);
+}
+
+void operator delete(void *p) noexcept { QNET::Free(p); }
+void operator delete[](void *p) noexcept { QNET::Free(p); }
+void operator delete(void *p, std::size_t) noexcept { QNET::Free(p); }
+void operator delete[](void *p, std::size_t) noexcept { QNET::Free(p); }
+void operator delete(void *p, const std::nothrow_t &) noexcept { QNET::Free(p); }
+void operator delete[](void *p, const std::nothrow_t &) noexcept { QNET::Free(p); }
+void operator delete(void *p, std::align_val_t) noexcept { QNET::Free(p); }
+void operator delete[](void *p, std::align_val_t) noexcept { QNET::Free(p); }
+void operator delete(void *p, std::size_t, std::align_val_t) noexcept { QNET::Free(p); }
+void operator delete[](void *p, std::size_t, std::align_val_t) noexcept { QNET::Free(p); }
+void operator delete(void *p, std::align_val_t, const std::nothrow_t &) noexcept { QNET::Free(p); }
+void operator delete[](void *p, std::align_val_t, const std::nothrow_t &) noexcept { QNET::Free(p); }
+#endif
\ No newline at end of file
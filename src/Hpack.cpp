@@ -0,0 +1,681 @@
+#include "quicknet/components/Hpack.h"
+
+#include <algorithm>
+#include <array>
+#include <unordered_map>
+
+namespace QNET
+{
+    namespace
+    {
+        struct HpackStaticEntry
+        {
+            const char *pszName;
+            const char *pszValue;
+        };
+
+        constexpr size_t kStaticTableSize = 61;
+
+        /// @brief Per-entry overhead added to name and value lengths when sizing tables (RFC 7541 section 4.1).
+        constexpr size_t kEntryOverhead = 32;
+
+        /// @brief Largest integer accepted in a block; anything larger is an attack, not a header.
+        constexpr uint64_t kMaxInteger = 0xFFFFFFFFull;
+
+        /// @brief The code of each symbol, right-aligned, and its length in bits (RFC 7541 appendix B). Symbol 256
+        /// is EOS.
+        const uint32_t kHuffmanCodes[257] = {
+            0x1ff8, 0x7fffd8, 0xfffffe2, 0xfffffe3, 0xfffffe4, 0xfffffe5, 0xfffffe6, 0xfffffe7,
+            0xfffffe8, 0xffffea, 0x3ffffffc, 0xfffffe9, 0xfffffea, 0x3ffffffd, 0xfffffeb, 0xfffffec,
+            0xfffffed, 0xfffffee, 0xfffffef, 0xffffff0, 0xffffff1, 0xffffff2, 0x3ffffffe, 0xffffff3,
+            0xffffff4, 0xffffff5, 0xffffff6, 0xffffff7, 0xffffff8, 0xffffff9, 0xffffffa, 0xffffffb,
+            0x14, 0x3f8, 0x3f9, 0xffa, 0x1ff9, 0x15, 0xf8, 0x7fa,
+            0x3fa, 0x3fb, 0xf9, 0x7fb, 0xfa, 0x16, 0x17, 0x18,
+            0x0, 0x1, 0x2, 0x19, 0x1a, 0x1b, 0x1c, 0x1d,
+            0x1e, 0x1f, 0x5c, 0xfb, 0x7ffc, 0x20, 0xffb, 0x3fc,
+            0x1ffa, 0x21, 0x5d, 0x5e, 0x5f, 0x60, 0x61, 0x62,
+            0x63, 0x64, 0x65, 0x66, 0x67, 0x68, 0x69, 0x6a,
+            0x6b, 0x6c, 0x6d, 0x6e, 0x6f, 0x70, 0x71, 0x72,
+            0xfc, 0x73, 0xfd, 0x1ffb, 0x7fff0, 0x1ffc, 0x3ffc, 0x22,
+            0x7ffd, 0x3, 0x23, 0x4, 0x24, 0x5, 0x25, 0x26,
+            0x27, 0x6, 0x74, 0x75, 0x28, 0x29, 0x2a, 0x7,
+            0x2b, 0x76, 0x2c, 0x8, 0x9, 0x2d, 0x77, 0x78,
+            0x79, 0x7a, 0x7b, 0x7ffe, 0x7fc, 0x3ffd, 0x1ffd, 0xffffffc,
+            0xfffe6, 0x3fffd2, 0xfffe7, 0xfffe8, 0x3fffd3, 0x3fffd4, 0x3fffd5, 0x7fffd9,
+            0x3fffd6, 0x7fffda, 0x7fffdb, 0x7fffdc, 0x7fffdd, 0x7fffde, 0xffffeb, 0x7fffdf,
+            0xffffec, 0xffffed, 0x3fffd7, 0x7fffe0, 0xffffee, 0x7fffe1, 0x7fffe2, 0x7fffe3,
+            0x7fffe4, 0x1fffdc, 0x3fffd8, 0x7fffe5, 0x3fffd9, 0x7fffe6, 0x7fffe7, 0xffffef,
+            0x3fffda, 0x1fffdd, 0xfffe9, 0x3fffdb, 0x3fffdc, 0x7fffe8, 0x7fffe9, 0x1fffde,
+            0x7fffea, 0x3fffdd, 0x3fffde, 0xfffff0, 0x1fffdf, 0x3fffdf, 0x7fffeb, 0x7fffec,
+            0x1fffe0, 0x1fffe1, 0x3fffe0, 0x1fffe2, 0x7fffed, 0x3fffe1, 0x7fffee, 0x7fffef,
+            0xfffea, 0x3fffe2, 0x3fffe3, 0x3fffe4, 0x7ffff0, 0x3fffe5, 0x3fffe6, 0x7ffff1,
+            0x3ffffe0, 0x3ffffe1, 0xfffeb, 0x7fff1, 0x3fffe7, 0x7ffff2, 0x3fffe8, 0x1ffffec,
+            0x3ffffe2, 0x3ffffe3, 0x3ffffe4, 0x7ffffde, 0x7ffffdf, 0x3ffffe5, 0xfffff1, 0x1ffffed,
+            0x7fff2, 0x1fffe3, 0x3ffffe6, 0x7ffffe0, 0x7ffffe1, 0x3ffffe7, 0x7ffffe2, 0xfffff2,
+            0x1fffe4, 0x1fffe5, 0x3ffffe8, 0x3ffffe9, 0xffffffd, 0x7ffffe3, 0x7ffffe4, 0x7ffffe5,
+            0xfffec, 0xfffff3, 0xfffed, 0x1fffe6, 0x3fffe9, 0x1fffe7, 0x1fffe8, 0x7ffff3,
+            0x3fffea, 0x3fffeb, 0x1ffffee, 0x1ffffef, 0xfffff4, 0xfffff5, 0x3ffffea, 0x7ffff4,
+            0x3ffffeb, 0x7ffffe6, 0x3ffffec, 0x3ffffed, 0x7ffffe7, 0x7ffffe8, 0x7ffffe9, 0x7ffffea,
+            0x7ffffeb, 0xffffffe, 0x7ffffec, 0x7ffffed, 0x7ffffee, 0x7ffffef, 0x7fffff0, 0x3ffffee,
+            0x3fffffff
+        };
+        const uint8_t kHuffmanLengths[257] = {
+            13, 23, 28, 28, 28, 28, 28, 28, 28, 24, 30, 28, 28, 30, 28, 28,
+            28, 28, 28, 28, 28, 28, 30, 28, 28, 28, 28, 28, 28, 28, 28, 28,
+            6, 10, 10, 12, 13, 6, 8, 11, 10, 10, 8, 11, 8, 6, 6, 6,
+            5, 5, 5, 6, 6, 6, 6, 6, 6, 6, 7, 8, 15, 6, 12, 10,
+            13, 6, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7,
+            7, 7, 7, 7, 7, 7, 7, 7, 8, 7, 8, 13, 19, 13, 14, 6,
+            15, 5, 6, 5, 6, 5, 6, 6, 6, 5, 7, 7, 6, 6, 6, 5,
+            6, 7, 6, 5, 5, 6, 7, 7, 7, 7, 7, 15, 11, 14, 13, 28,
+            20, 22, 20, 20, 22, 22, 22, 23, 22, 23, 23, 23, 23, 23, 24, 23,
+            24, 24, 22, 23, 24, 23, 23, 23, 23, 21, 22, 23, 22, 23, 23, 24,
+            22, 21, 20, 22, 22, 23, 23, 21, 23, 22, 22, 24, 21, 22, 23, 23,
+            21, 21, 22, 21, 23, 22, 23, 23, 20, 22, 22, 22, 23, 22, 22, 23,
+            26, 26, 20, 19, 22, 23, 22, 25, 26, 26, 26, 27, 27, 26, 24, 25,
+            19, 21, 26, 27, 27, 26, 27, 24, 21, 21, 26, 26, 28, 27, 27, 27,
+            20, 24, 20, 21, 22, 21, 21, 23, 22, 22, 25, 25, 24, 24, 26, 23,
+            26, 27, 26, 26, 27, 27, 27, 27, 27, 28, 27, 27, 27, 27, 27, 26,
+            30
+        };
+        /// @brief RFC 7541 appendix A; HPACK index i is kStaticTable[i - 1].
+        const HpackStaticEntry kStaticTable[kStaticTableSize] = {
+            {":authority", ""},
+            {":method", "GET"},
+            {":method", "POST"},
+            {":path", "/"},
+            {":path", "/index.html"},
+            {":scheme", "http"},
+            {":scheme", "https"},
+            {":status", "200"},
+            {":status", "204"},
+            {":status", "206"},
+            {":status", "304"},
+            {":status", "400"},
+            {":status", "404"},
+            {":status", "500"},
+            {"accept-charset", ""},
+            {"accept-encoding", "gzip, deflate"},
+            {"accept-language", ""},
+            {"accept-ranges", ""},
+            {"accept", ""},
+            {"access-control-allow-origin", ""},
+            {"age", ""},
+            {"allow", ""},
+            {"authorization", ""},
+            {"cache-control", ""},
+            {"content-disposition", ""},
+            {"content-encoding", ""},
+            {"content-language", ""},
+            {"content-length", ""},
+            {"content-location", ""},
+            {"content-range", ""},
+            {"content-type", ""},
+            {"cookie", ""},
+            {"date", ""},
+            {"etag", ""},
+            {"expect", ""},
+            {"expires", ""},
+            {"from", ""},
+            {"host", ""},
+            {"if-match", ""},
+            {"if-modified-since", ""},
+            {"if-none-match", ""},
+            {"if-range", ""},
+            {"if-unmodified-since", ""},
+            {"last-modified", ""},
+            {"link", ""},
+            {"location", ""},
+            {"max-forwards", ""},
+            {"proxy-authenticate", ""},
+            {"proxy-authorization", ""},
+            {"range", ""},
+            {"referer", ""},
+            {"refresh", ""},
+            {"retry-after", ""},
+            {"server", ""},
+            {"set-cookie", ""},
+            {"strict-transport-security", ""},
+            {"transfer-encoding", ""},
+            {"user-agent", ""},
+            {"vary", ""},
+            {"via", ""},
+            {"www-authenticate", ""}
+        };
+
+        size_t EntrySize(const HpackHeader &header)
+        {
+            return header.strName.size() + header.strValue.size() + kEntryOverhead;
+        }
+
+        /// @brief The Huffman code as a state machine that consumes 4 bits at a time. A state is an internal node of
+        /// the code tree; each step yields the next state and at most one symbol, since no code is shorter than 5
+        /// bits.
+        class HuffmanDecodeTable
+        {
+        public:
+            struct Step
+            {
+                uint8_t nState = 0;
+                bool bEmit = false;
+                bool bFail = false;
+                uint8_t nSymbol = 0;
+            };
+
+            static const HuffmanDecodeTable &Get()
+            {
+                static const HuffmanDecodeTable table;
+                return table;
+            }
+
+            const Step &Next(uint8_t nState, uint8_t nNibble) const { return m_aSteps[nState * 16 + nNibble]; }
+
+            /// @brief Whether input may end in a state: its path from the root is at most 7 one bits, the only
+            /// valid padding.
+            bool IsAccepting(uint8_t nState) const { return m_aAccepting[nState]; }
+
+        private:
+            HuffmanDecodeTable()
+            {
+                // Build the code tree. Children are node ids; leaves are marked with their symbol.
+                struct Node
+                {
+                    int aChildren[2] = {-1, -1};
+                    int nSymbol = -1;
+                };
+                std::vector<Node> vecNodes(1);
+                for (int nSymbol = 0; nSymbol <= 256; ++nSymbol)
+                {
+                    int nNode = 0;
+                    for (int nBit = kHuffmanLengths[nSymbol] - 1; nBit >= 0; --nBit)
+                    {
+                        const int nDirection = (kHuffmanCodes[nSymbol] >> nBit) & 1;
+                        if (vecNodes[nNode].aChildren[nDirection] < 0)
+                        {
+                            vecNodes[nNode].aChildren[nDirection] = static_cast<int>(vecNodes.size());
+                            vecNodes.emplace_back();
+                        }
+                        nNode = vecNodes[nNode].aChildren[nDirection];
+                    }
+                    vecNodes[nNode].nSymbol = nSymbol;
+                }
+
+                // Number the internal nodes as states; the root is state 0. A complete code over 257 symbols has
+                // 256 of them.
+                std::vector<int> vecState(vecNodes.size(), -1);
+                std::vector<int> vecInternal;
+                for (size_t i = 0; i < vecNodes.size(); ++i)
+                {
+                    if (vecNodes[i].nSymbol < 0)
+                    {
+                        vecState[i] = static_cast<int>(vecInternal.size());
+                        vecInternal.push_back(static_cast<int>(i));
+                    }
+                }
+
+                // The accepting states lie on the all-ones path from the root, less than 8 deep.
+                m_aAccepting.fill(false);
+                for (int nNode = 0, nDepth = 0; nNode >= 0 && nDepth < 8 && vecNodes[nNode].nSymbol < 0; ++nDepth)
+                {
+                    m_aAccepting[vecState[nNode]] = true;
+                    nNode = vecNodes[nNode].aChildren[1];
+                }
+
+                for (size_t nState = 0; nState < vecInternal.size(); ++nState)
+                {
+                    for (int nNibble = 0; nNibble < 16; ++nNibble)
+                    {
+                        Step &step = m_aSteps[nState * 16 + nNibble];
+                        int nNode = vecInternal[nState];
+                        for (int nBit = 3; nBit >= 0; --nBit)
+                        {
+                            nNode = vecNodes[nNode].aChildren[(nNibble >> nBit) & 1];
+                            if (vecNodes[nNode].nSymbol < 0)
+                                continue;
+
+                            if (vecNodes[nNode].nSymbol == 256)
+                            {
+                                step.bFail = true;
+                            }
+                            step.bEmit = true;
+                            step.nSymbol = static_cast<uint8_t>(vecNodes[nNode].nSymbol);
+                            nNode = 0;
+                        }
+                        step.nState = static_cast<uint8_t>(vecState[nNode]);
+                    }
+                }
+            }
+
+        private:
+            std::array<Step, 256 * 16> m_aSteps;
+            std::array<bool, 256> m_aAccepting;
+        };
+
+        /// @brief The static table as maps from "name" and "name\0value" to the lowest matching index.
+        class StaticTableIndex
+        {
+        public:
+            static const StaticTableIndex &Get()
+            {
+                static const StaticTableIndex index;
+                return index;
+            }
+
+            void Find(const HpackHeader &header, uint64_t &nFull, uint64_t &nName) const
+            {
+                nFull = 0;
+                nName = 0;
+                auto itName = m_mapNames.find(header.strName);
+                if (itName == m_mapNames.end())
+                    return;
+
+                nName = itName->second;
+                auto itFull = m_mapFields.find(header.strName + '\0' + header.strValue);
+                if (itFull != m_mapFields.end())
+                {
+                    nFull = itFull->second;
+                }
+            }
+
+        private:
+            StaticTableIndex()
+            {
+                for (size_t i = 0; i < kStaticTableSize; ++i)
+                {
+                    const std::string strName = kStaticTable[i].pszName;
+                    m_mapNames.emplace(strName, i + 1);
+                    m_mapFields.emplace(strName + '\0' + kStaticTable[i].pszValue, i + 1);
+                }
+            }
+
+        private:
+            std::unordered_map<std::string, uint64_t> m_mapNames;
+            std::unordered_map<std::string, uint64_t> m_mapFields;
+        };
+
+        bool DecodeInteger(const uint8_t *&p, const uint8_t *pEnd, int nPrefixBits, uint64_t &nValue)
+        {
+            if (p >= pEnd)
+                return false;
+
+            const uint64_t nPrefixMax = (1u << nPrefixBits) - 1;
+            nValue = *p++ & nPrefixMax;
+            if (nValue < nPrefixMax)
+                return true;
+
+            for (int nShift = 0; p < pEnd; nShift += 7)
+            {
+                const uint8_t nByte = *p++;
+                nValue += static_cast<uint64_t>(nByte & 0x7F) << nShift;
+                if (nValue > kMaxInteger)
+                    return false;
+                if ((nByte & 0x80) == 0)
+                    return true;
+            }
+            return false;
+        }
+
+        bool DecodeString(const uint8_t *&p, const uint8_t *pEnd, std::string &strOut)
+        {
+            if (p >= pEnd)
+                return false;
+
+            const bool bHuffman = (*p & 0x80) != 0;
+            uint64_t cbLength = 0;
+            if (!DecodeInteger(p, pEnd, 7, cbLength) || cbLength > static_cast<uint64_t>(pEnd - p))
+                return false;
+
+            if (bHuffman)
+            {
+                if (!HpackHuffmanDecode(p, static_cast<size_t>(cbLength), strOut))
+                    return false;
+            }
+            else
+            {
+                strOut.assign(reinterpret_cast<const char *>(p), static_cast<size_t>(cbLength));
+            }
+            p += cbLength;
+            return true;
+        }
+
+        void EncodeInteger(std::string &strOut, uint8_t nFlags, int nPrefixBits, uint64_t nValue)
+        {
+            const uint64_t nPrefixMax = (1u << nPrefixBits) - 1;
+            if (nValue < nPrefixMax)
+            {
+                strOut += static_cast<char>(nFlags | nValue);
+                return;
+            }
+
+            strOut += static_cast<char>(nFlags | nPrefixMax);
+            nValue -= nPrefixMax;
+            while (nValue >= 0x80)
+            {
+                strOut += static_cast<char>(0x80 | (nValue & 0x7F));
+                nValue >>= 7;
+            }
+            strOut += static_cast<char>(nValue);
+        }
+
+        void EncodeString(std::string &strOut, const std::string &strValue)
+        {
+            const size_t cbHuffman = HpackHuffmanEncodedLength(strValue);
+            if (cbHuffman < strValue.size())
+            {
+                EncodeInteger(strOut, 0x80, 7, cbHuffman);
+                HpackHuffmanEncode(strValue, strOut);
+            }
+            else
+            {
+                EncodeInteger(strOut, 0x00, 7, strValue.size());
+                strOut += strValue;
+            }
+        }
+
+        /// @brief Fields whose values rarely repeat, so indexing them would only churn the dynamic table.
+        bool IsIndexWorthy(const std::string &strName)
+        {
+            return strName != ":path" && strName != "content-length" && strName != "date" && strName != "etag" &&
+                   strName != "last-modified" && strName != "age" && strName != "expires" &&
+                   strName != "if-modified-since" && strName != "if-none-match" && strName != "location";
+        }
+
+        /// @brief Credentials, which are never indexed so they cannot be probed through the table.
+        bool IsSensitive(const std::string &strName)
+        {
+            return strName == "authorization" || strName == "proxy-authorization";
+        }
+    } // namespace
+
+    void HpackHuffmanEncode(const std::string &strIn, std::string &strOut)
+    {
+        uint64_t nBits = 0;
+        int nBitCount = 0;
+        for (unsigned char ch : strIn)
+        {
+            nBits = (nBits << kHuffmanLengths[ch]) | kHuffmanCodes[ch];
+            nBitCount += kHuffmanLengths[ch];
+            while (nBitCount >= 8)
+            {
+                nBitCount -= 8;
+                strOut += static_cast<char>(nBits >> nBitCount);
+            }
+            nBits &= (1ull << nBitCount) - 1;
+        }
+
+        // Pad with the most significant bits of EOS, which are all ones.
+        if (nBitCount > 0)
+        {
+            strOut += static_cast<char>((nBits << (8 - nBitCount)) | (0xFF >> nBitCount));
+        }
+    }
+
+    size_t HpackHuffmanEncodedLength(const std::string &strIn)
+    {
+        size_t nBits = 0;
+        for (unsigned char ch : strIn)
+        {
+            nBits += kHuffmanLengths[ch];
+        }
+        return (nBits + 7) / 8;
+    }
+
+    bool HpackHuffmanDecode(const uint8_t *pData, size_t cbData, std::string &strOut)
+    {
+        const HuffmanDecodeTable &table = HuffmanDecodeTable::Get();
+        uint8_t nState = 0;
+        for (size_t i = 0; i < cbData; ++i)
+        {
+            for (int nShift = 4; nShift >= 0; nShift -= 4)
+            {
+                const HuffmanDecodeTable::Step &step = table.Next(nState, (pData[i] >> nShift) & 0x0F);
+                if (step.bFail)
+                    return false;
+                if (step.bEmit)
+                {
+                    strOut += static_cast<char>(step.nSymbol);
+                }
+                nState = step.nState;
+            }
+        }
+        return table.IsAccepting(nState);
+    }
+
+    HpackDecoder::HpackDecoder(uint32_t cbMaxTableSize)
+        : m_cbMaxTableSize(cbMaxTableSize), m_cbSettingsMaxTableSize(cbMaxTableSize)
+    {
+    }
+
+    bool HpackDecoder::Decode(const uint8_t *pData, size_t cbData, std::vector<HpackHeader> &vecHeaders,
+                              size_t cbMaxHeaderList, bool *pbTooLarge)
+    {
+        const uint8_t *p = pData;
+        const uint8_t *pEnd = pData + cbData;
+        size_t cbHeaderList = 0;
+        bool bTooLarge = false;
+        bool bFieldSeen = false;
+
+        while (p < pEnd)
+        {
+            const uint8_t nFirst = *p;
+            HpackHeader header;
+            bool bIndex = false;
+
+            if (nFirst & 0x80)
+            {
+                // Indexed field.
+                uint64_t nIndex = 0;
+                if (!DecodeInteger(p, pEnd, 7, nIndex))
+                    return false;
+                const HpackHeader *pEntry = Lookup(nIndex);
+                if (!pEntry)
+                    return false;
+                header.strName = pEntry->strName;
+                header.strValue = pEntry->strValue;
+            }
+            else if ((nFirst & 0xE0) == 0x20)
+            {
+                // Dynamic table size update, only allowed before the first field of a block.
+                uint64_t cbSize = 0;
+                if (bFieldSeen || !DecodeInteger(p, pEnd, 5, cbSize) || cbSize > m_cbSettingsMaxTableSize)
+                    return false;
+                m_cbMaxTableSize = static_cast<size_t>(cbSize);
+                EvictTo(m_cbMaxTableSize);
+                continue;
+            }
+            else
+            {
+                // Literal field: with incremental indexing (01), never indexed (0001) or without indexing (0000).
+                const int nPrefixBits = (nFirst & 0xC0) == 0x40 ? 6 : 4;
+                bIndex = nPrefixBits == 6;
+                header.bNeverIndex = (nFirst & 0xF0) == 0x10;
+
+                uint64_t nNameIndex = 0;
+                if (!DecodeInteger(p, pEnd, nPrefixBits, nNameIndex))
+                    return false;
+                if (nNameIndex > 0)
+                {
+                    const HpackHeader *pEntry = Lookup(nNameIndex);
+                    if (!pEntry)
+                        return false;
+                    header.strName = pEntry->strName;
+                }
+                else if (!DecodeString(p, pEnd, header.strName))
+                {
+                    return false;
+                }
+                if (!DecodeString(p, pEnd, header.strValue))
+                    return false;
+            }
+
+            bFieldSeen = true;
+            if (bIndex)
+            {
+                Insert(header);
+            }
+
+            cbHeaderList += EntrySize(header);
+            if (cbHeaderList > cbMaxHeaderList)
+            {
+                bTooLarge = true;
+            }
+            if (!bTooLarge)
+            {
+                vecHeaders.push_back(std::move(header));
+            }
+        }
+
+        if (pbTooLarge)
+        {
+            *pbTooLarge = bTooLarge;
+        }
+        return true;
+    }
+
+    const HpackHeader *HpackDecoder::Lookup(uint64_t nIndex) const
+    {
+        // The static table as HpackHeaders, so that both tables are read the same way.
+        static const std::vector<HpackHeader> s_vecStatic = []()
+        {
+            std::vector<HpackHeader> vecEntries;
+            for (const HpackStaticEntry &entry : kStaticTable)
+            {
+                vecEntries.push_back({entry.pszName, entry.pszValue, false});
+            }
+            return vecEntries;
+        }();
+
+        if (nIndex == 0)
+            return nullptr;
+        if (nIndex <= kStaticTableSize)
+            return &s_vecStatic[static_cast<size_t>(nIndex - 1)];
+
+        const uint64_t nDynamic = nIndex - kStaticTableSize - 1;
+        return nDynamic < m_dequeTable.size() ? &m_dequeTable[static_cast<size_t>(nDynamic)] : nullptr;
+    }
+
+    void HpackDecoder::Insert(HpackHeader header)
+    {
+        const size_t cbEntry = EntrySize(header);
+        if (cbEntry > m_cbMaxTableSize)
+        {
+            // An entry larger than the table empties it (RFC 7541 section 4.4).
+            EvictTo(0);
+            return;
+        }
+
+        EvictTo(m_cbMaxTableSize - cbEntry);
+        m_cbTableSize += cbEntry;
+        header.bNeverIndex = false;
+        m_dequeTable.push_front(std::move(header));
+    }
+
+    void HpackDecoder::EvictTo(size_t cbSize)
+    {
+        while (m_cbTableSize > cbSize && !m_dequeTable.empty())
+        {
+            m_cbTableSize -= EntrySize(m_dequeTable.back());
+            m_dequeTable.pop_back();
+        }
+    }
+
+    HpackEncoder::HpackEncoder(uint32_t cbMaxTableSize) : m_cbMaxTableSize(cbMaxTableSize) {}
+
+    void HpackEncoder::SetMaxTableSize(uint32_t cbMaxTableSize)
+    {
+        if (cbMaxTableSize == m_cbMaxTableSize)
+            return;
+
+        m_cbMinPendingSize = m_bPendingSizeUpdate ? std::min<size_t>(m_cbMinPendingSize, cbMaxTableSize)
+                                                  : cbMaxTableSize;
+        m_bPendingSizeUpdate = true;
+        m_cbMaxTableSize = cbMaxTableSize;
+        EvictTo(m_cbMaxTableSize);
+    }
+
+    void HpackEncoder::Encode(const std::vector<HpackHeader> &vecHeaders, std::string &strOut)
+    {
+        if (m_bPendingSizeUpdate)
+        {
+            // If the size dropped and rose again since the last block, the peer must see the low point first.
+            if (m_cbMinPendingSize < m_cbMaxTableSize)
+            {
+                EncodeInteger(strOut, 0x20, 5, m_cbMinPendingSize);
+            }
+            EncodeInteger(strOut, 0x20, 5, m_cbMaxTableSize);
+            m_bPendingSizeUpdate = false;
+        }
+
+        for (const HpackHeader &header : vecHeaders)
+        {
+            uint64_t nFull = 0;
+            uint64_t nName = 0;
+            Find(header, nFull, nName);
+
+            const bool bNeverIndex = header.bNeverIndex || IsSensitive(header.strName);
+            if (nFull > 0 && !bNeverIndex)
+            {
+                EncodeInteger(strOut, 0x80, 7, nFull);
+                continue;
+            }
+
+            const bool bIndex = !bNeverIndex && IsIndexWorthy(header.strName) && EntrySize(header) <= m_cbMaxTableSize;
+            if (bIndex)
+                EncodeInteger(strOut, 0x40, 6, nName);
+            else
+                EncodeInteger(strOut, bNeverIndex ? 0x10 : 0x00, 4, nName);
+
+            if (nName == 0)
+            {
+                EncodeString(strOut, header.strName);
+            }
+            EncodeString(strOut, header.strValue);
+
+            if (bIndex)
+            {
+                Insert(header);
+            }
+        }
+    }
+
+    void HpackEncoder::Find(const HpackHeader &header, uint64_t &nFull, uint64_t &nName) const
+    {
+        StaticTableIndex::Get().Find(header, nFull, nName);
+        if (nFull > 0)
+            return;
+
+        for (size_t i = 0; i < m_dequeTable.size(); ++i)
+        {
+            const HpackHeader &entry = m_dequeTable[i];
+            if (entry.strName != header.strName)
+                continue;
+
+            if (entry.strValue == header.strValue)
+            {
+                nFull = kStaticTableSize + 1 + i;
+                return;
+            }
+            if (nName == 0)
+            {
+                nName = kStaticTableSize + 1 + i;
+            }
+        }
+    }
+
+    void HpackEncoder::Insert(const HpackHeader &header)
+    {
+        const size_t cbEntry = EntrySize(header);
+        EvictTo(m_cbMaxTableSize - cbEntry);
+        m_cbTableSize += cbEntry;
+        m_dequeTable.push_front({header.strName, header.strValue, false});
+    }
+
+    void HpackEncoder::EvictTo(size_t cbSize)
+    {
+        while (m_cbTableSize > cbSize && !m_dequeTable.empty())
+        {
+            m_cbTableSize -= EntrySize(m_dequeTable.back());
+            m_dequeTable.pop_back();
+        }
+    }
+} // namespace QNET
\ No newline at end of file
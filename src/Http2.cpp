@@ -0,0 +1,1143 @@
+#include "quicknet/components/Http2.h"
+
+#include <algorithm>
+#include <cctype>
+#include <chrono>
+#include <condition_variable>
+#include <cstdlib>
+#include <cstring>
+#include <map>
+#include <unordered_map>
+
+#ifdef _WIN32
+#include <winsock2.h>
+#include <ws2tcpip.h>
+#else
+#include <arpa/inet.h>
+#include <cerrno>
+#include <netdb.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <unistd.h>
+#endif
+
+#ifndef MSG_NOSIGNAL
+#define MSG_NOSIGNAL 0
+#endif
+
+namespace QNET
+{
+    namespace
+    {
+#ifdef _WIN32
+        using socket_t = SOCKET;
+        const socket_t kInvalidSocket = INVALID_SOCKET;
+
+        void CloseSocket(socket_t s) { closesocket(s); }
+        void ShutdownSocket(socket_t s) { shutdown(s, SD_BOTH); }
+        int PollSocket(pollfd *pFd, int nTimeoutMs) { return WSAPoll(pFd, 1, nTimeoutMs); }
+        bool IsTimeout() { return WSAGetLastError() == WSAETIMEDOUT; }
+
+        void SetReceiveTimeout(socket_t s, int nTimeoutMs)
+        {
+            DWORD nTimeout = static_cast<DWORD>(nTimeoutMs);
+            setsockopt(s, SOL_SOCKET, SO_RCVTIMEO, reinterpret_cast<const char *>(&nTimeout), sizeof(nTimeout));
+        }
+#else
+        using socket_t = int;
+        const socket_t kInvalidSocket = -1;
+
+        void CloseSocket(socket_t s) { close(s); }
+        void ShutdownSocket(socket_t s) { shutdown(s, SHUT_RDWR); }
+        int PollSocket(pollfd *pFd, int nTimeoutMs) { return poll(pFd, 1, nTimeoutMs); }
+        bool IsTimeout() { return errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR; }
+
+        void SetReceiveTimeout(socket_t s, int nTimeoutMs)
+        {
+            timeval tv;
+            tv.tv_sec = nTimeoutMs / 1000;
+            tv.tv_usec = (nTimeoutMs % 1000) * 1000;
+            setsockopt(s, SOL_SOCKET, SO_RCVTIMEO, reinterpret_cast<const char *>(&tv), sizeof(tv));
+        }
+#endif
+
+        socket_t ToSocket(std::intptr_t nSocket) { return static_cast<socket_t>(nSocket); }
+
+        /// @brief How often a blocked reader or the accept loop wakes up to check for shutdown and idleness.
+        constexpr int kPollIntervalMs = 250;
+
+        /// @brief Output the writer gathers before sending, so small frames of many streams go out in one call.
+        constexpr size_t kWriteBatchBytes = 64 * 1024;
+
+        /// @brief Largest dynamic table used to encode responses, whatever the client allows.
+        constexpr uint32_t kMaxEncoderTableSize = 4096;
+
+        void AppendUint32(std::string &strOut, uint32_t nValue)
+        {
+            strOut += static_cast<char>(nValue >> 24);
+            strOut += static_cast<char>(nValue >> 16);
+            strOut += static_cast<char>(nValue >> 8);
+            strOut += static_cast<char>(nValue);
+        }
+
+        uint32_t ReadUint32(const uint8_t *p)
+        {
+            return (static_cast<uint32_t>(p[0]) << 24) | (static_cast<uint32_t>(p[1]) << 16) |
+                   (static_cast<uint32_t>(p[2]) << 8) | p[3];
+        }
+
+        bool SendAll(socket_t s, const std::string &strData)
+        {
+            size_t cbSent = 0;
+            while (cbSent < strData.size())
+            {
+                const int cbChunk = static_cast<int>(std::min<size_t>(strData.size() - cbSent, 1 << 30));
+                const auto cbResult = send(s, strData.data() + cbSent, cbChunk, MSG_NOSIGNAL);
+                if (cbResult <= 0)
+                    return false;
+                cbSent += static_cast<size_t>(cbResult);
+            }
+            return true;
+        }
+
+        /// @brief Headers that are specific to HTTP/1.1 connections and must not appear in HTTP/2.
+        bool IsConnectionHeader(const std::string &strName)
+        {
+            return strName == "connection" || strName == "keep-alive" || strName == "proxy-connection" ||
+                   strName == "transfer-encoding" || strName == "upgrade";
+        }
+
+        std::string ToLower(std::string str)
+        {
+            std::transform(str.begin(), str.end(), str.begin(),
+                           [](unsigned char ch) { return static_cast<char>(std::tolower(ch)); });
+            return str;
+        }
+    } // namespace
+
+    void AppendHttp2Frame(std::string &strOut, Http2FrameType eType, uint8_t nFlags, uint32_t nStreamId,
+                          const char *pPayload, size_t cbPayload)
+    {
+        strOut += static_cast<char>(cbPayload >> 16);
+        strOut += static_cast<char>(cbPayload >> 8);
+        strOut += static_cast<char>(cbPayload);
+        strOut += static_cast<char>(eType);
+        strOut += static_cast<char>(nFlags);
+        AppendUint32(strOut, nStreamId & 0x7FFFFFFF);
+        strOut.append(pPayload, cbPayload);
+    }
+
+    void AppendHttp2Headers(std::string &strOut, uint32_t nStreamId, const std::string &strBlock, bool bEndStream,
+                            uint32_t cbMaxFrame)
+    {
+        size_t nOffset = 0;
+        bool bFirst = true;
+        do
+        {
+            const size_t cbChunk = std::min<size_t>(strBlock.size() - nOffset, cbMaxFrame);
+            const bool bLast = nOffset + cbChunk == strBlock.size();
+            uint8_t nFlags = bLast ? kHttp2FlagEndHeaders : 0;
+            if (bFirst && bEndStream)
+            {
+                nFlags |= kHttp2FlagEndStream;
+            }
+            AppendHttp2Frame(strOut, bFirst ? Http2FrameType::Headers : Http2FrameType::Continuation, nFlags,
+                             nStreamId, strBlock.data() + nOffset, cbChunk);
+            nOffset += cbChunk;
+            bFirst = false;
+        } while (nOffset < strBlock.size());
+    }
+
+    void AppendHttp2Settings(std::string &strOut, const std::vector<std::pair<uint16_t, uint32_t>> &vecSettings)
+    {
+        std::string strPayload;
+        for (const auto &setting : vecSettings)
+        {
+            strPayload += static_cast<char>(setting.first >> 8);
+            strPayload += static_cast<char>(setting.first);
+            AppendUint32(strPayload, setting.second);
+        }
+        AppendHttp2Frame(strOut, Http2FrameType::Settings, 0, 0, strPayload.data(), strPayload.size());
+    }
+
+    void AppendHttp2WindowUpdate(std::string &strOut, uint32_t nStreamId, uint32_t nIncrement)
+    {
+        std::string strPayload;
+        AppendUint32(strPayload, nIncrement & 0x7FFFFFFF);
+        AppendHttp2Frame(strOut, Http2FrameType::WindowUpdate, 0, nStreamId, strPayload.data(), strPayload.size());
+    }
+
+    Http2FrameHeader ParseHttp2FrameHeader(const uint8_t *pData)
+    {
+        Http2FrameHeader header;
+        header.cbLength = (static_cast<uint32_t>(pData[0]) << 16) | (static_cast<uint32_t>(pData[1]) << 8) | pData[2];
+        header.nType = pData[3];
+        header.nFlags = pData[4];
+        header.nStreamId = ReadUint32(pData + 5) & 0x7FFFFFFF;
+        return header;
+    }
+
+    /// @brief One accepted HTTP/2 connection. Run() is the reader and owns everything not under m_mutex; the
+    /// writer thread and the worker threads meet it on the send side, which m_mutex guards.
+    class Http2Connection : public std::enable_shared_from_this<Http2Connection>
+    {
+    public:
+        Http2Connection(socket_t socket, std::string strRemoteAddr, int nRemotePort, const Http2Config &config,
+                        const Http2Listener::Dispatch &dispatch, httplib::ThreadPool &pool)
+            : m_socket(socket), m_strRemoteAddr(std::move(strRemoteAddr)), m_nRemotePort(nRemotePort),
+              m_config(config), m_dispatch(dispatch), m_pool(pool), m_decoder(4096),
+              m_nReceiveWindow(config.cbConnectionWindow)
+        {
+        }
+
+        /// @brief Serves the connection until it ends, then closes the socket. Runs on the connection's thread.
+        void Run()
+        {
+            SetReceiveTimeout(m_socket, kPollIntervalMs);
+            m_writer = std::thread([this]() { WriterLoop(); });
+
+            // The server preface: our settings, and the connection window beyond the default 65535.
+            std::string strPreface;
+            AppendHttp2Settings(strPreface, {{kHttp2SettingsMaxConcurrentStreams, m_config.nMaxConcurrentStreams},
+                                             {kHttp2SettingsInitialWindowSize, m_config.cbStreamWindow},
+                                             {kHttp2SettingsMaxFrameSize, m_config.cbMaxFrameSize},
+                                             {kHttp2SettingsMaxHeaderListSize, m_config.cbMaxHeaderListSize},
+                                             {kHttp2SettingsEnablePush, 0}});
+            if (m_config.cbConnectionWindow > kHttp2DefaultWindowSize)
+            {
+                AppendHttp2WindowUpdate(strPreface, 0, m_config.cbConnectionWindow - kHttp2DefaultWindowSize);
+            }
+            QueueControl(std::move(strPreface));
+
+            m_tLastActivity = std::chrono::steady_clock::now();
+            if (ReadPreface())
+            {
+                std::vector<uint8_t> vecPayload;
+                Http2FrameHeader header;
+                while (ReadFrame(header, vecPayload) && HandleFrame(header, vecPayload.data()))
+                {
+                }
+            }
+
+            {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                m_bReaderDone = true;
+            }
+            m_cvWriter.notify_all();
+            m_writer.join();
+
+            std::lock_guard<std::mutex> lock(m_mutex);
+            CloseSocket(m_socket);
+            m_bClosed = true;
+        }
+
+        /// @brief Wakes the reader so the connection ends. May be called from any thread.
+        void Shutdown()
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_bShutdown = true;
+            if (!m_bClosed)
+            {
+                ShutdownSocket(m_socket);
+            }
+        }
+
+        bool IsClosed() const
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            return m_bClosed;
+        }
+
+        /// @brief Hands the response of a stream to the writer. Called on a worker thread.
+        void QueueResponse(uint32_t nStreamId, const httplib::Response &res, bool bHead)
+        {
+            std::vector<HpackHeader> vecHeaders;
+            vecHeaders.reserve(res.headers.size() + 2);
+            const int nStatus = res.status >= 100 && res.status < 1000 ? res.status : 500;
+            vecHeaders.push_back({":status", std::to_string(nStatus)});
+            for (const auto &header : res.headers)
+            {
+                std::string strName = ToLower(header.first);
+                if (!IsConnectionHeader(strName) && strName != "content-length")
+                {
+                    vecHeaders.push_back({std::move(strName), header.second});
+                }
+            }
+            vecHeaders.push_back({"content-length", std::to_string(res.body.size())});
+
+            {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                auto it = m_mapSend.find(nStreamId);
+                if (it == m_mapSend.end())
+                    return; // Reset by the client meanwhile.
+
+                it->second.vecHeaders = std::move(vecHeaders);
+                if (!bHead)
+                {
+                    it->second.strBody = res.body;
+                }
+                it->second.bReady = true;
+            }
+            m_cvWriter.notify_all();
+        }
+
+    private:
+        /// @brief A request being received.
+        struct ReceiveStream
+        {
+            std::vector<HpackHeader> vecHeaders;
+            std::string strBody;
+            int64_t nWindow = 0;
+            uint32_t cbUnacknowledged = 0;
+            bool bBodyTooLarge = false;
+        };
+
+        /// @brief A stream between its request headers and the end of its response.
+        struct SendStream
+        {
+            int64_t nWindow = 0;
+            bool bReady = false;
+            bool bHeadersSent = false;
+            std::vector<HpackHeader> vecHeaders;
+            std::string strBody;
+            size_t nOffset = 0;
+        };
+
+        // ---- Reader ----
+
+        /// @brief Reads exactly cbData bytes; false on EOF, error, shutdown or idle timeout.
+        bool ReadExact(uint8_t *pData, size_t cbData)
+        {
+            size_t cbRead = 0;
+            while (cbRead < cbData)
+            {
+                const auto cbResult =
+                    recv(m_socket, reinterpret_cast<char *>(pData + cbRead), static_cast<int>(cbData - cbRead), 0);
+                if (cbResult > 0)
+                {
+                    cbRead += static_cast<size_t>(cbResult);
+                    continue;
+                }
+                if (cbResult == 0 || !IsTimeout())
+                    return false;
+
+                // Timed out: check for shutdown and idleness.
+                std::lock_guard<std::mutex> lock(m_mutex);
+                if (m_bShutdown)
+                    return false;
+
+                const auto tIdle = std::chrono::steady_clock::now() - m_tLastActivity;
+                if (m_mapSend.empty() && m_mapReceive.empty() &&
+                    tIdle >= std::chrono::seconds(m_config.nIdleTimeoutSeconds))
+                {
+                    AppendGoAwayLocked(Http2Error::NoError);
+                    return false;
+                }
+            }
+            return true;
+        }
+
+        bool ReadPreface()
+        {
+            uint8_t aPreface[kHttp2PrefaceSize];
+            if (!ReadExact(aPreface, sizeof(aPreface)))
+                return false;
+            // Anything else, typically an HTTP/1.1 client on the h2c port, is closed without an answer.
+            return std::memcmp(aPreface, kHttp2Preface, kHttp2PrefaceSize) == 0;
+        }
+
+        bool ReadFrame(Http2FrameHeader &header, std::vector<uint8_t> &vecPayload)
+        {
+            uint8_t aHeader[kHttp2FrameHeaderSize];
+            if (!ReadExact(aHeader, sizeof(aHeader)))
+                return false;
+
+            header = ParseHttp2FrameHeader(aHeader);
+            if (header.cbLength > m_config.cbMaxFrameSize)
+                return ConnectionError(Http2Error::FrameSizeError);
+
+            vecPayload.resize(header.cbLength);
+            if (header.cbLength > 0 && !ReadExact(vecPayload.data(), header.cbLength))
+                return false;
+
+            m_tLastActivity = std::chrono::steady_clock::now();
+            return true;
+        }
+
+        bool HandleFrame(const Http2FrameHeader &header, const uint8_t *pPayload)
+        {
+            // A header block must be followed by its CONTINUATION frames and nothing else.
+            if (m_nContinuationStream != 0 && (header.nType != static_cast<uint8_t>(Http2FrameType::Continuation) ||
+                                               header.nStreamId != m_nContinuationStream))
+                return ConnectionError(Http2Error::ProtocolError);
+
+            switch (static_cast<Http2FrameType>(header.nType))
+            {
+            case Http2FrameType::Data:
+                return HandleData(header, pPayload);
+            case Http2FrameType::Headers:
+                return HandleHeaders(header, pPayload);
+            case Http2FrameType::Priority:
+                if (header.nStreamId == 0)
+                    return ConnectionError(Http2Error::ProtocolError);
+                if (header.cbLength != 5)
+                    return ConnectionError(Http2Error::FrameSizeError);
+                return true;
+            case Http2FrameType::RstStream:
+                return HandleRstStream(header, pPayload);
+            case Http2FrameType::Settings:
+                return HandleSettings(header, pPayload);
+            case Http2FrameType::PushPromise:
+                return ConnectionError(Http2Error::ProtocolError);
+            case Http2FrameType::Ping:
+                return HandlePing(header, pPayload);
+            case Http2FrameType::GoAway:
+                if (header.nStreamId != 0)
+                    return ConnectionError(Http2Error::ProtocolError);
+                m_bGoAwayReceived = true;
+                return true;
+            case Http2FrameType::WindowUpdate:
+                return HandleWindowUpdate(header, pPayload);
+            case Http2FrameType::Continuation:
+                if (m_nContinuationStream == 0)
+                    return ConnectionError(Http2Error::ProtocolError);
+                m_strHeaderBlock.append(reinterpret_cast<const char *>(pPayload), header.cbLength);
+                if (m_strHeaderBlock.size() > 2 * static_cast<size_t>(m_config.cbMaxHeaderListSize))
+                    return ConnectionError(Http2Error::EnhanceYourCalm);
+                if (header.nFlags & kHttp2FlagEndHeaders)
+                {
+                    m_nContinuationStream = 0;
+                    return HandleHeaderBlock(header.nStreamId);
+                }
+                return true;
+            default:
+                return true; // Unknown frame types are ignored.
+            }
+        }
+
+        /// @brief Strips the padding of a DATA or HEADERS frame; false if it is malformed.
+        static bool StripPadding(const Http2FrameHeader &header, const uint8_t *&pPayload, size_t &cbPayload)
+        {
+            if ((header.nFlags & kHttp2FlagPadded) == 0)
+                return true;
+            if (cbPayload < 1 || pPayload[0] >= cbPayload)
+                return false;
+
+            cbPayload -= 1 + pPayload[0];
+            pPayload += 1;
+            return true;
+        }
+
+        bool HandleData(const Http2FrameHeader &header, const uint8_t *pPayload)
+        {
+            if (header.nStreamId == 0)
+                return ConnectionError(Http2Error::ProtocolError);
+
+            // Flow control counts the whole payload, padding included.
+            m_nReceiveWindow -= header.cbLength;
+            if (m_nReceiveWindow < 0)
+                return ConnectionError(Http2Error::FlowControlError);
+            AcknowledgeConnection(header.cbLength);
+
+            size_t cbData = header.cbLength;
+            if (!StripPadding(header, pPayload, cbData))
+                return ConnectionError(Http2Error::ProtocolError);
+
+            auto it = m_mapReceive.find(header.nStreamId);
+            if (it == m_mapReceive.end())
+            {
+                // Idle streams cannot carry data; data for a stream we closed or reset is dropped.
+                if (header.nStreamId > m_nLastStreamId)
+                    return ConnectionError(Http2Error::ProtocolError);
+                return true;
+            }
+
+            ReceiveStream &stream = it->second;
+            stream.nWindow -= header.cbLength;
+            if (stream.nWindow < 0)
+            {
+                ResetStream(header.nStreamId, Http2Error::FlowControlError);
+                return true;
+            }
+
+            if (stream.strBody.size() + cbData > m_config.cbMaxBody)
+            {
+                stream.bBodyTooLarge = true;
+                stream.strBody.clear();
+            }
+            if (!stream.bBodyTooLarge)
+            {
+                stream.strBody.append(reinterpret_cast<const char *>(pPayload), cbData);
+            }
+
+            if (header.nFlags & kHttp2FlagEndStream)
+            {
+                CompleteRequest(header.nStreamId);
+                return true;
+            }
+
+            // Give the window back once half of it is used, so a client is rarely blocked by it.
+            stream.cbUnacknowledged += header.cbLength;
+            if (stream.cbUnacknowledged >= m_config.cbStreamWindow / 2)
+            {
+                std::string strFrame;
+                AppendHttp2WindowUpdate(strFrame, header.nStreamId, stream.cbUnacknowledged);
+                stream.nWindow += stream.cbUnacknowledged;
+                stream.cbUnacknowledged = 0;
+                QueueControl(std::move(strFrame));
+            }
+            return true;
+        }
+
+        bool HandleHeaders(const Http2FrameHeader &header, const uint8_t *pPayload)
+        {
+            if (header.nStreamId == 0 || (header.nStreamId & 1) == 0)
+                return ConnectionError(Http2Error::ProtocolError);
+
+            size_t cbBlock = header.cbLength;
+            if (!StripPadding(header, pPayload, cbBlock))
+                return ConnectionError(Http2Error::ProtocolError);
+            if (header.nFlags & kHttp2FlagPriority)
+            {
+                if (cbBlock < 5)
+                    return ConnectionError(Http2Error::ProtocolError);
+                pPayload += 5;
+                cbBlock -= 5;
+            }
+
+            m_strHeaderBlock.assign(reinterpret_cast<const char *>(pPayload), cbBlock);
+            m_bBlockEndsStream = (header.nFlags & kHttp2FlagEndStream) != 0;
+            if ((header.nFlags & kHttp2FlagEndHeaders) == 0)
+            {
+                m_nContinuationStream = header.nStreamId;
+                return true;
+            }
+            return HandleHeaderBlock(header.nStreamId);
+        }
+
+        /// @brief Decodes a complete header block: the headers of a new request, or trailers.
+        bool HandleHeaderBlock(uint32_t nStreamId)
+        {
+            // Decode first in every case, to keep the HPACK table in step with the client.
+            std::vector<HpackHeader> vecHeaders;
+            bool bTooLarge = false;
+            if (!m_decoder.Decode(reinterpret_cast<const uint8_t *>(m_strHeaderBlock.data()), m_strHeaderBlock.size(),
+                                  vecHeaders, m_config.cbMaxHeaderListSize, &bTooLarge))
+                return ConnectionError(Http2Error::CompressionError);
+
+            if (nStreamId <= m_nLastStreamId)
+            {
+                // Trailers end the request; their fields are not passed on. Anything else on an old stream is
+                // a stream we already closed.
+                auto it = m_mapReceive.find(nStreamId);
+                if (it == m_mapReceive.end())
+                    return true;
+                if (!m_bBlockEndsStream)
+                    return ConnectionError(Http2Error::ProtocolError);
+                CompleteRequest(nStreamId);
+                return true;
+            }
+            m_nLastStreamId = nStreamId;
+
+            {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                if (m_bGoAwayReceived || m_mapSend.size() >= m_config.nMaxConcurrentStreams)
+                {
+                    AppendRstStreamLocked(nStreamId, Http2Error::RefusedStream);
+                    m_cvWriter.notify_all();
+                    return true;
+                }
+                m_mapSend[nStreamId].nWindow = m_nPeerInitialWindow;
+            }
+
+            ReceiveStream &stream = m_mapReceive[nStreamId];
+            stream.vecHeaders = std::move(vecHeaders);
+            stream.nWindow = m_config.cbStreamWindow;
+            if (bTooLarge)
+            {
+                Respond(nStreamId, 431);
+                return true;
+            }
+            if (!ValidateRequestHeaders(stream.vecHeaders))
+            {
+                m_mapReceive.erase(nStreamId);
+                ResetStream(nStreamId, Http2Error::ProtocolError);
+                return true;
+            }
+
+            if (m_bBlockEndsStream)
+            {
+                CompleteRequest(nStreamId);
+            }
+            return true;
+        }
+
+        /// @brief Checks the rules of RFC 9113 section 8.3: lowercase names, pseudo-headers first and known, and
+        /// :method, :scheme and :path present.
+        static bool ValidateRequestHeaders(const std::vector<HpackHeader> &vecHeaders)
+        {
+            bool bMethod = false;
+            bool bScheme = false;
+            bool bPath = false;
+            bool bRegular = false;
+            for (const HpackHeader &header : vecHeaders)
+            {
+                if (header.strName.empty())
+                    return false;
+                for (char ch : header.strName)
+                {
+                    if (ch >= 'A' && ch <= 'Z')
+                        return false;
+                }
+
+                if (header.strName[0] != ':')
+                {
+                    bRegular = true;
+                    if (IsConnectionHeader(header.strName) || (header.strName == "te" && header.strValue != "trailers"))
+                        return false;
+                    continue;
+                }
+
+                if (bRegular)
+                    return false;
+                if (header.strName == ":method")
+                    bMethod = true;
+                else if (header.strName == ":scheme")
+                    bScheme = true;
+                else if (header.strName == ":path")
+                    bPath = !header.strValue.empty();
+                else if (header.strName != ":authority")
+                    return false;
+            }
+            return bMethod && bScheme && bPath;
+        }
+
+        /// @brief The request of a stream is complete: hands it to a worker.
+        void CompleteRequest(uint32_t nStreamId)
+        {
+            auto it = m_mapReceive.find(nStreamId);
+            if (it == m_mapReceive.end())
+                return;
+
+            ReceiveStream stream = std::move(it->second);
+            m_mapReceive.erase(it);
+            if (stream.bBodyTooLarge)
+            {
+                Respond(nStreamId, 413);
+                return;
+            }
+
+            auto req = std::make_shared<httplib::Request>();
+            req->version = "HTTP/2";
+            req->remote_addr = m_strRemoteAddr;
+            req->remote_port = m_nRemotePort;
+            req->body = std::move(stream.strBody);
+            std::string strAuthority;
+            for (HpackHeader &header : stream.vecHeaders)
+            {
+                if (header.strName == ":method")
+                    req->method = std::move(header.strValue);
+                else if (header.strName == ":path")
+                    req->target = std::move(header.strValue);
+                else if (header.strName == ":authority")
+                    strAuthority = std::move(header.strValue);
+                else if (header.strName[0] != ':')
+                    req->headers.emplace(std::move(header.strName), std::move(header.strValue));
+            }
+            if (!strAuthority.empty() && req->headers.find("host") == req->headers.end())
+            {
+                req->headers.emplace("host", strAuthority);
+            }
+
+            auto pSelf = shared_from_this();
+            const bool bQueued = m_pool.enqueue(
+                [pSelf, nStreamId, req]()
+                {
+                    httplib::Response res;
+                    try
+                    {
+                        pSelf->m_dispatch(*req, res);
+                    }
+                    catch (...)
+                    {
+                        res = httplib::Response();
+                        res.status = 500;
+                    }
+                    pSelf->QueueResponse(nStreamId, res, req->method == "HEAD");
+                });
+            if (!bQueued)
+            {
+                Respond(nStreamId, 503);
+            }
+        }
+
+        /// @brief Answers a stream with an empty response, without running a handler.
+        void Respond(uint32_t nStreamId, int nStatus)
+        {
+            m_mapReceive.erase(nStreamId);
+            httplib::Response res;
+            res.status = nStatus;
+            QueueResponse(nStreamId, res, false);
+        }
+
+        bool HandleRstStream(const Http2FrameHeader &header, const uint8_t *)
+        {
+            if (header.nStreamId == 0 || header.nStreamId > m_nLastStreamId)
+                return ConnectionError(Http2Error::ProtocolError);
+            if (header.cbLength != 4)
+                return ConnectionError(Http2Error::FrameSizeError);
+
+            m_mapReceive.erase(header.nStreamId);
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_mapSend.erase(header.nStreamId);
+            return true;
+        }
+
+        bool HandleSettings(const Http2FrameHeader &header, const uint8_t *pPayload)
+        {
+            if (header.nStreamId != 0)
+                return ConnectionError(Http2Error::ProtocolError);
+            if (header.nFlags & kHttp2FlagAck)
+                return header.cbLength == 0 ? true : ConnectionError(Http2Error::FrameSizeError);
+            if (header.cbLength % 6 != 0)
+                return ConnectionError(Http2Error::FrameSizeError);
+
+            {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                for (size_t i = 0; i < header.cbLength; i += 6)
+                {
+                    const uint16_t nId = static_cast<uint16_t>((pPayload[i] << 8) | pPayload[i + 1]);
+                    const uint32_t nValue = ReadUint32(pPayload + i + 2);
+                    switch (nId)
+                    {
+                    case kHttp2SettingsHeaderTableSize:
+                        m_encoder.SetMaxTableSize(std::min(nValue, kMaxEncoderTableSize));
+                        break;
+                    case kHttp2SettingsEnablePush:
+                        if (nValue > 1)
+                            return ConnectionErrorLocked(Http2Error::ProtocolError);
+                        break;
+                    case kHttp2SettingsInitialWindowSize:
+                    {
+                        if (nValue > kHttp2MaxWindowSize)
+                            return ConnectionErrorLocked(Http2Error::FlowControlError);
+
+                        // The change applies to every open stream (RFC 9113 section 6.9.2).
+                        const int64_t nDelta = static_cast<int64_t>(nValue) - m_nPeerInitialWindow;
+                        for (auto &entry : m_mapSend)
+                        {
+                            entry.second.nWindow += nDelta;
+                            if (entry.second.nWindow > kHttp2MaxWindowSize)
+                                return ConnectionErrorLocked(Http2Error::FlowControlError);
+                        }
+                        m_nPeerInitialWindow = nValue;
+                        break;
+                    }
+                    case kHttp2SettingsMaxFrameSize:
+                        if (nValue < kHttp2MinFrameSize || nValue > kHttp2MaxFrameSize)
+                            return ConnectionErrorLocked(Http2Error::ProtocolError);
+                        m_cbPeerMaxFrame = nValue;
+                        break;
+                    default:
+                        break; // Unknown settings are ignored.
+                    }
+                }
+                AppendHttp2Frame(m_strControl, Http2FrameType::Settings, kHttp2FlagAck, 0, nullptr, 0);
+            }
+            m_cvWriter.notify_all();
+            return true;
+        }
+
+        bool HandlePing(const Http2FrameHeader &header, const uint8_t *pPayload)
+        {
+            if (header.nStreamId != 0)
+                return ConnectionError(Http2Error::ProtocolError);
+            if (header.cbLength != 8)
+                return ConnectionError(Http2Error::FrameSizeError);
+            if (header.nFlags & kHttp2FlagAck)
+                return true;
+
+            std::string strFrame;
+            AppendHttp2Frame(strFrame, Http2FrameType::Ping, kHttp2FlagAck, 0, reinterpret_cast<const char *>(pPayload),
+                             8);
+            QueueControl(std::move(strFrame));
+            return true;
+        }
+
+        bool HandleWindowUpdate(const Http2FrameHeader &header, const uint8_t *pPayload)
+        {
+            if (header.cbLength != 4)
+                return ConnectionError(Http2Error::FrameSizeError);
+
+            const uint32_t nIncrement = ReadUint32(pPayload) & 0x7FFFFFFF;
+            {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                if (header.nStreamId == 0)
+                {
+                    if (nIncrement == 0)
+                        return ConnectionErrorLocked(Http2Error::ProtocolError);
+                    m_nSendWindow += nIncrement;
+                    if (m_nSendWindow > kHttp2MaxWindowSize)
+                        return ConnectionErrorLocked(Http2Error::FlowControlError);
+                }
+                else
+                {
+                    auto it = m_mapSend.find(header.nStreamId);
+                    if (it != m_mapSend.end())
+                    {
+                        it->second.nWindow += nIncrement;
+                        if (nIncrement == 0 || it->second.nWindow > kHttp2MaxWindowSize)
+                        {
+                            AppendRstStreamLocked(header.nStreamId, nIncrement == 0 ? Http2Error::ProtocolError
+                                                                                    : Http2Error::FlowControlError);
+                            m_mapSend.erase(it);
+                        }
+                    }
+                }
+            }
+            m_cvWriter.notify_all();
+            return true;
+        }
+
+        /// @brief Returns received connection-level bytes to the client's window in batches.
+        void AcknowledgeConnection(uint32_t cbData)
+        {
+            m_cbConnectionUnacknowledged += cbData;
+            if (m_cbConnectionUnacknowledged >= m_config.cbConnectionWindow / 2)
+            {
+                std::string strFrame;
+                AppendHttp2WindowUpdate(strFrame, 0, m_cbConnectionUnacknowledged);
+                m_nReceiveWindow += m_cbConnectionUnacknowledged;
+                m_cbConnectionUnacknowledged = 0;
+                QueueControl(std::move(strFrame));
+            }
+        }
+
+        void ResetStream(uint32_t nStreamId, Http2Error eError)
+        {
+            m_mapReceive.erase(nStreamId);
+            {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                m_mapSend.erase(nStreamId);
+                AppendRstStreamLocked(nStreamId, eError);
+            }
+            m_cvWriter.notify_all();
+        }
+
+        /// @brief Queues GOAWAY and returns false, which ends the reader.
+        bool ConnectionError(Http2Error eError)
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            return ConnectionErrorLocked(eError);
+        }
+
+        bool ConnectionErrorLocked(Http2Error eError)
+        {
+            AppendGoAwayLocked(eError);
+            return false;
+        }
+
+        void AppendGoAwayLocked(Http2Error eError)
+        {
+            std::string strPayload;
+            AppendUint32(strPayload, m_nLastStreamId);
+            AppendUint32(strPayload, static_cast<uint32_t>(eError));
+            AppendHttp2Frame(m_strControl, Http2FrameType::GoAway, 0, 0, strPayload.data(), strPayload.size());
+        }
+
+        void AppendRstStreamLocked(uint32_t nStreamId, Http2Error eError)
+        {
+            std::string strPayload;
+            AppendUint32(strPayload, static_cast<uint32_t>(eError));
+            AppendHttp2Frame(m_strControl, Http2FrameType::RstStream, 0, nStreamId, strPayload.data(),
+                             strPayload.size());
+        }
+
+        void QueueControl(std::string strFrames)
+        {
+            {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                m_strControl += strFrames;
+            }
+            m_cvWriter.notify_all();
+        }
+
+        // ---- Writer ----
+
+        void WriterLoop()
+        {
+            std::string strOut;
+            while (true)
+            {
+                {
+                    std::unique_lock<std::mutex> lock(m_mutex);
+                    m_cvWriter.wait(lock, [this]() { return m_bReaderDone || HasOutputLocked(); });
+                    BuildOutputLocked(strOut);
+                    if (strOut.empty() && m_bReaderDone)
+                        return;
+                }
+
+                if (!SendAll(m_socket, strOut))
+                {
+                    // The peer is gone; make sure the reader notices too.
+                    Shutdown();
+                    return;
+                }
+                strOut.clear();
+            }
+        }
+
+        bool HasOutputLocked() const
+        {
+            if (!m_strControl.empty())
+                return true;
+            for (const auto &entry : m_mapSend)
+            {
+                const SendStream &stream = entry.second;
+                if (stream.bReady && (!stream.bHeadersSent || (stream.nOffset < stream.strBody.size() &&
+                                                               stream.nWindow > 0 && m_nSendWindow > 0)))
+                    return true;
+            }
+            return false;
+        }
+
+        /// @brief Moves control frames, then response headers and DATA within the flow control windows, to strOut.
+        /// Streams take turns one frame at a time, so a large response does not hold up small ones.
+        void BuildOutputLocked(std::string &strOut)
+        {
+            strOut += m_strControl;
+            m_strControl.clear();
+
+            bool bProgress = true;
+            while (bProgress && strOut.size() < kWriteBatchBytes)
+            {
+                bProgress = false;
+                for (auto it = m_mapSend.begin(); it != m_mapSend.end() && strOut.size() < kWriteBatchBytes;)
+                {
+                    SendStream &stream = it->second;
+                    if (!stream.bReady)
+                    {
+                        ++it;
+                        continue;
+                    }
+
+                    if (!stream.bHeadersSent)
+                    {
+                        std::string strBlock;
+                        m_encoder.Encode(stream.vecHeaders, strBlock);
+                        AppendHttp2Headers(strOut, it->first, strBlock, stream.strBody.empty(), m_cbPeerMaxFrame);
+                        stream.bHeadersSent = true;
+                        bProgress = true;
+                    }
+
+                    const size_t cbLeft = stream.strBody.size() - stream.nOffset;
+                    const int64_t nWindow = std::min(stream.nWindow, m_nSendWindow);
+                    if (cbLeft > 0 && nWindow > 0)
+                    {
+                        const size_t cbChunk = std::min({cbLeft, static_cast<size_t>(nWindow),
+                                                         static_cast<size_t>(m_cbPeerMaxFrame)});
+                        const bool bLast = cbChunk == cbLeft;
+                        AppendHttp2Frame(strOut, Http2FrameType::Data, bLast ? kHttp2FlagEndStream : 0, it->first,
+                                         stream.strBody.data() + stream.nOffset, cbChunk);
+                        stream.nOffset += cbChunk;
+                        stream.nWindow -= static_cast<int64_t>(cbChunk);
+                        m_nSendWindow -= static_cast<int64_t>(cbChunk);
+                        bProgress = true;
+                    }
+
+                    if (stream.nOffset == stream.strBody.size())
+                        it = m_mapSend.erase(it);
+                    else
+                        ++it;
+                }
+            }
+        }
+
+    private:
+        const socket_t m_socket;
+        const std::string m_strRemoteAddr;
+        const int m_nRemotePort;
+        const Http2Config &m_config;
+        const Http2Listener::Dispatch &m_dispatch;
+        httplib::ThreadPool &m_pool;
+
+        // Reader state.
+        HpackDecoder m_decoder;
+        std::unordered_map<uint32_t, ReceiveStream> m_mapReceive;
+        uint32_t m_nLastStreamId = 0;
+        int64_t m_nReceiveWindow;
+        uint32_t m_cbConnectionUnacknowledged = 0;
+        std::string m_strHeaderBlock;
+        uint32_t m_nContinuationStream = 0;
+        bool m_bBlockEndsStream = false;
+        bool m_bGoAwayReceived = false;
+        std::chrono::steady_clock::time_point m_tLastActivity;
+
+        // Send state, shared with the writer and the workers.
+        mutable std::mutex m_mutex;
+        std::condition_variable m_cvWriter;
+        std::string m_strControl;
+        std::map<uint32_t, SendStream> m_mapSend;
+        HpackEncoder m_encoder;
+        int64_t m_nSendWindow = kHttp2DefaultWindowSize;
+        int64_t m_nPeerInitialWindow = kHttp2DefaultWindowSize;
+        uint32_t m_cbPeerMaxFrame = kHttp2MinFrameSize;
+        bool m_bReaderDone = false;
+        bool m_bShutdown = false;
+        bool m_bClosed = false;
+
+        std::thread m_writer;
+    };
+
+    Http2Listener::Http2Listener(Dispatch dispatch, const Http2Config &config)
+        : m_dispatch(std::move(dispatch)), m_config(config)
+    {
+    }
+
+    Http2Listener::~Http2Listener() { Stop(); }
+
+    bool Http2Listener::Start(const std::string &strHost, uint16_t nPort)
+    {
+        if (m_acceptThread.joinable())
+            return false;
+
+        addrinfo hints;
+        std::memset(&hints, 0, sizeof(hints));
+        hints.ai_family = AF_UNSPEC;
+        hints.ai_socktype = SOCK_STREAM;
+        hints.ai_flags = AI_PASSIVE;
+        addrinfo *pResult = nullptr;
+        if (getaddrinfo(strHost.c_str(), std::to_string(nPort).c_str(), &hints, &pResult) != 0)
+            return false;
+
+        socket_t s = kInvalidSocket;
+        for (addrinfo *p = pResult; p && s == kInvalidSocket; p = p->ai_next)
+        {
+            s = socket(p->ai_family, p->ai_socktype, p->ai_protocol);
+            if (s == kInvalidSocket)
+                continue;
+
+            int nYes = 1;
+            setsockopt(s, SOL_SOCKET, SO_REUSEADDR, reinterpret_cast<const char *>(&nYes), sizeof(nYes));
+            if (bind(s, p->ai_addr, static_cast<int>(p->ai_addrlen)) != 0 || listen(s, SOMAXCONN) != 0)
+            {
+                CloseSocket(s);
+                s = kInvalidSocket;
+            }
+        }
+        freeaddrinfo(pResult);
+        if (s == kInvalidSocket)
+            return false;
+
+        m_listenSocket = static_cast<std::intptr_t>(s);
+        m_bStopping = false;
+        m_pool = std::make_unique<httplib::ThreadPool>(std::max<uint32_t>(m_config.nWorkerThreads, 1));
+        m_acceptThread = std::thread([this]() { AcceptLoop(); });
+        return true;
+    }
+
+    void Http2Listener::Stop()
+    {
+        if (!m_acceptThread.joinable())
+            return;
+
+        m_bStopping = true;
+        m_acceptThread.join();
+        CloseSocket(ToSocket(m_listenSocket));
+        m_listenSocket = -1;
+
+        std::vector<ConnectionThread> vecConnections;
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            vecConnections.swap(m_vecConnections);
+        }
+        for (ConnectionThread &connection : vecConnections)
+        {
+            connection.pConnection->Shutdown();
+        }
+        for (ConnectionThread &connection : vecConnections)
+        {
+            connection.thread.join();
+        }
+
+        // Handlers still running finish here; their responses are dropped with their connections.
+        m_pool->shutdown();
+        m_pool.reset();
+    }
+
+    size_t Http2Listener::GetConnectionCount() const
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        size_t nOpen = 0;
+        for (const ConnectionThread &connection : m_vecConnections)
+        {
+            if (!connection.pConnection->IsClosed())
+            {
+                ++nOpen;
+            }
+        }
+        return nOpen;
+    }
+
+    void Http2Listener::AcceptLoop()
+    {
+        const socket_t listenSocket = ToSocket(m_listenSocket);
+        while (!m_bStopping)
+        {
+            pollfd fd;
+            fd.fd = listenSocket;
+            fd.events = POLLIN;
+            fd.revents = 0;
+            if (PollSocket(&fd, kPollIntervalMs) <= 0)
+                continue;
+
+            sockaddr_storage addr;
+            socklen_t cbAddr = sizeof(addr);
+            const socket_t s = accept(listenSocket, reinterpret_cast<sockaddr *>(&addr), &cbAddr);
+            if (s == kInvalidSocket)
+                continue;
+
+            char szHost[NI_MAXHOST] = {};
+            char szPort[NI_MAXSERV] = {};
+            getnameinfo(reinterpret_cast<sockaddr *>(&addr), cbAddr, szHost, sizeof(szHost), szPort, sizeof(szPort),
+                        NI_NUMERICHOST | NI_NUMERICSERV);
+
+            int nYes = 1;
+            setsockopt(s, IPPROTO_TCP, TCP_NODELAY, reinterpret_cast<const char *>(&nYes), sizeof(nYes));
+#ifdef SO_NOSIGPIPE
+            setsockopt(s, SOL_SOCKET, SO_NOSIGPIPE, reinterpret_cast<const char *>(&nYes), sizeof(nYes));
+#endif
+
+            std::lock_guard<std::mutex> lock(m_mutex);
+            ReapConnections();
+            if (m_vecConnections.size() >= m_config.nMaxConnections)
+            {
+                CloseSocket(s);
+                continue;
+            }
+
+            auto pConnection = std::make_shared<Http2Connection>(s, szHost, std::atoi(szPort), m_config, m_dispatch,
+                                                                 *m_pool);
+            m_vecConnections.push_back({pConnection, std::thread([pConnection]() { pConnection->Run(); })});
+        }
+    }
+
+    void Http2Listener::ReapConnections()
+    {
+        for (auto it = m_vecConnections.begin(); it != m_vecConnections.end();)
+        {
+            if (it->pConnection->IsClosed())
+            {
+                it->thread.join();
+                it = m_vecConnections.erase(it);
+            }
+            else
+            {
+                ++it;
+            }
+        }
+    }
+} // namespace QNET
\ No newline at end of file
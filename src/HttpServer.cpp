@@ -1,32 +1,403 @@
 #include "quicknet/components/HttpServer.h"
 
+#include <algorithm>
+#include <atomic>
+#include <cctype>
+#include <chrono>
+#include <condition_variable>
+#include <cstdlib>
+#include <deque>
+#include <exception>
+
 namespace QNET
 {
+    namespace
+    {
+        /// @brief Returns true for the headers that describe a request body, which a sub-request of a batch does not
+        /// inherit from the batch.
+        bool is_body_header(const std::string &name)
+        {
+            std::string lower(name);
+            std::transform(lower.begin(), lower.end(), lower.begin(),
+                           [](unsigned char ch) { return static_cast<char>(std::tolower(ch)); });
+            return lower.rfind("content-", 0) == 0 || lower == "transfer-encoding";
+        }
+
+        int hex_value(char ch)
+        {
+            if (ch >= '0' && ch <= '9')
+                return ch - '0';
+            if (ch >= 'a' && ch <= 'f')
+                return ch - 'a' + 10;
+            if (ch >= 'A' && ch <= 'F')
+                return ch - 'A' + 10;
+            return -1;
+        }
+
+        /// @brief Decodes %XX escapes, and '+' as a space if plus_is_space (query strings).
+        std::string decode_url(const std::string &text, bool plus_is_space)
+        {
+            std::string out;
+            out.reserve(text.size());
+            for (size_t i = 0; i < text.size(); ++i)
+            {
+                if (text[i] == '%' && i + 2 < text.size() && hex_value(text[i + 1]) >= 0 &&
+                    hex_value(text[i + 2]) >= 0)
+                {
+                    out += static_cast<char>(hex_value(text[i + 1]) * 16 + hex_value(text[i + 2]));
+                    i += 2;
+                }
+                else if (text[i] == '+' && plus_is_space)
+                {
+                    out += ' ';
+                }
+                else
+                {
+                    out += text[i];
+                }
+            }
+            return out;
+        }
+
+        void parse_query(const std::string &query, httplib::Params &params)
+        {
+            size_t start = 0;
+            while (start <= query.size())
+            {
+                size_t end = query.find('&', start);
+                if (end == std::string::npos)
+                    end = query.size();
+
+                const std::string pair = query.substr(start, end - start);
+                if (!pair.empty())
+                {
+                    const size_t equals = pair.find('=');
+                    if (equals == std::string::npos)
+                        params.emplace(decode_url(pair, true), "");
+                    else
+                        params.emplace(decode_url(pair.substr(0, equals), true),
+                                       decode_url(pair.substr(equals + 1), true));
+                }
+                start = end + 1;
+            }
+        }
+
+        /// @brief Sets path and params from target, as httplib does for requests it parses.
+        void parse_target(Request &req)
+        {
+            const size_t query = req.target.find('?');
+            req.path = decode_url(req.target.substr(0, query), false);
+            if (query != std::string::npos)
+            {
+                parse_query(req.target.substr(query + 1), req.params);
+            }
+        }
+
+        void write_error_page(Response &res)
+        {
+            const char *fmt = "<h1>Error %d</h1><p>%s</p>";
+            char buf[BUFSIZ];
+            snprintf(buf, sizeof(buf), fmt, res.status, httplib::status_message(res.status));
+            res.set_content(buf, "text/html");
+        }
+
+        void log_request(const Request &req, const Response &res)
+        {
+            std::cout << req.method << " " << req.remote_addr << " " << req.path << " -> " << res.status << std::endl;
+        }
+
+        const httplib::Headers &default_headers()
+        {
+            // CORS headers by default, for web development.
+            static const httplib::Headers headers = {
+                {"Access-Control-Allow-Origin", "*"},
+                {"Access-Control-Allow-Methods", "POST, GET, OPTIONS"},
+                {"Access-Control-Allow-Headers", "Content-Type"},
+            };
+            return headers;
+        }
+
+        /// @brief Returns true if text is well-formed UTF-8: no overlong forms, surrogates or code points above
+        /// U+10FFFF.
+        bool is_valid_utf8(const std::string &text)
+        {
+            const unsigned char *p = reinterpret_cast<const unsigned char *>(text.data());
+            const unsigned char *end = p + text.size();
+            while (p < end)
+            {
+                const unsigned char lead = *p;
+                if (lead < 0x80)
+                {
+                    ++p;
+                    continue;
+                }
+
+                size_t length = 0;
+                unsigned char min_next = 0x80;
+                unsigned char max_next = 0xbf;
+                if (lead >= 0xc2 && lead <= 0xdf)
+                    length = 2;
+                else if (lead >= 0xe0 && lead <= 0xef)
+                {
+                    length = 3;
+                    min_next = lead == 0xe0 ? 0xa0 : 0x80;
+                    max_next = lead == 0xed ? 0x9f : 0xbf;
+                }
+                else if (lead >= 0xf0 && lead <= 0xf4)
+                {
+                    length = 4;
+                    min_next = lead == 0xf0 ? 0x90 : 0x80;
+                    max_next = lead == 0xf4 ? 0x8f : 0xbf;
+                }
+                else
+                    return false;
+
+                if (size_t(end - p) < length || p[1] < min_next || p[1] > max_next)
+                    return false;
+                for (size_t i = 2; i < length; ++i)
+                {
+                    if ((p[i] & 0xc0) != 0x80)
+                        return false;
+                }
+                p += length;
+            }
+            return true;
+        }
+
+        std::string encode_base64(const std::string &data)
+        {
+            static const char alphabet[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+            std::string out;
+            out.reserve((data.size() + 2) / 3 * 4);
+            size_t i = 0;
+            for (; i + 3 <= data.size(); i += 3)
+            {
+                const uint32_t bits = uint32_t(uint8_t(data[i])) << 16 | uint32_t(uint8_t(data[i + 1])) << 8 |
+                                      uint8_t(data[i + 2]);
+                out += alphabet[bits >> 18];
+                out += alphabet[(bits >> 12) & 0x3f];
+                out += alphabet[(bits >> 6) & 0x3f];
+                out += alphabet[bits & 0x3f];
+            }
+            if (i < data.size())
+            {
+                const bool two = i + 1 < data.size();
+                const uint32_t bits =
+                    uint32_t(uint8_t(data[i])) << 16 | (two ? uint32_t(uint8_t(data[i + 1])) << 8 : 0);
+                out += alphabet[bits >> 18];
+                out += alphabet[(bits >> 12) & 0x3f];
+                out += two ? alphabet[(bits >> 6) & 0x3f] : '=';
+                out += '=';
+            }
+            return out;
+        }
+
+        /// @brief Returns the length of a sub-response body as a batch response carries it: base64 if the body is not
+        /// UTF-8 text.
+        size_t batch_body_size(const std::string &body, bool text)
+        {
+            return text ? body.size() : (body.size() + 2) / 3 * 4;
+        }
+
+        /// @brief Writes an entry of a batch response for a sub-request that produced no response of its own.
+        void write_batch_error(JsonWriter &writer, int status, const std::string &message)
+        {
+            writer.BeginObject().Key("status").Int(status).Key("error").String(message).EndObject();
+        }
+    } // namespace
+
+    struct HttpServer::batch_state
+    {
+        explicit batch_state(size_t count) : items(count), remaining(count) {}
+
+        std::vector<batch_item> items;
+
+        /// @brief The next item to claim, and the response bytes produced so far.
+        std::atomic<size_t> next{0};
+        std::atomic<size_t> response_bytes{0};
+
+        /// @brief Items not finished yet; the thread that received the batch waits for it to reach zero.
+        std::mutex mutex;
+        std::condition_variable done;
+        size_t remaining;
+    };
+
+    class HttpServer::bulkhead
+    {
+    public:
+        enum class outcome
+        {
+            done,
+            rejected,
+            timed_out
+        };
+
+        bulkhead(const std::string &name, const HttpBulkheadConfig &config) : m_name(name), m_config(config)
+        {
+            for (uint32_t i = 0; i < m_config.nWorkerThreads; ++i)
+            {
+                m_threads.emplace_back([this]() { worker_loop(); });
+            }
+        }
+
+        ~bulkhead() { stop(); }
+
+        /// @brief Stops the workers once the queue has drained. Requests arriving afterwards are rejected.
+        void stop()
+        {
+            {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                m_stopping = true;
+            }
+            m_work_ready.notify_all();
+            for (std::thread &thread : m_threads)
+            {
+                if (thread.joinable())
+                {
+                    thread.join();
+                }
+            }
+        }
+
+        /// @brief Runs fn on a worker and waits for it to return. Exceptions thrown by fn are rethrown here.
+        outcome run(const std::function<void()> &fn)
+        {
+            task item;
+            item.fn = &fn;
+            item.queued_at = std::chrono::steady_clock::now();
+
+            std::unique_lock<std::mutex> lock(m_mutex);
+            if (m_stopping || m_busy + m_queue.size() >= m_config.nWorkerThreads + m_config.nMaxQueue)
+            {
+                ++m_stats.nRejected;
+                return outcome::rejected;
+            }
+            m_queue.push_back(&item);
+            m_stats.nPeakQueued = std::max(m_stats.nPeakQueued, static_cast<uint32_t>(m_queue.size()));
+            m_work_ready.notify_one();
+
+            if (m_config.nQueueTimeoutMs > 0)
+            {
+                const auto deadline = item.queued_at + std::chrono::milliseconds(m_config.nQueueTimeoutMs);
+                if (!item.done_cv.wait_until(lock, deadline, [&item]() { return item.state != task_state::queued; }))
+                {
+                    // Still queued, so no worker refers to the task: it can be taken out and abandoned.
+                    m_queue.erase(std::find(m_queue.begin(), m_queue.end(), &item));
+                    ++m_stats.nTimedOut;
+                    return outcome::timed_out;
+                }
+            }
+            item.done_cv.wait(lock, [&item]() { return item.state == task_state::done; });
+            lock.unlock();
+
+            if (item.error)
+            {
+                std::rethrow_exception(item.error);
+            }
+            return outcome::done;
+        }
+
+        HttpBulkheadStats stats() const
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            HttpBulkheadStats stats = m_stats;
+            stats.strName = m_name;
+            stats.nWorkerThreads = m_config.nWorkerThreads;
+            stats.nMaxQueue = m_config.nMaxQueue;
+            stats.nBusy = m_busy;
+            stats.nQueued = static_cast<uint32_t>(m_queue.size());
+            return stats;
+        }
+
+    private:
+        enum class task_state
+        {
+            queued,
+            running,
+            done
+        };
+
+        /// @brief A request handed to the pool. Lives on the waiting thread's stack, which does not return before
+        /// the task is done or taken back out of the queue.
+        struct task
+        {
+            const std::function<void()> *fn = nullptr;
+            std::chrono::steady_clock::time_point queued_at;
+            task_state state = task_state::queued;
+            std::exception_ptr error;
+            std::condition_variable done_cv;
+        };
+
+        void worker_loop()
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            while (true)
+            {
+                m_work_ready.wait(lock, [this]() { return m_stopping || !m_queue.empty(); });
+                if (m_queue.empty())
+                    return;
+
+                task *item = m_queue.front();
+                m_queue.pop_front();
+                item->state = task_state::running;
+                ++m_busy;
+
+                const auto started_at = std::chrono::steady_clock::now();
+                m_stats.usecQueued +=
+                    std::chrono::duration_cast<std::chrono::microseconds>(started_at - item->queued_at).count();
+                item->done_cv.notify_one();
+                lock.unlock();
+
+                std::exception_ptr error;
+                try
+                {
+                    (*item->fn)();
+                }
+                catch (...)
+                {
+                    error = std::current_exception();
+                }
+
+                const auto finished_at = std::chrono::steady_clock::now();
+                lock.lock();
+                item->error = error;
+                item->state = task_state::done;
+                --m_busy;
+                ++m_stats.nCompleted;
+                m_stats.usecBusy +=
+                    std::chrono::duration_cast<std::chrono::microseconds>(finished_at - started_at).count();
+
+                // Notified with the lock held: the waiter cannot wake, see done and destroy the task before.
+                item->done_cv.notify_one();
+            }
+        }
+
+    private:
+        const std::string m_name;
+        const HttpBulkheadConfig m_config;
+
+        mutable std::mutex m_mutex;
+        std::condition_variable m_work_ready;
+        std::deque<task *> m_queue;
+        uint32_t m_busy = 0;
+        bool m_stopping = false;
+        HttpBulkheadStats m_stats;
+
+        std::vector<std::thread> m_threads;
+    };
+
     HttpServer::HttpServer()
     {
         m_server = std::make_unique<httplib::Server>();
 
         // Set up a default error handler
-        m_server->set_error_handler(
-            [](const Request &, Response &res)
-            {
-                const char *fmt = "<h1>Error %d</h1><p>%s</p>";
-                char buf[BUFSIZ];
-                snprintf(buf, sizeof(buf), fmt, res.status, httplib::status_message(res.status));
-                res.set_content(buf, "text/html");
-            });
+        m_server->set_error_handler([](const Request &, Response &res) { write_error_page(res); });
 
         // Set up a default logger to print requests to the console
-        m_server->set_logger(
-            [](const Request &req, const Response &res)
-            { std::cout << req.method << " " << req.remote_addr << " " << req.path << " -> " << res.status << std::endl; });
+        m_server->set_logger([](const Request &req, const Response &res) { log_request(req, res); });
 
         // Set up CORS headers by default for web development
-        m_server->set_default_headers({
-            {"Access-Control-Allow-Origin", "*"},
-            {"Access-Control-Allow-Methods", "POST, GET, OPTIONS"},
-            {"Access-Control-Allow-Headers", "Content-Type"},
-        });
+        m_server->set_default_headers(default_headers());
         m_server->Options(".*",
                           [](const Request &, Response &res)
                           {
@@ -34,38 +405,37 @@ namespace QNET
                           });
     }
 
-    HttpServer::~HttpServer() { Stop(); }
-
-    void HttpServer::Get(const std::string &path, Handler handler)
+    HttpServer::~HttpServer()
     {
-        if (m_server)
+        Stop();
+        if (m_batch_pool)
+        {
+            m_batch_pool->shutdown();
+        }
+        for (auto &entry : m_bulkheads)
         {
-            m_server->Get(path_to_regex(path), handler);
+            entry.second->stop();
         }
     }
 
-    void HttpServer::Post(const std::string &path, Handler handler)
+    void HttpServer::Get(const std::string &path, Handler handler, const std::string &bulkhead)
     {
-        if (m_server)
-        {
-            m_server->Post(path_to_regex(path), handler);
-        }
+        add_route("GET", path, std::move(handler), bulkhead);
     }
 
-    void HttpServer::Put(const std::string &path, Handler handler)
+    void HttpServer::Post(const std::string &path, Handler handler, const std::string &bulkhead)
     {
-        if (m_server)
-        {
-            m_server->Put(path_to_regex(path), handler);
-        }
+        add_route("POST", path, std::move(handler), bulkhead);
     }
 
-    void HttpServer::Delete(const std::string &path, Handler handler)
+    void HttpServer::Put(const std::string &path, Handler handler, const std::string &bulkhead)
     {
-        if (m_server)
-        {
-            m_server->Delete(path_to_regex(path), handler);
-        }
+        add_route("PUT", path, std::move(handler), bulkhead);
+    }
+
+    void HttpServer::Delete(const std::string &path, Handler handler, const std::string &bulkhead)
+    {
+        add_route("DELETE", path, std::move(handler), bulkhead);
     }
 
     bool HttpServer::ServeStaticFiles(const std::string &mount_point, const std::string &dir_path)
@@ -92,6 +462,12 @@ namespace QNET
 
     void HttpServer::Stop()
     {
+        if (m_http2)
+        {
+            m_http2->Stop();
+            m_http2.reset();
+            std::cout << "HTTP/2 listener stopped." << std::endl;
+        }
         if (m_server && m_server->is_running())
         {
             m_server->stop();
@@ -99,6 +475,114 @@ namespace QNET
         }
     }
 
+    void HttpServer::SetWatchdog(Watchdog *pWatchdog)
+    {
+        std::lock_guard<std::mutex> lock(m_monitor_mutex);
+        m_watchdog = pWatchdog;
+        m_monitors.clear();
+    }
+
+    bool HttpServer::AddBulkhead(const std::string &name, const HttpBulkheadConfig &config)
+    {
+        if (name.empty() || m_bulkheads.count(name))
+        {
+            log_message("A bulkhead needs a name of its own; '" + name + "' is empty or already taken.");
+            return false;
+        }
+
+        HttpBulkheadConfig checked = config;
+        checked.nWorkerThreads = std::max<uint32_t>(checked.nWorkerThreads, 1);
+        m_bulkheads.emplace(name, std::make_unique<bulkhead>(name, checked));
+        return true;
+    }
+
+    std::vector<HttpBulkheadStats> HttpServer::GetBulkheadStats() const
+    {
+        std::vector<HttpBulkheadStats> stats;
+        for (const auto &entry : m_bulkheads)
+        {
+            stats.push_back(entry.second->stats());
+        }
+        return stats;
+    }
+
+    void HttpServer::ServeBulkheadStats(const std::string &path)
+    {
+        Get(path,
+            [this](const Request &, Response &res)
+            {
+                JsonWriter writer;
+                writer.BeginObject();
+                writer.Key("bulkheads").BeginArray();
+                for (const HttpBulkheadStats &stats : GetBulkheadStats())
+                {
+                    writer.BeginObject();
+                    writer.Key("name").String(stats.strName);
+                    writer.Key("workers").UInt(stats.nWorkerThreads);
+                    writer.Key("maxQueue").UInt(stats.nMaxQueue);
+                    writer.Key("busy").UInt(stats.nBusy);
+                    writer.Key("queued").UInt(stats.nQueued);
+                    writer.Key("peakQueued").UInt(stats.nPeakQueued);
+                    writer.Key("completed").UInt(stats.nCompleted);
+                    writer.Key("rejected").UInt(stats.nRejected);
+                    writer.Key("timedOut").UInt(stats.nTimedOut);
+                    writer.Key("busyUs").UInt(stats.usecBusy);
+                    writer.Key("queuedUs").UInt(stats.usecQueued);
+                    writer.EndObject();
+                }
+                writer.EndArray();
+                writer.EndObject();
+                res.set_content(writer.GetString(), "application/json");
+            });
+    }
+
+    void HttpServer::SetRequestArena(size_t cbInitialSize, size_t cbMaxRetained)
+    {
+        m_arena_size = cbInitialSize;
+        m_arena_max_size = cbMaxRetained;
+    }
+
+    bool HttpServer::StartHttp2(uint16_t port, const Http2Config &config)
+    {
+        if (m_http2)
+        {
+            log_message("The HTTP/2 listener is already running.");
+            return false;
+        }
+
+        auto listener = std::make_unique<Http2Listener>([this](Request &req, Response &res) { serve_http2(req, res); },
+                                                        config);
+        if (!listener->Start("0.0.0.0", port))
+        {
+            log_message("Failed to bind HTTP/2 listener to port " + std::to_string(port));
+            return false;
+        }
+        m_http2 = std::move(listener);
+        std::cout << "HTTP/2 (h2c) listener started on port " << port << "." << std::endl;
+        return true;
+    }
+
+    bool HttpServer::EnableBatch(const std::string &path, const HttpBatchConfig &config)
+    {
+        if (!m_batch_path.empty())
+        {
+            log_message("A batch route is already registered at '" + m_batch_path + "'.");
+            return false;
+        }
+
+        m_batch_path = path;
+        m_batch_config = config;
+        if (config.nWorkerThreads > 0 && config.nMaxParallelism > 1)
+        {
+            m_batch_pool = std::make_unique<httplib::ThreadPool>(config.nWorkerThreads);
+        }
+
+        // Registered with httplib only, so that the route table never routes a sub-request back into a batch. Not
+        // watched itself: each sub-request is, under its own route, and watchdog callbacks do not nest.
+        m_server->Post(path, [this](const Request &req, Response &res) { handle_batch(req, res); });
+        return true;
+    }
+
     void HttpServer::log_message(const std::string &msg) { std::cerr << "ERROR: " << msg << std::endl; }
 
     // This helper function converts a path with :params into a regular expression
@@ -109,4 +593,400 @@ namespace QNET
         std::regex pattern(":([a-zA-Z0-9_]+)");
         return std::regex_replace(path, pattern, "([^/]+)");
     }
+
+    void HttpServer::add_route(const std::string &method, const std::string &path, Handler handler,
+                               const std::string &bulkhead_name)
+    {
+        if (!m_server)
+            return;
+
+        bulkhead *group = nullptr;
+        if (!bulkhead_name.empty())
+        {
+            auto it = m_bulkheads.find(bulkhead_name);
+            if (it == m_bulkheads.end())
+                log_message("Unknown bulkhead '" + bulkhead_name + "' for " + method + " " + path +
+                            "; the route runs on the shared workers.");
+            else
+                group = it->second.get();
+        }
+
+        const std::string pattern = path_to_regex(path);
+        Handler wrapped = wrap_handler(method + " " + path, std::move(handler), group);
+        m_routes.push_back({method, std::regex(pattern), wrapped});
+
+        if (method == "GET")
+            m_server->Get(pattern, std::move(wrapped));
+        else if (method == "POST")
+            m_server->Post(pattern, std::move(wrapped));
+        else if (method == "PUT")
+            m_server->Put(pattern, std::move(wrapped));
+        else if (method == "DELETE")
+            m_server->Delete(pattern, std::move(wrapped));
+    }
+
+    void HttpServer::handle_batch(const Request &req, Response &res)
+    {
+        auto reject = [&res](int status, const std::string &message) { RespondError(res, status, message); };
+
+        if (req.body.size() > m_batch_config.cbMaxBody)
+            return reject(413, "batch body exceeds " + std::to_string(m_batch_config.cbMaxBody) + " bytes");
+
+        JsonValue doc;
+        std::string error;
+        if (!JsonValue::Parse(req.body, doc, &error))
+            return reject(400, "invalid JSON: " + error);
+
+        const JsonValue *requests = doc.Find("requests");
+        if (!requests || !requests->IsArray())
+            return reject(400, "the batch needs a \"requests\" array");
+
+        const std::vector<JsonValue> &descs = requests->GetArray();
+        if (descs.size() > m_batch_config.nMaxRequests)
+            return reject(413, "a batch holds at most " + std::to_string(m_batch_config.nMaxRequests) + " requests");
+
+        // Every sub-request is checked before any runs, so a malformed batch has no side effects.
+        auto state = std::make_shared<batch_state>(descs.size());
+        for (size_t i = 0; i < descs.size(); ++i)
+        {
+            if (!prepare_batch_item(req, descs[i], state->items[i], error))
+                return reject(400, "request " + std::to_string(i) + ": " + error);
+        }
+
+        const JsonValue *parallel = doc.Find("parallel");
+        if (parallel && parallel->GetBool() && m_batch_pool && descs.size() > 1)
+        {
+            // Helpers claim items alongside this thread. One that starts after the items ran out finds nothing to
+            // do, so this thread never waits on a queued helper, only on items in progress.
+            const size_t helpers = std::min<size_t>({descs.size() - 1, m_batch_config.nWorkerThreads,
+                                                     m_batch_config.nMaxParallelism - 1});
+            for (size_t i = 0; i < helpers; ++i)
+            {
+                if (!m_batch_pool->enqueue([this, state]() { run_batch_items(*state); }))
+                    break;
+            }
+        }
+        run_batch_items(*state);
+        {
+            std::unique_lock<std::mutex> lock(state->mutex);
+            state->done.wait(lock, [&state]() { return state->remaining == 0; });
+        }
+
+        JsonWriter writer;
+        writer.BeginObject().Key("responses").BeginArray();
+        size_t response_bytes = 0;
+        for (const batch_item &item : state->items)
+        {
+            // JSON strings hold text, so binary bodies (images, protobuf, gzip) are sent in base64 instead of being
+            // mangled into invalid JSON.
+            const bool text = item.run && is_valid_utf8(item.res.body);
+            const size_t body_size = batch_body_size(item.res.body, text);
+            if (!item.run || response_bytes + body_size > m_batch_config.cbMaxResponse)
+            {
+                write_batch_error(writer, 413, "batch response limit reached");
+                continue;
+            }
+            if (!item.error.empty())
+            {
+                write_batch_error(writer, item.res.status, item.error);
+                continue;
+            }
+
+            response_bytes += body_size;
+            writer.BeginObject().Key("status").Int(item.res.status).Key("headers").BeginObject();
+            for (const auto &header : item.res.headers)
+            {
+                writer.Key(header.first).String(header.second);
+            }
+            writer.EndObject();
+
+            if (text)
+            {
+                writer.Key("body").String(item.res.body);
+            }
+            else
+            {
+                writer.Key("encoding").String("base64").Key("body").String(encode_base64(item.res.body));
+            }
+            writer.EndObject();
+        }
+        writer.EndArray().EndObject();
+
+        res.status = 200;
+        res.set_content(writer.GetString(), "application/json");
+    }
+
+    void HttpServer::RespondError(Response &res, int status, const std::string &message)
+    {
+        JsonWriter writer;
+        writer.BeginObject().Key("error").String(message).EndObject();
+        res.status = status;
+        res.set_content(writer.GetString(), "application/json");
+    }
+
+    bool HttpServer::CheckBearerToken(const Request &req, Response &res, const std::string &token)
+    {
+        if (token.empty())
+            return true;
+
+        // Every byte of the expected header is compared whatever the header holds; only its length shows.
+        const std::string expected = "Bearer " + token;
+        const std::string header = req.get_header_value("Authorization");
+        unsigned char diff = header.size() == expected.size() ? 0 : 1;
+        for (size_t i = 0; i < expected.size(); ++i)
+        {
+            diff |= static_cast<unsigned char>(expected[i] ^ (i < header.size() ? header[i] : 0));
+        }
+        if (diff == 0)
+            return true;
+
+        RespondError(res, 401, "unauthorized");
+        return false;
+    }
+
+    bool HttpServer::ReadUIntParam(const Request &req, const char *name, uint64_t &value)
+    {
+        if (!req.has_param(name))
+            return true;
+
+        const std::string text = req.get_param_value(name);
+        char *end = nullptr;
+        const unsigned long long parsed = std::strtoull(text.c_str(), &end, 10);
+        if (text.empty() || *end != '\0' || text[0] == '-')
+            return false;
+
+        value = parsed;
+        return true;
+    }
+
+    bool HttpServer::prepare_batch_item(const Request &outer, const JsonValue &desc, batch_item &item,
+                                        std::string &strError)
+    {
+        if (!desc.IsObject())
+        {
+            strError = "not an object";
+            return false;
+        }
+
+        Request &req = item.req;
+        req.method = "GET";
+        if (const JsonValue *method = desc.Find("method"))
+        {
+            if (!method->IsString() || method->GetString().empty())
+            {
+                strError = "\"method\" must be a string";
+                return false;
+            }
+            req.method = method->GetString();
+            std::transform(req.method.begin(), req.method.end(), req.method.begin(),
+                           [](unsigned char ch) { return static_cast<char>(std::toupper(ch)); });
+        }
+
+        const JsonValue *path = desc.Find("path");
+        if (!path || !path->IsString() || path->GetString().empty() || path->GetString()[0] != '/')
+        {
+            strError = "\"path\" must be a string starting with '/'";
+            return false;
+        }
+        req.target = path->GetString();
+        parse_target(req);
+        if (req.path == m_batch_path)
+        {
+            strError = "batches cannot be nested";
+            return false;
+        }
+
+        for (const auto &header : outer.headers)
+        {
+            if (!is_body_header(header.first))
+            {
+                req.headers.emplace(header.first, header.second);
+            }
+        }
+        if (const JsonValue *headers = desc.Find("headers"))
+        {
+            if (!headers->IsObject())
+            {
+                strError = "\"headers\" must be an object";
+                return false;
+            }
+            for (const auto &header : headers->GetMembers())
+            {
+                if (!header.second.IsString())
+                {
+                    strError = "header \"" + header.first + "\" must be a string";
+                    return false;
+                }
+                req.headers.erase(header.first);
+            }
+            for (const auto &header : headers->GetMembers())
+            {
+                req.headers.emplace(header.first, header.second.GetString());
+            }
+        }
+
+        if (const JsonValue *body = desc.Find("body"))
+        {
+            if (!body->IsString())
+            {
+                strError = "\"body\" must be a string";
+                return false;
+            }
+            req.body = body->GetString();
+        }
+
+        req.version = outer.version;
+        req.remote_addr = outer.remote_addr;
+        req.remote_port = outer.remote_port;
+        return true;
+    }
+
+    void HttpServer::run_batch_items(batch_state &state)
+    {
+        for (size_t i = state.next.fetch_add(1); i < state.items.size(); i = state.next.fetch_add(1))
+        {
+            batch_item &item = state.items[i];
+            if (state.response_bytes.load(std::memory_order_relaxed) < m_batch_config.cbMaxResponse)
+            {
+                run_batch_item(item);
+                const size_t body_size = batch_body_size(item.res.body, is_valid_utf8(item.res.body));
+                state.response_bytes.fetch_add(body_size, std::memory_order_relaxed);
+            }
+
+            std::lock_guard<std::mutex> lock(state.mutex);
+            if (--state.remaining == 0)
+            {
+                state.done.notify_all();
+            }
+        }
+    }
+
+    void HttpServer::run_batch_item(batch_item &item)
+    {
+        item.run = true;
+        route_request(item.req, item.res, item.error);
+    }
+
+    bool HttpServer::route_request(Request &req, Response &res, std::string &error)
+    {
+        // HEAD is served by the GET handler, as httplib does; the HTTP/2 layer drops the body.
+        const std::string &method = req.method == "HEAD" ? std::string("GET") : req.method;
+        for (const route_entry &route : m_routes)
+        {
+            // First match in registration order, as httplib routes.
+            if (route.method != method || !std::regex_match(req.path, req.matches, route.pattern))
+                continue;
+
+            try
+            {
+                route.handler(req, res);
+                if (res.status == -1)
+                {
+                    res.status = 200;
+                }
+            }
+            catch (const std::exception &e)
+            {
+                res = Response();
+                res.status = 500;
+                error = e.what();
+            }
+            catch (...)
+            {
+                res = Response();
+                res.status = 500;
+                error = "unknown exception";
+            }
+            return true;
+        }
+
+        res.status = 404;
+        error = "no route for " + req.method + " " + req.path;
+        return false;
+    }
+
+    void HttpServer::serve_http2(Request &req, Response &res)
+    {
+        parse_target(req);
+        if (req.method == "OPTIONS")
+        {
+            res.status = 204; // No Content
+        }
+        else if (req.method == "POST" && !m_batch_path.empty() && req.path == m_batch_path)
+        {
+            handle_batch(req, res);
+        }
+        else
+        {
+            std::string error;
+            route_request(req, res, error);
+        }
+
+        if (res.status >= 400 && res.body.empty())
+        {
+            write_error_page(res);
+        }
+        for (const auto &header : default_headers())
+        {
+            if (res.headers.find(header.first) == res.headers.end())
+            {
+                res.headers.emplace(header.first, header.second);
+            }
+        }
+        log_request(req, res);
+    }
+
+    Handler HttpServer::wrap_handler(const std::string &route, Handler handler, bulkhead *group)
+    {
+        // The route string must outlive every report that refers to it, so it is owned by the wrapper.
+        auto route_name = std::make_shared<const std::string>(route);
+        Handler wrapped = [this, route_name, handler = std::move(handler)](const Request &req, Response &res)
+        {
+            RequestArena::Scope arena(get_thread_arena());
+            const std::shared_ptr<LoopMonitor> monitor = get_thread_monitor();
+            LoopMonitor::CallbackScope scope(monitor.get(), k_HSteamNetConnection_Invalid, -1, route_name->c_str());
+            handler(req, res);
+        };
+        if (!group)
+            return wrapped;
+
+        // The arena and monitor scopes are entered on the bulkhead's worker, which is where the handler runs.
+        return [group, wrapped = std::move(wrapped)](const Request &req, Response &res)
+        {
+            if (group->run([&]() { wrapped(req, res); }) != bulkhead::outcome::done)
+            {
+                res.status = 503;
+                res.set_header("Retry-After", "1");
+            }
+        };
+    }
+
+    std::shared_ptr<LoopMonitor> HttpServer::get_thread_monitor()
+    {
+        std::lock_guard<std::mutex> lock(m_monitor_mutex);
+        if (!m_watchdog)
+            return nullptr;
+
+        std::shared_ptr<LoopMonitor> &monitor = m_monitors[std::this_thread::get_id()];
+        if (!monitor)
+        {
+            monitor = m_watchdog->Watch("HttpServer worker " + std::to_string(m_monitors.size()));
+        }
+        return monitor;
+    }
+
+    RequestArena *HttpServer::get_thread_arena()
+    {
+        if (m_arena_size == 0)
+            return nullptr;
+
+        // One arena per thread, whichever server or pool the thread belongs to, so that no lock is taken per
+        // request. A thread serving several servers uses the sizes of the first one.
+        thread_local std::unique_ptr<RequestArena> arena;
+        if (!arena)
+        {
+            arena = std::make_unique<RequestArena>(m_arena_size, m_arena_max_size);
+        }
+        return arena.get();
+    }
 } // namespace QNET
\ No newline at end of file
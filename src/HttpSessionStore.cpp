@@ -0,0 +1,637 @@
+#include "quicknet/components/HttpSessionStore.h"
+
+#include "quicknet/components/ByteStream.h"
+
+#include <algorithm>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <random>
+
+#ifndef _WIN32
+#include <cerrno>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace QNET
+{
+    namespace
+    {
+        const char kMagic[8] = {'Q', 'N', 'S', 'E', 'S', 'S', 'N', 'S'};
+        constexpr uint32_t kVersion = 1;
+
+        /// @brief Wheel slots of one second each. Sessions further out than that are refiled when their slot
+        /// comes round before they expire.
+        constexpr uint32_t kWheelSlots = 256;
+
+        /// @brief Writes strData to a new file at strPath that only the owner can read, since session values are
+        /// secrets, and flushes it to disk so that a rename over the previous snapshot never exposes an empty file.
+        bool WritePrivateFile(const std::string &strPath, const std::string &strData)
+        {
+#ifdef _WIN32
+            std::ofstream file(strPath, std::ios::binary | std::ios::trunc);
+            if (!file)
+                return false;
+
+            file.write(strData.data(), std::streamsize(strData.size()));
+            return bool(file);
+#else
+            const int nFd = open(strPath.c_str(), O_CREAT | O_TRUNC | O_WRONLY | O_CLOEXEC, S_IRUSR | S_IWUSR);
+            if (nFd < 0)
+                return false;
+
+            // O_CREAT only applies the mode to new files, so a leftover file from an older version is fixed up.
+            bool bOk = fchmod(nFd, S_IRUSR | S_IWUSR) == 0;
+            size_t cbWritten = 0;
+            while (bOk && cbWritten < strData.size())
+            {
+                const ssize_t cb = write(nFd, strData.data() + cbWritten, strData.size() - cbWritten);
+                if (cb < 0 && errno == EINTR)
+                    continue;
+                bOk = cb > 0;
+                if (bOk)
+                {
+                    cbWritten += size_t(cb);
+                }
+            }
+            bOk = bOk && fsync(nFd) == 0;
+            return close(nFd) == 0 && bOk;
+#endif
+        }
+
+        /// @brief Flushes the directory holding strPath, so that a rename into it survives a power loss.
+        void SyncParentDirectory(const std::string &strPath)
+        {
+#ifndef _WIN32
+            std::string strDirectory = std::filesystem::path(strPath).parent_path().string();
+            if (strDirectory.empty())
+            {
+                strDirectory = ".";
+            }
+            const int nFd = open(strDirectory.c_str(), O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+            if (nFd >= 0)
+            {
+                fsync(nFd);
+                close(nFd);
+            }
+#else
+            (void)strPath;
+#endif
+        }
+
+        /// @brief Session ids are 128 random bits in hex.
+        constexpr size_t kIdLength = 32;
+
+        /// @brief An arena is compacted once it has this much garbage and the garbage is more than half of it.
+        constexpr size_t kMinCompactBytes = 64 * 1024;
+
+        /// @brief Size of an entry in a snapshot without its value: id, remaining seconds and value size.
+        constexpr size_t kSnapshotEntrySize = 16 + 4 + 4;
+
+        int64_t UnixSeconds()
+        {
+            return std::chrono::duration_cast<std::chrono::seconds>(
+                       std::chrono::system_clock::now().time_since_epoch())
+                .count();
+        }
+
+        /// @brief Digit values of the lowercase hex characters, and 0xff for every other byte.
+        struct HexTable
+        {
+            uint8_t anValues[256];
+
+            HexTable()
+            {
+                std::memset(anValues, 0xff, sizeof(anValues));
+                for (int i = 0; i < 10; ++i)
+                {
+                    anValues['0' + i] = uint8_t(i);
+                }
+                for (int i = 0; i < 6; ++i)
+                {
+                    anValues['a' + i] = uint8_t(10 + i);
+                }
+            }
+        };
+
+        const HexTable s_hexTable;
+
+        /// @brief Parses 16 hex digits; bad digits set bits above the low nibble in nInvalid.
+        uint64_t ParseHalf(const char *psz, uint8_t &nInvalid)
+        {
+            uint64_t nValue = 0;
+            for (int i = 0; i < 16; ++i)
+            {
+                const uint8_t nDigit = s_hexTable.anValues[uint8_t(psz[i])];
+                nInvalid |= nDigit;
+                nValue = (nValue << 4) | (nDigit & 0xf);
+            }
+            return nValue;
+        }
+    } // namespace
+
+    HttpSessionStore::HttpSessionStore(const HttpSessionConfig &config)
+        : m_config(config), m_tStart(std::chrono::steady_clock::now())
+    {
+        m_vecShards.resize(std::max<uint32_t>(m_config.nShards, 1));
+        for (std::unique_ptr<Shard> &pShard : m_vecShards)
+        {
+            pShard = std::make_unique<Shard>();
+            pShard->vecWheel.resize(kWheelSlots);
+        }
+
+        if (m_config.strSnapshotPath.empty())
+            return;
+
+        std::error_code error;
+        if (std::filesystem::exists(m_config.strSnapshotPath, error))
+        {
+            const int64_t nLoaded = LoadSnapshot(m_config.strSnapshotPath);
+            if (nLoaded < 0)
+                std::cerr << "HttpSessionStore: ignoring unreadable snapshot " << m_config.strSnapshotPath << std::endl;
+            else
+                std::cout << "HttpSessionStore: restored " << nLoaded << " sessions" << std::endl;
+        }
+
+        if (m_config.nSnapshotIntervalSeconds > 0)
+        {
+            m_snapshotThread = std::thread(&HttpSessionStore::SnapshotLoop, this);
+        }
+    }
+
+    HttpSessionStore::~HttpSessionStore()
+    {
+        if (m_snapshotThread.joinable())
+        {
+            {
+                std::lock_guard<std::mutex> lock(m_snapshotMutex);
+                m_bStopping = true;
+            }
+            m_snapshotCondition.notify_all();
+            m_snapshotThread.join();
+        }
+
+        if (!m_config.strSnapshotPath.empty() && !SaveSnapshot(m_config.strSnapshotPath))
+        {
+            std::cerr << "HttpSessionStore: failed to write " << m_config.strSnapshotPath << std::endl;
+        }
+    }
+
+    std::string HttpSessionStore::Create(const std::string &strValue)
+    {
+        if (strValue.size() > m_config.cbMaxValue)
+            return std::string();
+
+        // The ids are what authenticates a client, so they come from the system's random source rather than a
+        // seeded generator whose output could be predicted.
+        thread_local std::random_device t_random;
+        const uint32_t nNow = GetNow();
+        for (;;)
+        {
+            Key key;
+            key.nHigh = (uint64_t(t_random()) << 32) | t_random();
+            key.nLow = (uint64_t(t_random()) << 32) | t_random();
+
+            Shard &shard = GetShard(key);
+            std::lock_guard<std::mutex> lock(shard.mutex);
+            Advance(shard, nNow);
+            if (shard.mapEntries.count(key) != 0)
+                continue;
+
+            if (!Insert(shard, key, strValue.data(), strValue.size(), nNow + m_config.nIdleTimeoutSeconds))
+                return std::string();
+            return FormatId(key);
+        }
+    }
+
+    bool HttpSessionStore::Get(const std::string &strId, std::string &strValue)
+    {
+        Key key;
+        if (!ParseId(strId, key))
+            return false;
+
+        const uint32_t nNow = GetNow();
+        Shard &shard = GetShard(key);
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        auto it = shard.mapEntries.find(key);
+        if (it == shard.mapEntries.end())
+            return false;
+
+        Entry &entry = it->second;
+        if (entry.nExpires <= nNow)
+        {
+            Erase(shard, it);
+            return false;
+        }
+
+        // The wheel slot is left as it is; the entry is refiled when the slot comes round.
+        entry.nExpires = nNow + m_config.nIdleTimeoutSeconds;
+        strValue.assign(shard.vecArena.data() + entry.nOffset, entry.cbSize);
+        return true;
+    }
+
+    bool HttpSessionStore::Update(const std::string &strId, const std::string &strValue)
+    {
+        Key key;
+        if (strValue.size() > m_config.cbMaxValue || !ParseId(strId, key))
+            return false;
+
+        const uint32_t nNow = GetNow();
+        Shard &shard = GetShard(key);
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        Advance(shard, nNow);
+        auto it = shard.mapEntries.find(key);
+        if (it == shard.mapEntries.end())
+            return false;
+
+        Entry &entry = it->second;
+        if (entry.nExpires <= nNow)
+        {
+            Erase(shard, it);
+            return false;
+        }
+
+        entry.nExpires = nNow + m_config.nIdleTimeoutSeconds;
+        if (strValue.size() <= entry.cbCapacity)
+        {
+            std::memcpy(shard.vecArena.data() + entry.nOffset, strValue.data(), strValue.size());
+            entry.cbSize = uint32_t(strValue.size());
+            return true;
+        }
+
+        // A value that outgrew its place moves to the end of the arena, and the old place becomes garbage.
+        const size_t nOffset = shard.vecArena.size();
+        if (nOffset + strValue.size() > UINT32_MAX)
+        {
+            std::cerr << "HttpSessionStore: shard arena is full" << std::endl;
+            return false;
+        }
+
+        shard.vecArena.insert(shard.vecArena.end(), strValue.begin(), strValue.end());
+        shard.cbGarbage += entry.cbCapacity;
+        entry.nOffset = uint32_t(nOffset);
+        entry.cbSize = uint32_t(strValue.size());
+        entry.cbCapacity = entry.cbSize;
+        return true;
+    }
+
+    bool HttpSessionStore::Remove(const std::string &strId)
+    {
+        Key key;
+        if (!ParseId(strId, key))
+            return false;
+
+        Shard &shard = GetShard(key);
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        auto it = shard.mapEntries.find(key);
+        if (it == shard.mapEntries.end())
+            return false;
+
+        const bool bLive = it->second.nExpires > GetNow();
+        Erase(shard, it);
+        return bLive;
+    }
+
+    size_t HttpSessionStore::GetCount() const
+    {
+        size_t nCount = 0;
+        for (const std::unique_ptr<Shard> &pShard : m_vecShards)
+        {
+            std::lock_guard<std::mutex> lock(pShard->mutex);
+            nCount += pShard->mapEntries.size();
+        }
+        return nCount;
+    }
+
+    /// @brief Reads the Cookie headers, of which HTTP/2 requests may have several, for the session cookie.
+    std::string HttpSessionStore::GetSessionId(const Request &req) const
+    {
+        const std::string &strName = m_config.strCookieName;
+        const auto range = req.headers.equal_range("Cookie");
+        for (auto itHeader = range.first; itHeader != range.second; ++itHeader)
+        {
+            const std::string &strHeader = itHeader->second;
+            size_t nPos = 0;
+            while (nPos < strHeader.size())
+            {
+                size_t nEnd = strHeader.find(';', nPos);
+                if (nEnd == std::string::npos)
+                {
+                    nEnd = strHeader.size();
+                }
+                while (nPos < nEnd && strHeader[nPos] == ' ')
+                {
+                    ++nPos;
+                }
+
+                if (nEnd - nPos > strName.size() && strHeader.compare(nPos, strName.size(), strName) == 0 &&
+                    strHeader[nPos + strName.size()] == '=')
+                {
+                    const size_t nValue = nPos + strName.size() + 1;
+                    size_t nValueEnd = nEnd;
+                    while (nValueEnd > nValue && strHeader[nValueEnd - 1] == ' ')
+                    {
+                        --nValueEnd;
+                    }
+                    return strHeader.substr(nValue, nValueEnd - nValue);
+                }
+                nPos = nEnd + 1;
+            }
+        }
+        return std::string();
+    }
+
+    bool HttpSessionStore::GetSession(const Request &req, std::string &strValue)
+    {
+        return Get(GetSessionId(req), strValue);
+    }
+
+    std::string HttpSessionStore::StartSession(Response &res, const std::string &strValue)
+    {
+        const std::string strId = Create(strValue);
+        if (strId.empty())
+            return strId;
+
+        // No Max-Age: the browser keeps the cookie until it closes, and the store decides when the session ends.
+        std::string strCookie = m_config.strCookieName + "=" + strId + "; Path=" + m_config.strCookiePath +
+                                "; HttpOnly; SameSite=Lax";
+        if (m_config.bSecureCookie)
+        {
+            strCookie += "; Secure";
+        }
+        res.set_header("Set-Cookie", strCookie);
+        return strId;
+    }
+
+    void HttpSessionStore::EndSession(const Request &req, Response &res)
+    {
+        const std::string strId = GetSessionId(req);
+        if (strId.empty())
+            return;
+
+        Remove(strId);
+        std::string strCookie =
+            m_config.strCookieName + "=; Path=" + m_config.strCookiePath + "; Max-Age=0; HttpOnly; SameSite=Lax";
+        if (m_config.bSecureCookie)
+        {
+            strCookie += "; Secure";
+        }
+        res.set_header("Set-Cookie", strCookie);
+    }
+
+    void HttpSessionStore::ExpireSessions()
+    {
+        const uint32_t nNow = GetNow();
+        for (std::unique_ptr<Shard> &pShard : m_vecShards)
+        {
+            std::lock_guard<std::mutex> lock(pShard->mutex);
+            Advance(*pShard, nNow);
+        }
+    }
+
+    /// @brief Copies each shard under its lock, then writes the file without holding any.
+    bool HttpSessionStore::SaveSnapshot(const std::string &strPath) const
+    {
+        const uint32_t nNow = GetNow();
+        std::string strBody;
+        uint64_t nSessions = 0;
+        for (const std::unique_ptr<Shard> &pShard : m_vecShards)
+        {
+            std::lock_guard<std::mutex> lock(pShard->mutex);
+            for (const auto &item : pShard->mapEntries)
+            {
+                const Entry &entry = item.second;
+                if (entry.nExpires <= nNow)
+                    continue;
+
+                AppendLittleEndian(strBody, item.first.nHigh, 8);
+                AppendLittleEndian(strBody, item.first.nLow, 8);
+                AppendLittleEndian(strBody, entry.nExpires - nNow, 4);
+                AppendLittleEndian(strBody, entry.cbSize, 4);
+                strBody.append(pShard->vecArena.data() + entry.nOffset, entry.cbSize);
+                ++nSessions;
+            }
+        }
+
+        std::string strOut;
+        strOut.reserve(sizeof(kMagic) + 4 + 8 + 8 + strBody.size());
+        strOut.append(kMagic, sizeof(kMagic));
+        AppendLittleEndian(strOut, kVersion, 4);
+        AppendLittleEndian(strOut, uint64_t(UnixSeconds()), 8);
+        AppendLittleEndian(strOut, nSessions, 8);
+        strOut += strBody;
+
+        const std::string strTempPath = strPath + ".tmp";
+        if (!WritePrivateFile(strTempPath, strOut))
+        {
+            std::error_code error;
+            std::filesystem::remove(strTempPath, error);
+            return false;
+        }
+
+        std::error_code error;
+        std::filesystem::rename(strTempPath, strPath, error);
+        if (error)
+            return false;
+
+        SyncParentDirectory(strPath);
+        return true;
+    }
+
+    int64_t HttpSessionStore::LoadSnapshot(const std::string &strPath)
+    {
+        std::ifstream file(strPath, std::ios::binary);
+        if (!file)
+            return -1;
+
+        const std::string strData((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+        if (strData.size() < sizeof(kMagic) || std::memcmp(strData.data(), kMagic, sizeof(kMagic)) != 0)
+            return -1;
+
+        ByteReader reader(strData);
+        uint64_t nVersion = 0;
+        uint64_t nWritten = 0;
+        uint64_t nSessions = 0;
+        if (!reader.Skip(sizeof(kMagic)) || !reader.Read(nVersion, 4) || nVersion != kVersion ||
+            !reader.Read(nWritten, 8) || !reader.Read(nSessions, 8) ||
+            reader.GetRemaining() / kSnapshotEntrySize < nSessions)
+            return -1;
+
+        // Validate the whole file before adding anything, so a truncated snapshot adds nothing.
+        struct Loaded
+        {
+            Key key;
+            uint32_t nRemaining;
+            const char *pValue;
+            uint32_t cbValue;
+        };
+        std::vector<Loaded> vecLoaded;
+        vecLoaded.reserve(size_t(nSessions));
+        for (uint64_t i = 0; i < nSessions; ++i)
+        {
+            Loaded loaded;
+            uint64_t nRemaining = 0;
+            uint64_t cbValue = 0;
+            if (!reader.Read(loaded.key.nHigh, 8) || !reader.Read(loaded.key.nLow, 8) || !reader.Read(nRemaining, 4) ||
+                !reader.Read(cbValue, 4) || cbValue > m_config.cbMaxValue)
+                return -1;
+
+            loaded.pValue = reader.Skip(size_t(cbValue));
+            if (!loaded.pValue)
+                return -1;
+
+            loaded.nRemaining = uint32_t(nRemaining);
+            loaded.cbValue = uint32_t(cbValue);
+            vecLoaded.push_back(loaded);
+        }
+        if (reader.GetRemaining() != 0)
+            return -1;
+
+        // The time the process was down counts against the sessions, as it would have if it had kept running.
+        const int64_t nDowntime = std::max<int64_t>(UnixSeconds() - int64_t(nWritten), 0);
+        const uint32_t nNow = GetNow();
+        int64_t nAdded = 0;
+        for (const Loaded &loaded : vecLoaded)
+        {
+            if (int64_t(loaded.nRemaining) <= nDowntime)
+                continue;
+
+            const uint32_t nRemaining = uint32_t(std::min<int64_t>(loaded.nRemaining - nDowntime,
+                                                                   m_config.nIdleTimeoutSeconds));
+            Shard &shard = GetShard(loaded.key);
+            std::lock_guard<std::mutex> lock(shard.mutex);
+            if (shard.mapEntries.count(loaded.key) == 0 &&
+                Insert(shard, loaded.key, loaded.pValue, loaded.cbValue, nNow + nRemaining))
+            {
+                ++nAdded;
+            }
+        }
+        return nAdded;
+    }
+
+    bool HttpSessionStore::ParseId(const std::string &strId, Key &key)
+    {
+        if (strId.size() != kIdLength)
+            return false;
+
+        // Lookups of every request go through here, so the digits are checked once at the end instead of
+        // branching on each.
+        uint8_t nInvalid = 0;
+        key.nHigh = ParseHalf(strId.data(), nInvalid);
+        key.nLow = ParseHalf(strId.data() + 16, nInvalid);
+        return (nInvalid & 0xf0) == 0;
+    }
+
+    std::string HttpSessionStore::FormatId(const Key &key)
+    {
+        static const char s_szHex[] = "0123456789abcdef";
+        std::string strId(kIdLength, '0');
+        for (size_t i = 0; i < 16; ++i)
+        {
+            strId[15 - i] = s_szHex[(key.nHigh >> (4 * i)) & 0xf];
+            strId[31 - i] = s_szHex[(key.nLow >> (4 * i)) & 0xf];
+        }
+        return strId;
+    }
+
+    uint32_t HttpSessionStore::GetNow() const
+    {
+        return uint32_t(
+            std::chrono::duration_cast<std::chrono::seconds>(std::chrono::steady_clock::now() - m_tStart).count());
+    }
+
+    bool HttpSessionStore::Insert(Shard &shard, const Key &key, const char *pValue, size_t cbValue,
+                                  uint32_t nExpires)
+    {
+        const size_t nOffset = shard.vecArena.size();
+        if (nOffset + cbValue > UINT32_MAX)
+        {
+            std::cerr << "HttpSessionStore: shard arena is full" << std::endl;
+            return false;
+        }
+
+        shard.vecArena.insert(shard.vecArena.end(), pValue, pValue + cbValue);
+        Entry &entry = shard.mapEntries[key];
+        entry.nOffset = uint32_t(nOffset);
+        entry.cbSize = uint32_t(cbValue);
+        entry.cbCapacity = uint32_t(cbValue);
+        entry.nExpires = nExpires;
+        Schedule(shard, key, entry);
+        return true;
+    }
+
+    void HttpSessionStore::Erase(Shard &shard, std::unordered_map<Key, Entry, KeyHash>::iterator it)
+    {
+        shard.cbGarbage += it->second.cbCapacity;
+        shard.mapEntries.erase(it);
+    }
+
+    void HttpSessionStore::Schedule(Shard &shard, const Key &key, Entry &entry)
+    {
+        entry.nSlot = entry.nExpires % kWheelSlots;
+        shard.vecWheel[entry.nSlot].push_back(key);
+    }
+
+    void HttpSessionStore::Advance(Shard &shard, uint32_t nNow)
+    {
+        if (nNow > shard.nWheelTime)
+        {
+            // After a long quiet spell every slot is visited once, which finds everything that expired.
+            const uint32_t nSteps = std::min(nNow - shard.nWheelTime, kWheelSlots);
+            for (uint32_t nStep = 1; nStep <= nSteps; ++nStep)
+            {
+                const uint32_t nSlot = (shard.nWheelTime + nStep) % kWheelSlots;
+                shard.vecExpiring.swap(shard.vecWheel[nSlot]);
+                for (const Key &key : shard.vecExpiring)
+                {
+                    auto it = shard.mapEntries.find(key);
+                    if (it == shard.mapEntries.end() || it->second.nSlot != nSlot)
+                        continue;
+
+                    if (it->second.nExpires <= nNow)
+                        Erase(shard, it);
+                    else
+                        Schedule(shard, key, it->second);
+                }
+                shard.vecExpiring.clear();
+            }
+            shard.nWheelTime = nNow;
+        }
+
+        if (shard.cbGarbage < kMinCompactBytes || shard.cbGarbage * 2 < shard.vecArena.size())
+            return;
+
+        std::vector<char> vecArena;
+        vecArena.reserve(shard.vecArena.size() - shard.cbGarbage);
+        for (auto &item : shard.mapEntries)
+        {
+            Entry &entry = item.second;
+            const char *pValue = shard.vecArena.data() + entry.nOffset;
+            entry.nOffset = uint32_t(vecArena.size());
+            entry.cbCapacity = entry.cbSize;
+            vecArena.insert(vecArena.end(), pValue, pValue + entry.cbSize);
+        }
+        shard.vecArena.swap(vecArena);
+        shard.cbGarbage = 0;
+    }
+
+    void HttpSessionStore::SnapshotLoop()
+    {
+        std::unique_lock<std::mutex> lock(m_snapshotMutex);
+        while (!m_snapshotCondition.wait_for(lock, std::chrono::seconds(m_config.nSnapshotIntervalSeconds),
+                                             [this]() { return m_bStopping; }))
+        {
+            lock.unlock();
+            ExpireSessions();
+            if (!SaveSnapshot(m_config.strSnapshotPath))
+            {
+                std::cerr << "HttpSessionStore: failed to write " << m_config.strSnapshotPath << std::endl;
+            }
+            lock.lock();
+        }
+    }
+} // namespace QNET
\ No newline at end of file
@@ -0,0 +1,545 @@
+#include "quicknet/components/Json.h"
+
+#include <cctype>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+namespace QNET
+{
+    JsonWriter &JsonWriter::BeginObject()
+    {
+        BeforeValue();
+        m_strOut += '{';
+        m_vecHasElements.push_back(false);
+        return *this;
+    }
+
+    JsonWriter &JsonWriter::EndObject()
+    {
+        if (!m_vecHasElements.empty())
+        {
+            m_vecHasElements.pop_back();
+        }
+        m_strOut += '}';
+        return *this;
+    }
+
+    JsonWriter &JsonWriter::BeginArray()
+    {
+        BeforeValue();
+        m_strOut += '[';
+        m_vecHasElements.push_back(false);
+        return *this;
+    }
+
+    JsonWriter &JsonWriter::EndArray()
+    {
+        if (!m_vecHasElements.empty())
+        {
+            m_vecHasElements.pop_back();
+        }
+        m_strOut += ']';
+        return *this;
+    }
+
+    JsonWriter &JsonWriter::Key(const std::string &strKey)
+    {
+        BeforeValue();
+        AppendQuoted(m_strOut, strKey);
+        m_strOut += ':';
+        m_bAfterKey = true;
+        return *this;
+    }
+
+    JsonWriter &JsonWriter::String(const std::string &strValue)
+    {
+        BeforeValue();
+        AppendQuoted(m_strOut, strValue);
+        return *this;
+    }
+
+    JsonWriter &JsonWriter::Int(int64_t nValue)
+    {
+        BeforeValue();
+        m_strOut += std::to_string(nValue);
+        return *this;
+    }
+
+    JsonWriter &JsonWriter::UInt(uint64_t nValue)
+    {
+        BeforeValue();
+        m_strOut += std::to_string(nValue);
+        return *this;
+    }
+
+    /// @brief Writes up to 15 significant digits, which round-trips every value a metric is likely to hold
+    /// without the noise digits of a full 17-digit representation.
+    JsonWriter &JsonWriter::Double(double flValue)
+    {
+        if (!std::isfinite(flValue))
+            return Null();
+
+        BeforeValue();
+        char szBuffer[32];
+        std::snprintf(szBuffer, sizeof(szBuffer), "%.15g", flValue);
+        m_strOut += szBuffer;
+        return *this;
+    }
+
+    JsonWriter &JsonWriter::Bool(bool bValue)
+    {
+        BeforeValue();
+        m_strOut += bValue ? "true" : "false";
+        return *this;
+    }
+
+    JsonWriter &JsonWriter::Null()
+    {
+        BeforeValue();
+        m_strOut += "null";
+        return *this;
+    }
+
+    JsonWriter &JsonWriter::Raw(const std::string &strJson)
+    {
+        BeforeValue();
+        m_strOut += strJson;
+        return *this;
+    }
+
+    void JsonWriter::Clear()
+    {
+        m_strOut.clear();
+        m_vecHasElements.clear();
+        m_bAfterKey = false;
+    }
+
+    void JsonWriter::AppendQuoted(std::string &strOut, const std::string &strValue)
+    {
+        static const char *const kHexDigits = "0123456789abcdef";
+
+        strOut += '"';
+        for (char ch : strValue)
+        {
+            switch (ch)
+            {
+            case '"':
+                strOut += "\\\"";
+                break;
+            case '\\':
+                strOut += "\\\\";
+                break;
+            case '\n':
+                strOut += "\\n";
+                break;
+            case '\r':
+                strOut += "\\r";
+                break;
+            case '\t':
+                strOut += "\\t";
+                break;
+            default:
+                if (static_cast<unsigned char>(ch) < 0x20)
+                {
+                    strOut += "\\u00";
+                    strOut += kHexDigits[(ch >> 4) & 0xF];
+                    strOut += kHexDigits[ch & 0xF];
+                }
+                else
+                {
+                    strOut += ch;
+                }
+                break;
+            }
+        }
+        strOut += '"';
+    }
+
+    void JsonWriter::BeforeValue()
+    {
+        if (m_bAfterKey)
+        {
+            m_bAfterKey = false;
+            return;
+        }
+
+        if (!m_vecHasElements.empty())
+        {
+            if (m_vecHasElements.back())
+            {
+                m_strOut += ',';
+            }
+            m_vecHasElements.back() = true;
+        }
+    }
+
+    /// @brief Recursive descent parser behind JsonValue::Parse().
+    class JsonParser
+    {
+    public:
+        explicit JsonParser(const std::string &strJson) : m_strJson(strJson) {}
+
+        bool ParseDocument(JsonValue &value)
+        {
+            SkipWhitespace();
+            if (!ParseValue(value, 0))
+                return false;
+
+            SkipWhitespace();
+            if (m_nPos != m_strJson.size())
+                return Fail("unexpected content after the document");
+            return true;
+        }
+
+        const std::string &GetError() const { return m_strError; }
+
+    private:
+        bool Fail(const char *pszWhat)
+        {
+            if (m_strError.empty())
+            {
+                m_strError = std::string(pszWhat) + " at offset " + std::to_string(m_nPos);
+            }
+            return false;
+        }
+
+        void SkipWhitespace()
+        {
+            while (m_nPos < m_strJson.size() &&
+                   (m_strJson[m_nPos] == ' ' || m_strJson[m_nPos] == '\t' || m_strJson[m_nPos] == '\n' ||
+                    m_strJson[m_nPos] == '\r'))
+            {
+                ++m_nPos;
+            }
+        }
+
+        bool ConsumeLiteral(const char *pszLiteral)
+        {
+            const size_t nLength = std::strlen(pszLiteral);
+            if (m_strJson.compare(m_nPos, nLength, pszLiteral) != 0)
+                return Fail("invalid literal");
+            m_nPos += nLength;
+            return true;
+        }
+
+        bool ParseValue(JsonValue &value, int nDepth)
+        {
+            if (m_nPos >= m_strJson.size())
+                return Fail("unexpected end of input");
+
+            switch (m_strJson[m_nPos])
+            {
+            case '{':
+                return ParseObject(value, nDepth + 1);
+            case '[':
+                return ParseArray(value, nDepth + 1);
+            case '"':
+                value.m_eType = JsonValue::Type::String;
+                return ParseString(value.m_strValue);
+            case 't':
+                value.m_eType = JsonValue::Type::Bool;
+                value.m_bValue = true;
+                return ConsumeLiteral("true");
+            case 'f':
+                value.m_eType = JsonValue::Type::Bool;
+                value.m_bValue = false;
+                return ConsumeLiteral("false");
+            case 'n':
+                value.m_eType = JsonValue::Type::Null;
+                return ConsumeLiteral("null");
+            default:
+                return ParseNumber(value);
+            }
+        }
+
+        bool ParseObject(JsonValue &value, int nDepth)
+        {
+            if (nDepth > JsonValue::kMaxDepth)
+                return Fail("document nested too deeply");
+
+            value.m_eType = JsonValue::Type::Object;
+            ++m_nPos; // '{'
+            SkipWhitespace();
+            if (m_nPos < m_strJson.size() && m_strJson[m_nPos] == '}')
+            {
+                ++m_nPos;
+                return true;
+            }
+
+            while (true)
+            {
+                SkipWhitespace();
+                if (m_nPos >= m_strJson.size() || m_strJson[m_nPos] != '"')
+                    return Fail("expected a member name");
+
+                value.m_vecMembers.emplace_back();
+                if (!ParseString(value.m_vecMembers.back().first))
+                    return false;
+
+                SkipWhitespace();
+                if (m_nPos >= m_strJson.size() || m_strJson[m_nPos] != ':')
+                    return Fail("expected ':'");
+                ++m_nPos;
+
+                SkipWhitespace();
+                if (!ParseValue(value.m_vecMembers.back().second, nDepth))
+                    return false;
+
+                SkipWhitespace();
+                if (m_nPos >= m_strJson.size())
+                    return Fail("unterminated object");
+                if (m_strJson[m_nPos] == '}')
+                {
+                    ++m_nPos;
+                    return true;
+                }
+                if (m_strJson[m_nPos] != ',')
+                    return Fail("expected ',' or '}'");
+                ++m_nPos;
+            }
+        }
+
+        bool ParseArray(JsonValue &value, int nDepth)
+        {
+            if (nDepth > JsonValue::kMaxDepth)
+                return Fail("document nested too deeply");
+
+            value.m_eType = JsonValue::Type::Array;
+            ++m_nPos; // '['
+            SkipWhitespace();
+            if (m_nPos < m_strJson.size() && m_strJson[m_nPos] == ']')
+            {
+                ++m_nPos;
+                return true;
+            }
+
+            while (true)
+            {
+                SkipWhitespace();
+                value.m_vecElements.emplace_back();
+                if (!ParseValue(value.m_vecElements.back(), nDepth))
+                    return false;
+
+                SkipWhitespace();
+                if (m_nPos >= m_strJson.size())
+                    return Fail("unterminated array");
+                if (m_strJson[m_nPos] == ']')
+                {
+                    ++m_nPos;
+                    return true;
+                }
+                if (m_strJson[m_nPos] != ',')
+                    return Fail("expected ',' or ']'");
+                ++m_nPos;
+            }
+        }
+
+        bool ParseHex4(uint32_t &nCode)
+        {
+            if (m_nPos + 4 > m_strJson.size())
+                return Fail("truncated \\u escape");
+
+            nCode = 0;
+            for (int i = 0; i < 4; ++i)
+            {
+                const char ch = m_strJson[m_nPos++];
+                nCode <<= 4;
+                if (ch >= '0' && ch <= '9')
+                    nCode |= ch - '0';
+                else if (ch >= 'a' && ch <= 'f')
+                    nCode |= ch - 'a' + 10;
+                else if (ch >= 'A' && ch <= 'F')
+                    nCode |= ch - 'A' + 10;
+                else
+                    return Fail("invalid \\u escape");
+            }
+            return true;
+        }
+
+        static void AppendUtf8(std::string &strOut, uint32_t nCode)
+        {
+            if (nCode < 0x80)
+            {
+                strOut += static_cast<char>(nCode);
+            }
+            else if (nCode < 0x800)
+            {
+                strOut += static_cast<char>(0xC0 | (nCode >> 6));
+                strOut += static_cast<char>(0x80 | (nCode & 0x3F));
+            }
+            else if (nCode < 0x10000)
+            {
+                strOut += static_cast<char>(0xE0 | (nCode >> 12));
+                strOut += static_cast<char>(0x80 | ((nCode >> 6) & 0x3F));
+                strOut += static_cast<char>(0x80 | (nCode & 0x3F));
+            }
+            else
+            {
+                strOut += static_cast<char>(0xF0 | (nCode >> 18));
+                strOut += static_cast<char>(0x80 | ((nCode >> 12) & 0x3F));
+                strOut += static_cast<char>(0x80 | ((nCode >> 6) & 0x3F));
+                strOut += static_cast<char>(0x80 | (nCode & 0x3F));
+            }
+        }
+
+        bool ParseString(std::string &strOut)
+        {
+            ++m_nPos; // '"'
+            while (true)
+            {
+                // Copy the run up to the next quote, escape or control character in one go.
+                const size_t nStart = m_nPos;
+                while (m_nPos < m_strJson.size() && m_strJson[m_nPos] != '"' && m_strJson[m_nPos] != '\\' &&
+                       static_cast<unsigned char>(m_strJson[m_nPos]) >= 0x20)
+                {
+                    ++m_nPos;
+                }
+                strOut.append(m_strJson, nStart, m_nPos - nStart);
+
+                if (m_nPos >= m_strJson.size())
+                    return Fail("unterminated string");
+
+                const char ch = m_strJson[m_nPos++];
+                if (ch == '"')
+                    return true;
+                if (ch != '\\')
+                    return Fail("control character in string");
+                if (m_nPos >= m_strJson.size())
+                    return Fail("unterminated string");
+
+                switch (m_strJson[m_nPos++])
+                {
+                case '"':
+                    strOut += '"';
+                    break;
+                case '\\':
+                    strOut += '\\';
+                    break;
+                case '/':
+                    strOut += '/';
+                    break;
+                case 'b':
+                    strOut += '\b';
+                    break;
+                case 'f':
+                    strOut += '\f';
+                    break;
+                case 'n':
+                    strOut += '\n';
+                    break;
+                case 'r':
+                    strOut += '\r';
+                    break;
+                case 't':
+                    strOut += '\t';
+                    break;
+                case 'u':
+                {
+                    uint32_t nCode = 0;
+                    if (!ParseHex4(nCode))
+                        return false;
+
+                    if (nCode >= 0xD800 && nCode <= 0xDBFF)
+                    {
+                        uint32_t nLow = 0;
+                        if (m_strJson.compare(m_nPos, 2, "\\u") != 0)
+                            return Fail("unpaired surrogate");
+                        m_nPos += 2;
+                        if (!ParseHex4(nLow))
+                            return false;
+                        if (nLow < 0xDC00 || nLow > 0xDFFF)
+                            return Fail("unpaired surrogate");
+                        nCode = 0x10000 + ((nCode - 0xD800) << 10) + (nLow - 0xDC00);
+                    }
+                    else if (nCode >= 0xDC00 && nCode <= 0xDFFF)
+                    {
+                        return Fail("unpaired surrogate");
+                    }
+                    AppendUtf8(strOut, nCode);
+                    break;
+                }
+                default:
+                    return Fail("invalid escape");
+                }
+            }
+        }
+
+        bool ParseNumber(JsonValue &value)
+        {
+            // Validate the JSON grammar first; strtod alone would also accept hex, "inf" and leading '+'.
+            const size_t nStart = m_nPos;
+            if (m_nPos < m_strJson.size() && m_strJson[m_nPos] == '-')
+                ++m_nPos;
+
+            if (m_nPos >= m_strJson.size() || !std::isdigit(static_cast<unsigned char>(m_strJson[m_nPos])))
+                return Fail("invalid value");
+            if (m_strJson[m_nPos] == '0')
+                ++m_nPos;
+            else
+                SkipDigits();
+
+            if (m_nPos < m_strJson.size() && m_strJson[m_nPos] == '.')
+            {
+                ++m_nPos;
+                if (m_nPos >= m_strJson.size() || !std::isdigit(static_cast<unsigned char>(m_strJson[m_nPos])))
+                    return Fail("invalid number");
+                SkipDigits();
+            }
+
+            if (m_nPos < m_strJson.size() && (m_strJson[m_nPos] == 'e' || m_strJson[m_nPos] == 'E'))
+            {
+                ++m_nPos;
+                if (m_nPos < m_strJson.size() && (m_strJson[m_nPos] == '+' || m_strJson[m_nPos] == '-'))
+                    ++m_nPos;
+                if (m_nPos >= m_strJson.size() || !std::isdigit(static_cast<unsigned char>(m_strJson[m_nPos])))
+                    return Fail("invalid number");
+                SkipDigits();
+            }
+
+            value.m_eType = JsonValue::Type::Number;
+            value.m_flValue = std::strtod(m_strJson.substr(nStart, m_nPos - nStart).c_str(), nullptr);
+            return true;
+        }
+
+        void SkipDigits()
+        {
+            while (m_nPos < m_strJson.size() && std::isdigit(static_cast<unsigned char>(m_strJson[m_nPos])))
+            {
+                ++m_nPos;
+            }
+        }
+
+    private:
+        const std::string &m_strJson;
+        size_t m_nPos = 0;
+        std::string m_strError;
+    };
+
+    const JsonValue *JsonValue::Find(const std::string &strKey) const
+    {
+        for (const auto &member : m_vecMembers)
+        {
+            if (member.first == strKey)
+                return &member.second;
+        }
+        return nullptr;
+    }
+
+    bool JsonValue::Parse(const std::string &strJson, JsonValue &value, std::string *pstrError)
+    {
+        JsonParser parser(strJson);
+        JsonValue parsed;
+        if (!parser.ParseDocument(parsed))
+        {
+            if (pstrError)
+            {
+                *pstrError = parser.GetError();
+            }
+            return false;
+        }
+        value = std::move(parsed);
+        return true;
+    }
+} // namespace QNET
\ No newline at end of file
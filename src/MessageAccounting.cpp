@@ -0,0 +1,188 @@
+#include "quicknet/components/MessageAccounting.h"
+
+#include "quicknet/components/HttpServer.h"
+#include "quicknet/components/Json.h"
+
+namespace QNET
+{
+    namespace
+    {
+        /// @brief Source of MessageAccounting ids; 0 marks an empty cache entry.
+        std::atomic<uint64_t> s_nNextId{1};
+
+        /// @brief The shards the calling thread used last, so that a thread recording for a server and a client
+        /// does not go through the lock on every message.
+        constexpr size_t kCacheSize = 4;
+
+        struct ShardCacheEntry
+        {
+            uint64_t nOwnerId;
+            void *pShard;
+        };
+
+        thread_local ShardCacheEntry t_aShardCache[kCacheSize] = {};
+        thread_local size_t t_nNextCacheEntry = 0;
+
+        /// @brief Adds to a counter that only the calling thread writes; readers see a value without tearing.
+        void Add(std::atomic<uint64_t> &nCounter, uint64_t nValue)
+        {
+            nCounter.store(nCounter.load(std::memory_order_relaxed) + nValue, std::memory_order_relaxed);
+        }
+
+        size_t GetSizeBucket(uint32 cbSize)
+        {
+            size_t nBucket = 0;
+            while (nBucket < MessageAccounting::kSizeBucketCount - 1 && cbSize > (64u << nBucket))
+            {
+                ++nBucket;
+            }
+            return nBucket;
+        }
+
+        void WriteTraffic(JsonWriter &writer, const MessageTrafficStats &stats)
+        {
+            writer.BeginObject();
+            writer.Key("messages").UInt(stats.nMessages);
+            writer.Key("bytes").UInt(stats.cbBytes);
+            writer.Key("sizes").BeginArray();
+            for (uint64_t nCount : stats.anSizes)
+            {
+                writer.UInt(nCount);
+            }
+            writer.EndArray();
+            writer.EndObject();
+        }
+    } // namespace
+
+    MessageAccounting::MessageAccounting(MessageTypeExtractor extractor, uint32 nMaxTypes)
+        : m_extractor(std::move(extractor)), m_nMaxTypes(nMaxTypes), m_tStart(std::chrono::steady_clock::now()),
+          m_nId(s_nNextId.fetch_add(1))
+    {
+    }
+
+    MessageAccounting::~MessageAccounting() = default;
+
+    uint32 MessageAccounting::GetSizeBucketLimit(size_t nBucket)
+    {
+        return nBucket + 1 < kSizeBucketCount ? 64u << nBucket : UINT32_MAX;
+    }
+
+    void MessageAccounting::Record(const void *pData, uint32 cbSize, bool bReceived)
+    {
+        int32 nType = -1;
+        if (cbSize > 0)
+        {
+            const uint8 *pBytes = static_cast<const uint8 *>(pData);
+            nType = m_extractor ? m_extractor(pBytes, cbSize) : int32(pBytes[0]);
+        }
+        const size_t nSlot = nType >= 0 && uint32(nType) < m_nMaxTypes ? size_t(nType) : size_t(m_nMaxTypes);
+
+        Shard &shard = GetLocalShard();
+        Counters &counters = (bReceived ? shard.pReceived : shard.pSent)[nSlot];
+        Add(counters.nMessages, 1);
+        Add(counters.cbBytes, cbSize);
+        Add(counters.anSizes[GetSizeBucket(cbSize)], 1);
+    }
+
+    MessageAccounting::Shard &MessageAccounting::GetLocalShard()
+    {
+        for (const ShardCacheEntry &entry : t_aShardCache)
+        {
+            if (entry.nOwnerId == m_nId)
+                return *static_cast<Shard *>(entry.pShard);
+        }
+
+        // A thread id may be reused once its thread has exited; the new thread then continues the old counters,
+        // which still have a single writer.
+        std::lock_guard<std::mutex> lock(m_mutex);
+        std::unique_ptr<Shard> &pShard = m_mapShards[std::this_thread::get_id()];
+        if (!pShard)
+        {
+            pShard = std::make_unique<Shard>();
+            pShard->pSent = std::make_unique<Counters[]>(size_t(m_nMaxTypes) + 1);
+            pShard->pReceived = std::make_unique<Counters[]>(size_t(m_nMaxTypes) + 1);
+        }
+
+        ShardCacheEntry &entry = t_aShardCache[t_nNextCacheEntry];
+        t_nNextCacheEntry = (t_nNextCacheEntry + 1) % kCacheSize;
+        entry.nOwnerId = m_nId;
+        entry.pShard = pShard.get();
+        return *pShard;
+    }
+
+    std::vector<MessageTypeStats> MessageAccounting::GetStats() const
+    {
+        auto Sum = [](const Counters &counters, MessageTrafficStats &stats)
+        {
+            stats.nMessages += counters.nMessages.load(std::memory_order_relaxed);
+            stats.cbBytes += counters.cbBytes.load(std::memory_order_relaxed);
+            for (size_t i = 0; i < kSizeBucketCount; ++i)
+            {
+                stats.anSizes[i] += counters.anSizes[i].load(std::memory_order_relaxed);
+            }
+        };
+
+        // Slot m_nMaxTypes holds type -1, which is reported first.
+        std::vector<MessageTypeStats> vecSlots(size_t(m_nMaxTypes) + 1);
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            for (const auto &entry : m_mapShards)
+            {
+                for (size_t nSlot = 0; nSlot < vecSlots.size(); ++nSlot)
+                {
+                    Sum(entry.second->pSent[nSlot], vecSlots[nSlot].sent);
+                    Sum(entry.second->pReceived[nSlot], vecSlots[nSlot].received);
+                }
+            }
+        }
+
+        std::vector<MessageTypeStats> vecStats;
+        for (size_t i = 0; i < vecSlots.size(); ++i)
+        {
+            const size_t nSlot = (i + m_nMaxTypes) % vecSlots.size();
+            MessageTypeStats &stats = vecSlots[nSlot];
+            if (stats.sent.nMessages == 0 && stats.received.nMessages == 0)
+                continue;
+
+            stats.nType = nSlot == m_nMaxTypes ? -1 : int32(nSlot);
+            vecStats.push_back(stats);
+        }
+        return vecStats;
+    }
+
+    void MessageAccounting::ServeMetrics(HttpServer &http, const std::string &strPath) const
+    {
+        http.Get(strPath,
+                 [this](const Request &, Response &res)
+                 {
+                     const auto msElapsed = std::chrono::duration_cast<std::chrono::milliseconds>(GetElapsed());
+
+                     JsonWriter writer;
+                     writer.BeginObject();
+                     writer.Key("elapsedMs").Int(msElapsed.count());
+                     writer.Key("sizeBuckets").BeginArray();
+                     for (size_t i = 0; i < kSizeBucketCount; ++i)
+                     {
+                         if (GetSizeBucketLimit(i) == UINT32_MAX)
+                             writer.Null();
+                         else
+                             writer.UInt(GetSizeBucketLimit(i));
+                     }
+                     writer.EndArray();
+                     writer.Key("types").BeginArray();
+                     for (const MessageTypeStats &stats : GetStats())
+                     {
+                         writer.BeginObject();
+                         writer.Key("type").Int(stats.nType);
+                         writer.Key("sent");
+                         WriteTraffic(writer, stats.sent);
+                         writer.Key("received");
+                         WriteTraffic(writer, stats.received);
+                         writer.EndObject();
+                     }
+                     writer.EndArray();
+                     writer.EndObject();
+                     res.set_content(writer.GetString(), "application/json");
+                 });
+    }
+} // namespace QNET
\ No newline at end of file
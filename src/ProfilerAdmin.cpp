@@ -0,0 +1,165 @@
+#include "quicknet/components/ProfilerAdmin.h"
+
+#include <algorithm>
+
+namespace QNET
+{
+    namespace
+    {
+        const char *const kNoHeapProfiler =
+            "the heap profiler is not built in; configure with QNET_ENABLE_HEAP_PROFILER=ON";
+    } // namespace
+
+    ProfilerAdmin::ProfilerAdmin(HttpServer &http, const ProfilerAdminConfig &config) : m_config(config)
+    {
+        http.Get(
+            m_config.strPrefix + "/cpu", [this](const Request &req, Response &res) { HandleCpu(req, res); },
+            m_config.strBulkhead);
+        http.Post(
+            m_config.strPrefix + "/heap/start",
+            [this](const Request &req, Response &res) { HandleHeapStart(req, res); }, m_config.strBulkhead);
+        http.Post(
+            m_config.strPrefix + "/heap/stop", [this](const Request &req, Response &res) { HandleHeapStop(req, res); },
+            m_config.strBulkhead);
+        http.Get(
+            m_config.strPrefix + "/heap", [this](const Request &req, Response &res) { HandleHeap(req, res); },
+            m_config.strBulkhead);
+    }
+
+    void ProfilerAdmin::HandleCpu(const Request &req, Response &res)
+    {
+        if (!HttpServer::CheckBearerToken(req, res, m_config.strBearerToken))
+            return;
+
+        if (!CpuProfiler::IsSupported())
+            return HttpServer::RespondError(res, 501, "CPU profiling is not supported on this platform");
+
+        uint64_t nSeconds = 10;
+        uint64_t nFrequencyHz = 99;
+        if (!HttpServer::ReadUIntParam(req, "seconds", nSeconds) ||
+            !HttpServer::ReadUIntParam(req, "hz", nFrequencyHz))
+            return HttpServer::RespondError(res, 400, "seconds and hz must be unsigned integers");
+        if (nSeconds == 0 || nSeconds > m_config.nMaxSeconds)
+            return HttpServer::RespondError(res, 400,
+                                            "seconds must be between 1 and " + std::to_string(m_config.nMaxSeconds));
+        if (nFrequencyHz == 0 || nFrequencyHz > 1000)
+            return HttpServer::RespondError(res, 400, "hz must be between 1 and 1000");
+
+        CpuProfilerConfig config;
+        config.nFrequencyHz = static_cast<uint32_t>(nFrequencyHz);
+
+        // Room for every sample of a fully busy process on all cores would be wasteful; the buffer holds eight
+        // busy cores' worth, and the drop count says when that was not enough.
+        config.nMaxSamples = static_cast<uint32_t>(std::min<uint64_t>(nSeconds * nFrequencyHz * 8, 1000000));
+
+        CpuProfile profile;
+        std::string strError;
+        if (!CpuProfiler::Profile(static_cast<uint32_t>(nSeconds * 1000), profile, config, &strError))
+            return HttpServer::RespondError(res, CpuProfiler::IsRunning() ? 409 : 500, strError);
+
+        res.set_header("X-Profile-Samples", std::to_string(profile.nSamples));
+        res.set_header("X-Profile-Dropped", std::to_string(profile.nDropped));
+        res.set_content(profile.strFolded, "text/plain");
+    }
+
+    void ProfilerAdmin::HandleHeapStart(const Request &req, Response &res)
+    {
+        if (!HttpServer::CheckBearerToken(req, res, m_config.strBearerToken))
+            return;
+
+        if (!HeapProfiler::IsSupported())
+            return HttpServer::RespondError(res, 501, kNoHeapProfiler);
+
+        HeapProfilerConfig config;
+        if (!HttpServer::ReadUIntParam(req, "interval", config.cbSampleInterval) || config.cbSampleInterval == 0)
+            return HttpServer::RespondError(res, 400, "interval must be a positive integer");
+
+        std::string strError;
+        if (!HeapProfiler::Start(config, &strError))
+            return HttpServer::RespondError(res, HeapProfiler::IsRunning() ? 409 : 500, strError);
+
+        JsonWriter writer;
+        writer.BeginObject().Key("running").Bool(true).EndObject();
+        res.set_content(writer.GetString(), "application/json");
+    }
+
+    void ProfilerAdmin::HandleHeapStop(const Request &req, Response &res)
+    {
+        if (!HttpServer::CheckBearerToken(req, res, m_config.strBearerToken))
+            return;
+
+        if (!HeapProfiler::IsSupported())
+            return HttpServer::RespondError(res, 501, kNoHeapProfiler);
+        if (!HeapProfiler::Stop())
+            return HttpServer::RespondError(res, 409, "the heap profiler is not running");
+
+        JsonWriter writer;
+        writer.BeginObject().Key("running").Bool(false).EndObject();
+        res.set_content(writer.GetString(), "application/json");
+    }
+
+    void ProfilerAdmin::HandleHeap(const Request &req, Response &res)
+    {
+        if (!HttpServer::CheckBearerToken(req, res, m_config.strBearerToken))
+            return;
+
+        if (!HeapProfiler::IsSupported())
+            return HttpServer::RespondError(res, 501, kNoHeapProfiler);
+
+        uint64_t nLimit = 20;
+        if (!HttpServer::ReadUIntParam(req, "limit", nLimit) || nLimit == 0 || nLimit > 10000)
+            return HttpServer::RespondError(res, 400, "limit must be between 1 and 10000");
+
+        HeapProfile profile;
+        if (!HeapProfiler::GetProfile(profile, static_cast<size_t>(nLimit)))
+            return HttpServer::RespondError(res, 409, "the heap profiler was never started");
+
+        if (req.get_param_value("format") == "folded")
+        {
+            // Outermost frame first, weighted by live bytes, as flamegraph.pl expects.
+            std::string strFolded;
+            for (const HeapSite &site : profile.vecSites)
+            {
+                if (site.GetLiveBytes() == 0)
+                    continue;
+                for (size_t i = site.vecStack.size(); i-- > 0;)
+                {
+                    strFolded += site.vecStack[i];
+                    strFolded += i == 0 ? ' ' : ';';
+                }
+                strFolded += std::to_string(site.GetLiveBytes()) + '\n';
+            }
+            res.set_content(strFolded, "text/plain");
+            return;
+        }
+
+        JsonWriter writer;
+        writer.BeginObject();
+        writer.Key("running").Bool(profile.bRunning);
+        writer.Key("durationMs").UInt(profile.usecDuration / 1000);
+        writer.Key("sampleInterval").UInt(profile.cbSampleInterval);
+        writer.Key("samples").UInt(profile.nSamples);
+        writer.Key("dropped").UInt(profile.nDropped);
+        writer.Key("allocatedBytes").UInt(profile.cbAllocated);
+        writer.Key("liveBytes").UInt(profile.cbAllocated - profile.cbFreed);
+        writer.Key("sites").BeginArray();
+        for (const HeapSite &site : profile.vecSites)
+        {
+            writer.BeginObject();
+            writer.Key("liveBytes").UInt(site.GetLiveBytes());
+            writer.Key("liveSamples").UInt(site.GetLiveSamples());
+            writer.Key("allocatedBytes").UInt(site.cbAllocated);
+            writer.Key("allocatedSamples").UInt(site.nAllocSamples);
+            writer.Key("stack").BeginArray();
+            for (const std::string &strFrame : site.vecStack)
+            {
+                writer.String(strFrame);
+            }
+            writer.EndArray();
+            writer.EndObject();
+        }
+        writer.EndArray();
+        writer.EndObject();
+        res.set_content(writer.GetString(), "application/json");
+    }
+} // namespace QNET
\ No newline at end of file
@@ -0,0 +1,305 @@
+#include "quicknet/components/PublishBridge.h"
+
+#include "quicknet/components/ByteStream.h"
+#include "quicknet/components/Json.h"
+
+#include <cstdlib>
+#include <cstring>
+#include <new>
+
+namespace QNET
+{
+    PublishBridge::PublishBridge(Server &server, HttpServer &http, const PublishBridgeConfig &config)
+        : m_server(server), m_config(config)
+    {
+        const std::string &strPrefix = m_config.strPrefix;
+        http.Post(strPrefix + "/all",
+                  [this](const Request &req, Response &res) { HandleSingle(req, res, Target::All); });
+        http.Post(strPrefix + "/group/:group",
+                  [this](const Request &req, Response &res) { HandleSingle(req, res, Target::Group); });
+        http.Post(strPrefix + "/connection/:id",
+                  [this](const Request &req, Response &res) { HandleSingle(req, res, Target::Connection); });
+        http.Post(strPrefix + "/batch", [this](const Request &req, Response &res) { HandleBatch(req, res); });
+
+        m_nTickHandlerId = m_server.AddTickHandler([this]() { Drain(); });
+    }
+
+    PublishBridge::~PublishBridge()
+    {
+        m_server.RemoveTickHandler(m_nTickHandlerId);
+
+        std::unique_ptr<Publish> pPublish;
+        while (m_queue.Pop(pPublish))
+        {
+            ReleasePayload(pPublish->pPayload);
+        }
+    }
+
+    PublishBridgeStats PublishBridge::GetStats() const
+    {
+        PublishBridgeStats stats;
+        stats.nRequests = m_nRequests.load(std::memory_order_relaxed);
+        stats.nRejected = m_nRejected.load(std::memory_order_relaxed);
+        stats.nMessagesQueued = m_nMessagesQueued.load(std::memory_order_relaxed);
+        stats.nMessagesSent = m_nMessagesSent.load(std::memory_order_relaxed);
+        stats.nMessagesFailed = m_nMessagesFailed.load(std::memory_order_relaxed);
+        return stats;
+    }
+
+    void PublishBridge::HandleSingle(const Request &req, Response &res, Target eTarget)
+    {
+        m_nRequests.fetch_add(1, std::memory_order_relaxed);
+        if (!Authorize(req, res))
+            return;
+
+        if (req.body.empty())
+            return Reject(res, 400, "empty payload");
+
+        if (req.body.size() > UINT32_MAX)
+            return Reject(res, 413, "payload too large");
+
+        Record record;
+        record.eTarget = eTarget;
+        record.bReliable = req.get_param_value("reliable") != "0";
+        record.cbSize = uint32(req.body.size());
+        if (eTarget == Target::Group)
+        {
+            record.strGroup = req.matches[1];
+        }
+        else if (eTarget == Target::Connection)
+        {
+            const std::string strId = req.matches[1];
+            char *pszEnd = nullptr;
+            const unsigned long nId = std::strtoul(strId.c_str(), &pszEnd, 10);
+            if (strId.empty() || *pszEnd != '\0' || nId == 0 || nId > UINT32_MAX)
+                return Reject(res, 400, "invalid connection id");
+
+            record.hConn = HSteamNetConnection(nId);
+        }
+
+        std::vector<Record> vecRecords;
+        vecRecords.push_back(std::move(record));
+        Enqueue(req.body, std::move(vecRecords), res);
+    }
+
+    void PublishBridge::HandleBatch(const Request &req, Response &res)
+    {
+        m_nRequests.fetch_add(1, std::memory_order_relaxed);
+        if (!Authorize(req, res))
+            return;
+
+        if (req.body.size() > UINT32_MAX)
+            return Reject(res, 413, "batch too large");
+
+        // Records only point into the body; the payloads themselves are never copied out of it.
+        std::vector<Record> vecRecords;
+        ByteReader reader(req.body);
+        while (!reader.AtEnd())
+        {
+            if (vecRecords.size() >= m_config.nMaxBatchMessages)
+                return Reject(res, 413, "too many messages in batch");
+
+            Record record;
+            uint32 nTarget = 0;
+            uint32 nFlags = 0;
+            if (!reader.Read(nTarget, 1) || !reader.Read(nFlags, 1) || nTarget > uint32(Target::Connection))
+                return Reject(res, 400, "malformed record header");
+
+            record.eTarget = Target(nTarget);
+            record.bReliable = (nFlags & 1) != 0;
+            if (record.eTarget == Target::Group)
+            {
+                uint32 cbName = 0;
+                if (!reader.Read(cbName, 2) || !reader.Skip(cbName))
+                    return Reject(res, 400, "malformed group name");
+
+                record.strGroup = req.body.substr(reader.GetPos() - cbName, cbName);
+            }
+            else if (record.eTarget == Target::Connection)
+            {
+                if (!reader.Read(record.hConn, 4))
+                    return Reject(res, 400, "malformed connection handle");
+            }
+
+            if (!reader.Read(record.cbSize, 4) || record.cbSize == 0 || !reader.Skip(record.cbSize))
+                return Reject(res, 400, "malformed payload");
+
+            record.nOffset = uint32(reader.GetPos() - record.cbSize);
+            vecRecords.push_back(std::move(record));
+        }
+
+        if (vecRecords.empty())
+            return Reject(res, 400, "empty batch");
+
+        Enqueue(req.body, std::move(vecRecords), res);
+    }
+
+    bool PublishBridge::Authorize(const Request &req, Response &res)
+    {
+        if (HttpServer::CheckBearerToken(req, res, m_config.strBearerToken))
+            return true;
+
+        m_nRejected.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+
+    void PublishBridge::Enqueue(const std::string &strBody, std::vector<Record> vecRecords, Response &res)
+    {
+        // The limit is checked before the copy, so a burst of requests can overshoot it by the requests in flight.
+        if (m_cbQueued.load(std::memory_order_relaxed) + strBody.size() > m_config.cbMaxQueued)
+            return Reject(res, 503, "publish queue full");
+
+        auto pPublish = std::make_unique<Publish>();
+        pPublish->pPayload = CreatePayload(strBody);
+        pPublish->cbSize = strBody.size();
+        pPublish->vecRecords = std::move(vecRecords);
+        const size_t nMessages = pPublish->vecRecords.size();
+
+        m_cbQueued.fetch_add(strBody.size(), std::memory_order_relaxed);
+        m_nMessagesQueued.fetch_add(nMessages, std::memory_order_relaxed);
+        m_queue.Push(std::move(pPublish));
+
+        JsonWriter writer;
+        writer.BeginObject().Key("queued").UInt(nMessages).EndObject();
+        res.status = 202;
+        res.set_content(writer.GetString(), "application/json");
+    }
+
+    void PublishBridge::Reject(Response &res, int nStatus, const std::string &strMessage)
+    {
+        m_nRejected.fetch_add(1, std::memory_order_relaxed);
+        HttpServer::RespondError(res, nStatus, strMessage);
+    }
+
+    void PublishBridge::Drain()
+    {
+        std::unique_ptr<Publish> pPublish;
+        while (m_queue.Pop(pPublish))
+        {
+            for (const Record &record : pPublish->vecRecords)
+            {
+                switch (record.eTarget)
+                {
+                case Target::All:
+                    // Copied, since a failed send can disconnect a client and change the list.
+                    for (HSteamNetConnection hConn : std::vector<HSteamNetConnection>(m_server.GetClients()))
+                    {
+                        SendToConnection(pPublish->pPayload, record, hConn);
+                    }
+                    break;
+
+                case Target::Group:
+                    for (HSteamNetConnection hConn :
+                         std::vector<HSteamNetConnection>(m_server.GetGroupMembers(record.strGroup)))
+                    {
+                        SendToConnection(pPublish->pPayload, record, hConn);
+                    }
+                    break;
+
+                case Target::Connection:
+                    // Only clients may be addressed, never connections that are still authenticating.
+                    if (m_server.IsClient(record.hConn))
+                    {
+                        SendToConnection(pPublish->pPayload, record, record.hConn);
+                    }
+                    else
+                    {
+                        m_nMessagesFailed.fetch_add(1, std::memory_order_relaxed);
+                    }
+                    break;
+                }
+            }
+
+            m_cbQueued.fetch_sub(pPublish->cbSize, std::memory_order_relaxed);
+            ReleasePayload(pPublish->pPayload);
+        }
+    }
+
+    void PublishBridge::SendToConnection(Payload *pPayload, const Record &record, HSteamNetConnection hConn)
+    {
+        ISteamNetworkingMessage *pMsg = m_server.AllocateMessage(0);
+        if (!pMsg)
+        {
+            m_nMessagesFailed.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+
+        // The message borrows the payload buffer and holds a reference until GNS frees it.
+        pPayload->nRefs.fetch_add(1, std::memory_order_relaxed);
+        pMsg->m_pData = pPayload->pData + record.nOffset;
+        pMsg->m_cbSize = int(record.cbSize);
+        pMsg->m_nUserData = int64(reinterpret_cast<intptr_t>(pPayload));
+        pMsg->m_pfnFreeData = &PublishBridge::FreeMessageData;
+
+        const int nSendFlags =
+            record.bReliable ? k_nSteamNetworkingSend_Reliable : k_nSteamNetworkingSend_UnreliableNoDelay;
+        if (m_server.SendAllocatedMessage(hConn, pMsg, record.cbSize, nSendFlags) != 0)
+            m_nMessagesSent.fetch_add(1, std::memory_order_relaxed);
+        else
+            m_nMessagesFailed.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    PublishBridge::Payload *PublishBridge::CreatePayload(const std::string &strBody)
+    {
+        void *pBlock = std::malloc(sizeof(Payload) + strBody.size());
+        if (!pBlock)
+            throw std::bad_alloc();
+
+        Payload *pPayload = new (pBlock) Payload();
+        pPayload->nRefs.store(1, std::memory_order_relaxed);
+        pPayload->pData = reinterpret_cast<uint8 *>(pPayload + 1);
+        std::memcpy(pPayload->pData, strBody.data(), strBody.size());
+        return pPayload;
+    }
+
+    void PublishBridge::ReleasePayload(Payload *pPayload)
+    {
+        // GNS may free messages from its own thread, so the last reference can be dropped on any thread.
+        if (pPayload->nRefs.fetch_sub(1, std::memory_order_acq_rel) == 1)
+        {
+            pPayload->~Payload();
+            std::free(pPayload);
+        }
+    }
+
+    void PublishBridge::FreeMessageData(SteamNetworkingMessage_t *pMsg)
+    {
+        ReleasePayload(reinterpret_cast<Payload *>(static_cast<intptr_t>(pMsg->m_nUserData)));
+    }
+
+    void PublishBridge::AppendToAll(std::vector<uint8_t> &byteBatch, const std::vector<uint8_t> &bytePayload,
+                                    bool bReliable)
+    {
+        AppendHeader(byteBatch, Target::All, bReliable);
+        AppendPayload(byteBatch, bytePayload);
+    }
+
+    void PublishBridge::AppendToGroup(std::vector<uint8_t> &byteBatch, const std::string &strGroup,
+                                      const std::vector<uint8_t> &bytePayload, bool bReliable)
+    {
+        AppendHeader(byteBatch, Target::Group, bReliable);
+        AppendLittleEndian(byteBatch, uint32(strGroup.size()), 2);
+        byteBatch.insert(byteBatch.end(), strGroup.begin(), strGroup.end());
+        AppendPayload(byteBatch, bytePayload);
+    }
+
+    void PublishBridge::AppendToConnection(std::vector<uint8_t> &byteBatch, HSteamNetConnection hConn,
+                                           const std::vector<uint8_t> &bytePayload, bool bReliable)
+    {
+        AppendHeader(byteBatch, Target::Connection, bReliable);
+        AppendLittleEndian(byteBatch, hConn, 4);
+        AppendPayload(byteBatch, bytePayload);
+    }
+
+    void PublishBridge::AppendHeader(std::vector<uint8_t> &byteBatch, Target eTarget, bool bReliable)
+    {
+        byteBatch.push_back(uint8_t(eTarget));
+        byteBatch.push_back(bReliable ? 1 : 0);
+    }
+
+    void PublishBridge::AppendPayload(std::vector<uint8_t> &byteBatch, const std::vector<uint8_t> &bytePayload)
+    {
+        AppendLittleEndian(byteBatch, uint32(bytePayload.size()), 4);
+        byteBatch.insert(byteBatch.end(), bytePayload.begin(), bytePayload.end());
+    }
+} // namespace QNET
\ No newline at end of file
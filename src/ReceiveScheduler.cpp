@@ -0,0 +1,129 @@
+#include "quicknet/components/ReceiveScheduler.h"
+
+#include <algorithm>
+#include <limits>
+
+namespace QNET
+{
+    void ReceiveScheduler::SetWeight(HSteamNetConnection hConn, uint32 nWeight)
+    {
+        if (nWeight <= 1)
+            m_mapWeights.erase(hConn);
+        else
+            m_mapWeights[hConn] = nWeight;
+    }
+
+    void ReceiveScheduler::SetLimit(HSteamNetConnection hConn, uint32 nMaxMessages)
+    {
+        if (nMaxMessages == 0)
+            m_mapLimits.erase(hConn);
+        else
+            m_mapLimits[hConn] = nMaxMessages;
+    }
+
+    uint32 ReceiveScheduler::GetLimit(HSteamNetConnection hConn) const
+    {
+        auto it = m_mapLimits.find(hConn);
+        return it == m_mapLimits.end() ? 0 : it->second;
+    }
+
+    uint32 ReceiveScheduler::GetWeight(HSteamNetConnection hConn) const
+    {
+        auto it = m_mapWeights.find(hConn);
+        return it == m_mapWeights.end() ? 1 : it->second;
+    }
+
+    const ReceiveStats &ReceiveScheduler::Run(Transport &transport,
+                                              const std::vector<HSteamNetConnection> &vecConnections,
+                                              const BatchHandler &fnHandler, uint32 nMaxMessages)
+    {
+        m_lastStats = ReceiveStats();
+        const size_t nConnections = vecConnections.size();
+        if (nConnections == 0)
+            return m_lastStats;
+
+        // The pass starts where the previous one left off; positions are kept to know where that is next time.
+        const size_t nStart = m_nNextStart % nConnections;
+        m_vecActive.clear();
+        m_vecActive.reserve(nConnections);
+        for (size_t i = 0; i < nConnections; ++i)
+        {
+            ActiveConnection active;
+            active.nPosition = (nStart + i) % nConnections;
+            active.hConn = vecConnections[active.nPosition];
+            const uint32 nLimit = m_mapLimits.empty() ? 0 : GetLimit(active.hConn);
+            active.nLeft = nLimit > 0 ? nLimit : std::numeric_limits<uint32>::max();
+            m_vecActive.push_back(active);
+        }
+        m_nNextStart = nStart + 1;
+
+        const bool bTimed = m_budget.nMaxMicroseconds > 0;
+        const Clock::time_point tDeadline =
+            bTimed ? Clock::now() + std::chrono::microseconds(m_budget.nMaxMicroseconds) : Clock::time_point();
+        uint32 nRemaining = m_budget.nMaxMessages > 0 ? m_budget.nMaxMessages : std::numeric_limits<uint32>::max();
+        if (nMaxMessages > 0)
+        {
+            nRemaining = std::min(nRemaining, nMaxMessages);
+        }
+        const uint32 nQuantum = std::max(m_budget.nQuantum, 1u);
+
+        bool bExhausted = false;
+        while (!m_vecActive.empty() && !bExhausted)
+        {
+            ++m_lastStats.nRounds;
+
+            // Connections whose batch came back full stay for the next round, unless they reached their limit; the
+            // rest are drained.
+            size_t nKept = 0;
+            for (size_t i = 0; i < m_vecActive.size(); ++i)
+            {
+                ActiveConnection entry = m_vecActive[i];
+                if (bExhausted)
+                {
+                    m_vecActive[nKept++] = entry;
+                    continue;
+                }
+
+                const uint64 nShare = uint64(nQuantum) * GetWeight(entry.hConn);
+                const int nWant = int(
+                    std::min<uint64>({nShare, nRemaining, entry.nLeft, uint64(std::numeric_limits<int>::max())}));
+                if (m_vecBatch.size() < size_t(nWant))
+                {
+                    m_vecBatch.resize(nWant);
+                }
+
+                const int nReceived = transport.ReceiveMessagesOnConnection(entry.hConn, m_vecBatch.data(), nWant);
+                if (nReceived > 0)
+                {
+                    for (int j = 0; j < nReceived; ++j)
+                    {
+                        m_lastStats.cbBytes += uint64(m_vecBatch[j]->m_cbSize);
+                    }
+                    m_lastStats.nMessages += uint32(nReceived);
+                    nRemaining -= uint32(nReceived);
+                    entry.nLeft -= uint32(nReceived);
+                    fnHandler(entry.hConn, m_vecBatch.data(), nReceived);
+                }
+
+                if (nReceived == nWant)
+                {
+                    if (entry.nLeft > 0)
+                        m_vecActive[nKept++] = entry;
+                    else
+                        ++m_lastStats.nThrottledConnections;
+                }
+
+                if (nRemaining == 0 || (bTimed && Clock::now() >= tDeadline))
+                {
+                    bExhausted = true;
+                    m_nNextStart = entry.nPosition + 1;
+                }
+            }
+            m_vecActive.resize(nKept);
+        }
+
+        m_lastStats.bBudgetExhausted = bExhausted;
+        m_lastStats.nBacklogConnections = uint32(m_vecActive.size()) + m_lastStats.nThrottledConnections;
+        return m_lastStats;
+    }
+} // namespace QNET
\ No newline at end of file
@@ -0,0 +1,568 @@
+#include "quicknet/components/Replication.h"
+
+#include <algorithm>
+#include <iostream>
+
+namespace QNET
+{
+    namespace
+    {
+        /// @brief Size of the message header: the tag byte followed by the PropertyClass of the message.
+        constexpr size_t kMessageHeaderBytes = 2;
+
+        /// @brief Size of the fixed record header: entity id (u32), generation (u16) and property mask (u64).
+        constexpr size_t kRecordHeaderBytes = sizeof(uint32_t) + sizeof(uint16_t) + sizeof(uint64_t);
+
+        /// @brief Appends an unsigned integer in little-endian byte order.
+        template <typename T> void AppendLE(std::vector<uint8_t> &vecOut, T value)
+        {
+            for (size_t i = 0; i < sizeof(T); ++i)
+            {
+                vecOut.push_back(static_cast<uint8_t>(value >> (8 * i)));
+            }
+        }
+
+        /// @brief Reads an unsigned integer in little-endian byte order.
+        template <typename T> T ReadLE(const uint8_t *pData)
+        {
+            T value = 0;
+            for (size_t i = 0; i < sizeof(T); ++i)
+            {
+                value |= static_cast<T>(pData[i]) << (8 * i);
+            }
+            return value;
+        }
+    } // namespace
+
+    ReplicationManager::ReplicationManager(ConnectionManager &connectionManager) : m_connectionManager(connectionManager)
+    {
+    }
+
+    /// @brief Registers a fixed-size property column and sizes it for the current entity capacity.
+    PropertyId ReplicationManager::RegisterProperty(uint32_t cbSize, PropertyClass eClass)
+    {
+        if (m_vecProperties.size() >= kMaxProperties || cbSize == 0)
+        {
+            std::cerr << "ReplicationManager: Cannot register property (limit is " << kMaxProperties
+                      << " non-empty properties)." << std::endl;
+            return static_cast<PropertyId>(kMaxProperties);
+        }
+
+        PropertyId prop = static_cast<PropertyId>(m_vecProperties.size());
+        m_vecProperties.push_back({cbSize, eClass, std::vector<uint8_t>(m_vecAlive.size() * cbSize, 0)});
+        if (eClass == PropertyClass::Reliable)
+        {
+            m_nReliableMask |= uint64_t(1) << prop;
+        }
+        return prop;
+    }
+
+    /// @brief Creates an entity, reusing a destroyed slot when one is available under a new generation.
+    /// All of its properties are marked dirty so the initial state is replicated.
+    EntityId ReplicationManager::CreateEntity()
+    {
+        EntityId id;
+        if (!m_vecFreeIds.empty())
+        {
+            id = m_vecFreeIds.back();
+            m_vecFreeIds.pop_back();
+        }
+        else
+        {
+            id = static_cast<EntityId>(m_vecAlive.size());
+            EnsureCapacity(id);
+        }
+
+        m_vecAlive[id] = 1;
+        m_vecSpawned[id] = 1;
+        m_vecDirty[id] = AllPropertiesMask();
+        ++m_vecGeneration[id];
+        return id;
+    }
+
+    /// @brief Destroys an entity, zeroes its storage and queues the destruction for replication.
+    void ReplicationManager::DestroyEntity(EntityId id)
+    {
+        if (!IsAlive(id))
+            return;
+
+        m_vecAlive[id] = 0;
+        m_vecSpawned[id] = 0;
+        m_vecDirty[id] = 0;
+        m_vecPriority[id] = 1.0f;
+        for (PropertyColumn &column : m_vecProperties)
+        {
+            std::memset(column.vecData.data() + size_t(id) * column.cbSize, 0, column.cbSize);
+        }
+
+        // Nothing that was pending for the old entity may leak into a new entity reusing this slot.
+        for (ConnectionState &state : m_vecConnections)
+        {
+            if (id < state.vecPending.size())
+            {
+                state.vecPending[id] = 0;
+            }
+            if (id < state.vecAccumulated.size())
+            {
+                state.vecAccumulated[id] = 0.0f;
+            }
+        }
+
+        m_vecDestroyed.push_back({id, m_vecGeneration[id]});
+        m_vecFreeIds.push_back(id);
+    }
+
+    bool ReplicationManager::IsAlive(EntityId id) const { return id < m_vecAlive.size() && m_vecAlive[id] != 0; }
+
+    /// @brief Copies a new value into the property column and sets the dirty bit if the bytes differ.
+    bool ReplicationManager::SetRaw(EntityId id, PropertyId prop, const void *pData)
+    {
+        if (!IsAlive(id) || prop >= m_vecProperties.size() || !pData)
+            return false;
+
+        PropertyColumn &column = m_vecProperties[prop];
+        uint8_t *pSlot = column.vecData.data() + size_t(id) * column.cbSize;
+        if (std::memcmp(pSlot, pData, column.cbSize) != 0)
+        {
+            std::memcpy(pSlot, pData, column.cbSize);
+            m_vecDirty[id] |= uint64_t(1) << prop;
+        }
+        return true;
+    }
+
+    const void *ReplicationManager::GetRaw(EntityId id, PropertyId prop) const
+    {
+        if (!IsAlive(id) || prop >= m_vecProperties.size())
+            return nullptr;
+
+        const PropertyColumn &column = m_vecProperties[prop];
+        return column.vecData.data() + size_t(id) * column.cbSize;
+    }
+
+    /// @brief Adds a connection and marks every property of every live entity as pending for it.
+    void ReplicationManager::AddConnection(HSteamNetConnection hConn)
+    {
+        if (hConn == k_HSteamNetConnection_Invalid)
+            return;
+
+        RemoveConnection(hConn);
+
+        ConnectionState state{hConn, std::vector<uint64_t>(m_vecAlive.size(), 0), true, {}};
+        const uint64_t nAllMask = AllPropertiesMask();
+        for (size_t i = 0; i < m_vecAlive.size(); ++i)
+        {
+            state.vecPending[i] = m_vecAlive[i] ? nAllMask : 0;
+        }
+        m_vecConnections.push_back(std::move(state));
+    }
+
+    void ReplicationManager::RemoveConnection(HSteamNetConnection hConn)
+    {
+        auto it = std::remove_if(m_vecConnections.begin(), m_vecConnections.end(),
+                                 [hConn](const ConnectionState &state) { return state.hConn == hConn; });
+        m_vecConnections.erase(it, m_vecConnections.end());
+    }
+
+    void ReplicationManager::EnableBandwidthBudget(const ReplicationBudget &budget)
+    {
+        m_budget = budget;
+        m_budget.cbMaxPerFlush = std::max(m_budget.cbMaxPerFlush, m_budget.cbMinPerFlush);
+        if (!m_bBudgetEnabled)
+        {
+            // Priorities left from an earlier budget would favour whatever was starved back then.
+            for (ConnectionState &state : m_vecConnections)
+            {
+                state.vecAccumulated.clear();
+            }
+            m_usecLastFlush = m_connectionManager.GetLocalTimestamp();
+        }
+        m_bBudgetEnabled = true;
+    }
+
+    bool ReplicationManager::SetPriority(EntityId id, float flPriority)
+    {
+        if (!IsAlive(id) || !(flPriority >= 0.0f))
+            return false;
+
+        m_vecPriority[id] = flPriority;
+        return true;
+    }
+
+    /// @brief Merges the dirty masks into every connection's pending masks and sends the changed properties.
+    /// @details The merge is a plain OR over two contiguous uint64_t arrays, which the compiler vectorizes, and the
+    /// serialization pass skips clean entities four masks at a time. Reliable and unreliable properties of the same
+    /// entity end up in separate records of separate messages. With the budget enabled, unreliable records are
+    /// collected as candidates first and SendWithinBudget() picks which of them go out.
+    void ReplicationManager::Flush()
+    {
+        const size_t nEntities = m_vecDirty.size();
+        const uint64_t *pDirty = m_vecDirty.data();
+
+        const bool bBudget = m_bBudgetEnabled;
+        SteamNetworkingMicroseconds usecInterval = 0;
+        if (bBudget)
+        {
+            const SteamNetworkingMicroseconds usecNow = m_connectionManager.GetLocalTimestamp();
+            const SteamNetworkingMicroseconds usecMax = SteamNetworkingMicroseconds(m_budget.nMaxIntervalMs) * 1000;
+            usecInterval = std::min(usecNow - m_usecLastFlush, usecMax);
+            m_usecLastFlush = usecNow;
+        }
+        m_nDeferred = 0;
+
+        // The slice of entities whose unreliable properties are sent again, in case an earlier update was lost.
+        size_t nRefreshBegin = 0;
+        size_t nRefreshEnd = 0;
+        if (m_nRefreshFlushes > 0 && nEntities > 0)
+        {
+            nRefreshBegin = m_nRefreshCursor < nEntities ? m_nRefreshCursor : 0;
+            nRefreshEnd = std::min(nEntities, nRefreshBegin + (nEntities + m_nRefreshFlushes - 1) / m_nRefreshFlushes);
+            m_nRefreshCursor = nRefreshEnd;
+        }
+        const uint64_t nUnreliableMask = AllPropertiesMask() & ~m_nReliableMask;
+
+        for (ConnectionState &state : m_vecConnections)
+        {
+            state.vecPending.resize(nEntities, 0);
+            uint64_t *pPending = state.vecPending.data();
+            for (size_t i = 0; i < nEntities; ++i)
+            {
+                pPending[i] |= pDirty[i];
+            }
+            for (size_t i = nRefreshBegin; i < nRefreshEnd; ++i)
+            {
+                if (m_vecAlive[i])
+                {
+                    pPending[i] |= nUnreliableMask;
+                }
+            }
+
+            if (bBudget)
+            {
+                state.vecAccumulated.resize(nEntities, 0.0f);
+            }
+            m_vecCandidates.clear();
+            size_t cbReliable = 0;
+
+            ResetMessage(m_vecReliableScratch, PropertyClass::Reliable);
+            ResetMessage(m_vecUnreliableScratch, PropertyClass::Unreliable);
+
+            // Destructions always travel on the reliable path, ahead of any state for a reused slot.
+            for (const DestroyedEntity &destroyed : m_vecDestroyed)
+            {
+                AppendLE<uint32_t>(m_vecReliableScratch, destroyed.id);
+                AppendLE<uint16_t>(m_vecReliableScratch, destroyed.nGeneration);
+                AppendLE<uint64_t>(m_vecReliableScratch, 0);
+                cbReliable += kRecordHeaderBytes;
+            }
+
+            size_t i = 0;
+            while (i < nEntities)
+            {
+                if (i + 4 <= nEntities && (pPending[i] | pPending[i + 1] | pPending[i + 2] | pPending[i + 3]) == 0)
+                {
+                    i += 4;
+                    continue;
+                }
+
+                const uint64_t nPending = pPending[i];
+                if (nPending != 0)
+                {
+                    const bool bBaseline = state.bInitial || m_vecSpawned[i];
+                    const uint64_t nReliable = bBaseline ? nPending : nPending & m_nReliableMask;
+                    const uint64_t nUnreliable = bBaseline ? 0 : nPending & ~m_nReliableMask;
+                    if (nReliable)
+                    {
+                        const size_t cbBefore = m_vecReliableScratch.size();
+                        WriteRecord(m_vecReliableScratch, static_cast<EntityId>(i), nReliable);
+                        cbReliable += m_vecReliableScratch.size() - cbBefore;
+                        if (m_vecReliableScratch.size() >= kMaxMessageBytes)
+                            SendAndReset(state.hConn, m_vecReliableScratch, PropertyClass::Reliable);
+                    }
+                    if (nUnreliable && bBudget)
+                    {
+                        // Stays pending until picked, so whatever value is current then is sent.
+                        float &flAccumulated = state.vecAccumulated[i];
+                        flAccumulated += m_vecPriority[i];
+                        m_vecCandidates.push_back({static_cast<EntityId>(i),
+                                                   static_cast<uint32_t>(GetRecordSize(nUnreliable)), flAccumulated});
+                        pPending[i] = nUnreliable;
+                    }
+                    else
+                    {
+                        if (nUnreliable)
+                        {
+                            WriteRecord(m_vecUnreliableScratch, static_cast<EntityId>(i), nUnreliable);
+                            if (m_vecUnreliableScratch.size() >= kMaxMessageBytes)
+                                SendAndReset(state.hConn, m_vecUnreliableScratch, PropertyClass::Unreliable);
+                        }
+                        pPending[i] = 0;
+                    }
+                }
+                ++i;
+            }
+
+            SendAndReset(state.hConn, m_vecReliableScratch, PropertyClass::Reliable);
+            if (!m_vecCandidates.empty())
+            {
+                const size_t cbBudget = GetBudget(state.hConn, usecInterval);
+                SendWithinBudget(state, cbBudget > cbReliable ? cbBudget - cbReliable : 0);
+            }
+            SendAndReset(state.hConn, m_vecUnreliableScratch, PropertyClass::Unreliable);
+            state.bInitial = false;
+        }
+
+        std::fill(m_vecDirty.begin(), m_vecDirty.end(), 0);
+        std::fill(m_vecSpawned.begin(), m_vecSpawned.end(), 0);
+        m_vecDestroyed.clear();
+    }
+
+    bool ReplicationManager::IsReplicationMessage(const std::vector<uint8_t> &byteMessage) const
+    {
+        return !byteMessage.empty() && byteMessage[0] == m_nMessageTag;
+    }
+
+    /// @brief Decodes entity records and writes the received values into the local property columns.
+    /// Received values do not set dirty bits, so a receiving instance never echoes state back.
+    bool ReplicationManager::ApplyMessage(const std::vector<uint8_t> &byteMessage)
+    {
+        if (!IsReplicationMessage(byteMessage) || byteMessage.size() < kMessageHeaderBytes)
+            return false;
+
+        const uint8_t *pData = byteMessage.data();
+        const size_t cbSize = byteMessage.size();
+        if (pData[1] != uint8_t(PropertyClass::Reliable) && pData[1] != uint8_t(PropertyClass::Unreliable))
+            return false;
+
+        const bool bReliable = pData[1] == uint8_t(PropertyClass::Reliable);
+        size_t offset = kMessageHeaderBytes;
+
+        while (offset < cbSize)
+        {
+            if (cbSize - offset < kRecordHeaderBytes)
+                return false;
+
+            const EntityId id = ReadLE<uint32_t>(pData + offset);
+            const uint16_t nGeneration = ReadLE<uint16_t>(pData + offset + sizeof(uint32_t));
+            const uint64_t nMask = ReadLE<uint64_t>(pData + offset + sizeof(uint32_t) + sizeof(uint16_t));
+            offset += kRecordHeaderBytes;
+
+            // The id sizes every column, so one forged id must not make this side allocate gigabytes.
+            if (id >= m_nMaxEntities)
+            {
+                std::cerr << "ReplicationManager: Rejected message with entity id " << id << " (limit is "
+                          << m_nMaxEntities << ")." << std::endl;
+                return false;
+            }
+
+            // Records of an earlier entity in a reused slot name an older generation.
+            const bool bCurrent = IsAlive(id) && m_vecGeneration[id] == nGeneration;
+            if (nMask == 0)
+            {
+                if (bCurrent)
+                {
+                    DestroyReceived(id);
+                }
+                continue;
+            }
+
+            if ((nMask & ~AllPropertiesMask()) != 0)
+                return false;
+
+            // Unreliable updates are not ordered with the reliable creations and destructions, so one for an entity
+            // that is not current is either late, for a destroyed entity, or early, ahead of its baseline. Only
+            // reliable records create entities.
+            if (!bReliable && !bCurrent)
+            {
+                const size_t cbValues = GetRecordSize(nMask) - kRecordHeaderBytes;
+                if (cbSize - offset < cbValues)
+                    return false;
+
+                offset += cbValues;
+                continue;
+            }
+
+            if (!bCurrent)
+            {
+                // Reliable records arrive in order, so the old entity's destruction normally came first.
+                if (IsAlive(id))
+                {
+                    DestroyReceived(id);
+                }
+                EnsureCapacity(id);
+                m_vecAlive[id] = 1;
+                m_vecGeneration[id] = nGeneration;
+                m_vecFreeIds.erase(std::remove(m_vecFreeIds.begin(), m_vecFreeIds.end(), id), m_vecFreeIds.end());
+            }
+
+            for (PropertyId prop = 0; prop < m_vecProperties.size(); ++prop)
+            {
+                if ((nMask & (uint64_t(1) << prop)) == 0)
+                    continue;
+
+                PropertyColumn &column = m_vecProperties[prop];
+                if (cbSize - offset < column.cbSize)
+                    return false;
+
+                std::memcpy(column.vecData.data() + size_t(id) * column.cbSize, pData + offset, column.cbSize);
+                offset += column.cbSize;
+
+                if (OnPropertyReceived)
+                {
+                    OnPropertyReceived(id, prop);
+                }
+            }
+        }
+        return true;
+    }
+
+    void ReplicationManager::EnsureCapacity(EntityId id)
+    {
+        const size_t nRequired = size_t(id) + 1;
+        if (nRequired <= m_vecAlive.size())
+            return;
+
+        m_vecAlive.resize(nRequired, 0);
+        m_vecSpawned.resize(nRequired, 0);
+        m_vecDirty.resize(nRequired, 0);
+        m_vecPriority.resize(nRequired, 1.0f);
+        m_vecGeneration.resize(nRequired, 0);
+        for (PropertyColumn &column : m_vecProperties)
+        {
+            column.vecData.resize(nRequired * column.cbSize, 0);
+        }
+    }
+
+    void ReplicationManager::DestroyReceived(EntityId id)
+    {
+        DestroyEntity(id);
+        // The destruction was received, not initiated locally, so it must not be replicated again.
+        m_vecDestroyed.pop_back();
+        if (OnEntityDestroyed)
+        {
+            OnEntityDestroyed(id);
+        }
+    }
+
+    uint64_t ReplicationManager::AllPropertiesMask() const
+    {
+        const size_t nProperties = m_vecProperties.size();
+        return nProperties >= 64 ? ~uint64_t(0) : (uint64_t(1) << nProperties) - 1;
+    }
+
+    void ReplicationManager::WriteRecord(std::vector<uint8_t> &byteMessage, EntityId id, uint64_t nMask) const
+    {
+        AppendLE<uint32_t>(byteMessage, id);
+        AppendLE<uint16_t>(byteMessage, m_vecGeneration[id]);
+        AppendLE<uint64_t>(byteMessage, nMask);
+        for (PropertyId prop = 0; prop < m_vecProperties.size(); ++prop)
+        {
+            if ((nMask & (uint64_t(1) << prop)) == 0)
+                continue;
+
+            const PropertyColumn &column = m_vecProperties[prop];
+            const uint8_t *pSlot = column.vecData.data() + size_t(id) * column.cbSize;
+            byteMessage.insert(byteMessage.end(), pSlot, pSlot + column.cbSize);
+        }
+    }
+
+    size_t ReplicationManager::GetRecordSize(uint64_t nMask) const
+    {
+        size_t cbRecord = kRecordHeaderBytes;
+        for (PropertyId prop = 0; prop < m_vecProperties.size(); ++prop)
+        {
+            if ((nMask & (uint64_t(1) << prop)) != 0)
+            {
+                cbRecord += m_vecProperties[prop].cbSize;
+            }
+        }
+        return cbRecord;
+    }
+
+    /// @brief Credits the connection its estimated send rate for the time since the previous Flush(), less what is
+    /// still queued in GNS from earlier ticks, since that leaves first.
+    size_t ReplicationManager::GetBudget(HSteamNetConnection hConn, SteamNetworkingMicroseconds usecInterval)
+    {
+        double flBudget = m_budget.cbMinPerFlush;
+        SteamNetConnectionRealTimeStatus_t status;
+        if (m_connectionManager.GetRealTimeStatus(hConn, status))
+        {
+            const double flSeconds = double(usecInterval) / 1e6;
+            flBudget = double(status.m_nSendRateBytesPerSecond) * flSeconds * m_budget.flRateFraction -
+                       double(status.m_cbPendingUnreliable) - double(status.m_cbPendingReliable);
+        }
+        return static_cast<size_t>(
+            std::min<double>(std::max<double>(flBudget, m_budget.cbMinPerFlush), m_budget.cbMaxPerFlush));
+    }
+
+    /// @brief Packs the candidates with the highest accumulated priority into the budget.
+    /// @details The candidates are a flat array, and only the prefix the budget can take is ordered: a partial sort
+    /// of about as many candidates as fit at their average size, extended by another such step if records were
+    /// skipped for being too large. Under load that is a small part of the array. The first candidate is always
+    /// sent, even if it alone exceeds the budget, so that no entity starves.
+    void ReplicationManager::SendWithinBudget(ConnectionState &state, size_t cbBudget)
+    {
+        size_t cbTotal = 0;
+        uint32_t cbSmallest = UINT32_MAX;
+        for (const BudgetCandidate &candidate : m_vecCandidates)
+        {
+            cbTotal += candidate.cbRecord;
+            cbSmallest = std::min(cbSmallest, candidate.cbRecord);
+        }
+
+        const bool bAllFit = cbTotal <= cbBudget;
+        const size_t cbAverage = cbTotal / m_vecCandidates.size();
+        auto HigherPriority = [](const BudgetCandidate &a, const BudgetCandidate &b)
+        {
+            // Ties go to the lower id, so the order does not depend on the sort.
+            return a.flPriority > b.flPriority || (a.flPriority == b.flPriority && a.id < b.id);
+        };
+
+        size_t cbLeft = cbBudget;
+        size_t nSorted = bAllFit ? m_vecCandidates.size() : 0;
+        size_t nSent = 0;
+        for (size_t n = 0; n < m_vecCandidates.size(); ++n)
+        {
+            if (n > 0 && cbLeft < cbSmallest)
+                break;
+
+            if (n == nSorted)
+            {
+                nSorted = std::min(m_vecCandidates.size(), n + cbLeft / cbAverage + 1);
+                std::partial_sort(m_vecCandidates.begin() + n, m_vecCandidates.begin() + nSorted,
+                                  m_vecCandidates.end(), HigherPriority);
+            }
+
+            const BudgetCandidate &candidate = m_vecCandidates[n];
+            if (n > 0 && candidate.cbRecord > cbLeft)
+                continue;
+
+            WriteRecord(m_vecUnreliableScratch, candidate.id, state.vecPending[candidate.id]);
+            if (m_vecUnreliableScratch.size() >= kMaxMessageBytes)
+                SendAndReset(state.hConn, m_vecUnreliableScratch, PropertyClass::Unreliable);
+
+            cbLeft -= std::min<size_t>(cbLeft, candidate.cbRecord);
+            state.vecPending[candidate.id] = 0;
+            state.vecAccumulated[candidate.id] = 0.0f;
+            ++nSent;
+        }
+        m_nDeferred += m_vecCandidates.size() - nSent;
+    }
+
+    void ReplicationManager::SendAndReset(HSteamNetConnection hConn, std::vector<uint8_t> &byteMessage,
+                                          PropertyClass eClass)
+    {
+        if (byteMessage.size() > kMessageHeaderBytes)
+        {
+            if (eClass == PropertyClass::Reliable)
+                m_connectionManager.SendReliableMessage(hConn, byteMessage);
+            else
+                m_connectionManager.SendUnreliableMessage(hConn, byteMessage);
+        }
+        ResetMessage(byteMessage, eClass);
+    }
+
+    void ReplicationManager::ResetMessage(std::vector<uint8_t> &byteMessage, PropertyClass eClass) const
+    {
+        byteMessage.assign({m_nMessageTag, static_cast<uint8_t>(eClass)});
+    }
+} // namespace QNET
\ No newline at end of file
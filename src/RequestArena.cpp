@@ -0,0 +1,142 @@
+#include "quicknet/components/RequestArena.h"
+
+#include <algorithm>
+#include <cstdint>
+
+namespace QNET
+{
+    namespace
+    {
+        thread_local RequestArena *t_pCurrentArena = nullptr;
+
+        /// @brief Alignment of the block and of overflow allocations, enough for any standard type.
+        constexpr size_t kBlockAlignment = alignof(std::max_align_t);
+
+        /// @brief Smallest overflow block; small allocations past the block share one instead of each getting its own.
+        constexpr size_t kMinOverflowSize = 16 * 1024;
+
+        uintptr_t AlignUp(uintptr_t nValue, size_t nAlignment) { return (nValue + nAlignment - 1) & ~(nAlignment - 1); }
+    } // namespace
+
+    RequestArena::RequestArena(size_t cbInitialSize, size_t cbMaxRetained, std::pmr::memory_resource *pUpstream)
+        : m_pUpstream(pUpstream), m_cbMaxRetained(std::max(cbInitialSize, cbMaxRetained))
+    {
+        AllocateBlock(cbInitialSize);
+    }
+
+    RequestArena::~RequestArena()
+    {
+        Reset();
+        if (m_pBlock)
+        {
+            m_pUpstream->deallocate(m_pBlock, m_cbBlock, kBlockAlignment);
+        }
+    }
+
+    void RequestArena::Reset()
+    {
+        const size_t cbNeeded = GetBytesUsed();
+        while (m_pOverflow)
+        {
+            OverflowBlock *pNext = m_pOverflow->pNext;
+            m_pUpstream->deallocate(m_pOverflow, m_pOverflow->cbSize, m_pOverflow->nAlignment);
+            m_pOverflow = pNext;
+        }
+        m_cbOverflowOffset = 0;
+        m_cbOverflowUsed = 0;
+        m_cbUsed = 0;
+
+        // Grow to the next power of two that holds what this request needed, so its successors fit.
+        if (cbNeeded > m_cbBlock && m_cbBlock < m_cbMaxRetained)
+        {
+            size_t cbGrown = std::max<size_t>(m_cbBlock, 1024);
+            while (cbGrown < cbNeeded)
+            {
+                cbGrown *= 2;
+            }
+            m_pUpstream->deallocate(m_pBlock, m_cbBlock, kBlockAlignment);
+            m_pBlock = nullptr;
+            m_cbBlock = 0;
+            AllocateBlock(std::min(cbGrown, m_cbMaxRetained));
+        }
+    }
+
+    RequestArena *RequestArena::Current() { return t_pCurrentArena; }
+
+    std::pmr::memory_resource *RequestArena::Resource()
+    {
+        return t_pCurrentArena ? static_cast<std::pmr::memory_resource *>(t_pCurrentArena)
+                               : std::pmr::get_default_resource();
+    }
+
+    RequestArena::Scope::Scope(RequestArena *pArena) : m_pArena(pArena), m_pPrevious(t_pCurrentArena)
+    {
+        if (m_pArena)
+        {
+            t_pCurrentArena = m_pArena;
+        }
+    }
+
+    RequestArena::Scope::~Scope()
+    {
+        if (!m_pArena)
+            return;
+
+        t_pCurrentArena = m_pPrevious;
+        if (m_pPrevious != m_pArena)
+        {
+            m_pArena->Reset();
+        }
+    }
+
+    void *RequestArena::do_allocate(size_t cbSize, size_t cbAlignment)
+    {
+        if (cbSize == 0)
+        {
+            cbSize = 1;
+        }
+
+        const uintptr_t nBlock = reinterpret_cast<uintptr_t>(m_pBlock);
+        const size_t nOffset = AlignUp(nBlock + m_cbUsed, cbAlignment) - nBlock;
+        if (m_pBlock && nOffset + cbSize <= m_cbBlock)
+        {
+            m_cbUsed = nOffset + cbSize;
+            return m_pBlock + nOffset;
+        }
+
+        // Allocations past the block come from the newest overflow block while it has room.
+        if (m_pOverflow)
+        {
+            const uintptr_t nBase = reinterpret_cast<uintptr_t>(m_pOverflow);
+            const uintptr_t nStart = AlignUp(nBase + m_cbOverflowOffset, cbAlignment);
+            if (nStart + cbSize <= nBase + m_pOverflow->cbSize)
+            {
+                m_cbOverflowOffset = nStart + cbSize - nBase;
+                m_cbOverflowUsed += cbSize;
+                return reinterpret_cast<void *>(nStart);
+            }
+        }
+
+        const size_t nAlignment = std::max(cbAlignment, kBlockAlignment);
+        const size_t cbHeader = AlignUp(sizeof(OverflowBlock), nAlignment);
+        const size_t cbBlock = std::max(cbHeader + cbSize, kMinOverflowSize);
+        auto *pBlock = static_cast<OverflowBlock *>(m_pUpstream->allocate(cbBlock, nAlignment));
+        pBlock->pNext = m_pOverflow;
+        pBlock->cbSize = cbBlock;
+        pBlock->nAlignment = nAlignment;
+        m_pOverflow = pBlock;
+        m_cbOverflowOffset = cbHeader + cbSize;
+        m_cbOverflowUsed += cbSize;
+        ++m_nOverflowCount;
+        return reinterpret_cast<char *>(pBlock) + cbHeader;
+    }
+
+    void RequestArena::AllocateBlock(size_t cbSize)
+    {
+        if (cbSize == 0)
+            return;
+
+        m_pBlock = static_cast<char *>(m_pUpstream->allocate(cbSize, kBlockAlignment));
+        m_cbBlock = cbSize;
+    }
+} // namespace QNET
\ No newline at end of file
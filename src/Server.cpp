@@ -1,5 +1,7 @@
 #include "quicknet/components/Server.h"
 
+#include "quicknet/components/SessionHandoff.h"
+
 #include <algorithm>
 #include <chrono>
 #include <iostream>
@@ -56,6 +58,12 @@ namespace QNET
             ReceiveMessages();
             std::this_thread::sleep_for(std::chrono::milliseconds(10));
         }
+
+        // The loop no longer heartbeats, which is not a stall.
+        if (GetLoopMonitor())
+        {
+            GetLoopMonitor()->Suspend();
+        }
     }
 
     /// @brief Stops the server.
@@ -75,6 +83,23 @@ namespace QNET
             m_pInterface->CloseConnection(conn, 0, "Server shutting down", true);
         }
         m_vecClients.clear();
+        m_mapConnectionRecords.clear();
+        m_mapGroups.clear();
+        m_mapClientGroups.clear();
+
+        // Close connections that were still authenticating.
+        for (auto &pending : m_mapPendingClients)
+        {
+            ReleaseHeldMessages(pending.second);
+            m_pInterface->CloseConnection(pending.first, 0, "Server shutting down", true);
+        }
+        m_mapPendingClients.clear();
+
+        for (ISteamNetworkingMessage *pMsg : m_vecCollected)
+        {
+            pMsg->Release();
+        }
+        m_vecCollected.clear();
 
         // Close the listen socket.
         if (m_hListenSocket != k_HSteamListenSocket_Invalid)
@@ -142,8 +167,30 @@ namespace QNET
             /// @brief Logs that a client has successfully connected and adds them to the client list.
             std::cout << "Server: Client connected. ID: " << pInfo->m_hConn << " ("
                       << pInfo->m_info.m_szConnectionDescription << ")" << std::endl;
-            m_vecClients.push_back(pInfo->m_hConn);
-            // You might want to send a welcome message or perform other setup here.
+
+            ConnectionRecord &record = m_mapConnectionRecords[pInfo->m_hConn];
+            record.usecConnected = m_pInterface->GetLocalTimestamp();
+            record.strDescription = pInfo->m_info.m_szConnectionDescription;
+
+            if (!m_pAuthenticator)
+            {
+                AddClient(pInfo->m_hConn);
+                break;
+            }
+
+            // The client is held back until its token has been verified. A token carried in the identity can be
+            // submitted right away; otherwise the first message on the pending poll group is the token.
+            PendingClient &pending = m_mapPendingClients[pInfo->m_hConn];
+            pending.usecConnected = record.usecConnected;
+            pending.bSubmitted = false;
+            m_pInterface->SetConnectionPollGroup(pInfo->m_hConn, m_hPendingPollGroup);
+
+            const char *pszIdentityToken = pInfo->m_info.m_identityRemote.GetGenericString();
+            if (pszIdentityToken && *pszIdentityToken)
+            {
+                pending.bSubmitted = true;
+                m_pAuthenticator->Submit(pInfo->m_hConn, pszIdentityToken);
+            }
             break;
         }
 
@@ -154,12 +201,28 @@ namespace QNET
             std::cout << "Server: Client disconnected. ID: " << pInfo->m_hConn << " ("
                       << pInfo->m_info.m_szConnectionDescription << "). Reason: " << pInfo->m_info.m_szEndDebug << std::endl;
             m_pInterface->CloseConnection(pInfo->m_hConn, 0, nullptr, false); // Ensure connection is closed.
+            m_mapConnectionRecords.erase(pInfo->m_hConn);
+
+            // A connection that never finished authenticating was never a client.
+            auto itPending = m_mapPendingClients.find(pInfo->m_hConn);
+            if (itPending != m_mapPendingClients.end())
+            {
+                ReleaseHeldMessages(itPending->second);
+                m_mapPendingClients.erase(itPending);
+                break;
+            }
 
             // Remove the client from our active list.
             auto it = std::remove(m_vecClients.begin(), m_vecClients.end(), pInfo->m_hConn);
             if (it != m_vecClients.end())
             {
                 m_vecClients.erase(it);
+                LeaveAllGroups(pInfo->m_hConn);
+
+                if (OnClientDisconnected)
+                {
+                    OnClientDisconnected(pInfo->m_hConn);
+                }
             }
             break;
         }
@@ -174,38 +237,522 @@ namespace QNET
     }
 
     /// @brief Receives and processes messages from all connected clients.
-    /// Iterates through each connected client and invokes the OnMessageReceived callback.
+    /// Drains the clients in weighted round-robin batches within the receive budget and invokes the
+    /// OnMessageReceived callback for each message.
     void Server::ReceiveMessages()
     {
         if (!m_pInterface)
             return;
 
-        for (HSteamNetConnection hConn : m_vecClients)
+        const std::chrono::steady_clock::time_point tTickStart =
+            m_pFlightRecorder ? std::chrono::steady_clock::now() : std::chrono::steady_clock::time_point();
+        if (m_pFlightRecorder)
         {
-            ISteamNetworkingMessage *pIncomingMsgs[16]; // Buffer for incoming messages for this client.
-            int numMsgs = m_pInterface->ReceiveMessagesOnConnection(hConn, pIncomingMsgs, 16);
-            if (numMsgs < 0)
+            m_pFlightRecorder->BeginTick(m_pInterface->GetLocalTimestamp());
+        }
+
+        ProcessAuthentication();
+
+        const ReceiveStats &stats =
+            m_receiveScheduler.Run(*m_pInterface, m_vecClients,
+                                   [this](HSteamNetConnection hConn, ISteamNetworkingMessage **ppMsgs, int nMsgs)
+                                   { DispatchMessages(hConn, ppMsgs, nMsgs); });
+
+        RunTickHandlers();
+
+        if (m_pFlightRecorder)
+        {
+            FlightTick &tick = m_pFlightRecorder->GetCurrentTick();
+            tick.nMessages = stats.nMessages;
+            tick.cbBytes = stats.cbBytes;
+            tick.nClients = uint32(m_vecClients.size());
+            tick.nAuthenticating = uint32(m_mapPendingClients.size());
+            tick.nBacklogConnections = stats.nBacklogConnections;
+            tick.nThrottledConnections = stats.nThrottledConnections;
+            tick.bBudgetExhausted = stats.bBudgetExhausted;
+
+            for (uint32 i = 0; i < tick.nWorstConnections; ++i)
             {
-                // Error receiving messages for this connection
-                // std::cerr << "Error receiving messages on connection " << hConn << std::endl; // Optional: for debugging
+                FlightConnection &conn = tick.aWorstConnections[i];
+                SteamNetConnectionRealTimeStatus_t status;
+                if (m_pInterface->GetConnectionRealTimeStatus(conn.hConn, &status, 0, nullptr) == k_EResultOK)
+                {
+                    conn.nPingMs = status.m_nPing;
+                    conn.cbPendingReliable = status.m_cbPendingReliable;
+                    conn.cbPendingUnreliable = status.m_cbPendingUnreliable;
+                    conn.usecQueueTime = uint32(std::max<SteamNetworkingMicroseconds>(status.m_usecQueueTime, 0));
+                }
+            }
+
+            const auto usecTick = std::chrono::duration_cast<std::chrono::microseconds>(
+                std::chrono::steady_clock::now() - tTickStart);
+            m_pFlightRecorder->EndTick(uint32(std::min<int64>(usecTick.count(), UINT32_MAX)));
+        }
+    }
+
+    int Server::ReceiveBatch(ISteamNetworkingMessage **ppOutMessages, int nMaxMessages)
+    {
+        if (!m_pInterface || !ppOutMessages || nMaxMessages <= 0)
+            return 0;
+
+        // Messages left over by the previous call go first; a pass only runs if there is room for more.
+        if (m_vecCollected.size() < size_t(nMaxMessages))
+        {
+            m_bCollecting = true;
+            ProcessAuthentication();
+            if (m_vecCollected.size() < size_t(nMaxMessages))
+            {
+                m_receiveScheduler.Run(
+                    *m_pInterface, m_vecClients,
+                    [this](HSteamNetConnection hConn, ISteamNetworkingMessage **ppMsgs, int nMsgs)
+                    { DispatchMessages(hConn, ppMsgs, nMsgs); },
+                    uint32(size_t(nMaxMessages) - m_vecCollected.size()));
+            }
+            m_bCollecting = false;
+        }
+
+        const size_t nOut = std::min(m_vecCollected.size(), size_t(nMaxMessages));
+        std::copy(m_vecCollected.begin(), m_vecCollected.begin() + nOut, ppOutMessages);
+        m_vecCollected.erase(m_vecCollected.begin(), m_vecCollected.begin() + nOut);
+        return int(nOut);
+    }
+
+    void Server::RunTickHandlers()
+    {
+        // Indexed, because a handler may register another one.
+        for (size_t i = 0; i < m_vecTickHandlers.size(); ++i)
+        {
+            m_vecTickHandlers[i].second();
+        }
+    }
+
+    void Server::DispatchMessages(HSteamNetConnection hConn, ISteamNetworkingMessage **ppMsgs, int nMsgs)
+    {
+        // Collected messages are handled after the pass, so only the accounting measures the receive itself, and
+        // there is no flight recorder tick to add to.
+        const bool bRecordTick = m_pFlightRecorder && !m_bCollecting;
+        const bool bTimed = m_pAccounting || bRecordTick;
+        const ConnectionAccounting::Clock::time_point tStart =
+            bTimed ? ConnectionAccounting::Clock::now() : ConnectionAccounting::Clock::time_point();
+
+        // Only the first message of a connection may be a resume hello.
+        auto itFirst =
+            m_pSessionHandoff && nMsgs > 0 ? m_mapConnectionRecords.find(hConn) : m_mapConnectionRecords.end();
+        const bool bMayResume = itFirst != m_mapConnectionRecords.end() && !itFirst->second.bPastHello;
+
+        uint64_t cbReceived = 0;
+        for (int i = 0; i < nMsgs; ++i)
+        {
+            ISteamNetworkingMessage *pMsg = ppMsgs[i];
+            cbReceived += pMsg->m_cbSize;
+            AccountReceived(pMsg->m_pData, uint32(pMsg->m_cbSize));
+            if (i == 0 && bMayResume && ResumeSession(hConn, pMsg))
+            {
+                pMsg->Release();
+
+                // A rejected connection is closed; the rest of what it sent is dropped with it.
+                if (!IsClient(hConn))
+                {
+                    for (int j = 1; j < nMsgs; ++j)
+                    {
+                        ppMsgs[j]->Release();
+                    }
+                    return;
+                }
                 continue;
             }
 
+            DeliverMessage(hConn, pMsg);
+        }
+
+        // Looked up after dispatching, since a handler may have disconnected the client.
+        auto itRecord = m_mapConnectionRecords.find(hConn);
+        if (itRecord != m_mapConnectionRecords.end())
+        {
+            itRecord->second.cbReceived += cbReceived;
+            itRecord->second.nMessagesReceived += uint64(nMsgs);
+            itRecord->second.bPastHello = itRecord->second.bPastHello || nMsgs > 0;
+        }
+
+        if (bTimed)
+        {
+            const ConnectionAccounting::Clock::time_point tEnd = ConnectionAccounting::Clock::now();
+            if (m_pAccounting)
+            {
+                m_pAccounting->Record(hConn, tStart, tEnd, cbReceived, nMsgs);
+            }
+            if (bRecordTick)
+            {
+                const auto usecBatch = std::chrono::duration_cast<std::chrono::microseconds>(tEnd - tStart);
+                const uint32 usecTime = uint32(std::min<int64>(usecBatch.count(), UINT32_MAX));
+                m_pFlightRecorder->GetCurrentTick().usecDispatch += usecTime;
+                m_pFlightRecorder->RecordBatch(hConn, usecTime, uint32(nMsgs), cbReceived);
+            }
+        }
+    }
+
+    void Server::DeliverMessage(HSteamNetConnection hConn, ISteamNetworkingMessage *pMsg)
+    {
+        if (m_bCollecting && pMsg->m_cbSize > 0)
+        {
+            m_vecCollected.push_back(pMsg);
+            return;
+        }
+
+        if (pMsg->m_cbSize > 0 && OnMessageReceived)
+        {
+            std::vector<uint8_t> msg((const char *)pMsg->m_pData, (const char *)pMsg->m_pData + pMsg->m_cbSize);
+
+            LoopMonitor::CallbackScope scope(GetLoopMonitor(), hConn, GetMessageType(msg.data(), pMsg->m_cbSize));
+            OnMessageReceived(hConn, msg);
+        }
+        pMsg->Release(); // Release the message resource.
+    }
+
+    void Server::SetConnectionWeight(HSteamNetConnection hConn, uint32 nWeight)
+    {
+        m_receiveScheduler.SetWeight(hConn, nWeight);
+    }
+
+    void Server::ThrottleConnection(HSteamNetConnection hConn, uint32 nMaxMessages)
+    {
+        m_receiveScheduler.SetLimit(hConn, nMaxMessages);
+    }
+
+    bool Server::DisconnectClient(HSteamNetConnection hConn, int nReason, const std::string &strDebug)
+    {
+        if (!m_pInterface)
+            return false;
+
+        auto itPending = m_mapPendingClients.find(hConn);
+        const bool bPending = itPending != m_mapPendingClients.end();
+        if (bPending)
+        {
+            ReleaseHeldMessages(itPending->second);
+            m_mapPendingClients.erase(itPending);
+        }
+
+        auto itClient = std::find(m_vecClients.begin(), m_vecClients.end(), hConn);
+        const bool bClient = itClient != m_vecClients.end();
+        if (!bPending && !bClient)
+            return false;
+
+        // GNS reports no status change for a connection closed locally, so everything the disconnect callback
+        // would clean up is cleaned up here.
+        m_pInterface->CloseConnection(hConn, nReason, strDebug.c_str(), true);
+        m_mapConnectionRecords.erase(hConn);
+        m_receiveScheduler.Remove(hConn);
+        EnableDeliveryReceipts(hConn, false);
+
+        if (bClient)
+        {
+            m_vecClients.erase(itClient);
+            LeaveAllGroups(hConn);
+
+            if (OnClientDisconnected)
+            {
+                OnClientDisconnected(hConn);
+            }
+        }
+        return true;
+    }
+
+    /// @brief Creates the authenticator and the poll group used for connections that are still authenticating.
+    bool Server::EnableAuthentication(const AuthConfig &config, TokenVerifier verifier)
+    {
+        if (!m_pInterface)
+            return false;
+
+        if (m_hPendingPollGroup == k_HSteamNetPollGroup_Invalid)
+        {
+            m_hPendingPollGroup = m_pInterface->CreatePollGroup();
+        }
+        m_pAuthenticator = std::make_unique<Authenticator>(*m_pInterface, config, std::move(verifier));
+        return true;
+    }
+
+    void Server::EnableConnectionAccounting(uint32 nWindowSeconds)
+    {
+        m_pAccounting = std::make_unique<ConnectionAccounting>(nWindowSeconds);
+    }
+
+    FlightRecorder &Server::EnableFlightRecorder(const FlightRecorderConfig &config)
+    {
+        m_pFlightRecorder = std::make_unique<FlightRecorder>(config);
+        return *m_pFlightRecorder;
+    }
+
+    std::vector<ConnectionUsage> Server::GetTopConnections(size_t nCount, ConnectionAccounting::SortBy eSortBy) const
+    {
+        if (!m_pAccounting)
+            return {};
+
+        return m_pAccounting->GetTop(nCount, eSortBy);
+    }
+
+    bool Server::IsClient(HSteamNetConnection hConn) const
+    {
+        return std::find(m_vecClients.begin(), m_vecClients.end(), hConn) != m_vecClients.end();
+    }
+
+    bool Server::JoinGroup(HSteamNetConnection hConn, const std::string &strGroup)
+    {
+        if (!IsClient(hConn))
+            return false;
+
+        std::vector<std::string> &vecGroups = m_mapClientGroups[hConn];
+        if (std::find(vecGroups.begin(), vecGroups.end(), strGroup) == vecGroups.end())
+        {
+            vecGroups.push_back(strGroup);
+            m_mapGroups[strGroup].push_back(hConn);
+        }
+        return true;
+    }
+
+    void Server::LeaveGroup(HSteamNetConnection hConn, const std::string &strGroup)
+    {
+        auto itClient = m_mapClientGroups.find(hConn);
+        if (itClient == m_mapClientGroups.end())
+            return;
+
+        std::vector<std::string> &vecGroups = itClient->second;
+        auto itName = std::find(vecGroups.begin(), vecGroups.end(), strGroup);
+        if (itName == vecGroups.end())
+            return;
+
+        vecGroups.erase(itName);
+        if (vecGroups.empty())
+        {
+            m_mapClientGroups.erase(itClient);
+        }
+
+        auto itGroup = m_mapGroups.find(strGroup);
+        std::vector<HSteamNetConnection> &vecMembers = itGroup->second;
+        vecMembers.erase(std::find(vecMembers.begin(), vecMembers.end(), hConn));
+        if (vecMembers.empty())
+        {
+            m_mapGroups.erase(itGroup);
+        }
+    }
+
+    const std::vector<HSteamNetConnection> &Server::GetGroupMembers(const std::string &strGroup) const
+    {
+        static const std::vector<HSteamNetConnection> s_vecEmpty;
+        auto it = m_mapGroups.find(strGroup);
+        return it == m_mapGroups.end() ? s_vecEmpty : it->second;
+    }
+
+    const std::vector<std::string> &Server::GetClientGroups(HSteamNetConnection hConn) const
+    {
+        static const std::vector<std::string> s_vecEmpty;
+        auto it = m_mapClientGroups.find(hConn);
+        return it == m_mapClientGroups.end() ? s_vecEmpty : it->second;
+    }
+
+    void Server::LeaveAllGroups(HSteamNetConnection hConn)
+    {
+        auto it = m_mapClientGroups.find(hConn);
+        if (it == m_mapClientGroups.end())
+            return;
+
+        for (const std::string &strGroup : it->second)
+        {
+            auto itGroup = m_mapGroups.find(strGroup);
+            std::vector<HSteamNetConnection> &vecMembers = itGroup->second;
+            vecMembers.erase(std::find(vecMembers.begin(), vecMembers.end(), hConn));
+            if (vecMembers.empty())
+            {
+                m_mapGroups.erase(itGroup);
+            }
+        }
+        m_mapClientGroups.erase(it);
+    }
+
+    uint32 Server::AddTickHandler(std::function<void()> fnHandler)
+    {
+        const uint32 nHandlerId = m_nNextTickHandlerId++;
+        m_vecTickHandlers.emplace_back(nHandlerId, std::move(fnHandler));
+        return nHandlerId;
+    }
+
+    void Server::RemoveTickHandler(uint32 nHandlerId)
+    {
+        m_vecTickHandlers.erase(std::remove_if(m_vecTickHandlers.begin(), m_vecTickHandlers.end(),
+                                               [nHandlerId](const std::pair<uint32, std::function<void()>> &entry)
+                                               { return entry.first == nHandlerId; }),
+                                m_vecTickHandlers.end());
+    }
+
+    void Server::AddClient(HSteamNetConnection hConn)
+    {
+        m_vecClients.push_back(hConn);
+
+        if (OnClientConnected)
+        {
+            OnClientConnected(hConn);
+        }
+    }
+
+    /// @brief Runs the network-thread side of authentication.
+    /// The first message of each pending connection is its token; any later messages are held until the verdict
+    /// arrives. Accepted connections are moved to the client list and their held messages are delivered in order.
+    void Server::ProcessAuthentication()
+    {
+        if (!m_pAuthenticator)
+            return;
+
+        constexpr int kBatchSize = 32;
+        constexpr size_t kMaxHeldMessages = 64;
+
+        ISteamNetworkingMessage *pIncomingMsgs[kBatchSize];
+        int numMsgs;
+        do
+        {
+            numMsgs = m_pInterface->ReceiveMessagesOnPollGroup(m_hPendingPollGroup, pIncomingMsgs, kBatchSize);
             for (int i = 0; i < numMsgs; ++i)
             {
-                if (pIncomingMsgs[i] && pIncomingMsgs[i]->m_cbSize > 0)
+                ISteamNetworkingMessage *pMsg = pIncomingMsgs[i];
+                auto it = m_mapPendingClients.find(pMsg->m_conn);
+                if (it == m_mapPendingClients.end())
                 {
-                    std::vector<uint8_t> msg((const char *)pIncomingMsgs[i]->m_pData,
-                                             (const char *)pIncomingMsgs[i]->m_pData + pIncomingMsgs[i]->m_cbSize);
-
-                    if (OnMessageReceived)
+                    // A connection that resumed its session earlier in this batch is a client already.
+                    if (m_pSessionHandoff && IsClient(pMsg->m_conn))
                     {
-                        OnMessageReceived(hConn, msg);
+                        DispatchMessages(pMsg->m_conn, &pMsg, 1);
+                        continue;
                     }
+                    AccountReceived(pMsg->m_pData, uint32(pMsg->m_cbSize));
+                    pMsg->Release();
+                    continue;
+                }
+                AccountReceived(pMsg->m_pData, uint32(pMsg->m_cbSize));
 
-                    pIncomingMsgs[i]->Release(); // Release the message resource.
+                PendingClient &pending = it->second;
+                if (!pending.bSubmitted && m_pSessionHandoff && ResumeSession(pMsg->m_conn, pMsg))
+                {
+                    pMsg->Release();
                 }
+                else if (!pending.bSubmitted)
+                {
+                    pending.bSubmitted = true;
+                    m_pAuthenticator->Submit(pMsg->m_conn, std::string((const char *)pMsg->m_pData, pMsg->m_cbSize));
+                    pMsg->Release();
+                }
+                else if (pending.vecHeld.size() < kMaxHeldMessages)
+                {
+                    pending.vecHeld.push_back(pMsg);
+                }
+                else
+                {
+                    pMsg->Release();
+                    ReleaseHeldMessages(pending);
+                    m_pInterface->CloseConnection(it->first, Authenticator::kEndReasonAuthFailed,
+                                                  "Too many messages before authentication", false);
+                    m_mapConnectionRecords.erase(it->first);
+                    m_mapPendingClients.erase(it);
+                }
+            }
+        } while (numMsgs == kBatchSize);
+
+        m_vecAuthResults.clear();
+        m_pAuthenticator->DrainResults(m_vecAuthResults);
+        for (const AuthResult &result : m_vecAuthResults)
+        {
+            auto it = m_mapPendingClients.find(result.hConn);
+            if (it == m_mapPendingClients.end())
+                continue; // Disconnected while its token was being verified.
+
+            PendingClient pending = std::move(it->second);
+            m_mapPendingClients.erase(it);
+
+            if (!result.bAccepted)
+            {
+                ReleaseHeldMessages(pending);
+                std::cout << "Server: Authentication failed for connection " << result.hConn << std::endl;
+                m_pInterface->CloseConnection(result.hConn, Authenticator::kEndReasonAuthFailed, "Authentication failed",
+                                              false);
+                m_mapConnectionRecords.erase(result.hConn);
+                continue;
+            }
+
+            // The token took the place of a resume hello, so later messages are never taken for one.
+            auto itRecord = m_mapConnectionRecords.find(result.hConn);
+            if (itRecord != m_mapConnectionRecords.end())
+            {
+                itRecord->second.strIdentity = result.strIdentity;
+                itRecord->second.bPastHello = true;
+            }
+            m_pInterface->SetConnectionPollGroup(result.hConn, k_HSteamNetPollGroup_Invalid);
+            AddClient(result.hConn);
+
+            for (ISteamNetworkingMessage *pMsg : pending.vecHeld)
+            {
+                DeliverMessage(result.hConn, pMsg);
+            }
+        }
+
+        const SteamNetworkingMicroseconds usecDeadline =
+            m_pInterface->GetLocalTimestamp() -
+            SteamNetworkingMicroseconds(m_pAuthenticator->GetConfig().nHandshakeTimeoutMs) * 1000;
+        for (auto it = m_mapPendingClients.begin(); it != m_mapPendingClients.end();)
+        {
+            if (it->second.usecConnected < usecDeadline)
+            {
+                ReleaseHeldMessages(it->second);
+                m_pInterface->CloseConnection(it->first, Authenticator::kEndReasonAuthFailed, "Authentication timed out",
+                                              false);
+                m_mapConnectionRecords.erase(it->first);
+                it = m_mapPendingClients.erase(it);
             }
+            else
+            {
+                ++it;
+            }
+        }
+    }
+
+    bool Server::ResumeSession(HSteamNetConnection hConn, const ISteamNetworkingMessage *pMsg)
+    {
+        std::string strToken;
+        if (!SessionHandoff::ParseResumeHello(pMsg->m_pData, uint32(pMsg->m_cbSize), strToken))
+            return false;
+
+        SessionState state;
+        if (!m_pSessionHandoff->TakeSession(strToken, state))
+        {
+            std::cout << "Server: Rejected resume token of connection " << hConn << std::endl;
+            DisconnectClient(hConn, SessionHandoff::kEndReasonResumeRejected, "Unknown or expired resume token");
+            return true;
+        }
+
+        // The token stands in for authentication: the process that issued it had authenticated the client. A
+        // connection resumes once, so its later messages are dispatched as they are, even if they look like hellos.
+        auto itRecord = m_mapConnectionRecords.find(hConn);
+        if (itRecord != m_mapConnectionRecords.end())
+        {
+            itRecord->second.strIdentity = state.strIdentity;
+            itRecord->second.bPastHello = true;
+        }
+        auto itPending = m_mapPendingClients.find(hConn);
+        if (itPending != m_mapPendingClients.end())
+        {
+            ReleaseHeldMessages(itPending->second);
+            m_mapPendingClients.erase(itPending);
+            m_pInterface->SetConnectionPollGroup(hConn, k_HSteamNetPollGroup_Invalid);
+            AddClient(hConn);
+        }
+
+        std::cout << "Server: Connection " << hConn << " resumed its session" << std::endl;
+        m_pSessionHandoff->RestoreSession(hConn, state);
+        return true;
+    }
+
+    void Server::ReleaseHeldMessages(PendingClient &pending)
+    {
+        for (ISteamNetworkingMessage *pMsg : pending.vecHeld)
+        {
+            pMsg->Release();
         }
+        pending.vecHeld.clear();
     }
 } // namespace QNET
\ No newline at end of file
@@ -0,0 +1,355 @@
+#include "quicknet/components/SessionHandoff.h"
+
+#include "quicknet/components/BitStream.h"
+#include "quicknet/components/HttpServer.h"
+#include "quicknet/components/Json.h"
+#include "quicknet/components/Server.h"
+
+#include <algorithm>
+#include <cstring>
+#include <iostream>
+#include <random>
+#include <utility>
+
+namespace QNET
+{
+    namespace
+    {
+        /// @brief Starts every batch, followed by the format version.
+        constexpr char kBatchMagic[4] = {'Q', 'N', 'H', 'O'};
+        constexpr uint64_t kBatchVersion = 2;
+
+        /// @brief Starts a resume hello, followed by the token. The leading zero keeps it apart from text messages.
+        constexpr char kHelloMagic[8] = {'\0', 'Q', 'N', 'E', 'T', 'R', 'S', 'M'};
+
+        /// @brief Starts the debug text of a handoff, followed by "<address> <token>".
+        constexpr char kNoticePrefix[] = "qnet-handoff ";
+
+        /// @brief Resume tokens are 128 random bits in hex.
+        constexpr size_t kTokenLength = 32;
+
+        /// @brief Room for the debug text GNS delivers with a close, without the terminator.
+        constexpr size_t kMaxNoticeLength = 127;
+
+        std::string CreateToken(std::random_device &random)
+        {
+            static const char s_szHex[] = "0123456789abcdef";
+            std::string strToken;
+            strToken.reserve(kTokenLength);
+            for (size_t i = 0; i < kTokenLength / 8; ++i)
+            {
+                const uint32_t nBits = random();
+                for (int nShift = 28; nShift >= 0; nShift -= 4)
+                {
+                    strToken.push_back(s_szHex[(nBits >> nShift) & 0xf]);
+                }
+            }
+            return strToken;
+        }
+
+        bool IsToken(const std::string &strToken)
+        {
+            return strToken.size() == kTokenLength &&
+                   strToken.find_first_not_of("0123456789abcdef") == std::string::npos;
+        }
+
+        void WriteString(BitWriter &writer, const void *pData, size_t cbSize)
+        {
+            writer.WriteVarUInt(cbSize);
+            writer.WriteBytes(pData, cbSize);
+        }
+
+        /// @brief Reads a string written by WriteString(); returns false if the data ends first.
+        template <typename T> bool ReadString(BitReader &reader, T &value)
+        {
+            const uint64_t cbSize = reader.ReadVarUInt();
+            if (reader.IsOverflowed() || cbSize > reader.GetBitsRemaining() / 8)
+                return false;
+
+            value.resize(size_t(cbSize));
+            return cbSize == 0 || reader.ReadBytes(&value[0], size_t(cbSize));
+        }
+
+        std::string SerializeBatch(const std::vector<std::pair<std::string, SessionState>> &vecSessions)
+        {
+            BitWriter writer;
+            writer.WriteBytes(kBatchMagic, sizeof(kBatchMagic));
+            writer.WriteVarUInt(kBatchVersion);
+            writer.WriteVarUInt(vecSessions.size());
+            for (const auto &session : vecSessions)
+            {
+                const SessionState &state = session.second;
+                WriteString(writer, session.first.data(), session.first.size());
+                WriteString(writer, state.strIdentity.data(), state.strIdentity.size());
+                writer.WriteVarUInt(state.nWeight);
+                writer.WriteVarUInt(state.nThrottle);
+                writer.WriteVarUInt(state.vecGroups.size());
+                for (const std::string &strGroup : state.vecGroups)
+                {
+                    WriteString(writer, strGroup.data(), strGroup.size());
+                }
+                WriteString(writer, state.vecAppState.data(), state.vecAppState.size());
+            }
+            const size_t cbSize = writer.Finish();
+            return std::string(reinterpret_cast<const char *>(writer.GetData()), cbSize);
+        }
+    } // namespace
+
+    SessionHandoff::SessionHandoff(Server &server, const SessionHandoffConfig &config)
+        : m_server(server), m_config(config)
+    {
+        m_server.SetSessionHandoff(this);
+    }
+
+    SessionHandoff::~SessionHandoff() { m_server.SetSessionHandoff(nullptr); }
+
+    bool SessionHandoff::ServeHandoff(HttpServer &http)
+    {
+        if (m_config.strBearerToken.empty())
+        {
+            std::cerr << "SessionHandoff: refusing to serve handoffs without a bearer token" << std::endl;
+            return false;
+        }
+
+        http.Post(m_config.strPrefix + "/sessions",
+                  [this](const Request &req, Response &res)
+                  {
+                      if (!HttpServer::CheckBearerToken(req, res, m_config.strBearerToken))
+                          return;
+
+                      const int64_t nAccepted = ImportSessions(req.body);
+                      if (nAccepted < 0)
+                          return HttpServer::RespondError(res, 400, "malformed session batch");
+
+                      JsonWriter writer;
+                      writer.BeginObject().Key("accepted").Int(nAccepted).EndObject();
+                      res.set_content(writer.GetString(), "application/json");
+                  });
+        return true;
+    }
+
+    int64_t SessionHandoff::ImportSessions(const std::string &strBatch)
+    {
+        BitReader reader(strBatch.data(), strBatch.size());
+        char acMagic[sizeof(kBatchMagic)];
+        if (!reader.ReadBytes(acMagic, sizeof(acMagic)) || std::memcmp(acMagic, kBatchMagic, sizeof(acMagic)) != 0 ||
+            reader.ReadVarUInt() != kBatchVersion)
+            return -1;
+
+        const uint64_t nSessions = reader.ReadVarUInt();
+        if (reader.IsOverflowed() || nSessions > strBatch.size())
+            return -1;
+
+        std::vector<std::pair<std::string, SessionState>> vecSessions(static_cast<size_t>(nSessions));
+        for (auto &session : vecSessions)
+        {
+            SessionState &state = session.second;
+            if (!ReadString(reader, session.first) || !IsToken(session.first) || !ReadString(reader, state.strIdentity))
+                return -1;
+
+            state.nWeight = uint32(reader.ReadVarUInt());
+            state.nThrottle = uint32(reader.ReadVarUInt());
+            const uint64_t nGroups = reader.ReadVarUInt();
+            if (reader.IsOverflowed() || nGroups > reader.GetBitsRemaining() / 8)
+                return -1;
+
+            state.vecGroups.resize(size_t(nGroups));
+            for (std::string &strGroup : state.vecGroups)
+            {
+                if (!ReadString(reader, strGroup))
+                    return -1;
+            }
+            if (!ReadString(reader, state.vecAppState))
+                return -1;
+        }
+
+        const std::chrono::steady_clock::time_point tNow = std::chrono::steady_clock::now();
+        const std::chrono::steady_clock::time_point tExpires =
+            tNow + std::chrono::milliseconds(m_config.nResumeTimeoutMs);
+
+        std::lock_guard<std::mutex> lock(m_mutex);
+        ExpireSessions(tNow);
+        for (auto &session : vecSessions)
+        {
+            PendingSession &pending = m_mapSessions[session.first];
+            pending.state = std::move(session.second);
+            pending.tExpires = tExpires;
+        }
+        return int64_t(vecSessions.size());
+    }
+
+    size_t SessionHandoff::GetPendingCount()
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        ExpireSessions(std::chrono::steady_clock::now());
+        return m_mapSessions.size();
+    }
+
+    bool SessionHandoff::HandOff(const std::string &strTargetUrl, const std::string &strReconnectAddress,
+                                 std::string *pstrError)
+    {
+        httplib::Client client(strTargetUrl);
+        client.set_connection_timeout(m_config.nRequestTimeoutMs / 1000, (m_config.nRequestTimeoutMs % 1000) * 1000);
+        client.set_read_timeout(m_config.nRequestTimeoutMs / 1000, (m_config.nRequestTimeoutMs % 1000) * 1000);
+
+        httplib::Headers headers;
+        headers.emplace("Authorization", "Bearer " + m_config.strBearerToken);
+
+        const std::string strPath = m_config.strPrefix + "/sessions";
+        auto SendBatch = [&](const std::string &strBatch, std::string *pstrBatchError)
+        {
+            httplib::Result result = client.Post(strPath, headers, strBatch, "application/octet-stream");
+            if (!result)
+            {
+                *pstrBatchError = "no response from " + strTargetUrl;
+                return false;
+            }
+            if (result->status != 200)
+            {
+                *pstrBatchError = "status " + std::to_string(result->status) + " from " + strTargetUrl + ": " +
+                                  result->body;
+                return false;
+            }
+            return true;
+        };
+        return HandOff(SendBatch, strReconnectAddress, pstrError);
+    }
+
+    bool SessionHandoff::HandOff(const BatchSender &fnSend, const std::string &strReconnectAddress,
+                                 std::string *pstrError)
+    {
+        std::string strError;
+        const std::string strNoticePrefix = kNoticePrefix + strReconnectAddress + " ";
+        if (strReconnectAddress.empty() || strReconnectAddress.find(' ') != std::string::npos ||
+            strNoticePrefix.size() + kTokenLength > kMaxNoticeLength)
+        {
+            strError = "invalid reconnect address: " + strReconnectAddress;
+        }
+
+        // The clients are only closed once the new process holds all of their sessions, so a failure anywhere
+        // leaves them connected here.
+        std::random_device random;
+        std::vector<std::pair<HSteamNetConnection, std::string>> vecTokens;
+        std::vector<std::pair<std::string, SessionState>> vecBatch;
+        const std::vector<HSteamNetConnection> vecClients = m_server.GetClients();
+        for (size_t i = 0; i < vecClients.size() && strError.empty(); ++i)
+        {
+            const HSteamNetConnection hConn = vecClients[i];
+            vecTokens.emplace_back(hConn, CreateToken(random));
+
+            SessionState state;
+            auto itRecord = m_server.GetConnectionRecords().find(hConn);
+            if (itRecord != m_server.GetConnectionRecords().end())
+            {
+                state.strIdentity = itRecord->second.strIdentity;
+            }
+            state.vecGroups = m_server.GetClientGroups(hConn);
+            state.nWeight = m_server.GetConnectionWeight(hConn);
+            state.nThrottle = m_server.GetConnectionThrottle(hConn);
+            if (OnExportSession)
+            {
+                state.vecAppState = OnExportSession(hConn);
+            }
+            vecBatch.emplace_back(vecTokens.back().second, std::move(state));
+
+            if (vecBatch.size() >= std::max<uint32>(m_config.nBatchSize, 1) || i + 1 == vecClients.size())
+            {
+                if (!fnSend(SerializeBatch(vecBatch), &strError) && strError.empty())
+                {
+                    strError = "batch refused";
+                }
+                vecBatch.clear();
+            }
+        }
+
+        if (!strError.empty())
+        {
+            std::cerr << "SessionHandoff: handoff failed: " << strError << std::endl;
+            if (pstrError)
+            {
+                *pstrError = strError;
+            }
+            return false;
+        }
+
+        for (const auto &token : vecTokens)
+        {
+            m_server.DisconnectClient(token.first, kEndReasonHandoff, strNoticePrefix + token.second);
+        }
+        std::cout << "SessionHandoff: handed " << vecTokens.size() << " clients off to " << strReconnectAddress
+                  << std::endl;
+        return true;
+    }
+
+    std::vector<uint8_t> SessionHandoff::MakeResumeHello(const std::string &strToken)
+    {
+        std::vector<uint8_t> vecHello(kHelloMagic, kHelloMagic + sizeof(kHelloMagic));
+        vecHello.insert(vecHello.end(), strToken.begin(), strToken.end());
+        return vecHello;
+    }
+
+    bool SessionHandoff::ParseResumeHello(const void *pData, uint32 cbSize, std::string &strToken)
+    {
+        if (cbSize != sizeof(kHelloMagic) + kTokenLength || std::memcmp(pData, kHelloMagic, sizeof(kHelloMagic)) != 0)
+            return false;
+
+        strToken.assign(static_cast<const char *>(pData) + sizeof(kHelloMagic), kTokenLength);
+        return IsToken(strToken);
+    }
+
+    bool SessionHandoff::ParseHandoffNotice(const char *pszDebug, std::string &strAddress, std::string &strToken)
+    {
+        const size_t cchPrefix = sizeof(kNoticePrefix) - 1;
+        if (!pszDebug || std::strncmp(pszDebug, kNoticePrefix, cchPrefix) != 0)
+            return false;
+
+        const std::string strRest = pszDebug + cchPrefix;
+        const size_t nSpace = strRest.find(' ');
+        if (nSpace == 0 || nSpace == std::string::npos)
+            return false;
+
+        strAddress = strRest.substr(0, nSpace);
+        strToken = strRest.substr(nSpace + 1);
+        return IsToken(strToken);
+    }
+
+    bool SessionHandoff::TakeSession(const std::string &strToken, SessionState &state)
+    {
+        // Expired sessions are only swept when a batch arrives, so that resuming stays a single lookup.
+        std::lock_guard<std::mutex> lock(m_mutex);
+        auto it = m_mapSessions.find(strToken);
+        if (it == m_mapSessions.end())
+            return false;
+
+        const bool bExpired = it->second.tExpires <= std::chrono::steady_clock::now();
+        state = std::move(it->second.state);
+        m_mapSessions.erase(it);
+        return !bExpired;
+    }
+
+    void SessionHandoff::RestoreSession(HSteamNetConnection hConn, const SessionState &state)
+    {
+        for (const std::string &strGroup : state.vecGroups)
+        {
+            m_server.JoinGroup(hConn, strGroup);
+        }
+        m_server.SetConnectionWeight(hConn, state.nWeight);
+        m_server.ThrottleConnection(hConn, state.nThrottle);
+
+        if (OnSessionResumed)
+        {
+            OnSessionResumed(hConn, state);
+        }
+    }
+
+    void SessionHandoff::ExpireSessions(std::chrono::steady_clock::time_point tNow)
+    {
+        for (auto it = m_mapSessions.begin(); it != m_mapSessions.end();)
+        {
+            if (it->second.tExpires <= tNow)
+                it = m_mapSessions.erase(it);
+            else
+                ++it;
+        }
+    }
+} // namespace QNET
\ No newline at end of file
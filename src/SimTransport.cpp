@@ -0,0 +1,663 @@
+#include "quicknet/components/SimTransport.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <limits>
+
+namespace QNET
+{
+    namespace
+    {
+        /// @brief Resends of a reliable message before it is delivered regardless, so a 100% loss link still ends.
+        constexpr int kMaxResends = 16;
+
+        /// @brief Minimum resend timeout on top of the round trip.
+        constexpr SteamNetworkingMicroseconds kResendPaddingUsec = 10000;
+
+        /// @brief Send rate reported for links without a bandwidth limit.
+        constexpr int kUnlimitedSendRate = 100000000;
+
+        /// @brief GNS message structs have a protected destructor; this type makes them deletable.
+        struct SimMessage : SteamNetworkingMessage_t
+        {
+        };
+
+        void FreeMessageData(SteamNetworkingMessage_t *pMsg) { std::free(pMsg->m_pData); }
+
+        void ReleaseMessage(SteamNetworkingMessage_t *pMsg)
+        {
+            if (pMsg->m_pfnFreeData)
+            {
+                pMsg->m_pfnFreeData(pMsg);
+            }
+            delete static_cast<SimMessage *>(pMsg);
+        }
+
+        bool IsOpen(ESteamNetworkingConnectionState eState)
+        {
+            return eState == k_ESteamNetworkingConnectionState_Connecting ||
+                   eState == k_ESteamNetworkingConnectionState_Connected;
+        }
+
+        void CopyString(char *pszOut, size_t cbOut, const std::string &str)
+        {
+            std::snprintf(pszOut, cbOut, "%s", str.c_str());
+        }
+    } // namespace
+
+    SimTransport::SimTransport(uint64 nSeed, const SimLinkConfig &config)
+        : m_usecNow(1000000), m_link(config), m_rng(nSeed)
+    {
+    }
+
+    SimTransport::~SimTransport()
+    {
+        for (auto &entry : m_mapConnections)
+        {
+            for (SteamNetworkingMessage_t *pMsg : entry.second.dequeInbox)
+            {
+                pMsg->Release();
+            }
+        }
+        while (!m_queueEvents.empty())
+        {
+            if (m_queueEvents.top().pMsg)
+            {
+                m_queueEvents.top().pMsg->Release();
+            }
+            m_queueEvents.pop();
+        }
+    }
+
+    void SimTransport::AdvanceTime(SteamNetworkingMicroseconds usecDelta)
+    {
+        m_usecNow += std::max<SteamNetworkingMicroseconds>(usecDelta, 0);
+    }
+
+    void SimTransport::RunFor(SteamNetworkingMicroseconds usecDuration, SteamNetworkingMicroseconds usecStep,
+                              const std::function<void()> &fnTick)
+    {
+        usecStep = std::max<SteamNetworkingMicroseconds>(usecStep, 1);
+        const SteamNetworkingMicroseconds usecEnd = m_usecNow + usecDuration;
+        while (m_usecNow < usecEnd)
+        {
+            fnTick();
+            AdvanceTime(std::min(usecStep, usecEnd - m_usecNow));
+        }
+    }
+
+    SteamNetworkingMicroseconds SimTransport::GetNextEventTime() const
+    {
+        return m_queueEvents.empty() ? std::numeric_limits<SteamNetworkingMicroseconds>::max()
+                                     : m_queueEvents.top().usecTime;
+    }
+
+    void SimTransport::SetLinkConfig(const SimLinkConfig &config) { m_link = config; }
+
+    bool SimTransport::SetConnectionLinkConfig(HSteamNetConnection hConn, const SimLinkConfig &config)
+    {
+        auto it = m_mapConnections.find(hConn);
+        if (it == m_mapConnections.end())
+            return false;
+
+        it->second.link = config;
+        it->second.bCustomLink = true;
+        return true;
+    }
+
+    HSteamListenSocket SimTransport::CreateListenSocketIP(const SteamNetworkingIPAddr &localAddress, int nOptions,
+                                                          const SteamNetworkingConfigValue_t *pOptions)
+    {
+        ListenSocket socket;
+        socket.nPort = localAddress.m_port;
+        for (const auto &entry : m_mapListenSockets)
+        {
+            if (entry.second.nPort == socket.nPort)
+                return k_HSteamListenSocket_Invalid;
+        }
+        ReadOptions(nOptions, pOptions, socket.fnCallback, socket.nUserData);
+
+        const HSteamListenSocket hSocket = m_nNextHandle++;
+        m_mapListenSockets.emplace(hSocket, socket);
+        return hSocket;
+    }
+
+    HSteamNetConnection SimTransport::ConnectByIPAddress(const SteamNetworkingIPAddr &address, int nOptions,
+                                                         const SteamNetworkingConfigValue_t *pOptions)
+    {
+        const HSteamNetConnection hConn = m_nNextHandle++;
+        Connection &conn = m_mapConnections[hConn];
+        ReadOptions(nOptions, pOptions, conn.fnCallback, conn.nUserData);
+        conn.addrRemote = address;
+
+        char szAddress[SteamNetworkingIPAddr::k_cchMaxString];
+        address.ToString(szAddress, sizeof(szAddress), true);
+        conn.strDescription = "#" + std::to_string(hConn) + " sim " + szAddress;
+        SetState(hConn, conn, k_ESteamNetworkingConnectionState_Connecting);
+
+        Event request = {};
+        request.usecTime = m_usecNow + SteamNetworkingMicroseconds(m_link.nLatencyMs) * 1000;
+        request.eType = EventType::ConnectRequest;
+        request.hConn = hConn;
+        request.nPort = address.m_port;
+        Schedule(request);
+
+        Event timeout = {};
+        timeout.usecTime = m_usecNow + SteamNetworkingMicroseconds(m_link.nConnectTimeoutMs) * 1000;
+        timeout.eType = EventType::ConnectTimeout;
+        timeout.hConn = hConn;
+        Schedule(timeout);
+        return hConn;
+    }
+
+    EResult SimTransport::AcceptConnection(HSteamNetConnection hConn)
+    {
+        auto it = m_mapConnections.find(hConn);
+        if (it == m_mapConnections.end() || it->second.hListenSocket == k_HSteamListenSocket_Invalid)
+            return k_EResultInvalidParam;
+
+        Connection &conn = it->second;
+        if (conn.eState != k_ESteamNetworkingConnectionState_Connecting)
+            return k_EResultInvalidState;
+
+        // The server side is connected right away; the client learns about it one trip later.
+        SetState(hConn, conn, k_ESteamNetworkingConnectionState_Connected);
+
+        Event connected = {};
+        connected.usecTime = m_usecNow + SteamNetworkingMicroseconds(m_link.nLatencyMs) * 1000;
+        connected.eType = EventType::StateChange;
+        connected.hConn = conn.hPeer;
+        connected.eState = k_ESteamNetworkingConnectionState_Connected;
+        Schedule(connected);
+        return k_EResultOK;
+    }
+
+    bool SimTransport::CloseConnection(HSteamNetConnection hPeer, int nReason, const char *pszDebug,
+                                       bool bEnableLinger)
+    {
+        auto it = m_mapConnections.find(hPeer);
+        if (it == m_mapConnections.end())
+            return false;
+
+        Connection conn = std::move(it->second);
+        m_mapConnections.erase(it);
+        for (SteamNetworkingMessage_t *pMsg : conn.dequeInbox)
+        {
+            pMsg->Release();
+        }
+
+        auto itPeer = m_mapConnections.find(conn.hPeer);
+        if (itPeer == m_mapConnections.end() || itPeer->second.hPeer != hPeer || !IsOpen(itPeer->second.eState))
+            return true;
+
+        // With linger, reliable messages already on their way are delivered before the close.
+        Event closed = {};
+        closed.usecTime = m_usecNow + SteamNetworkingMicroseconds(m_link.nLatencyMs) * 1000;
+        if (bEnableLinger)
+        {
+            closed.usecTime = std::max(closed.usecTime, conn.usecLastReliableArrival);
+        }
+        closed.eType = EventType::StateChange;
+        closed.hConn = conn.hPeer;
+        closed.eState = k_ESteamNetworkingConnectionState_ClosedByPeer;
+        closed.nEndReason = nReason != 0 ? nReason : int(k_ESteamNetConnectionEnd_App_Generic);
+        closed.strEndDebug = pszDebug ? pszDebug : "";
+        Schedule(closed);
+        return true;
+    }
+
+    bool SimTransport::CloseListenSocket(HSteamListenSocket hSocket)
+    {
+        if (m_mapListenSockets.erase(hSocket) == 0)
+            return false;
+
+        // As in GNS, connections accepted on the socket are closed with it.
+        std::vector<HSteamNetConnection> vecAccepted;
+        for (const auto &entry : m_mapConnections)
+        {
+            if (entry.second.hListenSocket == hSocket)
+            {
+                vecAccepted.push_back(entry.first);
+            }
+        }
+        for (HSteamNetConnection hConn : vecAccepted)
+        {
+            CloseConnection(hConn, 0, "Listen socket closed", false);
+        }
+        return true;
+    }
+
+    EResult SimTransport::SendMessageToConnection(HSteamNetConnection hConn, const void *pData, uint32 cbData,
+                                                  int nSendFlags, int64 *pOutMessageNumber)
+    {
+        const int64 nResult = Send(hConn, pData, cbData, nSendFlags, 0);
+        if (nResult < 0)
+            return EResult(-nResult);
+
+        if (pOutMessageNumber)
+        {
+            *pOutMessageNumber = nResult;
+        }
+        return k_EResultOK;
+    }
+
+    void SimTransport::SendMessages(int nMessages, SteamNetworkingMessage_t *const *pMessages,
+                                    int64 *pOutMessageNumberOrResult)
+    {
+        for (int i = 0; i < nMessages; ++i)
+        {
+            SteamNetworkingMessage_t *pMsg = pMessages[i];
+            const int64 nResult = Send(pMsg->m_conn, pMsg->m_pData, static_cast<uint32>(pMsg->m_cbSize),
+                                       pMsg->m_nFlags, pMsg->m_idxLane);
+            if (pOutMessageNumberOrResult)
+            {
+                pOutMessageNumberOrResult[i] = nResult;
+            }
+            pMsg->Release();
+        }
+    }
+
+    int SimTransport::ReceiveMessagesOnConnection(HSteamNetConnection hConn, SteamNetworkingMessage_t **ppOutMessages,
+                                                  int nMaxMessages)
+    {
+        Pump();
+
+        auto it = m_mapConnections.find(hConn);
+        if (it == m_mapConnections.end())
+            return -1;
+
+        std::deque<SteamNetworkingMessage_t *> &dequeInbox = it->second.dequeInbox;
+        int nCount = 0;
+        while (nCount < nMaxMessages && !dequeInbox.empty())
+        {
+            ppOutMessages[nCount++] = dequeInbox.front();
+            dequeInbox.pop_front();
+        }
+        return nCount;
+    }
+
+    HSteamNetPollGroup SimTransport::CreatePollGroup()
+    {
+        const HSteamNetPollGroup hPollGroup = m_nNextHandle++;
+        m_mapPollGroups[hPollGroup];
+        return hPollGroup;
+    }
+
+    bool SimTransport::SetConnectionPollGroup(HSteamNetConnection hConn, HSteamNetPollGroup hPollGroup)
+    {
+        auto it = m_mapConnections.find(hConn);
+        if (it == m_mapConnections.end())
+            return false;
+
+        Connection &conn = it->second;
+        if (hPollGroup == k_HSteamNetPollGroup_Invalid)
+        {
+            conn.hPollGroup = k_HSteamNetPollGroup_Invalid;
+            return true;
+        }
+
+        auto itGroup = m_mapPollGroups.find(hPollGroup);
+        if (itGroup == m_mapPollGroups.end())
+            return false;
+
+        // Messages already waiting on the connection become available on the group.
+        conn.hPollGroup = hPollGroup;
+        itGroup->second.insert(itGroup->second.end(), conn.dequeInbox.size(), hConn);
+        return true;
+    }
+
+    int SimTransport::ReceiveMessagesOnPollGroup(HSteamNetPollGroup hPollGroup,
+                                                 SteamNetworkingMessage_t **ppOutMessages, int nMaxMessages)
+    {
+        Pump();
+
+        auto itGroup = m_mapPollGroups.find(hPollGroup);
+        if (itGroup == m_mapPollGroups.end())
+            return -1;
+
+        // Entries of connections that left the group, or whose messages were read directly, are skipped.
+        std::deque<HSteamNetConnection> &dequeArrivals = itGroup->second;
+        int nCount = 0;
+        while (nCount < nMaxMessages && !dequeArrivals.empty())
+        {
+            auto it = m_mapConnections.find(dequeArrivals.front());
+            dequeArrivals.pop_front();
+            if (it == m_mapConnections.end() || it->second.hPollGroup != hPollGroup || it->second.dequeInbox.empty())
+                continue;
+
+            ppOutMessages[nCount++] = it->second.dequeInbox.front();
+            it->second.dequeInbox.pop_front();
+        }
+        return nCount;
+    }
+
+    EResult SimTransport::GetConnectionRealTimeStatus(HSteamNetConnection hConn,
+                                                      SteamNetConnectionRealTimeStatus_t *pStatus, int nLanes,
+                                                      SteamNetConnectionRealTimeLaneStatus_t *pLanes)
+    {
+        Pump();
+
+        auto it = m_mapConnections.find(hConn);
+        if (it == m_mapConnections.end())
+            return k_EResultNoConnection;
+
+        Connection &conn = it->second;
+        const SimLinkConfig &link = conn.bCustomLink ? conn.link : m_link;
+        PruneSent(conn);
+
+        if (pStatus)
+        {
+            *pStatus = SteamNetConnectionRealTimeStatus_t();
+            pStatus->m_eState = conn.eState;
+            pStatus->m_nPing = int(link.nLatencyMs * 2);
+            pStatus->m_flConnectionQualityLocal = 1.0f - link.flLossPercent / 100.0f;
+            pStatus->m_flConnectionQualityRemote = pStatus->m_flConnectionQualityLocal;
+            pStatus->m_nSendRateBytesPerSecond =
+                link.nBandwidthBytesPerSec ? int(link.nBandwidthBytesPerSec) : kUnlimitedSendRate;
+            for (const SentRecord &record : conn.dequeSent)
+            {
+                if (record.usecStart > m_usecNow)
+                {
+                    (record.bReliable ? pStatus->m_cbPendingReliable : pStatus->m_cbPendingUnreliable) +=
+                        int(record.cbSize);
+                }
+                else if (record.bReliable && record.usecAcked > m_usecNow)
+                {
+                    pStatus->m_cbSentUnackedReliable += int(record.cbSize);
+                }
+            }
+            pStatus->m_usecQueueTime = std::max<SteamNetworkingMicroseconds>(conn.usecLinkFree - m_usecNow, 0);
+        }
+
+        for (int i = 0; pLanes && i < nLanes; ++i)
+        {
+            pLanes[i] = SteamNetConnectionRealTimeLaneStatus_t();
+        }
+        return k_EResultOK;
+    }
+
+    EResult SimTransport::ConfigureConnectionLanes(HSteamNetConnection hConn, int nNumLanes, const int *,
+                                                   const uint16 *)
+    {
+        auto it = m_mapConnections.find(hConn);
+        if (it == m_mapConnections.end())
+            return k_EResultNoConnection;
+
+        if (nNumLanes < 1 || nNumLanes > 255)
+            return k_EResultInvalidParam;
+
+        it->second.nLanes = nNumLanes;
+        return k_EResultOK;
+    }
+
+    void SimTransport::RunCallbacks()
+    {
+        Pump();
+
+        // Callbacks queued by the handlers themselves wait for the next call, as in GNS.
+        size_t nPending = m_dequeCallbacks.size();
+        while (nPending-- > 0)
+        {
+            auto entry = m_dequeCallbacks.front();
+            m_dequeCallbacks.pop_front();
+            if (m_mapConnections.count(entry.second.m_hConn))
+            {
+                entry.first(&entry.second);
+            }
+        }
+    }
+
+    SteamNetworkingMessage_t *SimTransport::AllocateMessage(int cbAllocateBuffer)
+    {
+        return CreateMessage(cbAllocateBuffer);
+    }
+
+    void SimTransport::Schedule(Event event)
+    {
+        event.nSequence = m_nNextSequence++;
+        m_queueEvents.push(std::move(event));
+    }
+
+    void SimTransport::Pump()
+    {
+        while (!m_queueEvents.empty() && m_queueEvents.top().usecTime <= m_usecNow)
+        {
+            Event event = m_queueEvents.top();
+            m_queueEvents.pop();
+
+            auto it = m_mapConnections.find(event.hConn);
+            switch (event.eType)
+            {
+            case EventType::ConnectRequest:
+                OnConnectRequest(event.hConn, event.nPort);
+                break;
+
+            case EventType::ConnectTimeout:
+                if (it != m_mapConnections.end() &&
+                    it->second.eState == k_ESteamNetworkingConnectionState_Connecting)
+                {
+                    it->second.nEndReason = k_ESteamNetConnectionEnd_Misc_Timeout;
+                    it->second.strEndDebug = "Timed out attempting to connect";
+                    SetState(event.hConn, it->second, k_ESteamNetworkingConnectionState_ProblemDetectedLocally);
+                }
+                break;
+
+            case EventType::StateChange:
+                if (it == m_mapConnections.end() || !IsOpen(it->second.eState) ||
+                    (event.eState == k_ESteamNetworkingConnectionState_Connected &&
+                     it->second.eState != k_ESteamNetworkingConnectionState_Connecting))
+                    break;
+
+                it->second.nEndReason = event.nEndReason;
+                it->second.strEndDebug = event.strEndDebug;
+                SetState(event.hConn, it->second, event.eState);
+                break;
+
+            case EventType::Deliver:
+                if (it == m_mapConnections.end() || it->second.eState != k_ESteamNetworkingConnectionState_Connected)
+                {
+                    ++m_stats.nMessagesDropped;
+                    event.pMsg->Release();
+                    break;
+                }
+
+                event.pMsg->m_nConnUserData = it->second.nUserData;
+                event.pMsg->m_usecTimeReceived = event.usecTime;
+                it->second.dequeInbox.push_back(event.pMsg);
+                if (it->second.hPollGroup != k_HSteamNetPollGroup_Invalid)
+                {
+                    m_mapPollGroups[it->second.hPollGroup].push_back(event.hConn);
+                }
+                ++m_stats.nMessagesDelivered;
+                break;
+            }
+        }
+    }
+
+    void SimTransport::SetState(HSteamNetConnection hConn, Connection &conn, ESteamNetworkingConnectionState eState)
+    {
+        const ESteamNetworkingConnectionState eOldState = conn.eState;
+        conn.eState = eState;
+        if (!conn.fnCallback)
+            return;
+
+        SteamNetConnectionStatusChangedCallback_t info = {};
+        info.m_hConn = hConn;
+        info.m_eOldState = eOldState;
+        info.m_info.m_identityRemote.SetIPAddr(conn.addrRemote);
+        info.m_info.m_nUserData = conn.nUserData;
+        info.m_info.m_hListenSocket = conn.hListenSocket;
+        info.m_info.m_addrRemote = conn.addrRemote;
+        info.m_info.m_eState = eState;
+        info.m_info.m_eEndReason = conn.nEndReason;
+        CopyString(info.m_info.m_szEndDebug, sizeof(info.m_info.m_szEndDebug), conn.strEndDebug);
+        CopyString(info.m_info.m_szConnectionDescription, sizeof(info.m_info.m_szConnectionDescription),
+                   conn.strDescription);
+        m_dequeCallbacks.emplace_back(conn.fnCallback, info);
+    }
+
+    void SimTransport::OnConnectRequest(HSteamNetConnection hClient, uint16 nPort)
+    {
+        auto itClient = m_mapConnections.find(hClient);
+        if (itClient == m_mapConnections.end() ||
+            itClient->second.eState != k_ESteamNetworkingConnectionState_Connecting)
+            return;
+
+        // Without a listener the request goes unanswered and the client times out.
+        auto itSocket = std::find_if(m_mapListenSockets.begin(), m_mapListenSockets.end(),
+                                     [nPort](const std::pair<const HSteamListenSocket, ListenSocket> &entry)
+                                     { return entry.second.nPort == nPort; });
+        if (itSocket == m_mapListenSockets.end())
+            return;
+
+        const HSteamNetConnection hServer = m_nNextHandle++;
+        Connection &server = m_mapConnections[hServer];
+        server.hPeer = hClient;
+        server.hListenSocket = itSocket->first;
+        server.fnCallback = itSocket->second.fnCallback;
+        server.nUserData = itSocket->second.nUserData;
+
+        // Every client appears to come from its own address in 10.0.0.0/8.
+        const uint32 nClient = m_nNextClientAddress++;
+        server.addrRemote.SetIPv4(0x0A000000u + nClient, static_cast<uint16>(40000 + nClient % 20000));
+        char szAddress[SteamNetworkingIPAddr::k_cchMaxString];
+        server.addrRemote.ToString(szAddress, sizeof(szAddress), true);
+        server.strDescription = "#" + std::to_string(hServer) + " sim " + szAddress;
+
+        itClient->second.hPeer = hServer;
+        SetState(hServer, server, k_ESteamNetworkingConnectionState_Connecting);
+    }
+
+    int64 SimTransport::Send(HSteamNetConnection hConn, const void *pData, uint32 cbData, int nSendFlags, uint16 nLane)
+    {
+        auto it = m_mapConnections.find(hConn);
+        if (it == m_mapConnections.end())
+            return -int64(k_EResultNoConnection);
+
+        Connection &conn = it->second;
+        if (conn.eState == k_ESteamNetworkingConnectionState_Connecting)
+            return -int64(k_EResultInvalidState);
+        if (conn.eState != k_ESteamNetworkingConnectionState_Connected)
+            return -int64(k_EResultNoConnection);
+        if (nLane >= conn.nLanes)
+            return -int64(k_EResultInvalidParam);
+
+        const SimLinkConfig &link = conn.bCustomLink ? conn.link : m_link;
+        const bool bReliable = (nSendFlags & k_nSteamNetworkingSend_Reliable) != 0;
+        const int64 nMessageNumber = conn.nNextMessageNumber++;
+        ++m_stats.nMessagesSent;
+        m_stats.cbSent += cbData;
+
+        // The link carries one message at a time at the configured rate; the rest wait in the send queue.
+        const SteamNetworkingMicroseconds usecStart = std::max(m_usecNow, conn.usecLinkFree);
+        const SteamNetworkingMicroseconds usecTransmit =
+            link.nBandwidthBytesPerSec ? SteamNetworkingMicroseconds(cbData) * 1000000 / link.nBandwidthBytesPerSec : 0;
+        conn.usecLinkFree = usecStart + usecTransmit;
+        SteamNetworkingMicroseconds usecArrival = conn.usecLinkFree + DrawDelay(link);
+
+        const double flLoss = link.flLossPercent / 100.0;
+        const SteamNetworkingMicroseconds usecLatency = SteamNetworkingMicroseconds(link.nLatencyMs) * 1000;
+        if (!bReliable)
+        {
+            if (flLoss > 0 && DrawUniform() < flLoss)
+            {
+                ++m_stats.nMessagesDropped;
+                conn.dequeSent.push_back({usecStart, usecStart, cbData, false});
+                return nMessageNumber;
+            }
+        }
+        else
+        {
+            for (int nResend = 0; nResend < kMaxResends && flLoss > 0 && DrawUniform() < flLoss; ++nResend)
+            {
+                usecArrival += 2 * usecLatency + kResendPaddingUsec;
+                ++m_stats.nRetransmits;
+            }
+
+            // Reliable messages are delivered in order.
+            usecArrival = std::max(usecArrival, conn.usecLastReliableArrival);
+            conn.usecLastReliableArrival = usecArrival;
+        }
+        conn.dequeSent.push_back({usecStart, bReliable ? usecArrival + usecLatency : usecStart, cbData, bReliable});
+
+        if (conn.hPeer == k_HSteamNetConnection_Invalid)
+        {
+            ++m_stats.nMessagesDropped;
+            return nMessageNumber;
+        }
+
+        SteamNetworkingMessage_t *pMsg = CreateMessage(static_cast<int>(cbData));
+        if (cbData > 0)
+        {
+            std::memcpy(pMsg->m_pData, pData, cbData);
+        }
+        pMsg->m_conn = conn.hPeer;
+        pMsg->m_nMessageNumber = nMessageNumber;
+        pMsg->m_nFlags = nSendFlags;
+        pMsg->m_idxLane = nLane;
+        pMsg->m_identityPeer.SetIPAddr(conn.addrRemote);
+
+        Event deliver = {};
+        deliver.usecTime = usecArrival;
+        deliver.eType = EventType::Deliver;
+        deliver.hConn = conn.hPeer;
+        deliver.pMsg = pMsg;
+        Schedule(deliver);
+        return nMessageNumber;
+    }
+
+    SteamNetworkingMicroseconds SimTransport::DrawDelay(const SimLinkConfig &link)
+    {
+        SteamNetworkingMicroseconds usecDelay = SteamNetworkingMicroseconds(link.nLatencyMs) * 1000;
+        if (link.nJitterMs > 0)
+        {
+            usecDelay += SteamNetworkingMicroseconds(DrawUniform() * link.nJitterMs * 1000.0);
+        }
+        return usecDelay;
+    }
+
+    double SimTransport::DrawUniform()
+    {
+        // std::uniform_real_distribution is implementation-defined, so the bits are converted by hand.
+        return double(m_rng() >> 11) * (1.0 / 9007199254740992.0);
+    }
+
+    void SimTransport::PruneSent(Connection &conn)
+    {
+        while (!conn.dequeSent.empty() && conn.dequeSent.front().usecStart <= m_usecNow &&
+               conn.dequeSent.front().usecAcked <= m_usecNow)
+        {
+            conn.dequeSent.pop_front();
+        }
+    }
+
+    void SimTransport::ReadOptions(int nOptions, const SteamNetworkingConfigValue_t *pOptions,
+                                   FnSteamNetConnectionStatusChanged &fnCallback, int64 &nUserData)
+    {
+        for (int i = 0; pOptions && i < nOptions; ++i)
+        {
+            if (pOptions[i].m_eValue == k_ESteamNetworkingConfig_Callback_ConnectionStatusChanged)
+            {
+                fnCallback = reinterpret_cast<FnSteamNetConnectionStatusChanged>(pOptions[i].m_val.m_ptr);
+            }
+            else if (pOptions[i].m_eValue == k_ESteamNetworkingConfig_ConnectionUserData)
+            {
+                nUserData = pOptions[i].m_val.m_int64;
+            }
+        }
+    }
+
+    SteamNetworkingMessage_t *SimTransport::CreateMessage(int cbSize)
+    {
+        SimMessage *pMsg = new SimMessage();
+        pMsg->m_pData = cbSize > 0 ? std::malloc(size_t(cbSize)) : nullptr;
+        pMsg->m_cbSize = cbSize;
+        pMsg->m_conn = k_HSteamNetConnection_Invalid;
+        pMsg->m_identityPeer.Clear();
+        pMsg->m_pfnFreeData = FreeMessageData;
+        pMsg->m_pfnRelease = ReleaseMessage;
+        return pMsg;
+    }
+} // namespace QNET
\ No newline at end of file
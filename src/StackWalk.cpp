@@ -0,0 +1,157 @@
+#include "quicknet/components/StackWalk.h"
+
+#if defined(__linux__) && (defined(__x86_64__) || defined(__i386__) || defined(__aarch64__))
+#define QNET_STACK_WALK 1
+#include <algorithm>
+#include <cerrno>
+#include <fcntl.h>
+#include <mutex>
+#include <sys/resource.h>
+#include <ucontext.h>
+#include <unistd.h>
+#endif
+
+namespace QNET
+{
+    namespace
+    {
+#ifdef QNET_STACK_WALK
+        /// @brief A non-blocking pipe that stack pages are written into to find out whether they are mapped: write()
+        /// fails with EFAULT instead of faulting, and it is async-signal-safe.
+        int s_anProbePipe[2] = {-1, -1};
+
+        /// @brief How far above the interrupted stack pointer frames are followed: the stack size limit, which is
+        /// also the default size of thread stacks.
+        uintptr_t s_cbMaxStack = 0;
+
+        std::once_flag s_initOnce;
+        bool s_bInitialized = false;
+
+        constexpr uintptr_t kPageSize = 4096;
+
+        /// @brief Frame pointers of consecutive frames further apart than this are taken as garbage.
+        constexpr uintptr_t kMaxFrameBytes = 1024 * 1024;
+
+        /// @brief Checks that the page holding nAddress is mapped and readable.
+        bool IsPageReadable(uintptr_t nAddress)
+        {
+            for (int nAttempt = 0; nAttempt < 2; ++nAttempt)
+            {
+                ssize_t cbWritten;
+                do
+                {
+                    cbWritten = write(s_anProbePipe[1], reinterpret_cast<const void *>(nAddress), 1);
+                } while (cbWritten < 0 && errno == EINTR);
+
+                // Empties the pipe, including bytes other threads' probes left, so that it never stays full.
+                char acDrain[64];
+                while (read(s_anProbePipe[0], acDrain, sizeof(acDrain)) > 0)
+                {
+                }
+
+                if (cbWritten == 1)
+                    return true;
+                if (errno != EAGAIN)
+                    return false;
+            }
+            return false;
+        }
+
+        void GetRegisters(const void *pContext, uintptr_t &nPc, uintptr_t &nFp, uintptr_t &nSp)
+        {
+            const mcontext_t &context = static_cast<const ucontext_t *>(pContext)->uc_mcontext;
+#if defined(__x86_64__)
+            nPc = static_cast<uintptr_t>(context.gregs[REG_RIP]);
+            nFp = static_cast<uintptr_t>(context.gregs[REG_RBP]);
+            nSp = static_cast<uintptr_t>(context.gregs[REG_RSP]);
+#elif defined(__i386__)
+            nPc = static_cast<uintptr_t>(context.gregs[REG_EIP]);
+            nFp = static_cast<uintptr_t>(context.gregs[REG_EBP]);
+            nSp = static_cast<uintptr_t>(context.gregs[REG_ESP]);
+#else
+            nPc = static_cast<uintptr_t>(context.pc);
+            nFp = static_cast<uintptr_t>(context.regs[29]);
+            nSp = static_cast<uintptr_t>(context.sp);
+#endif
+        }
+#endif
+    } // namespace
+
+    bool InitStackWalk()
+    {
+#ifdef QNET_STACK_WALK
+        std::call_once(s_initOnce,
+                       []()
+                       {
+                           if (pipe2(s_anProbePipe, O_NONBLOCK | O_CLOEXEC) != 0)
+                               return;
+
+                           rlimit limit = {};
+                           const uintptr_t cbDefault = 8 * 1024 * 1024;
+                           const bool bLimited =
+                               getrlimit(RLIMIT_STACK, &limit) == 0 && limit.rlim_cur != RLIM_INFINITY;
+                           s_cbMaxStack = bLimited ? static_cast<uintptr_t>(limit.rlim_cur) : cbDefault;
+                           s_bInitialized = true;
+                       });
+        return s_bInitialized;
+#else
+        return false;
+#endif
+    }
+
+    /// @brief Follows the chain of frame records, each of which holds the caller's frame pointer followed by the
+    /// return address, on every supported architecture.
+    uint32_t WalkSignalStack(const void *pContext, void **ppFrames, uint32_t nMaxFrames)
+    {
+#ifdef QNET_STACK_WALK
+        if (!s_bInitialized || !pContext || nMaxFrames == 0)
+            return 0;
+
+        uintptr_t nPc = 0;
+        uintptr_t nFp = 0;
+        uintptr_t nSp = 0;
+        GetRegisters(pContext, nPc, nFp, nSp);
+
+        uint32_t nFrames = 0;
+        ppFrames[nFrames++] = reinterpret_cast<void *>(nPc);
+
+        const uintptr_t nStackEnd = nSp + std::min(s_cbMaxStack, UINTPTR_MAX - nSp);
+        uintptr_t nLowest = nSp;
+        uintptr_t nReadablePage = 0;
+        while (nFrames < nMaxFrames)
+        {
+            if (nFp < nLowest || nFp % sizeof(uintptr_t) != 0 || nStackEnd - nFp < 2 * sizeof(uintptr_t))
+                break;
+
+            // A frame record is two aligned words, so it never straddles a page.
+            const uintptr_t nPage = nFp & ~(kPageSize - 1);
+            if (nPage != nReadablePage)
+            {
+                if (!IsPageReadable(nPage))
+                    break;
+                nReadablePage = nPage;
+            }
+
+            const uintptr_t *pRecord = reinterpret_cast<const uintptr_t *>(nFp);
+            const uintptr_t nCallerFp = pRecord[0];
+            const uintptr_t nReturn = pRecord[1];
+            if (nReturn == 0)
+                break;
+
+            ppFrames[nFrames++] = reinterpret_cast<void *>(nReturn);
+
+            // The stack grows down, so every caller's frame is above its callee's.
+            if (nCallerFp <= nFp || nCallerFp - nFp > kMaxFrameBytes)
+                break;
+            nLowest = nFp + 2 * sizeof(uintptr_t);
+            nFp = nCallerFp;
+        }
+        return nFrames;
+#else
+        (void)pContext;
+        (void)ppFrames;
+        (void)nMaxFrames;
+        return 0;
+#endif
+    }
+} // namespace QNET
\ No newline at end of file
@@ -0,0 +1,87 @@
+#include "quicknet/components/Transport.h"
+
+namespace QNET
+{
+    SteamTransport::SteamTransport(ISteamNetworkingSockets *pSockets) : m_pSockets(pSockets) {}
+
+    HSteamListenSocket SteamTransport::CreateListenSocketIP(const SteamNetworkingIPAddr &localAddress, int nOptions,
+                                                            const SteamNetworkingConfigValue_t *pOptions)
+    {
+        return m_pSockets->CreateListenSocketIP(localAddress, nOptions, pOptions);
+    }
+
+    HSteamNetConnection SteamTransport::ConnectByIPAddress(const SteamNetworkingIPAddr &address, int nOptions,
+                                                           const SteamNetworkingConfigValue_t *pOptions)
+    {
+        return m_pSockets->ConnectByIPAddress(address, nOptions, pOptions);
+    }
+
+    EResult SteamTransport::AcceptConnection(HSteamNetConnection hConn) { return m_pSockets->AcceptConnection(hConn); }
+
+    bool SteamTransport::CloseConnection(HSteamNetConnection hPeer, int nReason, const char *pszDebug,
+                                         bool bEnableLinger)
+    {
+        return m_pSockets->CloseConnection(hPeer, nReason, pszDebug, bEnableLinger);
+    }
+
+    bool SteamTransport::CloseListenSocket(HSteamListenSocket hSocket)
+    {
+        return m_pSockets->CloseListenSocket(hSocket);
+    }
+
+    EResult SteamTransport::SendMessageToConnection(HSteamNetConnection hConn, const void *pData, uint32 cbData,
+                                                    int nSendFlags, int64 *pOutMessageNumber)
+    {
+        return m_pSockets->SendMessageToConnection(hConn, pData, cbData, nSendFlags, pOutMessageNumber);
+    }
+
+    void SteamTransport::SendMessages(int nMessages, SteamNetworkingMessage_t *const *pMessages,
+                                      int64 *pOutMessageNumberOrResult)
+    {
+        m_pSockets->SendMessages(nMessages, pMessages, pOutMessageNumberOrResult);
+    }
+
+    int SteamTransport::ReceiveMessagesOnConnection(HSteamNetConnection hConn, SteamNetworkingMessage_t **ppOutMessages,
+                                                    int nMaxMessages)
+    {
+        return m_pSockets->ReceiveMessagesOnConnection(hConn, ppOutMessages, nMaxMessages);
+    }
+
+    HSteamNetPollGroup SteamTransport::CreatePollGroup() { return m_pSockets->CreatePollGroup(); }
+
+    bool SteamTransport::SetConnectionPollGroup(HSteamNetConnection hConn, HSteamNetPollGroup hPollGroup)
+    {
+        return m_pSockets->SetConnectionPollGroup(hConn, hPollGroup);
+    }
+
+    int SteamTransport::ReceiveMessagesOnPollGroup(HSteamNetPollGroup hPollGroup,
+                                                   SteamNetworkingMessage_t **ppOutMessages, int nMaxMessages)
+    {
+        return m_pSockets->ReceiveMessagesOnPollGroup(hPollGroup, ppOutMessages, nMaxMessages);
+    }
+
+    EResult SteamTransport::GetConnectionRealTimeStatus(HSteamNetConnection hConn,
+                                                        SteamNetConnectionRealTimeStatus_t *pStatus, int nLanes,
+                                                        SteamNetConnectionRealTimeLaneStatus_t *pLanes)
+    {
+        return m_pSockets->GetConnectionRealTimeStatus(hConn, pStatus, nLanes, pLanes);
+    }
+
+    EResult SteamTransport::ConfigureConnectionLanes(HSteamNetConnection hConn, int nNumLanes,
+                                                     const int *pLanePriorities, const uint16 *pLaneWeights)
+    {
+        return m_pSockets->ConfigureConnectionLanes(hConn, nNumLanes, pLanePriorities, pLaneWeights);
+    }
+
+    void SteamTransport::RunCallbacks() { m_pSockets->RunCallbacks(); }
+
+    SteamNetworkingMessage_t *SteamTransport::AllocateMessage(int cbAllocateBuffer)
+    {
+        return SteamNetworkingUtils()->AllocateMessage(cbAllocateBuffer);
+    }
+
+    SteamNetworkingMicroseconds SteamTransport::GetLocalTimestamp()
+    {
+        return SteamNetworkingUtils()->GetLocalTimestamp();
+    }
+} // namespace QNET
\ No newline at end of file
@@ -0,0 +1,305 @@
+#include "quicknet/components/Watchdog.h"
+#include "quicknet/components/StackWalk.h"
+
+#include <chrono>
+#include <iostream>
+
+#if defined(__linux__) && defined(__GLIBC__)
+#define QNET_WATCHDOG_STACKS 1
+#include <cerrno>
+#include <csignal>
+#include <cstdlib>
+#include <cxxabi.h>
+#include <execinfo.h>
+#include <pthread.h>
+#endif
+
+namespace QNET
+{
+    namespace
+    {
+#ifdef QNET_WATCHDOG_STACKS
+        constexpr uint32_t kMaxFrames = 64;
+
+        /// @brief Frames written by the signal handler running on the stuck thread.
+        void *s_apFrames[kMaxFrames];
+        std::atomic<uint32_t> s_nFrames{0};
+        std::atomic<bool> s_bCaptured{false};
+
+        /// @brief Serializes captures, since the frame buffer is shared by all watchdogs.
+        std::mutex s_captureMutex;
+        std::once_flag s_installOnce;
+
+        int StackSignal() { return SIGRTMIN + 2; }
+
+        void OnStackSignal(int, siginfo_t *, void *pContext)
+        {
+            const int nSavedErrno = errno;
+            s_nFrames.store(WalkSignalStack(pContext, s_apFrames, kMaxFrames), std::memory_order_relaxed);
+            s_bCaptured.store(true, std::memory_order_release);
+            errno = nSavedErrno;
+        }
+
+        /// @brief Turns "binary(_ZN4QNET3FooEv+0x1c) [0x...]" into "binary(QNET::Foo()+0x1c) [0x...]".
+        std::string Demangle(const char *pszSymbol)
+        {
+            std::string strSymbol = pszSymbol;
+            const size_t nBegin = strSymbol.find('(');
+            const size_t nEnd = strSymbol.find('+', nBegin);
+            if (nBegin == std::string::npos || nEnd == std::string::npos || nEnd == nBegin + 1)
+                return strSymbol;
+
+            const std::string strMangled = strSymbol.substr(nBegin + 1, nEnd - nBegin - 1);
+            int nStatus = 0;
+            char *pszDemangled = abi::__cxa_demangle(strMangled.c_str(), nullptr, nullptr, &nStatus);
+            if (nStatus == 0 && pszDemangled)
+            {
+                strSymbol.replace(nBegin + 1, strMangled.size(), pszDemangled);
+            }
+            std::free(pszDemangled);
+            return strSymbol;
+        }
+
+        /// @brief Interrupts a thread with a signal whose handler records its stack, and symbolizes the frames.
+        std::vector<std::string> CaptureStack(uint64 nThread)
+        {
+            if (!InitStackWalk())
+                return {};
+
+            std::call_once(s_installOnce,
+                           []()
+                           {
+                               struct sigaction action = {};
+                               action.sa_sigaction = OnStackSignal;
+                               sigemptyset(&action.sa_mask);
+                               action.sa_flags = SA_RESTART | SA_SIGINFO;
+                               sigaction(StackSignal(), &action, nullptr);
+                           });
+
+            std::lock_guard<std::mutex> lock(s_captureMutex);
+            s_bCaptured.store(false, std::memory_order_relaxed);
+            if (pthread_kill(static_cast<pthread_t>(nThread), StackSignal()) != 0)
+                return {};
+
+            const auto tDeadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(100);
+            while (!s_bCaptured.load(std::memory_order_acquire))
+            {
+                if (std::chrono::steady_clock::now() > tDeadline)
+                    return {};
+                std::this_thread::sleep_for(std::chrono::microseconds(200));
+            }
+
+            // The walk starts at the interrupted PC, so there are no signal delivery frames to skip.
+            const uint32_t nFrames = s_nFrames.load(std::memory_order_relaxed);
+            std::vector<std::string> vecStack;
+            if (nFrames == 0)
+                return vecStack;
+
+            char **ppszSymbols = backtrace_symbols(s_apFrames, static_cast<int>(nFrames));
+            if (!ppszSymbols)
+                return vecStack;
+
+            for (uint32_t i = 0; i < nFrames; ++i)
+            {
+                vecStack.push_back(Demangle(ppszSymbols[i]));
+            }
+            std::free(ppszSymbols);
+            return vecStack;
+        }
+#endif
+    } // namespace
+
+    void LoopMonitor::Heartbeat()
+    {
+        NoteThread();
+        m_usecHeartbeat.store(Watchdog::Now(), std::memory_order_relaxed);
+    }
+
+    void LoopMonitor::BeginCallback(HSteamNetConnection hConn, int32 nMessageType, const char *pszContext)
+    {
+        NoteThread();
+        m_hConn.store(hConn, std::memory_order_relaxed);
+        m_nMessageType.store(nMessageType, std::memory_order_relaxed);
+        m_pszContext.store(pszContext, std::memory_order_relaxed);
+        m_usecCallbackStart.store(Watchdog::Now(), std::memory_order_release);
+    }
+
+    void LoopMonitor::EndCallback() { m_usecCallbackStart.store(0, std::memory_order_relaxed); }
+
+    void LoopMonitor::Suspend() { m_usecHeartbeat.store(0, std::memory_order_relaxed); }
+
+    LoopMonitor::LoopMonitor(std::string strName) : m_strName(std::move(strName)) {}
+
+    void LoopMonitor::NoteThread()
+    {
+#ifdef QNET_WATCHDOG_STACKS
+        // Loops normally stay on one thread, so this is a load and a compare after the first call.
+        const uint64 nThread = static_cast<uint64>(pthread_self());
+        if (m_nThread.load(std::memory_order_relaxed) != nThread)
+        {
+            m_nThread.store(nThread, std::memory_order_relaxed);
+            m_bHasThread.store(true, std::memory_order_release);
+        }
+#endif
+    }
+
+    LoopMonitor::CallbackScope::CallbackScope(LoopMonitor *pMonitor, HSteamNetConnection hConn, int32 nMessageType,
+                                              const char *pszContext)
+        : m_pMonitor(pMonitor)
+    {
+        if (m_pMonitor)
+        {
+            m_pMonitor->BeginCallback(hConn, nMessageType, pszContext);
+        }
+    }
+
+    LoopMonitor::CallbackScope::~CallbackScope()
+    {
+        if (m_pMonitor)
+        {
+            m_pMonitor->EndCallback();
+        }
+    }
+
+    Watchdog::Watchdog(const WatchdogConfig &config) : m_config(config) {}
+
+    Watchdog::~Watchdog()
+    {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_bStop = true;
+        }
+        m_cvStop.notify_all();
+        if (m_thread.joinable())
+        {
+            m_thread.join();
+        }
+    }
+
+    std::shared_ptr<LoopMonitor> Watchdog::Watch(const std::string &strName)
+    {
+        std::shared_ptr<LoopMonitor> pMonitor(new LoopMonitor(strName));
+
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_vecMonitors.push_back(pMonitor);
+        if (!m_thread.joinable())
+        {
+            m_thread = std::thread(&Watchdog::ThreadMain, this);
+        }
+        return pMonitor;
+    }
+
+    int64 Watchdog::Now()
+    {
+        return std::chrono::duration_cast<std::chrono::microseconds>(
+                   std::chrono::steady_clock::now().time_since_epoch())
+            .count();
+    }
+
+    void Watchdog::ThreadMain()
+    {
+        std::vector<std::shared_ptr<LoopMonitor>> vecMonitors;
+        std::unique_lock<std::mutex> lock(m_mutex);
+        const auto interval = std::chrono::milliseconds(m_config.nCheckIntervalMs);
+        while (!m_cvStop.wait_for(lock, interval, [this]() { return m_bStop; }))
+        {
+            // Take strong references so monitors can be released while they are being checked.
+            vecMonitors.clear();
+            for (auto it = m_vecMonitors.begin(); it != m_vecMonitors.end();)
+            {
+                if (std::shared_ptr<LoopMonitor> pMonitor = it->lock())
+                {
+                    vecMonitors.push_back(std::move(pMonitor));
+                    ++it;
+                }
+                else
+                {
+                    it = m_vecMonitors.erase(it);
+                }
+            }
+            lock.unlock();
+
+            const int64 usecNow = Now();
+            for (const std::shared_ptr<LoopMonitor> &pMonitor : vecMonitors)
+            {
+                StallReport report;
+                if (!CheckMonitor(*pMonitor, usecNow, report))
+                    continue;
+
+                if (OnStall)
+                {
+                    OnStall(report);
+                }
+                else
+                {
+                    std::cerr << "Watchdog: " << report.strLoop << " stalled for " << report.nStalledMs << " ms";
+                    if (report.bInCallback)
+                    {
+                        std::cerr << " in a callback (connection " << report.hConn << ", message type "
+                                  << report.nMessageType << ")";
+                    }
+                    std::cerr << std::endl;
+                    for (const std::string &strFrame : report.vecStack)
+                    {
+                        std::cerr << "    " << strFrame << std::endl;
+                    }
+                }
+            }
+            vecMonitors.clear();
+
+            lock.lock();
+        }
+    }
+
+    bool Watchdog::CheckMonitor(LoopMonitor &monitor, int64 usecNow, StallReport &report)
+    {
+        const int64 usecThreshold = int64(m_config.nThresholdMs) * 1000;
+        const int64 usecHeartbeat = monitor.m_usecHeartbeat.load(std::memory_order_relaxed);
+        const int64 usecCallbackStart = monitor.m_usecCallbackStart.load(std::memory_order_acquire);
+
+        // A long callback is the more specific finding, so it takes precedence over a missing heartbeat. The
+        // heartbeat it held up is marked as reported too, so the same stall is not reported again once the
+        // callback returns but before the loop heartbeats.
+        if (usecCallbackStart != 0)
+        {
+            if (usecNow - usecCallbackStart <= usecThreshold || monitor.m_usecReportedCallback == usecCallbackStart)
+                return false;
+
+            report.hConn = monitor.m_hConn.load(std::memory_order_relaxed);
+            report.nMessageType = monitor.m_nMessageType.load(std::memory_order_relaxed);
+            const char *pszContext = monitor.m_pszContext.load(std::memory_order_relaxed);
+
+            // The fields belong to this callback only if it is still the current one.
+            if (monitor.m_usecCallbackStart.load(std::memory_order_acquire) != usecCallbackStart)
+                return false;
+
+            if (pszContext)
+            {
+                report.strContext = pszContext;
+            }
+            report.bInCallback = true;
+            report.nStalledMs = static_cast<uint32>((usecNow - usecCallbackStart) / 1000);
+            monitor.m_usecReportedCallback = usecCallbackStart;
+            monitor.m_usecReportedHeartbeat = usecHeartbeat;
+        }
+        else
+        {
+            if (usecHeartbeat == 0 || usecNow - usecHeartbeat <= usecThreshold ||
+                monitor.m_usecReportedHeartbeat == usecHeartbeat)
+                return false;
+
+            report.nStalledMs = static_cast<uint32>((usecNow - usecHeartbeat) / 1000);
+            monitor.m_usecReportedHeartbeat = usecHeartbeat;
+        }
+
+        report.strLoop = monitor.m_strName;
+
+#ifdef QNET_WATCHDOG_STACKS
+        if (m_config.bCaptureStack && monitor.m_bHasThread.load(std::memory_order_acquire))
+        {
+            report.vecStack = CaptureStack(monitor.m_nThread.load(std::memory_order_relaxed));
+        }
+#endif
+        return true;
+    }
+} // namespace QNET
\ No newline at end of file
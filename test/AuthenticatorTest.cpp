@@ -0,0 +1,103 @@
+#include "Check.h"
+
+#include "quicknet/components/Authenticator.h"
+
+#include <ctime>
+#include <string>
+
+namespace
+{
+    std::string Hex(const uint8_t *pData, size_t cbSize)
+    {
+        static const char s_szHex[] = "0123456789abcdef";
+        std::string strHex;
+        for (size_t i = 0; i < cbSize; ++i)
+        {
+            strHex += s_szHex[pData[i] >> 4];
+            strHex += s_szHex[pData[i] & 0xf];
+        }
+        return strHex;
+    }
+
+    std::string HmacHex(const std::string &strKey, const std::string &strData, size_t cbTruncate = 32)
+    {
+        const std::array<uint8_t, 32> aMac = QNET::Authenticator::HmacSha256(strKey, strData.data(), strData.size());
+        return Hex(aMac.data(), cbTruncate);
+    }
+
+    /// @brief The HMAC-SHA-256 vectors of RFC 4231 section 4.
+    void TestRfc4231()
+    {
+        // Test case 1: a 20-byte key.
+        QNET_CHECK_EQ(HmacHex(std::string(20, '\x0b'), "Hi There"),
+                      "b0344c61d8db38535ca8afceaf0bf12b881dc200c9833da726e9376c2e32cff7");
+
+        // Test case 2: a key shorter than the output.
+        QNET_CHECK_EQ(HmacHex("Jefe", "what do ya want for nothing?"),
+                      "5bdcc146bf60754e6a042426089575c75a003f089d2739839dec58b964ec3843");
+
+        // Test case 3: key and data of repeated bytes.
+        QNET_CHECK_EQ(HmacHex(std::string(20, '\xaa'), std::string(50, '\xdd')),
+                      "773ea91e36800e46854db8ebd09181a72959098b3ef8c122d9635514ced565fe");
+
+        // Test case 4: a 25-byte key of 0x01..0x19.
+        std::string strKey4;
+        for (char c = 1; c <= 25; ++c)
+        {
+            strKey4 += c;
+        }
+        QNET_CHECK_EQ(HmacHex(strKey4, std::string(50, '\xcd')),
+                      "82558a389a443c0ea4cc819899f2083a85f0faa3e578f8077a2e3ff46729665b");
+
+        // Test case 5: output truncated to 128 bits.
+        QNET_CHECK_EQ(HmacHex(std::string(20, '\x0c'), "Test With Truncation", 16), "a3b6167473100ee06e0c796c2955552b");
+
+        // Test cases 6 and 7: a key longer than the SHA-256 block, which is hashed first, and data longer than it.
+        const std::string strLongKey(131, '\xaa');
+        QNET_CHECK_EQ(HmacHex(strLongKey, "Test Using Larger Than Block-Size Key - Hash Key First"),
+                      "60e431591ee0b67f0d8a26aacbf5b77f8e0bc6213728c5140546040f0ee37f54");
+        QNET_CHECK_EQ(HmacHex(strLongKey, "This is a test using a larger than block-size key and a larger than "
+                                          "block-size data. The key needs to be hashed before being used by the "
+                                          "HMAC algorithm."),
+                      "9b09ffa71b942fcb27635fbcd5b0e944bfdc63644f0713938a7f51535c3a35e2");
+    }
+
+    /// @brief The token format built on the HMAC, and what VerifyToken() rejects.
+    void TestTokens()
+    {
+        const int64_t nExpiresAt = int64_t(std::time(nullptr)) + 3600;
+        const std::string strToken = QNET::Authenticator::CreateToken("secret", "user-7", nExpiresAt);
+
+        // The token is "payload.expiry.mac", with the MAC taken over "payload.expiry".
+        const std::string strSigned = "user-7." + std::to_string(nExpiresAt);
+        QNET_CHECK_EQ(strToken, strSigned + "." + HmacHex("secret", strSigned));
+
+        QNET::AuthClaims claims;
+        QNET_CHECK(QNET::Authenticator::VerifyToken("secret", strToken, claims));
+        QNET_CHECK_EQ(claims.strIdentity, "user-7");
+        QNET_CHECK_EQ(claims.nExpiresAt, nExpiresAt);
+
+        // Another secret, a changed payload or MAC, and an expired token are rejected.
+        QNET::AuthClaims rejected;
+        QNET_CHECK(!QNET::Authenticator::VerifyToken("other", strToken, rejected));
+        std::string strTampered = strToken;
+        strTampered[0] = 'U';
+        QNET_CHECK(!QNET::Authenticator::VerifyToken("secret", strTampered, rejected));
+        strTampered = strToken;
+        strTampered.back() = strTampered.back() == '0' ? '1' : '0';
+        QNET_CHECK(!QNET::Authenticator::VerifyToken("secret", strTampered, rejected));
+        QNET_CHECK(!QNET::Authenticator::VerifyToken("secret", strToken.substr(0, strToken.size() - 1), rejected));
+        const std::string strExpired =
+            QNET::Authenticator::CreateToken("secret", "user-7", int64_t(std::time(nullptr)) - 1);
+        QNET_CHECK(!QNET::Authenticator::VerifyToken("secret", strExpired, rejected));
+        QNET_CHECK(!QNET::Authenticator::VerifyToken("secret", "", rejected));
+        QNET_CHECK(!QNET::Authenticator::VerifyToken("secret", "user-7", rejected));
+    }
+} // namespace
+
+int main()
+{
+    TestRfc4231();
+    TestTokens();
+    return QNET::Test::Finish("AuthenticatorTest");
+}
\ No newline at end of file
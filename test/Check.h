@@ -0,0 +1,49 @@
+#pragma once
+
+#include <iostream>
+
+/// @brief Counts and reports a failed condition without stopping, so one run shows every failing vector.
+#define QNET_CHECK(condition)                                                                                      \
+    do                                                                                                             \
+    {                                                                                                              \
+        if (!(condition))                                                                                          \
+        {                                                                                                          \
+            ++QNET::Test::Failures();                                                                              \
+            std::cerr << __FILE__ << ":" << __LINE__ << ": check failed: " #condition << std::endl;                \
+        }                                                                                                          \
+    } while (false)
+
+/// @brief Like QNET_CHECK(a == b), and prints both values when they differ.
+#define QNET_CHECK_EQ(actual, expected)                                                                            \
+    do                                                                                                             \
+    {                                                                                                              \
+        const auto &qnetActual = (actual);                                                                         \
+        const auto &qnetExpected = (expected);                                                                     \
+        if (!(qnetActual == qnetExpected))                                                                         \
+        {                                                                                                          \
+            ++QNET::Test::Failures();                                                                              \
+            std::cerr << __FILE__ << ":" << __LINE__ << ": " #actual " is " << qnetActual << ", expected "          \
+                      << qnetExpected << std::endl;                                                                \
+        }                                                                                                          \
+    } while (false)
+
+namespace QNET
+{
+    namespace Test
+    {
+        /// @brief The number of failed checks so far in this test executable.
+        inline int &Failures()
+        {
+            static int s_nFailures = 0;
+            return s_nFailures;
+        }
+
+        /// @brief Prints the outcome and returns the exit code for CTest: 0 only if every check passed.
+        inline int Finish(const char *pszName)
+        {
+            std::cout << pszName << ": " << (Failures() == 0 ? "passed" : "FAILED") << " (" << Failures()
+                      << " failed checks)" << std::endl;
+            return Failures() == 0 ? 0 : 1;
+        }
+    } // namespace Test
+} // namespace QNET
\ No newline at end of file
@@ -0,0 +1,221 @@
+#include "Check.h"
+
+#include "quicknet/components/Hpack.h"
+
+#include <string>
+#include <vector>
+
+namespace
+{
+    using Headers = std::vector<QNET::HpackHeader>;
+
+    /// @brief Reads the hex dumps of RFC 7541 appendix C; spaces are ignored.
+    std::string FromHex(const char *pszHex)
+    {
+        std::string strBytes;
+        int nHigh = -1;
+        for (const char *p = pszHex; *p; ++p)
+        {
+            const char c = *p;
+            if (c == ' ')
+                continue;
+
+            const int nDigit = c <= '9' ? c - '0' : c - 'a' + 10;
+            if (nHigh < 0)
+            {
+                nHigh = nDigit;
+            }
+            else
+            {
+                strBytes += static_cast<char>(nHigh << 4 | nDigit);
+                nHigh = -1;
+            }
+        }
+        return strBytes;
+    }
+
+    std::string ToHex(const std::string &strBytes)
+    {
+        static const char s_szHex[] = "0123456789abcdef";
+        std::string strHex;
+        for (unsigned char c : strBytes)
+        {
+            strHex += s_szHex[c >> 4];
+            strHex += s_szHex[c & 0xf];
+        }
+        return strHex;
+    }
+
+    std::string Format(const Headers &vecHeaders)
+    {
+        std::string strOut;
+        for (const QNET::HpackHeader &header : vecHeaders)
+        {
+            strOut += header.strName + ": " + header.strValue + (header.bNeverIndex ? " (never indexed)" : "") + "\n";
+        }
+        return strOut;
+    }
+
+    /// @brief Decodes one block and checks the fields and the dynamic table size the RFC lists after it.
+    void CheckDecode(QNET::HpackDecoder &decoder, const char *pszHex, const Headers &vecExpected, size_t cbTable)
+    {
+        const std::string strBlock = FromHex(pszHex);
+        Headers vecHeaders;
+        QNET_CHECK(decoder.Decode(reinterpret_cast<const uint8_t *>(strBlock.data()), strBlock.size(), vecHeaders));
+        QNET_CHECK_EQ(Format(vecHeaders), Format(vecExpected));
+        QNET_CHECK_EQ(decoder.GetTableSize(), cbTable);
+    }
+
+    bool Decodes(const char *pszHex, uint32_t cbMaxTableSize = 4096)
+    {
+        const std::string strBlock = FromHex(pszHex);
+        QNET::HpackDecoder decoder(cbMaxTableSize);
+        Headers vecHeaders;
+        return decoder.Decode(reinterpret_cast<const uint8_t *>(strBlock.data()), strBlock.size(), vecHeaders);
+    }
+
+    const Headers kRequest1 = {{":method", "GET"}, {":scheme", "http"}, {":path", "/"},
+                               {":authority", "www.example.com"}};
+    const Headers kRequest2 = {{":method", "GET"},
+                               {":scheme", "http"},
+                               {":path", "/"},
+                               {":authority", "www.example.com"},
+                               {"cache-control", "no-cache"}};
+    const Headers kRequest3 = {{":method", "GET"},
+                               {":scheme", "https"},
+                               {":path", "/index.html"},
+                               {":authority", "www.example.com"},
+                               {"custom-key", "custom-value"}};
+    const Headers kResponse1 = {{":status", "302"},
+                                {"cache-control", "private"},
+                                {"date", "Mon, 21 Oct 2013 20:13:21 GMT"},
+                                {"location", "https://www.example.com"}};
+    const Headers kResponse2 = {{":status", "307"},
+                                {"cache-control", "private"},
+                                {"date", "Mon, 21 Oct 2013 20:13:21 GMT"},
+                                {"location", "https://www.example.com"}};
+    const Headers kResponse3 = {{":status", "200"},
+                                {"cache-control", "private"},
+                                {"date", "Mon, 21 Oct 2013 20:13:22 GMT"},
+                                {"location", "https://www.example.com"},
+                                {"content-encoding", "gzip"},
+                                {"set-cookie", "foo=ASDJKHQKBZXOQWEOPIUAXQWEOIU; max-age=3600; version=1"}};
+
+    /// @brief C.2: one field of each representation, each with a fresh table.
+    void TestFieldRepresentations()
+    {
+        QNET::HpackDecoder decoder1;
+        CheckDecode(decoder1, "400a 6375 7374 6f6d 2d6b 6579 0d63 7573 746f 6d2d 6865 6164 6572",
+                    {{"custom-key", "custom-header"}}, 55);
+
+        QNET::HpackDecoder decoder2;
+        CheckDecode(decoder2, "040c 2f73 616d 706c 652f 7061 7468", {{":path", "/sample/path"}}, 0);
+
+        QNET::HpackDecoder decoder3;
+        CheckDecode(decoder3, "1008 7061 7373 776f 7264 0673 6563 7265 74", {{"password", "secret", true}}, 0);
+
+        QNET::HpackDecoder decoder4;
+        CheckDecode(decoder4, "82", {{":method", "GET"}}, 0);
+    }
+
+    /// @brief C.3 and C.4: three requests on one connection, without and with Huffman coding.
+    void TestRequests()
+    {
+        QNET::HpackDecoder plain;
+        CheckDecode(plain, "8286 8441 0f77 7777 2e65 7861 6d70 6c65 2e63 6f6d", kRequest1, 57);
+        CheckDecode(plain, "8286 84be 5808 6e6f 2d63 6163 6865", kRequest2, 110);
+        CheckDecode(plain, "8287 85bf 400a 6375 7374 6f6d 2d6b 6579 0c63 7573 746f 6d2d 7661 6c75 65", kRequest3,
+                    164);
+
+        QNET::HpackDecoder huffman;
+        CheckDecode(huffman, "8286 8441 8cf1 e3c2 e5f2 3a6b a0ab 90f4 ff", kRequest1, 57);
+        CheckDecode(huffman, "8286 84be 5886 a8eb 1064 9cbf", kRequest2, 110);
+        CheckDecode(huffman, "8287 85bf 4088 25a8 49e9 5ba9 7d7f 8925 a849 e95b b8e8 b4bf", kRequest3, 164);
+
+        // The encoder makes the same choices as the RFC for these requests.
+        QNET::HpackEncoder encoder;
+        const char *apszExpected[] = {"828684418cf1e3c2e5f23a6ba0ab90f4ff", "828684be5886a8eb10649cbf",
+                                      "828785bf408825a849e95ba97d7f8925a849e95bb8e8b4bf"};
+        const Headers *apRequests[] = {&kRequest1, &kRequest2, &kRequest3};
+        for (int i = 0; i < 3; ++i)
+        {
+            std::string strBlock;
+            encoder.Encode(*apRequests[i], strBlock);
+            QNET_CHECK_EQ(ToHex(strBlock), std::string(apszExpected[i]));
+        }
+    }
+
+    /// @brief C.5 and C.6: three responses with a 256-byte table, so that later fields evict earlier ones.
+    void TestResponses()
+    {
+        QNET::HpackDecoder plain(256);
+        CheckDecode(plain,
+                    "4803 3330 3258 0770 7269 7661 7465 611d 4d6f 6e2c 2032 3120 4f63 7420 3230 3133 2032 303a 3133 "
+                    "3a32 3120 474d 546e 1768 7474 7073 3a2f 2f77 7777 2e65 7861 6d70 6c65 2e63 6f6d",
+                    kResponse1, 222);
+        CheckDecode(plain, "4803 3330 37c1 c0bf", kResponse2, 222);
+        CheckDecode(plain,
+                    "88c1 611d 4d6f 6e2c 2032 3120 4f63 7420 3230 3133 2032 303a 3133 3a32 3220 474d 54c0 5a04 677a "
+                    "6970 7738 666f 6f3d 4153 444a 4b48 514b 425a 584f 5157 454f 5049 5541 5851 5745 4f49 553b 206d "
+                    "6178 2d61 6765 3d33 3630 303b 2076 6572 7369 6f6e 3d31",
+                    kResponse3, 215);
+
+        QNET::HpackDecoder huffman(256);
+        CheckDecode(huffman,
+                    "4882 6402 5885 aec3 771a 4b61 96d0 7abe 9410 54d4 44a8 2005 9504 0b81 66e0 82a6 2d1b ff6e 919d "
+                    "29ad 1718 63c7 8f0b 97c8 e9ae 82ae 43d3",
+                    kResponse1, 222);
+        CheckDecode(huffman, "4883 640e ffc1 c0bf", kResponse2, 222);
+        CheckDecode(huffman,
+                    "88c1 6196 d07a be94 1054 d444 a820 0595 040b 8166 e084 a62d 1bff c05a 839b d9ab 77ad 94e7 821d "
+                    "d7f2 e6c7 b335 dfdf cd5b 3960 d5af 2708 7f36 72c1 ab27 0fb5 291f 9587 3160 65c0 03ed 4ee5 b106 "
+                    "3d50 07",
+                    kResponse3, 215);
+    }
+
+    void TestHuffman()
+    {
+        std::string strEncoded;
+        QNET::HpackHuffmanEncode("www.example.com", strEncoded);
+        QNET_CHECK_EQ(ToHex(strEncoded), std::string("f1e3c2e5f23a6ba0ab90f4ff"));
+        QNET_CHECK_EQ(QNET::HpackHuffmanEncodedLength("www.example.com"), size_t(12));
+
+        // Every byte value survives a round trip.
+        std::string strAll;
+        for (int c = 0; c < 256; ++c)
+        {
+            strAll += static_cast<char>(c);
+        }
+        strEncoded.clear();
+        QNET::HpackHuffmanEncode(strAll, strEncoded);
+        std::string strDecoded;
+        QNET_CHECK(QNET::HpackHuffmanDecode(reinterpret_cast<const uint8_t *>(strEncoded.data()), strEncoded.size(),
+                                            strDecoded));
+        QNET_CHECK(strDecoded == strAll);
+    }
+
+    /// @brief Blocks that are compression errors.
+    void TestMalformed()
+    {
+        QNET_CHECK(Decodes("8286 8441 8cf1 e3c2 e5f2 3a6b a0ab 90f4 ff"));
+        QNET_CHECK(!Decodes("80"));                                        // index 0
+        QNET_CHECK(!Decodes("be"));                                        // past the static table, table empty
+        QNET_CHECK(!Decodes("ff ff ff ff ff ff ff ff ff ff ff"));          // index overflows
+        QNET_CHECK(!Decodes("4188 f1e3 c2e5 f23a 6ba0 ab90 f4ff ff"));     // Huffman padding longer than 7 bits
+        QNET_CHECK(!Decodes("4181 fe"));                                   // Huffman padding not all ones
+        QNET_CHECK(!Decodes("410f 7777 772e"));                            // string longer than the block
+        QNET_CHECK(!Decodes("3fe2 1f"));                                   // table size 4099 above the limit of 4096
+        QNET_CHECK(!Decodes("82 20"));                                     // size update after a field
+        QNET_CHECK(Decodes("20 82"));                                      // size update at the start of a block
+    }
+} // namespace
+
+int main()
+{
+    TestFieldRepresentations();
+    TestRequests();
+    TestResponses();
+    TestHuffman();
+    TestMalformed();
+    return QNET::Test::Finish("HpackTest");
+}
\ No newline at end of file
@@ -0,0 +1,172 @@
+#include "Check.h"
+
+#include "quicknet/components/Json.h"
+
+#include <limits>
+#include <string>
+
+namespace
+{
+    bool Parses(const std::string &strJson)
+    {
+        QNET::JsonValue value;
+        return QNET::JsonValue::Parse(strJson, value);
+    }
+
+    /// @brief Writes a value back out with JsonWriter, for comparing documents after a round trip.
+    void Write(const QNET::JsonValue &value, QNET::JsonWriter &writer)
+    {
+        switch (value.GetType())
+        {
+        case QNET::JsonValue::Type::Null:
+            writer.Null();
+            break;
+        case QNET::JsonValue::Type::Bool:
+            writer.Bool(value.GetBool());
+            break;
+        case QNET::JsonValue::Type::Number:
+            writer.Double(value.GetNumber());
+            break;
+        case QNET::JsonValue::Type::String:
+            writer.String(value.GetString());
+            break;
+        case QNET::JsonValue::Type::Array:
+            writer.BeginArray();
+            for (const QNET::JsonValue &element : value.GetArray())
+            {
+                Write(element, writer);
+            }
+            writer.EndArray();
+            break;
+        case QNET::JsonValue::Type::Object:
+            writer.BeginObject();
+            for (const auto &member : value.GetMembers())
+            {
+                writer.Key(member.first);
+                Write(member.second, writer);
+            }
+            writer.EndObject();
+            break;
+        }
+    }
+
+    void TestWriter()
+    {
+        QNET::JsonWriter writer;
+        writer.BeginObject()
+            .Key("s")
+            .String(std::string("q\"b\\n\n\t\x01", 8))
+            .Key("i")
+            .Int(-42)
+            .Key("u")
+            .UInt(std::numeric_limits<uint64_t>::max())
+            .Key("d")
+            .Double(0.1)
+            .Key("a")
+            .BeginArray()
+            .Bool(true)
+            .Bool(false)
+            .Null()
+            .BeginObject()
+            .EndObject()
+            .EndArray()
+            .Key("raw")
+            .Raw("[1]")
+            .EndObject();
+        QNET_CHECK_EQ(writer.GetString(), std::string("{\"s\":\"q\\\"b\\\\n\\n\\t\\u0001\",\"i\":-42,"
+                                                      "\"u\":18446744073709551615,\"d\":0.1,"
+                                                      "\"a\":[true,false,null,{}],\"raw\":[1]}"));
+
+        // JSON has no infinities or NaN.
+        writer.Clear();
+        writer.BeginArray()
+            .Double(std::numeric_limits<double>::infinity())
+            .Double(std::numeric_limits<double>::quiet_NaN())
+            .EndArray();
+        QNET_CHECK_EQ(writer.GetString(), std::string("[null,null]"));
+    }
+
+    void TestParser()
+    {
+        QNET::JsonValue value;
+        std::string strError;
+        QNET_CHECK(QNET::JsonValue::Parse(" {\"a\":[1,2,{\"b\":\"\\ud83d\\ude00\\n\\u00e9\"}],\"c\":-1.5e3,"
+                                          "\"d\":true,\"e\":null,\"a\":0} ",
+                                          value, &strError));
+        QNET_CHECK_EQ(strError, std::string());
+        QNET_CHECK(value.IsObject());
+        QNET_CHECK_EQ(value.GetMembers().size(), size_t(5));
+
+        // Duplicate names are kept; Find() returns the first.
+        const QNET::JsonValue *pA = value.Find("a");
+        QNET_CHECK(pA && pA->IsArray() && pA->GetArray().size() == 3);
+        if (pA && pA->GetArray().size() == 3)
+        {
+            QNET_CHECK_EQ(pA->GetArray()[1].GetNumber(), 2.0);
+            const QNET::JsonValue *pB = pA->GetArray()[2].Find("b");
+            QNET_CHECK(pB && pB->IsString());
+            if (pB)
+                QNET_CHECK_EQ(pB->GetString(), std::string("\xf0\x9f\x98\x80\n\xc3\xa9"));
+        }
+
+        const QNET::JsonValue *pC = value.Find("c");
+        QNET_CHECK(pC && pC->GetNumber() == -1500.0);
+        QNET_CHECK(value.Find("d") && value.Find("d")->GetBool());
+        QNET_CHECK(value.Find("e") && value.Find("e")->IsNull());
+        QNET_CHECK(value.Find("missing") == nullptr);
+
+        // Typed getters fall back to their defaults.
+        QNET_CHECK_EQ(value.GetNumber(7.0), 7.0);
+        QNET_CHECK(value.GetString().empty());
+    }
+
+    /// @brief Parsing what the writer wrote gives back the same document.
+    void TestRoundTrip()
+    {
+        const std::string strDocument = "{\"name\":\"caf\xc3\xa9 \\\"\\u0001\",\"n\":[0,-1,0.5,1e+20,true,null],"
+                                        "\"nested\":{\"empty\":[],\"obj\":{}}}";
+        QNET::JsonValue value;
+        QNET_CHECK(QNET::JsonValue::Parse(strDocument, value));
+
+        QNET::JsonWriter writer;
+        Write(value, writer);
+        QNET_CHECK_EQ(writer.GetString(), strDocument);
+
+        QNET::JsonValue reparsed;
+        QNET_CHECK(QNET::JsonValue::Parse(writer.GetString(), reparsed));
+        QNET::JsonWriter rewriter;
+        Write(reparsed, rewriter);
+        QNET_CHECK_EQ(rewriter.GetString(), strDocument);
+    }
+
+    void TestMalformed()
+    {
+        const char *apszMalformed[] = {"", "{", "[1,]", "{\"a\":1,}", "{\"a\":1}x", "1 2", "[1 2]", "{\"a\" 1}",
+                                       "{\"a\"}", "{a:1}", "'a'", "01", "-", "+1", "1.", ".5", "1e", "tru", "nul",
+                                       "\"abc", "\"\\x\"", "[\"\x01\"]", "\"\\u12\"", "\"\\ud800\"", "\"\\udc00\"",
+                                       "\"\\ud800\\u0041\""};
+        for (const char *pszJson : apszMalformed)
+        {
+            QNET::JsonValue value;
+            std::string strError;
+            const bool bParsed = QNET::JsonValue::Parse(pszJson, value, &strError);
+            QNET_CHECK(!bParsed);
+            QNET_CHECK(!strError.empty());
+        }
+
+        // Nesting is accepted up to kMaxDepth and rejected beyond it.
+        const int nDepth = QNET::JsonValue::kMaxDepth;
+        QNET_CHECK(Parses(std::string(nDepth, '[') + std::string(nDepth, ']')));
+        QNET_CHECK(!Parses(std::string(nDepth + 1, '[') + std::string(nDepth + 1, ']')));
+        QNET_CHECK(!Parses(std::string(100000, '[')));
+    }
+} // namespace
+
+int main()
+{
+    TestWriter();
+    TestParser();
+    TestRoundTrip();
+    TestMalformed();
+    return QNET::Test::Finish("JsonTest");
+}
\ No newline at end of file
@@ -0,0 +1,224 @@
+#include "Check.h"
+
+#include "quicknet/components/Client.h"
+#include "quicknet/components/Replication.h"
+#include "quicknet/components/Server.h"
+#include "quicknet/components/SimTransport.h"
+
+#include <vector>
+
+namespace
+{
+    using Message = std::vector<uint8_t>;
+
+    struct Vec2
+    {
+        float x;
+        float y;
+    };
+
+    /// @brief A server replicating to one client over a simulated network. The client's messages are collected
+    /// rather than applied, so that tests can drop, reorder or replay them.
+    struct Link
+    {
+        QNET::SimTransport net;
+        QNET::Server server{net};
+        QNET::Client client{net};
+        QNET::ReplicationManager sender{server};
+        QNET::ReplicationManager receiver{client};
+        QNET::PropertyId position = 0;
+        QNET::PropertyId health = 0;
+        std::vector<Message> vecReceived;
+
+        Link()
+        {
+            for (QNET::ReplicationManager *pManager : {&sender, &receiver})
+            {
+                position = pManager->RegisterProperty<Vec2>(QNET::PropertyClass::Unreliable);
+                health = pManager->RegisterProperty<int32_t>(QNET::PropertyClass::Reliable);
+            }
+            server.OnClientConnected = [this](HSteamNetConnection hConn) { sender.AddConnection(hConn); };
+            client.OnMessageReceived = [this](const Message &message) { vecReceived.push_back(message); };
+            server.Initialize(27020);
+            client.Connect("127.0.0.1:27020");
+            Run();
+        }
+
+        void Run()
+        {
+            net.RunFor(200000, 5000,
+                       [this]()
+                       {
+                           server.Poll();
+                           server.ReceiveMessages();
+                           client.Poll();
+                           client.ReceiveMessages();
+                       });
+        }
+
+        /// @brief Flushes the sender and returns what the client received.
+        std::vector<Message> Flush()
+        {
+            vecReceived.clear();
+            sender.Flush();
+            Run();
+            return vecReceived;
+        }
+
+        /// @brief Flushes the sender and applies everything the client received.
+        void FlushAndApply()
+        {
+            for (const Message &message : Flush())
+            {
+                QNET_CHECK(receiver.ApplyMessage(message));
+            }
+        }
+    };
+
+    bool IsUnreliable(const Message &message)
+    {
+        return message.size() > 1 && message[1] == uint8_t(QNET::PropertyClass::Unreliable);
+    }
+
+    /// @brief Unreliable updates never create entities, since they may overtake the reliable baseline.
+    void TestReliableOnlyCreation()
+    {
+        Link link;
+        const QNET::EntityId id = link.sender.CreateEntity();
+        link.sender.Set(link.sender.CreateEntity(), link.health, 7);
+        link.sender.Set(id, link.position, Vec2{1.0f, 2.0f});
+        const std::vector<Message> vecBaseline = link.Flush();
+        QNET_CHECK(!vecBaseline.empty());
+        for (const Message &message : vecBaseline)
+        {
+            QNET_CHECK(!IsUnreliable(message));
+        }
+
+        link.sender.Set(id, link.position, Vec2{3.0f, 4.0f});
+        const std::vector<Message> vecUpdate = link.Flush();
+        QNET_CHECK_EQ(vecUpdate.size(), size_t(1));
+        if (vecUpdate.size() != 1)
+            return;
+        QNET_CHECK(IsUnreliable(vecUpdate[0]));
+
+        // Ahead of the baseline, the update is skipped.
+        QNET_CHECK(link.receiver.ApplyMessage(vecUpdate[0]));
+        QNET_CHECK(!link.receiver.IsAlive(id));
+
+        for (const Message &message : vecBaseline)
+        {
+            QNET_CHECK(link.receiver.ApplyMessage(message));
+        }
+        QNET_CHECK(link.receiver.IsAlive(id));
+        QNET_CHECK_EQ(link.receiver.Get<Vec2>(id, link.position).y, 2.0f);
+        QNET_CHECK_EQ(link.receiver.Get<int32_t>(id + 1, link.health), 7);
+
+        QNET_CHECK(link.receiver.ApplyMessage(vecUpdate[0]));
+        QNET_CHECK_EQ(link.receiver.Get<Vec2>(id, link.position).y, 4.0f);
+    }
+
+    /// @brief Ids at or above SetMaxEntities() reject the whole message.
+    void TestEntityCap()
+    {
+        Link link;
+        for (int i = 0; i < 5; ++i)
+        {
+            link.sender.CreateEntity();
+        }
+        const std::vector<Message> vecBaseline = link.Flush();
+        QNET_CHECK_EQ(vecBaseline.size(), size_t(1));
+
+        link.receiver.SetMaxEntities(4);
+        for (const Message &message : vecBaseline)
+        {
+            QNET_CHECK(!link.receiver.ApplyMessage(message));
+        }
+        QNET_CHECK(!link.receiver.IsAlive(4));
+
+        link.receiver.SetMaxEntities(5);
+        for (const Message &message : vecBaseline)
+        {
+            QNET_CHECK(link.receiver.ApplyMessage(message));
+        }
+        QNET_CHECK(link.receiver.IsAlive(4));
+    }
+
+    /// @brief A lost unreliable update is repaired by the periodic refresh, and only by it.
+    void TestRefresh()
+    {
+        for (uint32_t nRefreshFlushes : {0u, 2u})
+        {
+            Link link;
+            link.sender.SetRefreshInterval(nRefreshFlushes);
+            const QNET::EntityId id = link.sender.CreateEntity();
+            link.sender.CreateEntity();
+            link.FlushAndApply();
+
+            link.sender.Set(id, link.position, Vec2{5.0f, 6.0f});
+            QNET_CHECK_EQ(link.Flush().size(), size_t(1)); // lost
+
+            for (int i = 0; i < 2; ++i)
+            {
+                link.FlushAndApply();
+            }
+            const float flExpected = nRefreshFlushes ? 6.0f : 0.0f;
+            QNET_CHECK_EQ(link.receiver.Get<Vec2>(id, link.position).y, flExpected);
+        }
+    }
+
+    /// @brief A late update for a destroyed entity is not applied to the entity that reuses its id.
+    void TestIdReuse()
+    {
+        Link link;
+        int nDestroyed = 0;
+        link.receiver.OnEntityDestroyed = [&nDestroyed](QNET::EntityId) { ++nDestroyed; };
+
+        const QNET::EntityId id = link.sender.CreateEntity();
+        link.FlushAndApply();
+
+        link.sender.Set(id, link.position, Vec2{1.0f, 1.0f});
+        const std::vector<Message> vecLate = link.Flush();
+        QNET_CHECK_EQ(vecLate.size(), size_t(1));
+
+        link.sender.DestroyEntity(id);
+        const QNET::EntityId idReused = link.sender.CreateEntity();
+        QNET_CHECK_EQ(idReused, id);
+        link.sender.Set(idReused, link.position, Vec2{2.0f, 2.0f});
+        const std::vector<Message> vecRecreate = link.Flush();
+        for (const Message &message : vecRecreate)
+        {
+            QNET_CHECK(link.receiver.ApplyMessage(message));
+        }
+        QNET_CHECK_EQ(nDestroyed, 1);
+        QNET_CHECK(link.receiver.IsAlive(id));
+        QNET_CHECK_EQ(link.receiver.Get<Vec2>(id, link.position).x, 2.0f);
+
+        for (const Message &message : vecLate)
+        {
+            QNET_CHECK(link.receiver.ApplyMessage(message));
+        }
+        QNET_CHECK_EQ(link.receiver.Get<Vec2>(id, link.position).x, 2.0f);
+
+        // A replayed destruction of the old entity does not destroy the new one.
+        for (const Message &message : vecRecreate)
+        {
+            QNET_CHECK(link.receiver.ApplyMessage(message));
+        }
+        QNET_CHECK_EQ(nDestroyed, 1);
+        QNET_CHECK(link.receiver.IsAlive(id));
+
+        link.sender.DestroyEntity(idReused);
+        link.FlushAndApply();
+        QNET_CHECK_EQ(nDestroyed, 2);
+        QNET_CHECK(!link.receiver.IsAlive(id));
+    }
+} // namespace
+
+int main()
+{
+    TestReliableOnlyCreation();
+    TestEntityCap();
+    TestRefresh();
+    TestIdReuse();
+    return QNET::Test::Finish("ReplicationTest");
+}
\ No newline at end of file
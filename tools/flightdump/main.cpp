@@ -0,0 +1,198 @@
+// qnet_flightdump: decodes the files written by QNET::FlightRecorder.
+//
+//   qnet_flightdump qnet_flight-1718000000000-0.qnfr
+//   qnet_flightdump --last 200 --min-us 5000 qnet_flight-1718000000000-0.qnfr
+//   qnet_flightdump --csv qnet_flight-1718000000000-0.qnfr > ticks.csv
+//
+// The default output is a summary (tick time percentiles, the slowest ticks and the connections that appear most
+// often among the worst) followed by one line per tick, with times relative to the tick that triggered the dump.
+
+#include "quicknet/components/FlightRecorder.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace
+{
+    void PrintUsage()
+    {
+        std::cerr << "Usage: qnet_flightdump [options] FILE\n"
+                     "  --csv                One CSV line per tick and connection instead of the report\n"
+                     "  --last N             Only the last N ticks\n"
+                     "  --min-us N           Only ticks that took at least N microseconds\n";
+    }
+
+    uint32_t Percentile(std::vector<uint32_t> vecSorted, double flFraction)
+    {
+        if (vecSorted.empty())
+            return 0;
+
+        std::sort(vecSorted.begin(), vecSorted.end());
+        const size_t nIndex = std::min(vecSorted.size() - 1, static_cast<size_t>(flFraction * vecSorted.size()));
+        return vecSorted[nIndex];
+    }
+
+    /// @brief Milliseconds of a tick relative to the trigger, e.g. "-1234.5".
+    std::string RelativeMs(const QNET::FlightTick &tick, SteamNetworkingMicroseconds usecTrigger)
+    {
+        std::ostringstream ss;
+        ss << std::fixed << std::setprecision(1) << (tick.usecTimestamp - usecTrigger) / 1000.0;
+        return ss.str();
+    }
+
+    void PrintCsv(const QNET::FlightDump &dump, const std::vector<const QNET::FlightTick *> &vecTicks)
+    {
+        std::cout << "offset_ms,duration_us,dispatch_us,messages,bytes,clients,authenticating,backlog,throttled,"
+                     "budget_exhausted,rank,conn,conn_us,conn_messages,conn_bytes,ping_ms,pending_reliable,"
+                     "pending_unreliable,queue_us\n";
+        for (const QNET::FlightTick *pTick : vecTicks)
+        {
+            const QNET::FlightTick &tick = *pTick;
+            std::ostringstream ssTick;
+            ssTick << RelativeMs(tick, dump.usecTrigger) << ',' << tick.usecDuration << ',' << tick.usecDispatch
+                   << ',' << tick.nMessages << ',' << tick.cbBytes << ',' << tick.nClients << ','
+                   << tick.nAuthenticating << ',' << tick.nBacklogConnections << ',' << tick.nThrottledConnections
+                   << ',' << (tick.bBudgetExhausted ? 1 : 0);
+
+            // A tick without connections still gets a line, with the connection columns empty.
+            if (tick.nWorstConnections == 0)
+            {
+                std::cout << ssTick.str() << ",,,,,,,,,\n";
+                continue;
+            }
+            for (uint32_t i = 0; i < tick.nWorstConnections; ++i)
+            {
+                const QNET::FlightConnection &conn = tick.aWorstConnections[i];
+                std::cout << ssTick.str() << ',' << i << ',' << conn.hConn << ',' << conn.usecTime << ','
+                          << conn.nMessages << ',' << conn.cbBytes << ',' << conn.nPingMs << ','
+                          << conn.cbPendingReliable << ',' << conn.cbPendingUnreliable << ',' << conn.usecQueueTime
+                          << '\n';
+            }
+        }
+    }
+
+    void PrintReport(const QNET::FlightDump &dump, const std::vector<const QNET::FlightTick *> &vecTicks)
+    {
+        std::vector<uint32_t> vecDurations;
+        std::map<HSteamNetConnection, std::pair<uint32_t, uint64_t>> mapWorst; // Appearances and total time.
+        for (const QNET::FlightTick *pTick : vecTicks)
+        {
+            vecDurations.push_back(pTick->usecDuration);
+            for (uint32_t i = 0; i < pTick->nWorstConnections; ++i)
+            {
+                auto &entry = mapWorst[pTick->aWorstConnections[i].hConn];
+                ++entry.first;
+                entry.second += pTick->aWorstConnections[i].usecTime;
+            }
+        }
+
+        std::cout << "reason:     " << dump.strReason << "\n"
+                  << "threshold:  " << dump.nThresholdMicroseconds << " us\n"
+                  << "ticks:      " << vecTicks.size() << " of " << dump.vecTicks.size() << "\n";
+        if (!dump.vecTicks.empty())
+        {
+            std::cout << "span:       "
+                      << (dump.vecTicks.back().usecTimestamp - dump.vecTicks.front().usecTimestamp) / 1000 << " ms\n";
+        }
+        std::cout << "tick us:    p50 " << Percentile(vecDurations, 0.50) << "  p99 " << Percentile(vecDurations, 0.99)
+                  << "  max " << Percentile(vecDurations, 1.0) << "\n";
+
+        std::vector<std::pair<HSteamNetConnection, std::pair<uint32_t, uint64_t>>> vecWorst(mapWorst.begin(),
+                                                                                            mapWorst.end());
+        std::sort(vecWorst.begin(), vecWorst.end(),
+                  [](const auto &a, const auto &b) { return a.second.second > b.second.second; });
+        if (!vecWorst.empty())
+        {
+            std::cout << "\nheaviest connections (ticks among the worst, dispatch time):\n";
+            for (size_t i = 0; i < std::min<size_t>(vecWorst.size(), 10); ++i)
+            {
+                std::cout << "  #" << std::left << std::setw(10) << vecWorst[i].first << std::right << std::setw(8)
+                          << vecWorst[i].second.first << " ticks " << std::setw(12) << vecWorst[i].second.second
+                          << " us\n";
+            }
+        }
+
+        std::cout << "\n" << std::setw(10) << "offset ms" << std::setw(10) << "tick us" << std::setw(10) << "disp us"
+                  << std::setw(8) << "msgs" << std::setw(10) << "bytes" << std::setw(8) << "clients" << std::setw(6)
+                  << "auth" << std::setw(8) << "backlog" << "  worst (conn:us/msgs ping queue)\n";
+        for (const QNET::FlightTick *pTick : vecTicks)
+        {
+            const QNET::FlightTick &tick = *pTick;
+            const bool bSlow = dump.nThresholdMicroseconds > 0 && tick.usecDuration > dump.nThresholdMicroseconds;
+            std::cout << std::setw(10) << RelativeMs(tick, dump.usecTrigger) << std::setw(10) << tick.usecDuration
+                      << std::setw(10) << tick.usecDispatch << std::setw(8) << tick.nMessages << std::setw(10)
+                      << tick.cbBytes << std::setw(8) << tick.nClients << std::setw(6) << tick.nAuthenticating
+                      << std::setw(8) << tick.nBacklogConnections << (tick.bBudgetExhausted ? "*" : " ")
+                      << (bSlow ? "!" : " ");
+            for (uint32_t i = 0; i < tick.nWorstConnections; ++i)
+            {
+                const QNET::FlightConnection &conn = tick.aWorstConnections[i];
+                std::cout << " #" << conn.hConn << ':' << conn.usecTime << '/' << conn.nMessages << ' '
+                          << conn.nPingMs << "ms " << conn.usecQueueTime / 1000 << "ms";
+            }
+            std::cout << "\n";
+        }
+        std::cout << "\n* receive budget exhausted   ! over the threshold\n";
+    }
+} // namespace
+
+int main(int argc, char **argv)
+{
+    bool bCsv = false;
+    size_t nLast = 0;
+    uint32_t usecMin = 0;
+    std::string strPath;
+
+    for (int i = 1; i < argc; ++i)
+    {
+        const std::string strArg = argv[i];
+        if (strArg == "--csv")
+            bCsv = true;
+        else if (strArg == "--last" && i + 1 < argc)
+            nLast = static_cast<size_t>(std::atoll(argv[++i]));
+        else if (strArg == "--min-us" && i + 1 < argc)
+            usecMin = static_cast<uint32_t>(std::atoll(argv[++i]));
+        else if (strPath.empty() && strArg.rfind("--", 0) != 0)
+            strPath = strArg;
+        else
+        {
+            PrintUsage();
+            return 1;
+        }
+    }
+
+    if (strPath.empty())
+    {
+        PrintUsage();
+        return 1;
+    }
+
+    QNET::FlightDump dump;
+    if (!QNET::FlightRecorder::ReadDump(strPath, dump))
+    {
+        std::cerr << "qnet_flightdump: " << strPath << " is not a readable flight recorder dump" << std::endl;
+        return 1;
+    }
+
+    const size_t nFirst = nLast > 0 && nLast < dump.vecTicks.size() ? dump.vecTicks.size() - nLast : 0;
+    std::vector<const QNET::FlightTick *> vecTicks;
+    for (size_t i = nFirst; i < dump.vecTicks.size(); ++i)
+    {
+        if (dump.vecTicks[i].usecDuration >= usecMin)
+        {
+            vecTicks.push_back(&dump.vecTicks[i]);
+        }
+    }
+
+    if (bCsv)
+        PrintCsv(dump, vecTicks);
+    else
+        PrintReport(dump, vecTicks);
+    return 0;
+}
\ No newline at end of file
@@ -0,0 +1,289 @@
+// qnet_handoff: moves live clients from one server process to another with QNET::SessionHandoff.
+//
+//   qnet_handoff serve  --port 27021 --http-port 8081
+//   qnet_handoff serve  --port 27020 --http-port 8080 --handoff-to http://127.0.0.1:8081 --reconnect 127.0.0.1:27021
+//   qnet_handoff client --address 127.0.0.1:27020 --connections 50 --duration 30
+//
+// Start the new process first, then the old one and the clients. Each client sends a message every 100 ms and the
+// server answers with the number of messages it has counted for the session; the old process hands its clients
+// off after --after seconds and exits. The count is the session state carried across, so a client that sees it
+// go back to zero lost its session. The client mode exits with 1 if any client lost its session or was
+// disconnected.
+
+#include "quicknet/components/Client.h"
+#include "quicknet/components/HttpServer.h"
+#include "quicknet/components/Server.h"
+#include "quicknet/components/SessionHandoff.h"
+
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <exception>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+namespace
+{
+    struct Options
+    {
+        uint16_t nPort = 27020;
+        uint16_t nHttpPort = 8080;
+        std::string strHandoffTo;
+        std::string strReconnect;
+        double flAfterSeconds = 10;
+        std::string strAddress = "127.0.0.1:27020";
+        int nConnections = 10;
+        double flDurationSeconds = 30;
+        std::string strBearerToken;
+    };
+
+    void PrintUsage()
+    {
+        std::cerr << "Usage:\n"
+                     "  qnet_handoff serve  [options]   Run a server that resumes handed-off sessions\n"
+                     "    --port N                      QNET::Server port (default 27020)\n"
+                     "    --http-port N                 HttpServer port receiving sessions (default 8080)\n"
+                     "    --handoff-to URL              Hand the clients off to this process, then exit\n"
+                     "    --reconnect HOST:PORT         Address the clients reconnect to (with --handoff-to)\n"
+                     "    --after S                     Seconds before handing off (default 10)\n"
+                     "  qnet_handoff client [options]   Run clients that check their sessions survive\n"
+                     "    --address HOST:PORT           Server address (default 127.0.0.1:27020)\n"
+                     "    --connections N               Number of clients (default 10)\n"
+                     "    --duration S                  Run time in seconds (default 30)\n"
+                     "  Common options:\n"
+                     "    --token T                     Bearer token shared by the two server processes (required)\n";
+    }
+
+    std::vector<uint8_t> EncodeCount(uint64_t nCount)
+    {
+        std::vector<uint8_t> byteMessage(sizeof(nCount));
+        std::memcpy(byteMessage.data(), &nCount, sizeof(nCount));
+        return byteMessage;
+    }
+
+    bool DecodeCount(const std::vector<uint8_t> &byteMessage, uint64_t &nCount)
+    {
+        if (byteMessage.size() != sizeof(nCount))
+            return false;
+
+        std::memcpy(&nCount, byteMessage.data(), sizeof(nCount));
+        return true;
+    }
+
+    int RunServe(const Options &options)
+    {
+        QNET::Server server;
+        if (!server.Initialize(options.nPort))
+            return 1;
+
+        QNET::SessionHandoffConfig config;
+        config.strBearerToken = options.strBearerToken;
+        QNET::SessionHandoff handoff(server, config);
+
+        // The session state: messages counted per client.
+        std::unordered_map<HSteamNetConnection, uint64_t> mapCounts;
+        server.OnClientConnected = [&mapCounts](HSteamNetConnection hConn) { mapCounts[hConn] = 0; };
+        server.OnClientDisconnected = [&mapCounts](HSteamNetConnection hConn) { mapCounts.erase(hConn); };
+        server.OnMessageReceived = [&](HSteamNetConnection hConn, const std::vector<uint8_t> &)
+        { server.SendReliableMessage(hConn, EncodeCount(++mapCounts[hConn])); };
+        handoff.OnExportSession = [&mapCounts](HSteamNetConnection hConn) { return EncodeCount(mapCounts[hConn]); };
+        handoff.OnSessionResumed = [&mapCounts](HSteamNetConnection hConn, const QNET::SessionState &state)
+        { DecodeCount(state.vecAppState, mapCounts[hConn]); };
+
+        QNET::HttpServer httpServer;
+        if (!handoff.ServeHandoff(httpServer))
+            return 1;
+
+        std::thread httpThread(
+            [&httpServer, &options]()
+            {
+                try
+                {
+                    httpServer.Run(options.nHttpPort);
+                }
+                catch (const std::exception &e)
+                {
+                    std::cerr << "qnet_handoff: " << e.what() << std::endl;
+                }
+            });
+
+        // The handoff runs on the network thread; the process then lingers long enough for the closes to reach
+        // the clients.
+        std::chrono::steady_clock::time_point tStart = std::chrono::steady_clock::now();
+        std::chrono::steady_clock::time_point tHandedOff;
+        bool bHandedOff = false;
+        server.AddTickHandler(
+            [&]()
+            {
+                const std::chrono::steady_clock::time_point tNow = std::chrono::steady_clock::now();
+                if (options.strHandoffTo.empty())
+                    return;
+
+                if (bHandedOff)
+                {
+                    if (tNow - tHandedOff > std::chrono::seconds(2))
+                    {
+                        server.Stop();
+                    }
+                    return;
+                }
+
+                if (tNow - tStart < std::chrono::duration<double>(options.flAfterSeconds))
+                    return;
+
+                std::string strError;
+                const size_t nClients = server.GetClients().size();
+                if (!handoff.HandOff(options.strHandoffTo, options.strReconnect, &strError))
+                {
+                    std::cerr << "qnet_handoff: handoff failed, still serving: " << strError << std::endl;
+                    tStart = tNow;
+                    return;
+                }
+                const auto msTaken =
+                    std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - tNow);
+                std::cout << "qnet_handoff: handed " << nClients << " clients off in " << msTaken.count() << " ms"
+                          << std::endl;
+                bHandedOff = true;
+                tHandedOff = tNow;
+            });
+
+        // Runs until the process is terminated, or until shortly after the handoff.
+        server.Run();
+
+        httpServer.Stop();
+        httpThread.join();
+        return 0;
+    }
+
+    int RunClients(const Options &options)
+    {
+        struct Connection
+        {
+            std::unique_ptr<QNET::Client> pClient;
+            uint64_t nLastCount = 0;
+            int nHandoffs = 0;
+            bool bLostSession = false;
+            bool bDisconnected = false;
+        };
+
+        std::vector<Connection> vecConnections(static_cast<size_t>(options.nConnections));
+        for (Connection &conn : vecConnections)
+        {
+            conn.pClient = std::make_unique<QNET::Client>();
+            conn.pClient->OnMessageReceived = [&conn](const std::vector<uint8_t> &byteMessage)
+            {
+                uint64_t nCount = 0;
+                if (!DecodeCount(byteMessage, nCount))
+                    return;
+
+                if (nCount <= conn.nLastCount && !conn.bLostSession)
+                {
+                    std::cerr << "qnet_handoff: a client's count went from " << conn.nLastCount << " to " << nCount
+                              << "; its session was lost" << std::endl;
+                    conn.bLostSession = true;
+                }
+                conn.nLastCount = nCount;
+            };
+            conn.pClient->OnHandoff = [&conn](const std::string &) { ++conn.nHandoffs; };
+            conn.pClient->OnDisconnected = [&conn]() { conn.bDisconnected = true; };
+            if (!conn.pClient->Connect(options.strAddress))
+                return 1;
+        }
+
+        const std::chrono::steady_clock::time_point tEnd =
+            std::chrono::steady_clock::now() + std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+                                                   std::chrono::duration<double>(options.flDurationSeconds));
+        std::chrono::steady_clock::time_point tNextSend = std::chrono::steady_clock::now();
+        while (std::chrono::steady_clock::now() < tEnd)
+        {
+            const bool bSend = std::chrono::steady_clock::now() >= tNextSend;
+            if (bSend)
+            {
+                tNextSend += std::chrono::milliseconds(100);
+            }
+            for (Connection &conn : vecConnections)
+            {
+                conn.pClient->Poll();
+                conn.pClient->ReceiveMessages();
+                if (bSend && conn.pClient->IsConnected())
+                {
+                    conn.pClient->SendReliableMessageToServer(EncodeCount(0));
+                }
+            }
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        }
+
+        int nHandedOff = 0;
+        int nLost = 0;
+        int nDisconnected = 0;
+        for (Connection &conn : vecConnections)
+        {
+            nHandedOff += conn.nHandoffs > 0 ? 1 : 0;
+            nLost += conn.bLostSession ? 1 : 0;
+            nDisconnected += conn.bDisconnected ? 1 : 0;
+            conn.pClient->Disconnect();
+        }
+        std::cout << "clients: " << vecConnections.size() << "  handed off: " << nHandedOff
+                  << "  lost session: " << nLost << "  disconnected: " << nDisconnected << std::endl;
+        return nLost == 0 && nDisconnected == 0 ? 0 : 1;
+    }
+} // namespace
+
+int main(int argc, char **argv)
+{
+    if (argc < 2)
+    {
+        PrintUsage();
+        return 1;
+    }
+
+    const std::string strMode = argv[1];
+    Options options;
+    for (int i = 2; i < argc; ++i)
+    {
+        const std::string strArg = argv[i];
+        if (i + 1 >= argc)
+        {
+            PrintUsage();
+            return 1;
+        }
+
+        const std::string strValue = argv[++i];
+        if (strArg == "--port")
+            options.nPort = static_cast<uint16_t>(std::atoi(strValue.c_str()));
+        else if (strArg == "--http-port")
+            options.nHttpPort = static_cast<uint16_t>(std::atoi(strValue.c_str()));
+        else if (strArg == "--handoff-to")
+            options.strHandoffTo = strValue;
+        else if (strArg == "--reconnect")
+            options.strReconnect = strValue;
+        else if (strArg == "--after")
+            options.flAfterSeconds = std::atof(strValue.c_str());
+        else if (strArg == "--address")
+            options.strAddress = strValue;
+        else if (strArg == "--connections")
+            options.nConnections = std::atoi(strValue.c_str());
+        else if (strArg == "--duration")
+            options.flDurationSeconds = std::atof(strValue.c_str());
+        else if (strArg == "--token")
+            options.strBearerToken = strValue;
+        else
+        {
+            PrintUsage();
+            return 1;
+        }
+    }
+
+    if (strMode == "serve" && options.strHandoffTo.empty() == options.strReconnect.empty())
+        return RunServe(options);
+
+    if (strMode == "client" && options.nConnections > 0)
+        return RunClients(options);
+
+    PrintUsage();
+    return 1;
+}
\ No newline at end of file
@@ -0,0 +1,201 @@
+#include "HttpLoad.h"
+
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <iostream>
+#include <mutex>
+#include <random>
+#include <thread>
+
+namespace LoadGen
+{
+    namespace
+    {
+        using Clock = std::chrono::steady_clock;
+
+        /// @brief Requests scheduled but not yet picked up are capped, so a dead server cannot exhaust memory.
+        constexpr size_t kMaxQueuedRequests = 1000000;
+
+        struct ScheduledRequest
+        {
+            Clock::time_point tScheduled;
+            size_t nRoute;
+        };
+
+        /// @brief State shared by the scheduler and the worker connections.
+        struct SharedState
+        {
+            std::mutex queueMutex;
+            std::condition_variable queueCondition;
+            std::deque<ScheduledRequest> dequeRequests;
+            bool bStopping = false;
+
+            std::mutex statsMutex;
+            IntervalSample current;
+        };
+
+        httplib::Result Issue(httplib::Client &client, const HttpRoute &route, const std::string &strBody)
+        {
+            if (route.strMethod == "POST")
+                return client.Post(route.strPath, strBody, "application/octet-stream");
+            if (route.strMethod == "PUT")
+                return client.Put(route.strPath, strBody, "application/octet-stream");
+            if (route.strMethod == "DELETE")
+                return client.Delete(route.strPath);
+            return client.Get(route.strPath);
+        }
+
+        void WorkerLoop(const HttpLoadOptions &options, SharedState &state)
+        {
+            httplib::Client client(options.strUrl);
+            client.set_keep_alive(options.bKeepAlive);
+            client.set_connection_timeout(options.nTimeoutMs / 1000, (options.nTimeoutMs % 1000) * 1000);
+            client.set_read_timeout(options.nTimeoutMs / 1000, (options.nTimeoutMs % 1000) * 1000);
+
+            const std::string strBody(options.cbBody, 'x');
+            while (true)
+            {
+                ScheduledRequest request;
+                {
+                    std::unique_lock<std::mutex> lock(state.queueMutex);
+                    state.queueCondition.wait(lock, [&]() { return state.bStopping || !state.dequeRequests.empty(); });
+                    if (state.bStopping)
+                        return;
+
+                    request = state.dequeRequests.front();
+                    state.dequeRequests.pop_front();
+                }
+
+                {
+                    std::lock_guard<std::mutex> lock(state.statsMutex);
+                    ++state.current.nSent;
+                }
+
+                httplib::Result result = Issue(client, options.vecRoutes[request.nRoute], strBody);
+                const Clock::time_point tDone = Clock::now();
+                const bool bSuccess = result && result->status < 400;
+
+                std::lock_guard<std::mutex> lock(state.statsMutex);
+                if (bSuccess)
+                {
+                    ++state.current.nCompleted;
+                    state.current.histLatency.Record(uint64_t(
+                        std::chrono::duration_cast<std::chrono::microseconds>(tDone - request.tScheduled).count()));
+                }
+                else
+                {
+                    ++state.current.nErrors;
+                }
+            }
+        }
+    } // namespace
+
+    bool RunHttpLoad(const HttpLoadOptions &options, LoadReport &report)
+    {
+        if (options.vecRoutes.empty() || options.nConcurrency <= 0 || options.flRate <= 0)
+            return false;
+
+        SharedState state;
+        std::vector<std::thread> vecWorkers;
+        for (int i = 0; i < options.nConcurrency; ++i)
+        {
+            vecWorkers.emplace_back(WorkerLoop, std::cref(options), std::ref(state));
+        }
+
+        std::mt19937 rng(options.nSeed);
+        std::vector<uint32_t> vecWeights;
+        for (const HttpRoute &route : options.vecRoutes)
+        {
+            vecWeights.push_back(route.nWeight);
+        }
+        std::discrete_distribution<size_t> routeDistribution(vecWeights.begin(), vecWeights.end());
+
+        const Clock::duration sendInterval =
+            std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(1.0 / options.flRate));
+        const Clock::duration reportInterval =
+            std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(options.flIntervalSeconds));
+        const Clock::time_point tStart = Clock::now();
+        const Clock::time_point tEnd = tStart + std::chrono::duration_cast<Clock::duration>(
+                                                    std::chrono::duration<double>(options.flDurationSeconds));
+
+        auto CloseInterval = [&](Clock::time_point tNow, Clock::time_point tIntervalStart)
+        {
+            IntervalSample sample;
+            {
+                std::lock_guard<std::mutex> lock(state.statsMutex);
+                std::swap(sample, state.current);
+            }
+            sample.flEndSeconds = std::chrono::duration<double>(tNow - tStart).count();
+            sample.flSeconds = std::chrono::duration<double>(tNow - tIntervalStart).count();
+            report.AddInterval(sample);
+        };
+
+        // Open-loop schedule: requests are queued at their scheduled times whether or not a worker is free.
+        Clock::time_point tNextRequest = tStart;
+        Clock::time_point tIntervalStart = tStart;
+        Clock::time_point tNextReport = tStart + reportInterval;
+        for (Clock::time_point tNow = tStart; tNow < tEnd; tNow = Clock::now())
+        {
+            size_t nDropped = 0;
+            {
+                std::lock_guard<std::mutex> lock(state.queueMutex);
+                while (tNextRequest <= tNow && tNextRequest < tEnd)
+                {
+                    if (state.dequeRequests.size() < kMaxQueuedRequests)
+                        state.dequeRequests.push_back({tNextRequest, routeDistribution(rng)});
+                    else
+                        ++nDropped;
+                    tNextRequest += sendInterval;
+                }
+            }
+            state.queueCondition.notify_all();
+
+            if (nDropped > 0)
+            {
+                std::lock_guard<std::mutex> lock(state.statsMutex);
+                state.current.nErrors += nDropped;
+            }
+
+            if (tNow >= tNextReport)
+            {
+                CloseInterval(tNow, tIntervalStart);
+                tIntervalStart = tNow;
+                tNextReport += reportInterval;
+            }
+
+            std::this_thread::sleep_until(std::min(tNextRequest, tNextReport));
+        }
+
+        // Requests still queued at the end were never issued; in-flight ones are waited for.
+        size_t nUnsent = 0;
+        {
+            std::lock_guard<std::mutex> lock(state.queueMutex);
+            nUnsent = state.dequeRequests.size();
+            state.dequeRequests.clear();
+            state.bStopping = true;
+        }
+        state.queueCondition.notify_all();
+        for (std::thread &worker : vecWorkers)
+        {
+            worker.join();
+        }
+
+        if (nUnsent > 0)
+        {
+            std::cerr << "qnet_loadgen: " << nUnsent << " scheduled requests were never issued." << std::endl;
+            std::lock_guard<std::mutex> lock(state.statsMutex);
+            state.current.nErrors += nUnsent;
+        }
+        CloseInterval(Clock::now(), tIntervalStart);
+        return true;
+    }
+
+    void RegisterHttpEchoRoutes(QNET::HttpServer &server)
+    {
+        server.Get("/", [](const QNET::Request &, QNET::Response &res) { res.set_content("ok", "text/plain"); });
+        server.Post("/echo", [](const QNET::Request &req, QNET::Response &res)
+                    { res.set_content(req.body, "application/octet-stream"); });
+    }
+} // namespace LoadGen
\ No newline at end of file
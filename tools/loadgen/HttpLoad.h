@@ -0,0 +1,54 @@
+#pragma once
+
+#include "LoadReport.h"
+
+#include "quicknet/components/HttpServer.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace LoadGen
+{
+    /// @brief A request the HTTP load is made of, picked in proportion to its weight.
+    struct HttpRoute
+    {
+        std::string strMethod = "GET";
+        std::string strPath = "/";
+        uint32_t nWeight = 1;
+    };
+
+    /// @brief Settings for a load run against an HttpServer.
+    struct HttpLoadOptions
+    {
+        std::string strUrl = "http://127.0.0.1:8080";
+        std::vector<HttpRoute> vecRoutes = {HttpRoute()};
+
+        /// @brief Requests per second, scheduled open-loop, and the number of connections issuing them.
+        double flRate = 100.0;
+        int nConcurrency = 16;
+
+        double flDurationSeconds = 10.0;
+        double flIntervalSeconds = 1.0;
+
+        /// @brief Reuse connections between requests (HTTP keep-alive).
+        bool bKeepAlive = true;
+
+        /// @brief Size of the body sent with POST and PUT requests.
+        size_t cbBody = 0;
+
+        int nTimeoutMs = 5000;
+        uint32_t nSeed = 1;
+    };
+
+    /// @brief Issues the configured request mix for the configured time and reports every interval.
+    /// @details Requests are scheduled at fixed times and queued for nConcurrency worker connections; latency is
+    /// measured from the scheduled time, so a saturated server shows up as queueing latency instead of a silently
+    /// reduced request rate. Responses with a status of 400 or above count as errors.
+    /// @return False if the options are invalid.
+    bool RunHttpLoad(const HttpLoadOptions &options, LoadReport &report);
+
+    /// @brief Registers the routes the HTTP load uses by default: GET / and POST /echo (returns the body).
+    void RegisterHttpEchoRoutes(QNET::HttpServer &server);
+} // namespace LoadGen
\ No newline at end of file
@@ -0,0 +1,99 @@
+#pragma once
+
+#include "quicknet/components/BitStream.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+namespace LoadGen
+{
+    /// @brief Log-linear histogram of latencies in microseconds, with under 1% relative error.
+    /// @details Values below 2^kSubBucketBits are counted exactly; above that, every power-of-two range is split into
+    /// 2^kSubBucketBits equal buckets. Recording is O(1) and the bucket array only grows as far as the largest value
+    /// seen, so keeping one histogram per reporting interval is cheap.
+    class LatencyHistogram
+    {
+    public:
+        void Record(uint64_t usecValue)
+        {
+            const size_t nIndex = BucketIndex(usecValue);
+            if (nIndex >= m_vecCounts.size())
+            {
+                m_vecCounts.resize(nIndex + 1, 0);
+            }
+            ++m_vecCounts[nIndex];
+            ++m_nCount;
+            m_usecSum += usecValue;
+            m_usecMax = std::max(m_usecMax, usecValue);
+        }
+
+        void Merge(const LatencyHistogram &other)
+        {
+            if (other.m_vecCounts.size() > m_vecCounts.size())
+            {
+                m_vecCounts.resize(other.m_vecCounts.size(), 0);
+            }
+            for (size_t i = 0; i < other.m_vecCounts.size(); ++i)
+            {
+                m_vecCounts[i] += other.m_vecCounts[i];
+            }
+            m_nCount += other.m_nCount;
+            m_usecSum += other.m_usecSum;
+            m_usecMax = std::max(m_usecMax, other.m_usecMax);
+        }
+
+        uint64_t GetCount() const { return m_nCount; }
+        uint64_t GetMax() const { return m_usecMax; }
+        double GetMean() const { return m_nCount ? double(m_usecSum) / double(m_nCount) : 0.0; }
+
+        /// @brief Returns the smallest bucket bound that at least flPercentile percent of the samples do not exceed.
+        uint64_t GetPercentile(double flPercentile) const
+        {
+            if (m_nCount == 0)
+                return 0;
+
+            const uint64_t nRank =
+                std::max<uint64_t>(1, static_cast<uint64_t>(std::ceil(flPercentile / 100.0 * double(m_nCount))));
+            uint64_t nSeen = 0;
+            for (size_t i = 0; i < m_vecCounts.size(); ++i)
+            {
+                nSeen += m_vecCounts[i];
+                if (nSeen >= nRank)
+                    return std::min(BucketUpperBound(i), m_usecMax);
+            }
+            return m_usecMax;
+        }
+
+    private:
+        static constexpr int kSubBucketBits = 7;
+        static constexpr uint64_t kSubBucketCount = uint64_t(1) << kSubBucketBits;
+
+        static size_t BucketIndex(uint64_t nValue)
+        {
+            if (nValue < kSubBucketCount)
+                return static_cast<size_t>(nValue);
+
+            const int nShift = QNET::BitsRequired(nValue) - 1 - kSubBucketBits;
+            const uint64_t nSubBucket = (nValue >> nShift) & (kSubBucketCount - 1);
+            return static_cast<size_t>((uint64_t(nShift + 1) << kSubBucketBits) + nSubBucket);
+        }
+
+        static uint64_t BucketUpperBound(size_t nIndex)
+        {
+            if (nIndex < kSubBucketCount)
+                return nIndex;
+
+            const int nShift = static_cast<int>(nIndex >> kSubBucketBits) - 1;
+            const uint64_t nSubBucket = nIndex & (kSubBucketCount - 1);
+            return ((kSubBucketCount + nSubBucket + 1) << nShift) - 1;
+        }
+
+    private:
+        std::vector<uint64_t> m_vecCounts;
+        uint64_t m_nCount = 0;
+        uint64_t m_usecSum = 0;
+        uint64_t m_usecMax = 0;
+    };
+} // namespace LoadGen
\ No newline at end of file
@@ -0,0 +1,157 @@
+#include "LoadReport.h"
+
+#include "quicknet/components/Json.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+
+namespace LoadGen
+{
+    namespace
+    {
+        double ToMs(uint64_t usecValue) { return double(usecValue) / 1000.0; }
+
+        void WriteLatency(QNET::JsonWriter &writer, const LatencyHistogram &hist)
+        {
+            writer.BeginObject();
+            writer.Key("count").UInt(hist.GetCount());
+            writer.Key("mean").Double(hist.GetMean() / 1000.0);
+            writer.Key("p50").Double(ToMs(hist.GetPercentile(50)));
+            writer.Key("p90").Double(ToMs(hist.GetPercentile(90)));
+            writer.Key("p99").Double(ToMs(hist.GetPercentile(99)));
+            writer.Key("p999").Double(ToMs(hist.GetPercentile(99.9)));
+            writer.Key("max").Double(ToMs(hist.GetMax()));
+            writer.EndObject();
+        }
+
+        void WriteSample(QNET::JsonWriter &writer, const IntervalSample &sample)
+        {
+            const double flSeconds = std::max(sample.flSeconds, 1e-9);
+
+            writer.BeginObject();
+            writer.Key("end_s").Double(sample.flEndSeconds);
+            writer.Key("duration_s").Double(sample.flSeconds);
+            writer.Key("sent").UInt(sample.nSent);
+            writer.Key("completed").UInt(sample.nCompleted);
+            writer.Key("errors").UInt(sample.nErrors);
+            writer.Key("sent_per_s").Double(sample.nSent / flSeconds);
+            writer.Key("completed_per_s").Double(sample.nCompleted / flSeconds);
+            writer.Key("latency_ms");
+            WriteLatency(writer, sample.histLatency);
+            if (sample.histAck.GetCount() > 0)
+            {
+                writer.Key("ack_ms");
+                WriteLatency(writer, sample.histAck);
+            }
+            if (sample.flPingMs >= 0)
+            {
+                writer.Key("ping_ms").Double(sample.flPingMs);
+            }
+            if (sample.flMaxQueueMs >= 0)
+            {
+                writer.Key("max_queue_ms").Double(sample.flMaxQueueMs);
+            }
+            writer.EndObject();
+        }
+    } // namespace
+
+    void IntervalSample::Merge(const IntervalSample &other)
+    {
+        flEndSeconds = std::max(flEndSeconds, other.flEndSeconds);
+        flSeconds += other.flSeconds;
+        nSent += other.nSent;
+        nCompleted += other.nCompleted;
+        nErrors += other.nErrors;
+        histLatency.Merge(other.histLatency);
+        histAck.Merge(other.histAck);
+        flPingMs = std::max(flPingMs, other.flPingMs);
+        flMaxQueueMs = std::max(flMaxQueueMs, other.flMaxQueueMs);
+    }
+
+    LoadReport::LoadReport(std::string strMode, std::string strLatencyName, std::ostream &out)
+        : m_strMode(std::move(strMode)), m_strLatencyName(std::move(strLatencyName)), m_out(out)
+    {
+    }
+
+    void LoadReport::AddConfig(const std::string &strKey, const std::string &strValue)
+    {
+        m_vecConfig.emplace_back(strKey, strValue);
+    }
+
+    void LoadReport::AddInterval(const IntervalSample &sample)
+    {
+        char szLabel[32];
+        std::snprintf(szLabel, sizeof(szLabel), "%7.1fs", sample.flEndSeconds);
+        PrintSample(szLabel, sample);
+
+        m_vecIntervals.push_back(sample);
+        m_total.Merge(sample);
+    }
+
+    void LoadReport::PrintSummary()
+    {
+        m_out << "\n";
+        PrintSample("   total", m_total);
+    }
+
+    bool LoadReport::WriteJson(const std::string &strPath) const
+    {
+        QNET::JsonWriter writer;
+        writer.BeginObject();
+        writer.Key("mode").String(m_strMode);
+
+        writer.Key("config").BeginObject();
+        for (const auto &config : m_vecConfig)
+        {
+            writer.Key(config.first).String(config.second);
+        }
+        writer.EndObject();
+
+        writer.Key("intervals").BeginArray();
+        for (const IntervalSample &sample : m_vecIntervals)
+        {
+            WriteSample(writer, sample);
+        }
+        writer.EndArray();
+
+        writer.Key("total");
+        WriteSample(writer, m_total);
+        writer.EndObject();
+
+        std::ofstream file(strPath, std::ios::binary | std::ios::trunc);
+        if (!file)
+            return false;
+
+        file << writer.GetString() << "\n";
+        return bool(file);
+    }
+
+    /// @brief One line: throughput, then latency percentiles in milliseconds.
+    void LoadReport::PrintSample(const char *pszLabel, const IntervalSample &sample)
+    {
+        const double flSeconds = std::max(sample.flSeconds, 1e-9);
+        const LatencyHistogram &hist = sample.histLatency;
+
+        char szLine[512];
+        int nLength = std::snprintf(szLine, sizeof(szLine),
+                                    "%s  sent %9.1f/s  done %9.1f/s  err %6llu  %s ms p50 %8.2f p90 %8.2f p99 %8.2f "
+                                    "p99.9 %8.2f max %8.2f",
+                                    pszLabel, sample.nSent / flSeconds, sample.nCompleted / flSeconds,
+                                    (unsigned long long)sample.nErrors, m_strLatencyName.c_str(),
+                                    ToMs(hist.GetPercentile(50)), ToMs(hist.GetPercentile(90)),
+                                    ToMs(hist.GetPercentile(99)), ToMs(hist.GetPercentile(99.9)), ToMs(hist.GetMax()));
+
+        if (sample.histAck.GetCount() > 0 && nLength > 0 && size_t(nLength) < sizeof(szLine))
+        {
+            nLength += std::snprintf(szLine + nLength, sizeof(szLine) - nLength, "  ack ms p50 %8.2f p99 %8.2f",
+                                     ToMs(sample.histAck.GetPercentile(50)), ToMs(sample.histAck.GetPercentile(99)));
+        }
+        if (sample.flPingMs >= 0 && nLength > 0 && size_t(nLength) < sizeof(szLine))
+        {
+            std::snprintf(szLine + nLength, sizeof(szLine) - nLength, "  ping %5.1f ms  queue %7.2f ms",
+                          sample.flPingMs, sample.flMaxQueueMs);
+        }
+        m_out << szLine << std::endl;
+    }
+} // namespace LoadGen
\ No newline at end of file
@@ -0,0 +1,74 @@
+#pragma once
+
+#include "LatencyHistogram.h"
+
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace LoadGen
+{
+    /// @brief Measurements for one reporting interval (or, summed, for the whole run).
+    struct IntervalSample
+    {
+        /// @brief End of the interval and its length, in seconds since the start of the run.
+        double flEndSeconds = 0.0;
+        double flSeconds = 0.0;
+
+        /// @brief Messages or requests issued, answered, and failed (including dropped because the client fell
+        /// too far behind the schedule).
+        uint64_t nSent = 0;
+        uint64_t nCompleted = 0;
+        uint64_t nErrors = 0;
+
+        /// @brief Time from the scheduled send to the echo or response.
+        LatencyHistogram histLatency;
+
+        /// @brief Time from the scheduled send to the delivery receipt (reliable messages only).
+        LatencyHistogram histAck;
+
+        /// @brief Average ping and largest send queue time across connections; negative when not measured.
+        double flPingMs = -1.0;
+        double flMaxQueueMs = -1.0;
+
+        /// @brief Adds another sample's counts and latencies to this one; ping and queue time keep the worst value.
+        void Merge(const IntervalSample &other);
+    };
+
+    /// @brief Prints interval lines and a summary, and exports the whole run as JSON.
+    class LoadReport
+    {
+    public:
+        /// @param strMode "net" or "http", recorded in the JSON output.
+        /// @param strLatencyName How the main latency is labelled on the console, e.g. "rtt".
+        /// @param out Where the console report is written.
+        LoadReport(std::string strMode, std::string strLatencyName, std::ostream &out);
+
+        /// @brief Records a setting, echoed in the JSON output.
+        void AddConfig(const std::string &strKey, const std::string &strValue);
+
+        /// @brief Prints one interval line and keeps the interval for the summary and JSON output.
+        void AddInterval(const IntervalSample &sample);
+
+        /// @brief Prints the totals over all intervals.
+        void PrintSummary();
+
+        /// @brief Writes the configuration, every interval and the totals to a file.
+        /// @return False if the file could not be written.
+        bool WriteJson(const std::string &strPath) const;
+
+    private:
+        void PrintSample(const char *pszLabel, const IntervalSample &sample);
+
+    private:
+        std::string m_strMode;
+        std::string m_strLatencyName;
+        std::ostream &m_out;
+
+        std::vector<std::pair<std::string, std::string>> m_vecConfig;
+        std::vector<IntervalSample> m_vecIntervals;
+        IntervalSample m_total;
+    };
+} // namespace LoadGen
\ No newline at end of file
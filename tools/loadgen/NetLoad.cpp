@@ -0,0 +1,281 @@
+#include "NetLoad.h"
+
+#include "quicknet/components/Client.h"
+
+#include <steam/isteamnetworkingutils.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <deque>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <thread>
+
+namespace LoadGen
+{
+    namespace
+    {
+        using Clock = std::chrono::steady_clock;
+
+        constexpr uint32_t kHeaderMagic = 0x31474C51; // "QLG1"
+        constexpr uint8_t kHeaderFlagReliable = 0x01;
+
+        /// @brief Prefix of every load message. Echoed back verbatim by EchoLoadMessage().
+        struct LoadHeader
+        {
+            uint32_t nMagic;
+            uint8_t nFlags;
+            uint8_t nLane;
+            uint16_t nReserved;
+            uint64_t nSequence;
+            int64_t usecScheduled;
+        };
+        static_assert(sizeof(LoadHeader) == 24, "LoadHeader must be tightly packed");
+
+        bool ReadHeader(const std::vector<uint8_t> &byteMessage, LoadHeader &header)
+        {
+            if (byteMessage.size() < sizeof(LoadHeader))
+                return false;
+
+            std::memcpy(&header, byteMessage.data(), sizeof(LoadHeader));
+            return header.nMagic == kHeaderMagic;
+        }
+
+        /// @brief One load connection and the reliable messages still waiting for their delivery receipt.
+        struct LoadConnection
+        {
+            std::unique_ptr<QNET::Client> pClient;
+            bool bConnected = false;
+
+            /// @brief Message number and scheduled send time, oldest first.
+            std::deque<std::pair<int64, int64_t>> dequeUnacked;
+        };
+    } // namespace
+
+    bool RunNetLoad(const NetLoadOptions &options, LoadReport &report)
+    {
+        const Clock::time_point tEpoch = Clock::now();
+        auto UsecSinceEpoch = [tEpoch](Clock::time_point t)
+        { return std::chrono::duration_cast<std::chrono::microseconds>(t - tEpoch).count(); };
+
+        // Delivery receipts assume in-order acknowledgement, which only holds for a single lane.
+        const bool bReceipts = options.vecLaneWeights.size() <= 1;
+
+        IntervalSample current;
+        std::vector<LoadConnection> vecConnections(options.nConnections);
+        for (int i = 0; i < options.nConnections; ++i)
+        {
+            LoadConnection &conn = vecConnections[i];
+            conn.pClient = std::make_unique<QNET::Client>();
+            conn.pClient->OnConnected = [&conn]() { conn.bConnected = true; };
+            conn.pClient->OnMessageReceived = [&](const std::vector<uint8_t> &byteMessage)
+            {
+                LoadHeader header;
+                if (!ReadHeader(byteMessage, header))
+                    return;
+
+                ++current.nCompleted;
+                current.histLatency.Record(uint64_t(std::max<int64_t>(0, UsecSinceEpoch(Clock::now()) -
+                                                                              header.usecScheduled)));
+            };
+            conn.pClient->OnDeliveryReceipt = [&](HSteamNetConnection, int64 nMessageNumber)
+            {
+                const int64_t usecNow = UsecSinceEpoch(Clock::now());
+                while (!conn.dequeUnacked.empty() && conn.dequeUnacked.front().first <= nMessageNumber)
+                {
+                    current.histAck.Record(uint64_t(std::max<int64_t>(0, usecNow - conn.dequeUnacked.front().second)));
+                    conn.dequeUnacked.pop_front();
+                }
+            };
+
+            if (!conn.pClient->Connect(options.strAddress))
+                return false;
+        }
+
+        // Wait for every handshake before the clock starts.
+        const Clock::time_point tConnectDeadline = Clock::now() + std::chrono::seconds(10);
+        int nConnected = 0;
+        while (nConnected < options.nConnections && Clock::now() < tConnectDeadline)
+        {
+            nConnected = 0;
+            for (LoadConnection &conn : vecConnections)
+            {
+                conn.pClient->Poll();
+                nConnected += conn.bConnected ? 1 : 0;
+            }
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        if (nConnected < options.nConnections)
+        {
+            std::cerr << "qnet_loadgen: only " << nConnected << " of " << options.nConnections
+                      << " connections were established." << std::endl;
+            return false;
+        }
+
+        std::vector<int> vecLanePriorities(options.vecLaneWeights.size(), 0);
+        for (LoadConnection &conn : vecConnections)
+        {
+            const HSteamNetConnection hConn = conn.pClient->GetConnection();
+            if (!options.vecLaneWeights.empty() &&
+                !conn.pClient->ConfigureLanes(hConn, vecLanePriorities, options.vecLaneWeights))
+            {
+                std::cerr << "qnet_loadgen: failed to configure lanes." << std::endl;
+                return false;
+            }
+            conn.pClient->EnableDeliveryReceipts(hConn, bReceipts);
+        }
+
+        std::mt19937 rng(options.nSeed);
+        std::vector<uint32_t> vecSizeWeights;
+        for (const auto &size : options.vecSizeMix)
+        {
+            vecSizeWeights.push_back(size.second);
+        }
+        std::discrete_distribution<size_t> sizeDistribution(vecSizeWeights.begin(), vecSizeWeights.end());
+        std::discrete_distribution<uint16_t> laneDistribution(options.vecLaneWeights.begin(),
+                                                              options.vecLaneWeights.end());
+        std::bernoulli_distribution reliableDistribution(std::min(std::max(options.flReliableRatio, 0.0), 1.0));
+
+        uint64_t nSequence = 0;
+        auto SendOne = [&](Clock::time_point tScheduled)
+        {
+            LoadConnection &conn = vecConnections[nSequence % vecConnections.size()];
+            const uint32_t cbRequested = options.vecSizeMix[sizeDistribution(rng)].first;
+            const uint32_t cbSize = std::max<uint32_t>(sizeof(LoadHeader), cbRequested);
+            const bool bReliable = reliableDistribution(rng);
+            const uint16_t nLane = options.vecLaneWeights.size() > 1 ? laneDistribution(rng) : 0;
+
+            LoadHeader header;
+            header.nMagic = kHeaderMagic;
+            header.nFlags = bReliable ? kHeaderFlagReliable : 0;
+            header.nLane = static_cast<uint8_t>(nLane);
+            header.nReserved = 0;
+            header.nSequence = nSequence++;
+            header.usecScheduled = UsecSinceEpoch(tScheduled);
+
+            ISteamNetworkingMessage *pMsg = conn.pClient->AllocateMessage(cbSize);
+            if (!pMsg)
+            {
+                ++current.nErrors;
+                return;
+            }
+            std::memcpy(pMsg->m_pData, &header, sizeof(header));
+            std::memset(static_cast<uint8_t *>(pMsg->m_pData) + sizeof(header), 0, cbSize - sizeof(header));
+
+            // Same send flags as ConnectionManager::SendReliableMessage() and SendUnreliableMessage().
+            const int nSendFlags =
+                bReliable ? k_nSteamNetworkingSend_Reliable : k_nSteamNetworkingSend_UnreliableNoDelay;
+            const int64 nMessageNumber =
+                conn.pClient->SendAllocatedMessage(conn.pClient->GetConnection(), pMsg, cbSize, nSendFlags, nLane);
+            if (nMessageNumber == 0)
+            {
+                ++current.nErrors;
+                return;
+            }
+
+            ++current.nSent;
+            if (bReliable && bReceipts)
+            {
+                conn.dequeUnacked.emplace_back(nMessageNumber, header.usecScheduled);
+            }
+        };
+
+        auto CloseInterval = [&](Clock::time_point tNow, Clock::time_point tIntervalStart)
+        {
+            double flPingSum = 0.0;
+            double flMaxQueueMs = 0.0;
+            for (LoadConnection &conn : vecConnections)
+            {
+                SteamNetConnectionRealTimeStatus_t status;
+                if (conn.pClient->GetRealTimeStatus(conn.pClient->GetConnection(), status))
+                {
+                    flPingSum += status.m_nPing;
+                    flMaxQueueMs = std::max(flMaxQueueMs, status.m_usecQueueTime / 1000.0);
+                }
+            }
+
+            current.flEndSeconds = std::chrono::duration<double>(tNow - tEpoch).count();
+            current.flSeconds = std::chrono::duration<double>(tNow - tIntervalStart).count();
+            current.flPingMs = flPingSum / vecConnections.size();
+            current.flMaxQueueMs = flMaxQueueMs;
+            report.AddInterval(current);
+            current = IntervalSample();
+        };
+
+        auto PollAll = [&]()
+        {
+            for (LoadConnection &conn : vecConnections)
+            {
+                conn.pClient->Poll();
+                conn.pClient->ReceiveMessages();
+            }
+        };
+
+        // Open-loop schedule: every message that is due is sent, however late the loop is running, and latency is
+        // measured from the scheduled time, so a stall is reported as latency rather than hidden.
+        const Clock::duration sendInterval =
+            std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(1.0 / options.flRate));
+        const Clock::duration reportInterval =
+            std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(options.flIntervalSeconds));
+        const Clock::time_point tStart = Clock::now();
+        const Clock::time_point tEnd = tStart + std::chrono::duration_cast<Clock::duration>(
+                                                    std::chrono::duration<double>(options.flDurationSeconds));
+
+        Clock::time_point tNextSend = tStart;
+        Clock::time_point tIntervalStart = tStart;
+        Clock::time_point tNextReport = tStart + reportInterval;
+        for (Clock::time_point tNow = tStart; tNow < tEnd; tNow = Clock::now())
+        {
+            while (tNextSend <= tNow && tNextSend < tEnd)
+            {
+                SendOne(tNextSend);
+                tNextSend += sendInterval;
+            }
+
+            PollAll();
+
+            if (tNow >= tNextReport)
+            {
+                CloseInterval(tNow, tIntervalStart);
+                tIntervalStart = tNow;
+                tNextReport += reportInterval;
+            }
+
+            const Clock::time_point tWake = std::min(tNextSend, tNow + std::chrono::milliseconds(1));
+            if (tWake > Clock::now())
+            {
+                std::this_thread::sleep_until(tWake);
+            }
+        }
+
+        // Collect late echoes and receipts into the final interval.
+        const Clock::time_point tDrainEnd = Clock::now() + std::chrono::seconds(1);
+        while (Clock::now() < tDrainEnd)
+        {
+            PollAll();
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        CloseInterval(Clock::now(), tIntervalStart);
+
+        for (LoadConnection &conn : vecConnections)
+        {
+            conn.pClient->Disconnect();
+        }
+        return true;
+    }
+
+    void EchoLoadMessage(QNET::Server &server, HSteamNetConnection hConn, const std::vector<uint8_t> &byteMessage)
+    {
+        LoadHeader header;
+        if (ReadHeader(byteMessage, header) && (header.nFlags & kHeaderFlagReliable) == 0)
+        {
+            server.SendUnreliableMessage(hConn, byteMessage);
+        }
+        else
+        {
+            server.SendReliableMessage(hConn, byteMessage);
+        }
+    }
+} // namespace LoadGen
\ No newline at end of file
@@ -0,0 +1,47 @@
+#pragma once
+
+#include "LoadReport.h"
+
+#include "quicknet/components/Server.h"
+
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace LoadGen
+{
+    /// @brief Settings for a load run against a QNET::Server.
+    struct NetLoadOptions
+    {
+        std::string strAddress = "127.0.0.1:27020";
+        int nConnections = 10;
+
+        /// @brief Messages per second across all connections, scheduled open-loop.
+        double flRate = 1000.0;
+        double flDurationSeconds = 10.0;
+        double flIntervalSeconds = 1.0;
+
+        /// @brief Message sizes in bytes and their relative weights.
+        std::vector<std::pair<uint32_t, uint32_t>> vecSizeMix = {{64, 1}};
+
+        /// @brief Fraction of messages sent reliably.
+        double flReliableRatio = 0.5;
+
+        /// @brief Weight of each lane; messages are spread across lanes in proportion. Empty for a single lane.
+        std::vector<uint16_t> vecLaneWeights;
+
+        uint32_t nSeed = 1;
+    };
+
+    /// @brief Connects, sends the configured message mix for the configured time and reports every interval.
+    /// @details Every message starts with a small header holding its scheduled send time. Servers that echo
+    /// messages back (see EchoLoadMessage()) give round-trip latency; reliable messages additionally report the
+    /// time until their delivery receipt, which works against any server.
+    /// @return False if the connections could not be established.
+    bool RunNetLoad(const NetLoadOptions &options, LoadReport &report);
+
+    /// @brief Sends a message back to its sender, with the reliability it was sent with if it came from
+    /// RunNetLoad(), and reliably otherwise. Use as the body of Server::OnMessageReceived.
+    void EchoLoadMessage(QNET::Server &server, HSteamNetConnection hConn, const std::vector<uint8_t> &byteMessage);
+} // namespace LoadGen
\ No newline at end of file
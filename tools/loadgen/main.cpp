@@ -0,0 +1,259 @@
+// qnet_loadgen: load generator for QNET::Server and QNET::HttpServer.
+//
+//   qnet_loadgen net   --address 10.0.0.5:27020 --connections 200 --rate 20000 --sizes 64:8,1200:2 --json out.json
+//   qnet_loadgen http  --url http://10.0.0.5:8080 --route GET:/:3 --route POST:/echo:1 --rate 2000 --concurrency 64
+//   qnet_loadgen serve --port 27020 --http-port 8080
+//
+// The serve mode runs an echo Server (and optionally an HttpServer with GET / and POST /echo) so that both load
+// modes can be exercised locally without any other service.
+
+#include "HttpLoad.h"
+#include "LoadReport.h"
+#include "NetLoad.h"
+
+#include <cstdlib>
+#include <exception>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <thread>
+
+namespace
+{
+    void PrintUsage()
+    {
+        std::cerr
+            << "Usage:\n"
+               "  qnet_loadgen net   [options]   Load a QNET::Server\n"
+               "    --address HOST:PORT          Server address (default 127.0.0.1:27020)\n"
+               "    --connections N              Number of connections (default 10)\n"
+               "    --sizes BYTES:WEIGHT,...     Message size mix (default 64:1)\n"
+               "    --reliable-ratio F           Fraction of reliable messages (default 0.5)\n"
+               "    --lanes WEIGHT,...           Configure lanes with these weights (default: one lane)\n"
+               "  qnet_loadgen http  [options]   Load a QNET::HttpServer\n"
+               "    --url URL                    Base URL (default http://127.0.0.1:8080)\n"
+               "    --route METHOD:PATH[:WEIGHT] Request mix entry, repeatable (default GET:/)\n"
+               "    --concurrency N              Concurrent connections (default 16)\n"
+               "    --no-keep-alive              Open a new connection for every request\n"
+               "    --body-size BYTES            Body size for POST and PUT (default 0)\n"
+               "    --timeout-ms N               Connect and read timeout (default 5000)\n"
+               "  Common options for net and http:\n"
+               "    --rate R                     Messages or requests per second, open-loop (default 1000 / 100)\n"
+               "    --duration S                 Run time in seconds (default 10)\n"
+               "    --interval S                 Reporting interval in seconds (default 1)\n"
+               "    --seed N                     Random seed for the mixes (default 1)\n"
+               "    --json PATH                  Write all intervals and totals as JSON\n"
+               "  qnet_loadgen serve [options]   Run a local echo server\n"
+               "    --port N                     QNET::Server port (default 27020)\n"
+               "    --http-port N                Also run an HttpServer on this port\n";
+    }
+
+    std::vector<std::string> Split(const std::string &strValue, char chSeparator)
+    {
+        std::vector<std::string> vecParts;
+        std::stringstream ss(strValue);
+        std::string strPart;
+        while (std::getline(ss, strPart, chSeparator))
+        {
+            vecParts.push_back(strPart);
+        }
+        return vecParts;
+    }
+
+    /// @brief Parses "METHOD:PATH" or "METHOD:PATH:WEIGHT".
+    bool ParseRoute(const std::string &strValue, LoadGen::HttpRoute &route)
+    {
+        const size_t nMethodEnd = strValue.find(':');
+        if (nMethodEnd == std::string::npos || nMethodEnd + 1 >= strValue.size())
+            return false;
+
+        route.strMethod = strValue.substr(0, nMethodEnd);
+        route.strPath = strValue.substr(nMethodEnd + 1);
+        route.nWeight = 1;
+
+        const size_t nWeightStart = route.strPath.rfind(':');
+        if (nWeightStart != std::string::npos && nWeightStart + 1 < route.strPath.size() &&
+            route.strPath.find_first_not_of("0123456789", nWeightStart + 1) == std::string::npos)
+        {
+            route.nWeight = static_cast<uint32_t>(std::atoi(route.strPath.c_str() + nWeightStart + 1));
+            route.strPath.resize(nWeightStart);
+        }
+        return !route.strPath.empty() && route.strPath[0] == '/';
+    }
+
+    int RunServe(uint16_t nPort, uint16_t nHttpPort)
+    {
+        QNET::Server server;
+        server.OnMessageReceived = [&server](HSteamNetConnection hConn, const std::vector<uint8_t> &byteMessage)
+        { LoadGen::EchoLoadMessage(server, hConn, byteMessage); };
+        if (!server.Initialize(nPort))
+            return 1;
+
+        QNET::HttpServer httpServer;
+        std::thread httpThread;
+        if (nHttpPort != 0)
+        {
+            LoadGen::RegisterHttpEchoRoutes(httpServer);
+            httpThread = std::thread(
+                [&httpServer, nHttpPort]()
+                {
+                    try
+                    {
+                        httpServer.Run(nHttpPort);
+                    }
+                    catch (const std::exception &e)
+                    {
+                        std::cerr << "qnet_loadgen: " << e.what() << std::endl;
+                    }
+                });
+        }
+
+        // Runs until the process is terminated.
+        server.Run();
+
+        httpServer.Stop();
+        if (httpThread.joinable())
+        {
+            httpThread.join();
+        }
+        return 0;
+    }
+} // namespace
+
+int main(int argc, char **argv)
+{
+    if (argc < 2)
+    {
+        PrintUsage();
+        return 1;
+    }
+
+    const std::string strMode = argv[1];
+    LoadGen::NetLoadOptions netOptions;
+    LoadGen::HttpLoadOptions httpOptions;
+    std::vector<std::pair<std::string, std::string>> vecConfig;
+    std::string strJsonPath;
+    uint16_t nServePort = 27020;
+    uint16_t nServeHttpPort = 0;
+    bool bRoutesGiven = false;
+
+    for (int i = 2; i < argc; ++i)
+    {
+        const std::string strArg = argv[i];
+        if (strArg == "--no-keep-alive")
+        {
+            httpOptions.bKeepAlive = false;
+            vecConfig.emplace_back("keep_alive", "false");
+            continue;
+        }
+        if (i + 1 >= argc)
+        {
+            PrintUsage();
+            return 1;
+        }
+
+        const std::string strValue = argv[++i];
+        vecConfig.emplace_back(strArg.substr(2), strValue);
+        if (strArg == "--address")
+            netOptions.strAddress = strValue;
+        else if (strArg == "--connections")
+            netOptions.nConnections = std::atoi(strValue.c_str());
+        else if (strArg == "--sizes")
+        {
+            netOptions.vecSizeMix.clear();
+            for (const std::string &strEntry : Split(strValue, ','))
+            {
+                const std::vector<std::string> vecParts = Split(strEntry, ':');
+                const uint32_t nWeight = vecParts.size() > 1 ? std::atoi(vecParts[1].c_str()) : 1;
+                netOptions.vecSizeMix.emplace_back(std::atoi(vecParts[0].c_str()), nWeight);
+            }
+        }
+        else if (strArg == "--reliable-ratio")
+            netOptions.flReliableRatio = std::atof(strValue.c_str());
+        else if (strArg == "--lanes")
+        {
+            for (const std::string &strWeight : Split(strValue, ','))
+            {
+                netOptions.vecLaneWeights.push_back(static_cast<uint16_t>(std::atoi(strWeight.c_str())));
+            }
+        }
+        else if (strArg == "--url")
+            httpOptions.strUrl = strValue;
+        else if (strArg == "--route")
+        {
+            LoadGen::HttpRoute route;
+            if (!ParseRoute(strValue, route))
+            {
+                std::cerr << "qnet_loadgen: invalid route '" << strValue << "'" << std::endl;
+                return 1;
+            }
+            if (!bRoutesGiven)
+            {
+                httpOptions.vecRoutes.clear();
+                bRoutesGiven = true;
+            }
+            httpOptions.vecRoutes.push_back(route);
+        }
+        else if (strArg == "--concurrency")
+            httpOptions.nConcurrency = std::atoi(strValue.c_str());
+        else if (strArg == "--body-size")
+            httpOptions.cbBody = static_cast<size_t>(std::atoll(strValue.c_str()));
+        else if (strArg == "--timeout-ms")
+            httpOptions.nTimeoutMs = std::atoi(strValue.c_str());
+        else if (strArg == "--rate")
+            netOptions.flRate = httpOptions.flRate = std::atof(strValue.c_str());
+        else if (strArg == "--duration")
+            netOptions.flDurationSeconds = httpOptions.flDurationSeconds = std::atof(strValue.c_str());
+        else if (strArg == "--interval")
+            netOptions.flIntervalSeconds = httpOptions.flIntervalSeconds = std::atof(strValue.c_str());
+        else if (strArg == "--seed")
+            netOptions.nSeed = httpOptions.nSeed = static_cast<uint32_t>(std::atoll(strValue.c_str()));
+        else if (strArg == "--json")
+            strJsonPath = strValue;
+        else if (strArg == "--port")
+            nServePort = static_cast<uint16_t>(std::atoi(strValue.c_str()));
+        else if (strArg == "--http-port")
+            nServeHttpPort = static_cast<uint16_t>(std::atoi(strValue.c_str()));
+        else
+        {
+            PrintUsage();
+            return 1;
+        }
+    }
+
+    if (strMode == "serve")
+        return RunServe(nServePort, nServeHttpPort);
+
+    if (strMode != "net" && strMode != "http")
+    {
+        PrintUsage();
+        return 1;
+    }
+
+    const bool bNet = strMode == "net";
+    const double flRate = bNet ? netOptions.flRate : httpOptions.flRate;
+    const double flInterval = bNet ? netOptions.flIntervalSeconds : httpOptions.flIntervalSeconds;
+    if (!(flRate > 0) || !(flInterval > 0) || netOptions.nConnections <= 0 || netOptions.vecSizeMix.empty())
+    {
+        PrintUsage();
+        return 1;
+    }
+
+    LoadGen::LoadReport report(strMode, bNet ? "rtt" : "latency", std::cout);
+    for (const auto &config : vecConfig)
+    {
+        report.AddConfig(config.first, config.second);
+    }
+
+    const bool bSuccess = bNet ? LoadGen::RunNetLoad(netOptions, report) : LoadGen::RunHttpLoad(httpOptions, report);
+    if (!bSuccess)
+        return 1;
+
+    report.PrintSummary();
+    if (!strJsonPath.empty() && !report.WriteJson(strJsonPath))
+    {
+        std::cerr << "qnet_loadgen: could not write " << strJsonPath << std::endl;
+        return 1;
+    }
+    return 0;
+}
\ No newline at end of file